@@ -6,6 +6,7 @@ INSTALL(TARGETS AppCore
         
 INSTALL(DIRECTORY "include" DESTINATION ".")
 INSTALL(DIRECTORY "shaders" DESTINATION ".")
+INSTALL(FILES cmake/EmbedAssets.cmake cmake/GenerateEmbeddedAssets.cmake DESTINATION "cmake")
 INSTALL(FILES README.md LICENSE DESTINATION ".")
 
 if (PORT MATCHES "UltralightWin")
@@ -0,0 +1,53 @@
+# EmbedAssets.cmake
+# Compiles a directory of assets into a target's binary for MountEmbeddedAssets().
+#
+# Usage:
+#   include(EmbedAssets)
+#   appcore_embed_assets(<target> <directory> [NAME <table_name>])
+#
+# Defines 'extern const ultralight::EmbeddedAssetTable <table_name>;' (default:
+# <target>_assets) in a generated source added to <target>. File contents are
+# linked in with the assembler's .incbin directive (GCC and Clang), so they cost
+# nothing to compile; MSVC falls back to byte arrays.
+#
+# The table is regenerated whenever a file in <directory> changes, and files
+# added to or removed from <directory> are picked up on the next build.
+
+set(APPCORE_EMBED_ASSETS_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/GenerateEmbeddedAssets.cmake")
+
+function(appcore_embed_assets TARGET DIRECTORY)
+    cmake_parse_arguments(EMBED "" "NAME" "" ${ARGN})
+    if(NOT EMBED_NAME)
+        set(EMBED_NAME "${TARGET}_assets")
+    endif()
+    string(MAKE_C_IDENTIFIER "${EMBED_NAME}" EMBED_NAME)
+
+    get_filename_component(ASSET_DIR "${DIRECTORY}" ABSOLUTE)
+    file(GLOB_RECURSE ASSET_FILES CONFIGURE_DEPENDS LIST_DIRECTORIES false "${ASSET_DIR}/*")
+
+    if(MSVC)
+        set(USE_INCBIN OFF)
+    else()
+        set(USE_INCBIN ON)
+    endif()
+
+    set(OUTPUT_FILE "${CMAKE_CURRENT_BINARY_DIR}/${EMBED_NAME}.cpp")
+    add_custom_command(
+        OUTPUT "${OUTPUT_FILE}"
+        COMMAND "${CMAKE_COMMAND}"
+            -DASSET_DIR=${ASSET_DIR}
+            -DTABLE_NAME=${EMBED_NAME}
+            -DOUTPUT_FILE=${OUTPUT_FILE}
+            -DUSE_INCBIN=${USE_INCBIN}
+            -P "${APPCORE_EMBED_ASSETS_SCRIPT}"
+        DEPENDS ${ASSET_FILES} "${APPCORE_EMBED_ASSETS_SCRIPT}"
+        COMMENT "Embedding assets from ${ASSET_DIR}"
+        VERBATIM
+    )
+
+    target_sources(${TARGET} PRIVATE "${OUTPUT_FILE}")
+
+    # With .incbin an edit that keeps the file list and sizes leaves the
+    # generated source unchanged, so the object has to depend on the assets.
+    set_source_files_properties("${OUTPUT_FILE}" PROPERTIES OBJECT_DEPENDS "${ASSET_FILES}")
+endfunction()
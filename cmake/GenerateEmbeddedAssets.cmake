@@ -0,0 +1,98 @@
+# GenerateEmbeddedAssets.cmake
+# Generates the source for appcore_embed_assets() (see EmbedAssets.cmake)
+
+# Required variables:
+# ASSET_DIR - Absolute path of the directory to embed
+# TABLE_NAME - Name of the EmbeddedAssetTable to define
+# OUTPUT_FILE - Output source file
+# USE_INCBIN - Link files in with .incbin (otherwise byte arrays)
+
+if(NOT ASSET_DIR OR NOT TABLE_NAME OR NOT OUTPUT_FILE)
+    message(FATAL_ERROR "ASSET_DIR, TABLE_NAME, and OUTPUT_FILE must be defined")
+endif()
+
+# Sorted byte-wise, the order MountEmbeddedAssets() binary searches in.
+file(GLOB_RECURSE ASSET_FILES RELATIVE "${ASSET_DIR}" LIST_DIRECTORIES false "${ASSET_DIR}/*")
+list(SORT ASSET_FILES COMPARE STRING CASE SENSITIVE)
+
+set(CONTENT "// Auto-generated embedded assets
+// Source: ${ASSET_DIR}
+// Generated: ${CMAKE_CURRENT_LIST_FILE}
+
+#include <AppCore/EmbeddedAssets.h>
+
+")
+
+if(USE_INCBIN)
+    string(APPEND CONTENT "#if defined(__APPLE__)
+#  define APPCORE_ASSET_SECTION \".pushsection __TEXT,__const\"
+#  define APPCORE_ASSET_SYMBOL(name) \"_\" #name
+#  define APPCORE_ASSET_HIDDEN \".private_extern \"
+#else
+#  define APPCORE_ASSET_SECTION \".pushsection .rodata\"
+#  define APPCORE_ASSET_SYMBOL(name) #name
+#  define APPCORE_ASSET_HIDDEN \".hidden \"
+#endif
+
+#define APPCORE_INCBIN(name, file)                             \\
+  __asm__(APPCORE_ASSET_SECTION \"\\n\"                          \\
+          \".globl \" APPCORE_ASSET_SYMBOL(name) \"\\n\"            \\
+          APPCORE_ASSET_HIDDEN APPCORE_ASSET_SYMBOL(name) \"\\n\"  \\
+          \".balign 16\\n\"                                       \\
+          APPCORE_ASSET_SYMBOL(name) \":\\n\"                       \\
+          \".incbin \\\"\" file \"\\\"\\n\"                           \\
+          \".byte 0\\n\"                                          \\
+          \".popsection\\n\");                                    \\
+  extern \"C\" __attribute__((visibility(\"hidden\"))) const unsigned char name[]
+
+")
+endif()
+
+set(TABLE_ENTRIES "")
+set(INDEX 0)
+foreach(ASSET_FILE IN LISTS ASSET_FILES)
+    set(SYMBOL "${TABLE_NAME}_${INDEX}")
+    set(ASSET_PATH "${ASSET_DIR}/${ASSET_FILE}")
+    file(SIZE "${ASSET_PATH}" ASSET_SIZE)
+
+    # Escape for a C string literal
+    string(REPLACE "\\" "\\\\" PATH_LITERAL "${ASSET_FILE}")
+    string(REPLACE "\"" "\\\"" PATH_LITERAL "${PATH_LITERAL}")
+
+    if(USE_INCBIN)
+        # Escape for an assembler string inside a C string literal
+        string(REPLACE "\\" "\\\\\\\\" INCBIN_PATH "${ASSET_PATH}")
+        string(REPLACE "\"" "\\\\\\\"" INCBIN_PATH "${INCBIN_PATH}")
+        string(APPEND CONTENT "APPCORE_INCBIN(${SYMBOL}, \"${INCBIN_PATH}\");\n")
+    else()
+        file(READ "${ASSET_PATH}" ASSET_DATA HEX)
+        string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," ASSET_DATA "${ASSET_DATA}")
+        string(REGEX REPLACE "((0x..,){32})" "\\1\n    " ASSET_DATA "${ASSET_DATA}")
+        string(APPEND CONTENT "alignas(16) static const unsigned char ${SYMBOL}[] = {\n    ${ASSET_DATA}0x00\n};\n")
+    endif()
+
+    string(APPEND TABLE_ENTRIES "  { \"${PATH_LITERAL}\", ${SYMBOL}, ${ASSET_SIZE} },\n")
+    math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+if(INDEX EQUAL 0)
+    string(APPEND CONTENT "
+extern const ultralight::EmbeddedAssetTable ${TABLE_NAME} = { nullptr, 0 };
+")
+else()
+    string(APPEND CONTENT "
+static constexpr ultralight::EmbeddedAsset ${TABLE_NAME}_entries[] = {
+${TABLE_ENTRIES}};
+
+static_assert(ultralight::IsSortedByPath(${TABLE_NAME}_entries, ${INDEX}),
+              \"Embedded assets must be sorted by path\");
+
+extern const ultralight::EmbeddedAssetTable ${TABLE_NAME} = { ${TABLE_NAME}_entries, ${INDEX} };
+")
+endif()
+
+# Only touch the output when it changed, to avoid needless recompiles.
+set(TEMP_FILE "${OUTPUT_FILE}.tmp")
+file(WRITE "${TEMP_FILE}" "${CONTENT}")
+file(COPY_FILE "${TEMP_FILE}" "${OUTPUT_FILE}" ONLY_IF_DIFFERENT)
+file(REMOVE "${TEMP_FILE}")
@@ -11,6 +11,9 @@ set(UL_ENABLE_SAMPLES OFF                                 CACHE BOOL    "Whether
 set(UL_ENABLE_MEMORY_STATS OFF                            CACHE BOOL    "(Windows only) Whether or not to enable runtime memory stats gathering.")
 set(UL_ENABLE_DEBUG_CHECKS OFF                            CACHE BOOL    "Whether or not to enable debug assertions (disabled in all builds by default).")
 set(UL_ENABLE_ALLOCATOR_OVERRIDE OFF                      CACHE BOOL    "Whether or not to use the API hooks in Allocator.h for all heap allocations.")
+set(UL_ENABLE_PAK_TOOL ON                                 CACHE BOOL    "Whether or not to build the AppCorePak asset archive packer.")
+set(UL_ENABLE_IO_URING OFF                                CACHE BOOL    "(Linux only) Whether or not to use io_uring for asynchronous file reads (otherwise, a pread thread pool).")
+set(UL_ENABLE_VULKAN OFF                                  CACHE BOOL    "(Linux only) Whether or not to build the Vulkan GPU driver (falls back to OpenGL at runtime).")
 set(UL_ENABLE_STACK_TRACE OFF                             CACHE BOOL    "Whether or not to enable stack trace functionality.")
 set(UL_PROFILE_PERFORMANCE OFF                            CACHE BOOL    "Whether or not to enable runtime performance profiling via Tracy.")
 set(UL_PROFILE_MEMORY OFF                                 CACHE BOOL    "(Windows only) Whether or not to enable runtime memory profiling via Tracy.")
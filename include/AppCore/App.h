@@ -16,6 +16,21 @@ namespace ultralight {
 class Monitor;
 class Window;
 
+///
+/// Severity of a memory pressure event. @see AppListener::OnMemoryPressure
+///
+enum class MemoryPressureLevel : uint8_t {
+  ///
+  /// The system (or the app's cgroup) is short on memory. Caches should be trimmed.
+  ///
+  Moderate,
+
+  ///
+  /// The app is at risk of being killed. Release everything that can be recreated.
+  ///
+  Critical,
+};
+
 ///
 /// Interface for all App-related events. @see App::set_listener
 ///
@@ -35,14 +50,31 @@ public:
   /// Called when the app has been idle (low CPU utilization, no recent user input)
   /// for a sustained period.
   ///
-  /// @param  utilization  Thread CPU utilization (0.0-1.0) over the last ~1 second.
-  ///                      Lower values = more headroom for background work.
+  /// @param  utilization  CPU utilization over the last ~1 second that idle detection
+  ///                      compared against Settings::idle_utilization_threshold (process
+  ///                      cores in use, or main-thread 0.0-1.0, depending on
+  ///                      Settings::idle_uses_process_utilization). Lower values = more
+  ///                      headroom for background work.
   ///
   /// @note  Fires once after Settings::sustained_idle_time of continuous idle, then
   ///        repeats at the same interval while idle conditions hold. Stops immediately
   ///        when user input occurs or CPU utilization rises above threshold.
   ///
   virtual void OnIdle(double utilization) {}
+
+  ///
+  /// Called when the OS reports memory pressure, after the App has released memory on its
+  /// own (Renderer::Recycle() and GPU driver cache trimming, plus Renderer::PurgeMemory() at
+  /// the Critical level). Release any memory your application can spare.
+  ///
+  /// @note  Fires at most once per second unless the level rises. Pressure that persists
+  ///        escalates to Critical, but renderer memory is purged at most once every 10
+  ///        seconds (backing off up to 5 minutes while purges free nothing). Critical events
+  ///        in between are reported as Moderate.
+  ///
+  /// @note  Only supported on Linux at this time (PSI, cgroup v2 and RSS limits).
+  ///
+  virtual void OnMemoryPressure(MemoryPressureLevel level) {}
 };
 
 ///
@@ -78,6 +110,20 @@ struct AExport Settings {
   ///
   String file_system_path = "./assets/";
 
+  ///
+  /// Path to an asset archive (.pak) built by the AppCorePak tool, mounted over
+  /// file_system_path. Files in the archive take precedence, anything missing from it is
+  /// loaded from file_system_path.
+  ///
+  /// The archive is memory-mapped: uncompressed entries are served without copying and
+  /// compressed (LZ4/zstd) entries are decompressed when opened.
+  ///
+  /// This path is resolved relative to the same directory as file_system_path.
+  ///
+  /// Default: empty (no archive).
+  ///
+  String file_system_archive = "";
+
   ///
   /// Whether or not we should load and compile shaders from the file system
   /// (eg, from the /shaders/ path, relative to file_system_path).
@@ -118,11 +164,293 @@ struct AExport Settings {
   double sustained_idle_time = 2.0;
 
   ///
-  /// Thread CPU utilization threshold (0.0-1.0) below which the app is considered idle.
+  /// CPU utilization threshold below which the app is considered idle.
+  ///
+  /// With idle_uses_process_utilization this is in CPU cores used by the whole process
+  /// (0.5 = half of one core, summed over all threads), otherwise it is the main thread's
+  /// utilization (0.0-1.0).
   ///
-  /// Default: 0.5 (50%).
+  /// Default: 0.5.
   ///
   double idle_utilization_threshold = 0.5;
+
+  ///
+  /// Whether idle detection looks at the CPU time of every thread in the process (renderer,
+  /// JavaScript, workers, etc.) instead of just the main thread.
+  ///
+  /// Default: true.
+  ///
+  bool idle_uses_process_utilization = true;
+
+  ///
+  /// Minimum time (in seconds) between CPU utilization samples. Per-thread utilization is
+  /// sampled once per second regardless.
+  ///
+  /// Default: 0.1 seconds.
+  ///
+  double cpu_sample_interval = 0.1;
+
+  ///
+  /// GPU memory budget (in bytes) for textures, render targets and geometry.
+  ///
+  /// When the GPU driver reports usage above this budget the App first calls
+  /// Renderer::Recycle(), then Renderer::PurgeMemory() once if usage stays above
+  /// budget, and logs the largest GPU resources to the current Logger. Nothing
+  /// more is done until usage drops back under the budget.
+  ///
+  /// Default: 0 (no budget).
+  ///
+  /// @note  Only the OpenGL driver (Linux) tracks GPU memory at this time.
+  ///
+  uint64_t gpu_memory_budget = 0;
+
+  ///
+  /// Whether to watch OS memory pressure and release memory in response.
+  ///
+  /// On Linux this watches /proc/pressure/memory (PSI) and the memory.events, memory.high
+  /// and memory.max files of the app's cgroup (v2). @see AppListener::OnMemoryPressure
+  ///
+  /// Default: true.
+  ///
+  bool enable_memory_pressure_monitor = true;
+
+  ///
+  /// Resident memory limit (in bytes). When the app's RSS gets within 10% of this limit a
+  /// Moderate memory pressure event fires, and a Critical one fires when it goes over.
+  ///
+  /// Default: 0 (no limit).
+  ///
+  uint64_t memory_pressure_rss_limit = 0;
+
+  ///
+  /// Whether to index every file under file_system_path at startup, so that file existence
+  /// and mime type queries are answered from memory instead of the disk.
+  ///
+  /// The index is built on a background thread and kept up to date by watching the
+  /// directory tree; queries go to the disk until it is ready and while a change is being
+  /// indexed. @see App::file_system_index_stats
+  ///
+  /// Default: false.
+  ///
+  /// @note  Only supported on Linux (inotify) with the platform file system at this time.
+  ///
+  bool enable_file_system_index = false;
+
+  ///
+  /// Duration (in seconds) of the startup window to record file loads for.
+  ///
+  /// When non-zero, the paths of the files loaded during the first file_system_prefetch_time
+  /// seconds of each run are saved to a manifest in Config::cache_path. The next launch
+  /// replays that manifest on a background thread, loading those files into memory before
+  /// they are requested, which shortens cold starts on slow storage (spinning disks, SD
+  /// cards). Prefetched files that are still unused when the window ends are released.
+  ///
+  /// Default: 0 (disabled).
+  ///
+  double file_system_prefetch_time = 0.0;
+
+  ///
+  /// Maximum size (in bytes) of the in-memory cache of file contents.
+  ///
+  /// When non-zero, files loaded from file_system_path are kept in a least-recently-used
+  /// cache and shared (not copied) by later loads of the same file, eg, when a view is
+  /// recreated. Files are read from disk again once they change (this enables the file
+  /// system index, @see enable_file_system_index). The cache is emptied on memory pressure.
+  /// @see App::file_system_cache_stats
+  ///
+  /// Default: 0 (disabled).
+  ///
+  /// @note  Only supported on Linux with the platform file system at this time.
+  ///
+  uint64_t file_system_cache_size = 0;
+};
+
+///
+/// CPU utilization of a single thread. @see App::GetThreadCPUUsage
+///
+struct AExport ThreadCPUUsage {
+  ///
+  /// OS thread ID.
+  ///
+  uint64_t thread_id = 0;
+
+  ///
+  /// OS thread name (null-terminated, may be truncated or empty).
+  ///
+  char name[16] = {};
+
+  ///
+  /// Fraction of one core used by the thread (0.0-1.0) over the last ~1 second.
+  ///
+  double utilization = 0.0;
+};
+
+///
+/// GPU memory used by the platform GPU driver (in bytes). @see App::gpu_memory_stats
+///
+struct AExport GPUMemoryStats {
+  ///
+  /// Sampled textures (images, glyph atlases, CPU-rendered surfaces).
+  ///
+  uint64_t texture_bytes = 0;
+
+  ///
+  /// Textures backing render buffers (views, layers, filters).
+  ///
+  uint64_t render_target_bytes = 0;
+
+  ///
+  /// Multisampled twins of render target textures (only used with MSAA).
+  ///
+  uint64_t msaa_bytes = 0;
+
+  ///
+  /// Vertex and index buffers.
+  ///
+  uint64_t geometry_bytes = 0;
+
+  ///
+  /// Part of geometry_bytes holding live vertices and indices, the rest is
+  /// free space in the shared geometry pages.
+  ///
+  uint64_t geometry_used_bytes = 0;
+
+  ///
+  /// Largest contiguous free vertex range in a geometry page.
+  ///
+  uint64_t geometry_largest_free_bytes = 0;
+
+  ///
+  /// How scattered free vertex space is across the geometry pages, from 0.0
+  /// (all in one range) towards 1.0 (many small holes).
+  ///
+  double geometry_fragmentation = 0.0;
+
+  ///
+  /// Pixel buffers used to read back render buffers.
+  ///
+  uint64_t pixel_buffer_bytes = 0;
+
+  uint32_t texture_count = 0;
+  uint32_t render_buffer_count = 0;
+  uint32_t geometry_count = 0;
+
+  uint64_t total_bytes() const {
+    return texture_bytes + render_target_bytes + msaa_bytes + geometry_bytes + pixel_buffer_bytes;
+  }
+};
+
+///
+/// Counters of the platform GPU driver's caches and queues. @see App::gpu_driver_stats
+///
+struct AExport GPUDriverStats {
+  ///
+  /// Render buffers whose texture was reused from the render target pool.
+  ///
+  uint64_t render_target_pool_hits = 0;
+
+  ///
+  /// Render buffers that needed a new texture.
+  ///
+  uint64_t render_target_pool_misses = 0;
+
+  ///
+  /// Pooled render targets freed after going unused for a while, or to make room.
+  ///
+  uint64_t render_target_pool_evictions = 0;
+
+  ///
+  /// GPU objects released by the renderer whose deletion is deferred until the GPU is done with
+  /// them.
+  ///
+  uint32_t pending_deletion_objects = 0;
+
+  ///
+  /// Frames of deferred deletions still waiting on the GPU.
+  ///
+  uint32_t pending_deletion_frames = 0;
+
+  ///
+  /// Bytes of uniforms the last drawn frame would have uploaded sending the whole uniform block
+  /// for every draw.
+  ///
+  uint64_t uniform_full_bytes = 0;
+
+  ///
+  /// Bytes of uniforms the last drawn frame actually uploaded.
+  ///
+  uint64_t uniform_uploaded_bytes = 0;
+
+  ///
+  /// Draws in the last drawn frame whose uniforms were already uploaded.
+  ///
+  uint64_t uniform_skipped_uploads = 0;
+
+  double render_target_pool_hit_rate() const {
+    uint64_t total = render_target_pool_hits + render_target_pool_misses;
+    return total ? (double)render_target_pool_hits / (double)total : 0.0;
+  }
+};
+
+///
+/// Counters of the file system index. @see Settings::enable_file_system_index
+///
+struct AExport FileSystemIndexStats {
+  ///
+  /// Queries answered from the index for files that exist.
+  ///
+  uint64_t hits = 0;
+
+  ///
+  /// Queries answered from the index for files that don't exist.
+  ///
+  uint64_t misses = 0;
+
+  ///
+  /// Queries the index couldn't answer (not built yet, a change pending, or a path it can't
+  /// resolve such as one containing ".."), which went to the disk instead.
+  ///
+  uint64_t fallbacks = 0;
+
+  ///
+  /// Number of times the index was built, including the initial build.
+  ///
+  uint64_t rebuilds = 0;
+
+  ///
+  /// Files and directories in the current index.
+  ///
+  uint64_t entries = 0;
+};
+
+///
+/// Counters of the file content cache. @see Settings::file_system_cache_size
+///
+struct AExport FileSystemCacheStats {
+  ///
+  /// File loads served from the cache.
+  ///
+  uint64_t hits = 0;
+
+  ///
+  /// File loads that went to the disk (not cached yet, or changed since).
+  ///
+  uint64_t misses = 0;
+
+  ///
+  /// Files dropped to stay under Settings::file_system_cache_size.
+  ///
+  uint64_t evictions = 0;
+
+  ///
+  /// Bytes of file contents currently cached.
+  ///
+  uint64_t bytes = 0;
+
+  ///
+  /// Files currently cached.
+  ///
+  uint64_t entries = 0;
 };
 
 ///
@@ -279,6 +607,52 @@ public:
   ///
   virtual double thread_utilization() const = 0;
 
+  ///
+  /// Get the CPU utilization of the whole process (all threads) averaged over the last
+  /// ~1 second, in cores (1.0 = one core fully busy, may exceed 1.0 on multi-core machines).
+  ///
+  virtual double process_utilization() const = 0;
+
+  ///
+  /// Get the CPU utilization of each thread in the process over the last ~1 second,
+  /// busiest first.
+  ///
+  /// @param  usage      Array to fill, may be null when max_count is 0.
+  ///
+  /// @param  max_count  Capacity of the array.
+  ///
+  /// @return  The number of threads in the process (may be more than max_count).
+  ///
+  virtual uint32_t GetThreadCPUUsage(ThreadCPUUsage* usage, uint32_t max_count) const = 0;
+
+  ///
+  /// Get the GPU memory currently used by the platform GPU driver.
+  ///
+  /// @note  Drivers that don't track GPU memory report all zeros.
+  ///
+  virtual GPUMemoryStats gpu_memory_stats() const = 0;
+
+  ///
+  /// Get the counters of the platform GPU driver's caches and queues.
+  ///
+  /// @note  Drivers without them report all zeros.
+  ///
+  virtual GPUDriverStats gpu_driver_stats() const = 0;
+
+  ///
+  /// Get the counters of the file system index.
+  ///
+  /// @note  Reports all zeros unless Settings::enable_file_system_index is set and supported.
+  ///
+  virtual FileSystemIndexStats file_system_index_stats() const = 0;
+
+  ///
+  /// Get the counters of the file content cache.
+  ///
+  /// @note  Reports all zeros unless Settings::file_system_cache_size is set and supported.
+  ///
+  virtual FileSystemCacheStats file_system_cache_stats() const = 0;
+
 protected:
   virtual ~App();
 };
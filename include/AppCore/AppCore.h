@@ -7,8 +7,11 @@
  **************************************************************************************************/
 #include <AppCore/App.h>
 #include <AppCore/Dialogs.h>
+#include <AppCore/EmbeddedAssets.h>
 #include <AppCore/Monitor.h>
 #include <AppCore/Window.h>
 #include <AppCore/Overlay.h>
 #include <AppCore/JSHelpers.h>
-#include <AppCore/Platform.h>
\ No newline at end of file
+#include <AppCore/Platform.h>
+#include <AppCore/SoftwareGPUDriver.h>
+#include <AppCore/Tracing.h>
\ No newline at end of file
@@ -103,6 +103,107 @@ typedef struct C_Window* ULWindow;
 typedef struct C_Monitor* ULMonitor;
 typedef struct C_Overlay* ULOverlay;
 
+///
+/// GPU memory used by the platform GPU driver (in bytes). @see ulAppGetGPUMemoryStats
+///
+typedef struct {
+  unsigned long long texture_bytes;
+  unsigned long long render_target_bytes;
+  unsigned long long msaa_bytes;
+  unsigned long long geometry_bytes;
+  unsigned long long pixel_buffer_bytes;
+  unsigned long long total_bytes;
+  unsigned int texture_count;
+  unsigned int render_buffer_count;
+  unsigned int geometry_count;
+  unsigned long long geometry_used_bytes;
+  unsigned long long geometry_largest_free_bytes;
+  double geometry_fragmentation;
+} ULGPUMemoryStats;
+
+///
+/// Counters of the platform GPU driver's caches and queues. @see ulAppGetGPUDriverStats
+///
+typedef struct {
+  unsigned long long render_target_pool_hits;
+  unsigned long long render_target_pool_misses;
+  unsigned long long render_target_pool_evictions;
+  double render_target_pool_hit_rate;
+  unsigned int pending_deletion_objects;
+  unsigned int pending_deletion_frames;
+  unsigned long long uniform_full_bytes;
+  unsigned long long uniform_uploaded_bytes;
+  unsigned long long uniform_skipped_uploads;
+} ULGPUDriverStats;
+
+///
+/// CPU utilization of a single thread. @see ulAppGetThreadCPUUsage
+///
+typedef struct {
+  unsigned long long thread_id;
+  char name[16];
+  double utilization;
+} ULThreadCPUUsage;
+
+///
+/// Counters of the file system index. @see ulAppGetFileSystemIndexStats
+///
+typedef struct {
+  unsigned long long hits;
+  unsigned long long misses;
+  unsigned long long fallbacks;
+  unsigned long long rebuilds;
+  unsigned long long entries;
+} ULFileSystemIndexStats;
+
+///
+/// Counters of the file content cache. @see ulAppGetFileSystemCacheStats
+///
+typedef struct {
+  unsigned long long hits;
+  unsigned long long misses;
+  unsigned long long evictions;
+  unsigned long long bytes;
+  unsigned long long entries;
+} ULFileSystemCacheStats;
+
+///
+/// Frame-time distribution for one phase of a frame (in milliseconds).
+///
+typedef struct {
+  double mean_ms;
+  double p50_ms;
+  double p95_ms;
+  double p99_ms;
+  double max_ms;
+} ULFrameTimingPercentiles;
+
+///
+/// Summary of a window's frame timings. @see ulWindowGetFrameTimingSnapshot
+///
+typedef struct {
+  unsigned long long frame_count;
+  unsigned long long total_frames;
+  double fps;
+  ULFrameTimingPercentiles update;
+  ULFrameTimingPercentiles render;
+  ULFrameTimingPercentiles draw;
+  ULFrameTimingPercentiles swap;
+  ULFrameTimingPercentiles idle;
+  ULFrameTimingPercentiles total;
+} ULFrameTimingSnapshot;
+
+///
+/// Output format for ulWindowWriteFrameTimingReport.
+///
+/// CSV has one row per recent frame (up to 1024), times in milliseconds. JSON has the
+/// ULFrameTimingSnapshot followed by the same per-frame records.
+///
+typedef enum {
+  kFrameTimingFormat_CSV,
+  kFrameTimingFormat_JSON,
+} ULFrameTimingFormat;
+
 ///
 /// Window creation flags. @see Window::Create
 ///
@@ -159,6 +260,12 @@ ACExport void ulSettingsSetAppName(ULSettings settings, ULString name);
 ///
 ACExport void ulSettingsSetFileSystemPath(ULSettings settings, ULString path);
 
+///
+/// Set the path to an asset archive (.pak) to mount over the file system path, resolved
+/// relative to the same directory. Default: empty (no archive).
+///
+ACExport void ulSettingsSetFileSystemArchive(ULSettings settings, ULString path);
+
 ///
 /// Set whether or not we should load and compile shaders from the file system
 /// (eg, from the /shaders/ path, relative to file_system_path).
@@ -191,11 +298,58 @@ ACExport void ulSettingsSetIdleThreshold(ULSettings settings, double seconds);
 ACExport void ulSettingsSetSustainedIdleTime(ULSettings settings, double seconds);
 
 ///
-/// Set the thread CPU utilization threshold (0.0-1.0) below which the app is considered idle.
-/// Default: 0.5 (50%).
+/// Set the CPU utilization threshold below which the app is considered idle (process cores in
+/// use, or main-thread 0.0-1.0 if process utilization is disabled). Default: 0.5.
 ///
 ACExport void ulSettingsSetIdleUtilizationThreshold(ULSettings settings, double threshold);
 
+///
+/// Set whether idle detection uses the CPU time of every thread in the process instead of
+/// just the main thread. Default: true.
+///
+ACExport void ulSettingsSetIdleUsesProcessUtilization(ULSettings settings, bool enabled);
+
+///
+/// Set the minimum time (in seconds) between CPU utilization samples. Default: 0.1 seconds.
+///
+ACExport void ulSettingsSetCPUSampleInterval(ULSettings settings, double seconds);
+
+///
+/// Set whether to watch OS memory pressure and release memory in response. Default: true.
+///
+ACExport void ulSettingsSetEnableMemoryPressureMonitor(ULSettings settings, bool enabled);
+
+///
+/// Set a resident memory limit (in bytes) that triggers memory pressure events as the app
+/// approaches it. Default: 0 (no limit).
+///
+ACExport void ulSettingsSetMemoryPressureRSSLimit(ULSettings settings, unsigned long long bytes);
+
+///
+/// Set whether to index the files under the file system path at startup and answer file
+/// existence and mime type queries from memory. Default: false.
+///
+ACExport void ulSettingsSetEnableFileSystemIndex(ULSettings settings, bool enabled);
+
+///
+/// Set the duration (in seconds) of the startup window whose file loads are recorded and
+/// prefetched in the background on the next launch. Default: 0 (disabled).
+///
+ACExport void ulSettingsSetFileSystemPrefetchTime(ULSettings settings, double seconds);
+
+///
+/// Set the maximum size (in bytes) of the in-memory cache of file contents, emptied on memory
+/// pressure. Default: 0 (disabled).
+///
+ACExport void ulSettingsSetFileSystemCacheSize(ULSettings settings, unsigned long long bytes);
+
+///
+/// Set the GPU memory budget (in bytes). When exceeded, the app recycles and then purges
+/// renderer caches (once per crossing) and logs the largest GPU resources.
+/// Default: 0 (no budget).
+///
+ACExport void ulSettingsSetGPUMemoryBudget(ULSettings settings, unsigned long long bytes);
+
 ///
 /// Create the App singleton.
 ///
@@ -260,6 +414,21 @@ ACExport void ulAppQuit(ULApp app);
 typedef void
 (*ULIdleCallback) (void* user_data, double utilization);
 
+typedef enum {
+  kMemoryPressureLevel_Moderate,
+  kMemoryPressureLevel_Critical,
+} ULMemoryPressureLevel;
+
+typedef void
+(*ULMemoryPressureCallback) (void* user_data, ULMemoryPressureLevel level);
+
+///
+/// Set a callback for when the OS reports memory pressure (fired after the App has released
+/// its own caches). Only supported on Linux at this time.
+///
+ACExport void ulAppSetMemoryPressureCallback(ULApp app, ULMemoryPressureCallback callback,
+                                             void* user_data);
+
 ///
 /// Set a callback for when the app is idle (low CPU utilization, no recent user input).
 ///
@@ -282,6 +451,47 @@ ACExport bool ulAppIsIdle(ULApp app);
 ///
 ACExport double ulAppGetThreadUtilization(ULApp app);
 
+///
+/// Get the CPU utilization of the whole process (all threads) averaged over the last ~1 second,
+/// in cores (1.0 = one core fully busy).
+///
+ACExport double ulAppGetProcessUtilization(ULApp app);
+
+///
+/// Get the CPU utilization of each thread in the process over the last ~1 second, busiest
+/// first. Fills up to max_count entries and returns the number of threads in the process.
+///
+ACExport unsigned int ulAppGetThreadCPUUsage(ULApp app, ULThreadCPUUsage* usage,
+                                             unsigned int max_count);
+
+///
+/// Get the GPU memory currently used by the platform GPU driver.
+///
+/// @note  Drivers that don't track GPU memory report all zeros.
+///
+ACExport ULGPUMemoryStats ulAppGetGPUMemoryStats(ULApp app);
+
+///
+/// Get the counters of the platform GPU driver's caches and queues.
+///
+/// @note  Drivers without them report all zeros.
+///
+ACExport ULGPUDriverStats ulAppGetGPUDriverStats(ULApp app);
+
+///
+/// Get the counters of the file system index.
+///
+/// @note  Reports all zeros unless the index is enabled and supported (Linux only).
+///
+ACExport ULFileSystemIndexStats ulAppGetFileSystemIndexStats(ULApp app);
+
+///
+/// Get the counters of the file content cache.
+///
+/// @note  Reports all zeros unless the cache is enabled and supported (Linux only).
+///
+ACExport ULFileSystemCacheStats ulAppGetFileSystemCacheStats(ULApp app);
+
 ///
 /// Get the monitor's DPI scale (1.0 = 100%).
 ///
@@ -442,6 +652,29 @@ ACExport int ulWindowPixelsToScreen(ULWindow window, int val);
 ///
 ACExport void* ulWindowGetNativeHandle(ULWindow window);
 
+///
+/// Get a summary of the window's frame timings (percentiles since the window was created or
+/// since the last call to ulWindowResetFrameTiming).
+///
+/// @note  Frame timings are only recorded on Linux for now, on other platforms this returns
+///        all zeros.
+///
+ACExport ULFrameTimingSnapshot ulWindowGetFrameTimingSnapshot(ULWindow window);
+
+///
+/// Restart the window's frame-time percentiles.
+///
+ACExport void ulWindowResetFrameTiming(ULWindow window);
+
+///
+/// Write the window's recent frame timings to a CSV or JSON file.
+///
+/// @note  Frame timings are only recorded on Linux for now, on other platforms this writes
+///        nothing and returns false.
+///
+ACExport bool ulWindowWriteFrameTimingReport(ULWindow window, const char* path,
+                                             ULFrameTimingFormat format);
+
 ///
 /// Create a new Overlay.
 ///
@@ -586,6 +819,29 @@ ACExport void ulEnablePlatformFileSystem(ULString base_dir);
 ///
 ACExport void ulEnableDefaultLogger(ULString log_path);
 
+///
+/// Start or stop recording trace events (app update, repaint, overlay rendering, file loads,
+/// font matching, etc.) into per-thread ring buffers.
+///
+ACExport void ulEnableTracing(bool enabled);
+
+///
+/// Whether or not trace events are being recorded.
+///
+ACExport bool ulIsTracingEnabled();
+
+///
+/// Write all recorded trace events to a Chrome trace-event JSON file (open it in Perfetto or
+/// chrome://tracing). Returns whether or not the file was written.
+///
+ACExport bool ulWriteTraceFile(const char* path);
+
+///
+/// Write the trace file to 'path' whenever the process receives 'signal' (eg, SIGUSR2). Pass a
+/// null path to remove the handler. Does nothing on Windows.
+///
+ACExport void ulSetTraceSignal(int signal, const char* path);
+
 #ifdef __cplusplus
 }
 #endif
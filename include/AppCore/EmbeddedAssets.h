@@ -0,0 +1,84 @@
+/**************************************************************************************************
+ *  This file is a part of Ultralight, an ultra-portable web-browser engine.                      *
+ *                                                                                                *
+ *  See <https://ultralig.ht> for licensing and more.                                             *
+ *                                                                                                *
+ *  (C) 2024 Ultralight, Inc.                                                                     *
+ **************************************************************************************************/
+#pragma once
+#include "Defines.h"
+
+namespace ultralight {
+
+///
+/// A file compiled into the binary by the appcore_embed_assets() CMake function
+/// (cmake/EmbedAssets.cmake).
+///
+struct EmbeddedAsset {
+  ///
+  /// Path relative to the embedded directory, with forward slashes.
+  ///
+  const char* path;
+
+  ///
+  /// File contents (followed by a null byte, not included in size).
+  ///
+  const unsigned char* data;
+
+  size_t size;
+};
+
+///
+/// A directory of files compiled into the binary.
+///
+/// appcore_embed_assets(MyApp assets NAME my_assets) defines one of these as:
+///
+/// ```
+///   extern const ultralight::EmbeddedAssetTable my_assets;
+/// ```
+///
+struct EmbeddedAssetTable {
+  ///
+  /// Assets sorted by path (byte-wise).
+  ///
+  const EmbeddedAsset* assets;
+
+  size_t count;
+};
+
+///
+/// Byte-wise path comparison used to sort EmbeddedAssetTable::assets.
+///
+constexpr int CompareEmbeddedAssetPaths(const char* a, const char* b) {
+  while (*a && *a == *b) {
+    a++;
+    b++;
+  }
+  return (unsigned char)*a - (unsigned char)*b;
+}
+
+///
+/// Whether 'assets' are sorted by path, checked at compile time by generated tables.
+///
+constexpr bool IsSortedByPath(const EmbeddedAsset* assets, size_t count) {
+  for (size_t i = 1; i < count; i++) {
+    if (CompareEmbeddedAssetPaths(assets[i - 1].path, assets[i].path) >= 0)
+      return false;
+  }
+  return true;
+}
+
+///
+/// Serve the assets in 'table' straight from the binary, layered over the App's file system
+/// (Settings::file_system_path and Settings::file_system_archive).
+///
+/// Paths in the table are matched against file:/// URLs the same way as files under
+/// Settings::file_system_path. Returned Buffers point directly into the binary's read-only
+/// data, so loading them needs no I/O.
+///
+/// @note  Call this before App::Create(). Tables mounted later take precedence over earlier
+///        ones. The table must stay valid for the lifetime of the App (generated tables do).
+///
+AExport void MountEmbeddedAssets(const EmbeddedAssetTable* table);
+
+}  // namespace ultralight
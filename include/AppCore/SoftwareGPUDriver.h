@@ -0,0 +1,79 @@
+/**************************************************************************************************
+ *  This file is a part of Ultralight, an ultra-portable web-browser engine.                      *
+ *                                                                                                *
+ *  See <https://ultralig.ht> for licensing and more.                                             *
+ *                                                                                                *
+ *  (C) 2024 Ultralight, Inc.                                                                     *
+ **************************************************************************************************/
+#pragma once
+#include "Defines.h"
+#include <Ultralight/RefPtr.h>
+#include <Ultralight/Bitmap.h>
+#include <Ultralight/platform/GPUDriver.h>
+
+namespace ultralight {
+
+///
+/// GPU driver that executes Ultralight's GPU command lists on the CPU.
+///
+/// This lets the GPU renderer run on machines without a GPU (CI, render servers) and gives
+/// deterministic output for comparing against reference images: results don't depend on the
+/// number of worker threads.
+///
+/// ## Usage
+///
+/// ```
+///   auto driver = SoftwareGPUDriver::Create();
+///   Platform::instance().set_gpu_driver(driver->driver());
+///
+///   // Create the Renderer and a View with ViewConfig::is_accelerated = true, then each frame:
+///   renderer->Update();
+///   renderer->Render();
+///   driver->DrawCommandList();
+///
+///   RenderTarget target = view->render_target();
+///   RefPtr<Bitmap> pixels = driver->texture_bitmap(target.texture_id);
+/// ```
+///
+/// @note  Path geometry is drawn without anti-aliasing (the GL driver uses 4x MSAA).
+///
+class AExport SoftwareGPUDriver : public RefCounted {
+public:
+  ///
+  /// Create a software GPU driver.
+  ///
+  /// @param  worker_count  Number of threads that rasterize alongside the thread calling
+  ///                       DrawCommandList(), 0 to rasterize on that thread only. Negative
+  ///                       uses one worker per additional hardware thread.
+  ///
+  static RefPtr<SoftwareGPUDriver> Create(int32_t worker_count = -1);
+
+  ///
+  /// The driver to pass to Platform::set_gpu_driver(). Owned by this object, keep this object
+  /// alive for as long as the Renderer exists.
+  ///
+  virtual GPUDriver* driver() = 0;
+
+  ///
+  /// Execute the command list submitted by the last Renderer::Render() call.
+  ///
+  virtual void DrawCommandList() = 0;
+
+  ///
+  /// Set the bitmap that draws to render buffer 0 land in (must be BGRA8_UNORM_SRGB). Draws to
+  /// render buffer 0 are dropped if there isn't one.
+  ///
+  virtual void set_default_render_target(RefPtr<Bitmap> bitmap) = 0;
+
+  ///
+  /// Get the pixels of a texture (eg, RenderTarget::texture_id), null if the ID is unknown.
+  ///
+  /// @note  Only read the pixels between calls to DrawCommandList().
+  ///
+  virtual RefPtr<Bitmap> texture_bitmap(uint32_t texture_id) const = 0;
+
+protected:
+  virtual ~SoftwareGPUDriver();
+};
+
+}  // namespace ultralight
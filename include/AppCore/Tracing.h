@@ -0,0 +1,50 @@
+/**************************************************************************************************
+ *  This file is a part of Ultralight, an ultra-portable web-browser engine.                      *
+ *                                                                                                *
+ *  See <https://ultralig.ht> for licensing and more.                                             *
+ *                                                                                                *
+ *  (C) 2024 Ultralight, Inc.                                                                     *
+ **************************************************************************************************/
+#pragma once
+#include "Defines.h"
+
+namespace ultralight {
+
+///
+/// Start or stop recording trace events.
+///
+/// While enabled, AppCore records timed zones (app update, repaint, overlay rendering, command
+/// list execution, file loads, font matching, etc.) into per-thread ring buffers. Each thread
+/// keeps its most recent ~16K zones. Recording is off by default and costs a single relaxed
+/// load per zone while off.
+///
+AExport void EnableTracing(bool enabled);
+
+///
+/// Whether or not trace events are being recorded.
+///
+AExport bool IsTracingEnabled();
+
+///
+/// Write all recorded trace events to a file in the Chrome trace-event JSON format.
+///
+/// The file can be opened in Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+///
+/// @return  Whether or not the file was written.
+///
+/// @note  Recording continues, events written are not cleared.
+///
+AExport bool WriteTraceFile(const char* path);
+
+///
+/// Write the trace file when the process receives a signal (eg, SIGUSR2), so traces can be
+/// collected from a running app with `kill -USR2 <pid>`.
+///
+/// The file is written from the App's run loop shortly after the signal arrives, not from the
+/// signal handler itself. Pass a null path to remove the handler.
+///
+/// @note  Only supported on Linux and macOS, does nothing on Windows.
+///
+AExport void SetTraceSignal(int signal, const char* path);
+
+}  // namespace ultralight
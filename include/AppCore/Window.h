@@ -81,6 +81,63 @@ enum WindowFlags : uint8_t {
   kWindowFlags_Hidden      = 1 << 4,
 };
 
+///
+/// Frame-time distribution for one phase of a frame (in milliseconds).
+/// @see FrameTimingSnapshot
+///
+struct AExport FrameTimingPercentiles {
+  double mean_ms = 0.0;
+  double p50_ms = 0.0;
+  double p95_ms = 0.0;
+  double p99_ms = 0.0;
+  double max_ms = 0.0;
+};
+
+///
+/// Point-in-time summary of a window's frame timings. @see Window::frame_timing_snapshot
+///
+/// Percentiles cover every frame since the window was created or since the last call to
+/// Window::ResetFrameTiming(), and have ~3% relative precision.
+///
+struct AExport FrameTimingSnapshot {
+  ///
+  /// Frames covered by the percentiles below.
+  ///
+  uint64_t frame_count = 0;
+
+  ///
+  /// Frames presented since the window was created.
+  ///
+  uint64_t total_frames = 0;
+
+  ///
+  /// Average frames per second over the frames covered by the percentiles.
+  ///
+  double fps = 0.0;
+
+  FrameTimingPercentiles update;  ///< App updates between frames.
+  FrameTimingPercentiles render;  ///< Rendering overlays and building command lists.
+  FrameTimingPercentiles draw;    ///< Executing command lists and painting overlays.
+  FrameTimingPercentiles swap;    ///< Swapping buffers.
+  FrameTimingPercentiles idle;    ///< Waiting between frames.
+  FrameTimingPercentiles total;   ///< Whole frame, from the start of render to the end of swap.
+};
+
+///
+/// Output format for Window::WriteFrameTimingReport.
+///
+enum class FrameTimingFormat : uint8_t {
+  ///
+  /// One row per recent frame (up to 1024), times in milliseconds.
+  ///
+  CSV,
+
+  ///
+  /// The FrameTimingSnapshot followed by the same per-frame records as CSV.
+  ///
+  JSON,
+};
+
 ///
 /// A platform-specific window.
 ///
@@ -306,6 +363,33 @@ public:
     /// 
     virtual void EnableFrameStatistics() {}
 
+    ///
+    /// Get a summary of this window's frame timings.
+    ///
+    /// Timings are always recorded, whether or not frame statistics are shown in the titlebar.
+    ///
+    /// @note  Frame timings are only recorded on Linux for now, on other platforms this returns
+    ///        all zeros.
+    ///
+    virtual FrameTimingSnapshot frame_timing_snapshot() const { return FrameTimingSnapshot(); }
+
+    ///
+    /// Restart the frame-time percentiles (eg, after a warm-up period).
+    ///
+    virtual void ResetFrameTiming() {}
+
+    ///
+    /// Write this window's frame timings to a file.
+    ///
+    /// @note  Frame timings are only recorded on Linux for now, on other platforms this writes
+    ///        nothing and returns false.
+    ///
+    /// @return  Whether or not the file was written.
+    ///
+    virtual bool WriteFrameTimingReport(const char* path, FrameTimingFormat format) const {
+      return false;
+    }
+
 protected:
   virtual ~Window();
   virtual bool platform_always_uses_cpu_renderer() const = 0;
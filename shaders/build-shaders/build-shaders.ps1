@@ -68,7 +68,8 @@ function Initialize-OutputDirectories {
         "$OutputDir/headers",
         "$OutputDir/headers/d3d11",  # D3D11 binary headers (Windows)
         "$OutputDir/headers/d3d12",  # D3D12 binary headers (Windows)
-        "$OutputDir/headers/glsl"    # GLSL text headers (Linux)
+        "$OutputDir/headers/glsl",   # GLSL text headers (Linux)
+        "$OutputDir/headers/spirv"   # SPIR-V binary headers (Vulkan)
     )
     
     foreach ($dir in $dirs) {
@@ -172,6 +173,43 @@ function Compile-SPIRV {
     }
 }
 
+# Compile HLSL to SPIR-V for the Vulkan driver. Each register class gets its
+# own binding range so a single descriptor set can hold them all:
+# b0 -> binding 0, t0/t1 -> bindings 1/2, s0 -> binding 3
+# (see GPUContextVulkan::CreatePipelineObjects).
+function Compile-SPIRV-Vulkan {
+    param(
+        [string]$InputFile,
+        [string]$OutputFile,
+        [string]$Profile,
+        [string]$EntryPoint = "main"
+    )
+    
+    $args = @(
+        "-T", $Profile,
+        "-E", $EntryPoint,
+        "-spirv",
+        "-fspv-target-env=vulkan1.0",
+        "-fvk-b-shift", "0", "0",
+        "-fvk-t-shift", "1", "0",
+        "-fvk-s-shift", "3", "0",
+        "-I", "../hlsl",
+        "-Fo", $OutputFile,
+        $InputFile
+    )
+    
+    if ($Debug) {
+        $args += "-Od"
+    } else {
+        $args += "-O3"
+    }
+    
+    & $DXC $args
+    if ($LASTEXITCODE -ne 0) {
+        throw "DXC SPIR-V (Vulkan) compilation failed for $InputFile"
+    }
+}
+
 # Cross-compile SPIR-V to GLSL
 function Compile-GLSL {
     param(
@@ -307,6 +345,16 @@ function Compile-Shader {
     Compile-SPIRV -InputFile $Shader.File -OutputFile $spirvOutput -Profile $dxcProfile
     Write-Host " Done" -ForegroundColor Green
     
+    # SPIR-V for the Vulkan driver, a separate compile because the GLSL
+    # cross-compile below expects the unshifted bindings
+    Write-Host "    - SPIR-V (Vulkan)..." -NoNewline
+    $vulkanOutput = "$OutputDir/temp/$($Shader.Name)_vulkan.spv"
+    Compile-SPIRV-Vulkan -InputFile $Shader.File -OutputFile $vulkanOutput -Profile $dxcProfile
+    Generate-BinaryHeader -InputFile $vulkanOutput `
+                         -OutputFile "$OutputDir/headers/spirv/$($Shader.Name)$Suffix.h" `
+                         -VariableName "$($Shader.Name)$Suffix"
+    Write-Host " Done" -ForegroundColor Green
+    
     # GLSL cross-compilation
     Write-Host "    - GLSL..." -NoNewline
     $glslOutput = "$OutputDir/temp/$($Shader.Name).glsl"
@@ -402,6 +450,25 @@ function Generate-MasterHeaders {
         $glslContent += "`n#include `"$($shader.Name)_fs.h`""
     }
     [System.IO.File]::WriteAllText("$OutputDir/headers/glsl/shaders.h", $glslContent)
+
+    # SPIR-V Master Header
+    Write-Host "Generating SPIR-V master header..." -ForegroundColor Yellow
+    $spirvContent = @"
+// Generated SPIR-V shader header - Vulkan 1.0
+// Include this file to access all SPIR-V compiled shaders
+
+#pragma once
+
+// Vertex Shaders
+"@
+    foreach ($shader in $VertexShaders) {
+        $spirvContent += "`n#include `"$($shader.Name)_vs.h`""
+    }
+    $spirvContent += "`n`n// Pixel Shaders"
+    foreach ($shader in $PixelShaders) {
+        $spirvContent += "`n#include `"$($shader.Name)_ps.h`""
+    }
+    [System.IO.File]::WriteAllText("$OutputDir/headers/spirv/shaders.h", $spirvContent)
     
     Write-Host "Master headers generated successfully" -ForegroundColor Green
 }
@@ -417,6 +484,9 @@ function Generate-HeaderInfo {
 
     Write-Host "`nGLSL Headers (Linux):" -ForegroundColor Yellow  
     Get-ChildItem "$OutputDir/headers/glsl/*.h" | ForEach-Object { Write-Host "  $($_.Name)" }
+
+    Write-Host "`nSPIR-V Headers (Vulkan):" -ForegroundColor Yellow
+    Get-ChildItem "$OutputDir/headers/spirv/*.h" | ForEach-Object { Write-Host "  $($_.Name)" }
     
     Write-Host "`nMetal Source Files (macOS):" -ForegroundColor Yellow
     Get-ChildItem "$OutputDir/metal/*.metal" | ForEach-Object { Write-Host "  $($_.Name)" }
@@ -446,10 +516,12 @@ try {
     Write-Host "  headers/d3d11/  - D3D11 binary headers + shaders.h master header" -ForegroundColor Gray
     Write-Host "  headers/d3d12/  - D3D12 binary headers + shaders.h master header" -ForegroundColor Gray
     Write-Host "  headers/glsl/   - GLSL text headers + shaders.h master header" -ForegroundColor Gray
+    Write-Host "  headers/spirv/  - SPIR-V binary headers + shaders.h master header" -ForegroundColor Gray
     Write-Host "  metal/          - Metal source files" -ForegroundColor Gray
     Write-Host "`nGPU drivers can include platform-specific master headers:" -ForegroundColor Cyan
     Write-Host "  Windows: #include `"d3d11/shaders.h`" or #include `"d3d12/shaders.h`"" -ForegroundColor Gray
     Write-Host "  Linux:   #include `"glsl/shaders.h`"" -ForegroundColor Gray
+    Write-Host "  Vulkan:  #include `"spirv/shaders.h`"" -ForegroundColor Gray
     Write-Host "  macOS:   #include `"shaders.h`" (generated at build time)" -ForegroundColor Gray
 }
 catch {
@@ -1,8 +1,14 @@
 #include "AppImpl.h"
+#include "GPUDriverImpl.h"
+#include "TraceRecorder.h"
 #include <Ultralight/Renderer.h>
 #include <Ultralight/platform/Platform.h>
 #include <Ultralight/platform/Config.h>
 #include <Ultralight/private/tracy/Tracy.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
 
 namespace ultralight {
 
@@ -14,11 +20,78 @@ double AppImpl::thread_utilization() const {
   return cpu_monitor_.GetThreadUtilization();
 }
 
+double AppImpl::process_utilization() const {
+  return process_cpu_monitor_.GetProcessUtilization();
+}
+
+uint32_t AppImpl::GetThreadCPUUsage(ThreadCPUUsage* usage, uint32_t max_count) const {
+  const auto& threads = process_cpu_monitor_.thread_usage();
+  uint32_t count = std::min<uint32_t>(max_count, (uint32_t)threads.size());
+  for (uint32_t i = 0; i < count; i++) {
+    usage[i].thread_id = threads[i].thread_id;
+    memcpy(usage[i].name, threads[i].name, sizeof(usage[i].name));
+    usage[i].utilization = threads[i].utilization;
+  }
+  return (uint32_t)threads.size();
+}
+
+GPUMemoryStats AppImpl::gpu_memory_stats() const {
+  GPUDriverImpl* driver = gpu_driver_impl();
+  return driver ? driver->memory_stats() : GPUMemoryStats();
+}
+
+GPUDriverStats AppImpl::gpu_driver_stats() const {
+  GPUDriverImpl* driver = gpu_driver_impl();
+  return driver ? driver->driver_stats() : GPUDriverStats();
+}
+
+FileSystem* AppImpl::LayerFileSystems(FileSystem* file_system, const String& archive_path,
+                                      FileSystemPrefetch::AsyncOpenFunction async_open) {
+  size_t table_count;
+  const EmbeddedAssetTable* const* tables = FileSystemEmbedded::mounted_tables(&table_count);
+  if (!settings_.file_system_archive.empty() || table_count) {
+    layered_file_system_.reset(new FileSystemPak());
+    layered_file_system_->MountFileSystem(file_system);
+
+    // On failure (already logged) carry on with the loose files.
+    bool has_archive = !settings_.file_system_archive.empty() && layered_file_system_->MountArchive(archive_path);
+    if (has_archive || table_count) {
+      for (size_t i = 0; i < table_count; i++) {
+        embedded_file_systems_.emplace_back(new FileSystemEmbedded(tables[i]));
+        layered_file_system_->MountFileSystem(embedded_file_systems_.back().get());
+      }
+      file_system = layered_file_system_.get();
+    } else {
+      layered_file_system_.reset();
+    }
+  }
+
+  String cache_path = Platform::instance().config().cache_path;
+  if (settings_.file_system_prefetch_time > 0.0 && !cache_path.empty()) {
+    prefetch_file_system_.reset(new FileSystemPrefetch(file_system, cache_path + "/prefetch_manifest.txt",
+                                                       settings_.file_system_prefetch_time));
+    if (!layered_file_system_) {
+      prefetch_file_system_->set_async_open(std::move(async_open));
+    } else {
+      // Compressed archive entries are decompressed on the archive's worker
+      // too, in parallel with the prefetch worker's reads.
+      FileSystemPak* pak = layered_file_system_.get();
+      prefetch_file_system_->set_prefetch_hint([pak](const String& path) { pak->Prefetch(path); });
+    }
+    prefetch_file_system_->Start();
+    file_system = prefetch_file_system_.get();
+  }
+
+  return file_system;
+}
+
 void AppImpl::NotifyUserInteraction() {
   last_user_input_time_ = std::chrono::steady_clock::now();
 }
 
 void AppImpl::UpdateBegin() {
+  TraceRecorder::ProcessPendingSignal();
+
   if (listener_)
     listener_->OnUpdate();
 
@@ -32,6 +105,147 @@ void AppImpl::UpdateBegin() {
 #ifdef TRACY_PROFILE_PERFORMANCE
   FrameMarkEnd(frame_mark_update);
 #endif
+
+  UpdateGPUMemoryBudget();
+
+  if (prefetch_file_system_)
+    prefetch_file_system_->Update();
+}
+
+static void LogGPUMemoryConsumers(GPUDriverImpl* driver, uint64_t budget) {
+  Logger* logger = Platform::instance().logger();
+  if (!logger)
+    return;
+
+  GPUMemoryStats stats = driver->memory_stats();
+  std::ostringstream msg;
+  msg << "GPU memory budget exceeded: " << stats.total_bytes() << " of " << budget << " bytes ("
+      << "textures: " << stats.texture_bytes << ", render targets: " << stats.render_target_bytes
+      << ", msaa: " << stats.msaa_bytes << ", geometry: " << stats.geometry_bytes
+      << " (" << stats.geometry_used_bytes << " used, " << (int)(stats.geometry_fragmentation * 100.0)
+      << "% fragmented)"
+      << ", pixel buffers: " << stats.pixel_buffer_bytes << "). Largest resources:";
+  for (auto& usage : driver->TopMemoryConsumers(10))
+    msg << "\n  " << usage.kind << " " << usage.id << ": " << usage.bytes << " bytes";
+
+  logger->LogMessage(LogLevel::Warning, msg.str().c_str());
+}
+
+void AppImpl::UpdateGPUMemoryBudget() {
+  if (!settings_.gpu_memory_budget)
+    return;
+
+  GPUDriverImpl* driver = gpu_driver_impl();
+  if (!driver)
+    return;
+
+  if (driver->memory_stats().total_bytes() <= settings_.gpu_memory_budget) {
+    budget_state_ = BudgetState::UnderBudget;
+    return;
+  }
+
+  // Already purged since usage crossed the budget, purging again every
+  // cooldown would only evict what the renderer is still using. Wait until
+  // usage drops back under the budget.
+  if (budget_state_ == BudgetState::Purged)
+    return;
+
+  // Give the renderer time to release resources before escalating.
+  constexpr auto kBudgetCooldown = std::chrono::seconds(1);
+  auto now = std::chrono::steady_clock::now();
+  if (budget_state_ != BudgetState::UnderBudget && (now - last_budget_action_) < kBudgetCooldown)
+    return;
+
+  last_budget_action_ = now;
+
+  switch (budget_state_) {
+  case BudgetState::UnderBudget:
+    LogGPUMemoryConsumers(driver, settings_.gpu_memory_budget);
+    driver->PurgeCaches();
+    renderer()->Recycle();
+    budget_state_ = BudgetState::Recycled;
+    break;
+  case BudgetState::Recycled:
+    renderer()->PurgeMemory();
+    budget_state_ = BudgetState::Purged;
+    break;
+  case BudgetState::Purged:
+    break;
+  }
+}
+
+void AppImpl::HandleMemoryPressure(MemoryPressureLevel level) {
+  // Pressure sources fire repeatedly while memory stays tight, only respond
+  // again once the previous response had time to take effect.
+  constexpr auto kPressureCooldown = std::chrono::seconds(1);
+  constexpr auto kPressurePersistence = std::chrono::seconds(5);
+  auto now = std::chrono::steady_clock::now();
+
+  if (handled_memory_pressure_) {
+    auto since_last = now - last_memory_pressure_action_;
+    if (since_last < kPressureCooldown && level <= last_memory_pressure_level_)
+      return;
+
+    // Still under pressure after trimming caches, escalate.
+    if (since_last < kPressurePersistence)
+      level = MemoryPressureLevel::Critical;
+  }
+
+  // Purging throws away what the renderer needs for the next frame, so it
+  // would only thrash if repeated every time pressure persists. Back off
+  // further while purges don't free anything, and trim caches meanwhile.
+  constexpr auto kMinCriticalPurgeInterval = std::chrono::seconds(10);
+  constexpr auto kMaxCriticalPurgeInterval = std::chrono::minutes(5);
+  if (level == MemoryPressureLevel::Critical && purged_under_pressure_) {
+    if (now - last_critical_purge_ < critical_purge_interval_) {
+      level = MemoryPressureLevel::Moderate;
+    } else if (MemoryFootprint() >= footprint_before_purge_) {
+      critical_purge_interval_ = std::min<std::chrono::steady_clock::duration>(
+        critical_purge_interval_ * 2, kMaxCriticalPurgeInterval);
+      last_critical_purge_ = now;
+      // Retry once the longer interval is up, whatever the footprint then.
+      footprint_before_purge_ = UINT64_MAX;
+      level = MemoryPressureLevel::Moderate;
+    } else if (footprint_before_purge_ != UINT64_MAX) {
+      critical_purge_interval_ = kMinCriticalPurgeInterval;
+    }
+  }
+
+  if (level == MemoryPressureLevel::Critical) {
+    if (!purged_under_pressure_)
+      critical_purge_interval_ = kMinCriticalPurgeInterval;
+    purged_under_pressure_ = true;
+    last_critical_purge_ = now;
+    footprint_before_purge_ = MemoryFootprint();
+  }
+
+  handled_memory_pressure_ = true;
+  last_memory_pressure_level_ = level;
+  last_memory_pressure_action_ = now;
+
+  if (Logger* logger = Platform::instance().logger()) {
+    logger->LogMessage(LogLevel::Warning, level == MemoryPressureLevel::Critical ?
+      "Critical memory pressure, purging renderer memory." :
+      "Memory pressure, recycling renderer memory.");
+  }
+
+  if (GPUDriverImpl* driver = gpu_driver_impl())
+    driver->PurgeCaches();
+
+  PurgeFileSystemCaches();
+
+  renderer()->Recycle();
+  if (level == MemoryPressureLevel::Critical)
+    renderer()->PurgeMemory();
+
+  if (listener_)
+    listener_->OnMemoryPressure(level);
+}
+
+uint64_t AppImpl::MemoryFootprint() const {
+  GPUDriverImpl* driver = gpu_driver_impl();
+  uint64_t bytes = driver ? driver->memory_stats().total_bytes() : 0;
+  return bytes + file_system_cache_stats().bytes;
 }
 
 void AppImpl::UpdateIdleDetection() {
@@ -39,13 +253,20 @@ void AppImpl::UpdateIdleDetection() {
 
   // Staleness guard: if gap between Update() calls exceeds 100ms, the app was
   // likely frozen or had a severe stall. Reset idle state since stale utilization
-  // data from ThreadCPUMonitor is not trustworthy.
+  // data from the CPU monitors is not trustworthy.
   constexpr auto kStalenessThreshold = std::chrono::milliseconds(100);
   bool stale = (now - last_update_time_) > kStalenessThreshold;
   last_update_time_ = now;
 
   cpu_monitor_.Sample();
-  double utilization = cpu_monitor_.GetThreadUtilization();
+  process_cpu_monitor_.set_sample_interval(settings_.cpu_sample_interval);
+  process_cpu_monitor_.Sample();
+
+  // Background threads (renderer, JavaScript, workers) count too, so an app
+  // isn't declared idle while one of them keeps a core busy.
+  double utilization = settings_.idle_uses_process_utilization
+                     ? process_cpu_monitor_.GetProcessUtilization()
+                     : cpu_monitor_.GetThreadUtilization();
   double secs_since_input =
       std::chrono::duration<double>(now - last_user_input_time_).count();
 
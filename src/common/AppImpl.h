@@ -1,12 +1,19 @@
 #pragma once
 #include <AppCore/App.h>
 #include "ThreadCPUMonitor.h"
+#include "ProcessCPUMonitor.h"
 #include "FileLogger.h"
+#include "FileSystemPak.h"
+#include "FileSystemEmbedded.h"
+#include "FileSystemPrefetch.h"
 #include <chrono>
 #include <memory>
+#include <vector>
 
 namespace ultralight {
 
+class GPUDriverImpl;
+
 ///
 /// Internal base class for platform App implementations.
 ///
@@ -36,6 +43,18 @@ public:
 
   double thread_utilization() const override;
 
+  double process_utilization() const override;
+
+  uint32_t GetThreadCPUUsage(ThreadCPUUsage* usage, uint32_t max_count) const override;
+
+  GPUMemoryStats gpu_memory_stats() const override;
+
+  GPUDriverStats gpu_driver_stats() const override;
+
+  FileSystemIndexStats file_system_index_stats() const override { return FileSystemIndexStats(); }
+
+  FileSystemCacheStats file_system_cache_stats() const override { return FileSystemCacheStats(); }
+
   // --- Input tracking (called by Window Fire*Event methods) ---
 
   void NotifyUserInteraction();
@@ -45,11 +64,46 @@ protected:
   virtual ~AppImpl() = default;
 
   /// Call at the beginning of each platform's Update() method.
-  /// Dispatches listener_->OnUpdate() and renderer()->Update().
+  /// Dispatches listener_->OnUpdate() and renderer()->Update(), then enforces
+  /// Settings::gpu_memory_budget.
   void UpdateBegin();
 
+  /// The platform GPU driver, if it is an AppCore driver (used for stats).
+  virtual GPUDriverImpl* gpu_driver_impl() const { return nullptr; }
+
+  /// Recycles, then purges, renderer memory when the GPU driver reports usage
+  /// above Settings::gpu_memory_budget. Each escalation happens once per
+  /// crossing: nothing more is done until usage drops back under the budget.
+  void UpdateGPUMemoryBudget();
+
+  /// Releases memory in response to OS memory pressure, then fires
+  /// listener_->OnMemoryPressure(). Moderate pressure recycles the renderer,
+  /// trims GPU driver pools and empties file caches; critical (or persistent)
+  /// pressure also purges renderer memory. Purges are spaced at least
+  /// critical_purge_interval_ apart, and the interval doubles each time the
+  /// previous purge didn't shrink MemoryFootprint().
+  void HandleMemoryPressure(MemoryPressureLevel level);
+
+  /// Empties platform file caches (Settings::file_system_cache_size).
+  virtual void PurgeFileSystemCaches() {}
+
+  /// Bytes used by the process, to judge whether purging helped. Defaults to
+  /// GPU driver and file cache bytes, platforms that can read the resident
+  /// set size return that instead.
+  virtual uint64_t MemoryFootprint() const;
+
+  /// Layers Settings::file_system_archive (resolved to 'archive_path'), then
+  /// any tables passed to MountEmbeddedAssets(), over 'file_system', and wraps
+  /// the result for Settings::file_system_prefetch_time. Returns the file
+  /// system to give the Platform.
+  ///
+  /// 'async_open' (optional) reads from 'file_system' without blocking, the
+  /// prefetcher uses it when nothing is layered over 'file_system'.
+  FileSystem* LayerFileSystems(FileSystem* file_system, const String& archive_path,
+                               FileSystemPrefetch::AsyncOpenFunction async_open = nullptr);
+
   /// Call at the end of each platform's Update() method.
-  /// Samples CPU utilization, runs the idle state machine, and fires
+  /// Samples main-thread and process CPU utilization, runs the idle state machine, and fires
   /// renderer()->Recycle() + listener_->OnIdle() when appropriate.
   void UpdateIdleDetection();
 
@@ -58,6 +112,9 @@ protected:
   Settings settings_;
   bool is_running_ = false;
   AppListener* listener_ = nullptr;
+  std::vector<std::unique_ptr<FileSystemEmbedded>> embedded_file_systems_; // Outlive renderer_
+  std::unique_ptr<FileSystemPak> layered_file_system_;
+  std::unique_ptr<FileSystemPrefetch> prefetch_file_system_;
   RefPtr<Renderer> renderer_;
   std::unique_ptr<FileLogger> logger_;
   std::chrono::steady_clock::time_point last_statistics_update_;
@@ -65,6 +122,7 @@ protected:
   // --- Idle detection state ---
 
   ThreadCPUMonitor cpu_monitor_{1.0};
+  ProcessCPUMonitor process_cpu_monitor_{0.1, 1.0};
 
   enum class IdleState { Active, Pending, Cooldown };
   IdleState idle_state_ = IdleState::Active;
@@ -73,6 +131,22 @@ protected:
   std::chrono::steady_clock::time_point last_idle_fire_;
   std::chrono::steady_clock::time_point last_update_time_{std::chrono::steady_clock::now()};
   std::chrono::steady_clock::time_point last_user_input_time_{std::chrono::steady_clock::now()};
+
+  // --- GPU memory budget state ---
+
+  enum class BudgetState { UnderBudget, Recycled, Purged };
+  BudgetState budget_state_ = BudgetState::UnderBudget;
+  std::chrono::steady_clock::time_point last_budget_action_;
+
+  // --- Memory pressure state ---
+
+  bool handled_memory_pressure_ = false;
+  MemoryPressureLevel last_memory_pressure_level_ = MemoryPressureLevel::Moderate;
+  std::chrono::steady_clock::time_point last_memory_pressure_action_;
+  bool purged_under_pressure_ = false;
+  std::chrono::steady_clock::time_point last_critical_purge_;
+  std::chrono::steady_clock::duration critical_purge_interval_{};
+  uint64_t footprint_before_purge_ = 0;
 };
 
 } // namespace ultralight
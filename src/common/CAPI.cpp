@@ -3,6 +3,9 @@
 #include <AppCore/Platform.h>
 #include <Ultralight/platform/Platform.h>
 #include <Ultralight/platform/Config.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 using namespace ultralight;
 
@@ -33,6 +36,8 @@ struct C_App : public AppListener {
   void* update_callback_data = nullptr;
   ULIdleCallback idle_callback = nullptr;
   void* idle_callback_data = nullptr;
+  ULMemoryPressureCallback memory_pressure_callback = nullptr;
+  void* memory_pressure_callback_data = nullptr;
 
   C_App(RefPtr<App> app) : val(app) {
     val->set_listener(this);
@@ -53,6 +58,13 @@ struct C_App : public AppListener {
     if (idle_callback)
       idle_callback(idle_callback_data, utilization);
   }
+
+  virtual void OnMemoryPressure(MemoryPressureLevel level) override {
+    if (memory_pressure_callback)
+      memory_pressure_callback(memory_pressure_callback_data,
+        level == MemoryPressureLevel::Critical ? kMemoryPressureLevel_Critical
+                                               : kMemoryPressureLevel_Moderate);
+  }
 };
 
 struct C_Window : public WindowListener {
@@ -114,6 +126,10 @@ void ulSettingsSetFileSystemPath(ULSettings settings, ULString path) {
   settings->val.file_system_path = ToString(path).utf16();
 }
 
+void ulSettingsSetFileSystemArchive(ULSettings settings, ULString path) {
+  settings->val.file_system_archive = ToString(path).utf16();
+}
+
 void ulSettingsSetLoadShadersFromFileSystem(ULSettings settings, bool enabled) {
   settings->val.load_shaders_from_file_system = enabled;
 }
@@ -134,6 +150,38 @@ void ulSettingsSetIdleUtilizationThreshold(ULSettings settings, double threshold
   settings->val.idle_utilization_threshold = threshold;
 }
 
+void ulSettingsSetIdleUsesProcessUtilization(ULSettings settings, bool enabled) {
+  settings->val.idle_uses_process_utilization = enabled;
+}
+
+void ulSettingsSetCPUSampleInterval(ULSettings settings, double seconds) {
+  settings->val.cpu_sample_interval = seconds;
+}
+
+void ulSettingsSetEnableMemoryPressureMonitor(ULSettings settings, bool enabled) {
+  settings->val.enable_memory_pressure_monitor = enabled;
+}
+
+void ulSettingsSetMemoryPressureRSSLimit(ULSettings settings, unsigned long long bytes) {
+  settings->val.memory_pressure_rss_limit = bytes;
+}
+
+void ulSettingsSetEnableFileSystemIndex(ULSettings settings, bool enabled) {
+  settings->val.enable_file_system_index = enabled;
+}
+
+void ulSettingsSetFileSystemPrefetchTime(ULSettings settings, double seconds) {
+  settings->val.file_system_prefetch_time = seconds;
+}
+
+void ulSettingsSetFileSystemCacheSize(ULSettings settings, unsigned long long bytes) {
+  settings->val.file_system_cache_size = bytes;
+}
+
+void ulSettingsSetGPUMemoryBudget(ULSettings settings, unsigned long long bytes) {
+  settings->val.gpu_memory_budget = bytes;
+}
+
 ULApp ulCreateApp(ULSettings settings, ULConfig config) {
   return new C_App{ App::Create(settings ? settings->val : Settings(),
                                 config ? config->val : Config()) };
@@ -173,6 +221,12 @@ void ulAppSetIdleCallback(ULApp app, ULIdleCallback callback, void* user_data) {
   app->idle_callback_data = user_data;
 }
 
+void ulAppSetMemoryPressureCallback(ULApp app, ULMemoryPressureCallback callback,
+                                    void* user_data) {
+  app->memory_pressure_callback = callback;
+  app->memory_pressure_callback_data = user_data;
+}
+
 bool ulAppIsIdle(ULApp app) {
   return app->val->is_idle();
 }
@@ -181,6 +235,76 @@ double ulAppGetThreadUtilization(ULApp app) {
   return app->val->thread_utilization();
 }
 
+double ulAppGetProcessUtilization(ULApp app) {
+  return app->val->process_utilization();
+}
+
+unsigned int ulAppGetThreadCPUUsage(ULApp app, ULThreadCPUUsage* usage, unsigned int max_count) {
+  std::vector<ThreadCPUUsage> threads(max_count);
+  uint32_t count = app->val->GetThreadCPUUsage(threads.data(), max_count);
+  for (uint32_t i = 0; i < std::min(count, max_count); i++) {
+    usage[i].thread_id = threads[i].thread_id;
+    memcpy(usage[i].name, threads[i].name, sizeof(usage[i].name));
+    usage[i].utilization = threads[i].utilization;
+  }
+  return count;
+}
+
+ULGPUMemoryStats ulAppGetGPUMemoryStats(ULApp app) {
+  GPUMemoryStats stats = app->val->gpu_memory_stats();
+  ULGPUMemoryStats result;
+  result.texture_bytes = stats.texture_bytes;
+  result.render_target_bytes = stats.render_target_bytes;
+  result.msaa_bytes = stats.msaa_bytes;
+  result.geometry_bytes = stats.geometry_bytes;
+  result.pixel_buffer_bytes = stats.pixel_buffer_bytes;
+  result.total_bytes = stats.total_bytes();
+  result.texture_count = stats.texture_count;
+  result.render_buffer_count = stats.render_buffer_count;
+  result.geometry_count = stats.geometry_count;
+  result.geometry_used_bytes = stats.geometry_used_bytes;
+  result.geometry_largest_free_bytes = stats.geometry_largest_free_bytes;
+  result.geometry_fragmentation = stats.geometry_fragmentation;
+  return result;
+}
+
+ULGPUDriverStats ulAppGetGPUDriverStats(ULApp app) {
+  GPUDriverStats stats = app->val->gpu_driver_stats();
+  ULGPUDriverStats result;
+  result.render_target_pool_hits = stats.render_target_pool_hits;
+  result.render_target_pool_misses = stats.render_target_pool_misses;
+  result.render_target_pool_evictions = stats.render_target_pool_evictions;
+  result.render_target_pool_hit_rate = stats.render_target_pool_hit_rate();
+  result.pending_deletion_objects = stats.pending_deletion_objects;
+  result.pending_deletion_frames = stats.pending_deletion_frames;
+  result.uniform_full_bytes = stats.uniform_full_bytes;
+  result.uniform_uploaded_bytes = stats.uniform_uploaded_bytes;
+  result.uniform_skipped_uploads = stats.uniform_skipped_uploads;
+  return result;
+}
+
+ULFileSystemIndexStats ulAppGetFileSystemIndexStats(ULApp app) {
+  FileSystemIndexStats stats = app->val->file_system_index_stats();
+  ULFileSystemIndexStats result;
+  result.hits = stats.hits;
+  result.misses = stats.misses;
+  result.fallbacks = stats.fallbacks;
+  result.rebuilds = stats.rebuilds;
+  result.entries = stats.entries;
+  return result;
+}
+
+ULFileSystemCacheStats ulAppGetFileSystemCacheStats(ULApp app) {
+  FileSystemCacheStats stats = app->val->file_system_cache_stats();
+  ULFileSystemCacheStats result;
+  result.hits = stats.hits;
+  result.misses = stats.misses;
+  result.evictions = stats.evictions;
+  result.bytes = stats.bytes;
+  result.entries = stats.entries;
+  return result;
+}
+
 double ulMonitorGetScale(ULMonitor monitor) {
   return reinterpret_cast<Monitor*>(monitor)->scale();
 }
@@ -271,6 +395,41 @@ void* ulWindowGetNativeHandle(ULWindow window) {
   return window->val->native_handle();
 }
 
+static ULFrameTimingPercentiles C_WrapPercentiles(const FrameTimingPercentiles& p) {
+  ULFrameTimingPercentiles result;
+  result.mean_ms = p.mean_ms;
+  result.p50_ms = p.p50_ms;
+  result.p95_ms = p.p95_ms;
+  result.p99_ms = p.p99_ms;
+  result.max_ms = p.max_ms;
+  return result;
+}
+
+ULFrameTimingSnapshot ulWindowGetFrameTimingSnapshot(ULWindow window) {
+  FrameTimingSnapshot snapshot = window->val->frame_timing_snapshot();
+  ULFrameTimingSnapshot result;
+  result.frame_count = snapshot.frame_count;
+  result.total_frames = snapshot.total_frames;
+  result.fps = snapshot.fps;
+  result.update = C_WrapPercentiles(snapshot.update);
+  result.render = C_WrapPercentiles(snapshot.render);
+  result.draw = C_WrapPercentiles(snapshot.draw);
+  result.swap = C_WrapPercentiles(snapshot.swap);
+  result.idle = C_WrapPercentiles(snapshot.idle);
+  result.total = C_WrapPercentiles(snapshot.total);
+  return result;
+}
+
+void ulWindowResetFrameTiming(ULWindow window) {
+  window->val->ResetFrameTiming();
+}
+
+bool ulWindowWriteFrameTimingReport(ULWindow window, const char* path,
+                                    ULFrameTimingFormat format) {
+  return window->val->WriteFrameTimingReport(path, format == kFrameTimingFormat_JSON ?
+    FrameTimingFormat::JSON : FrameTimingFormat::CSV);
+}
+
 ULOverlay ulCreateOverlay(ULWindow window, unsigned int width,
                           unsigned int height, int x, int y) {
   return new C_Overlay(Overlay::Create(window->val, width, height, x, y));
@@ -355,3 +514,19 @@ void ulEnableDefaultLogger(ULString log_path) {
 
   Platform::instance().set_logger(GetDefaultLogger(str));
 }
+
+void ulEnableTracing(bool enabled) {
+  EnableTracing(enabled);
+}
+
+bool ulIsTracingEnabled() {
+  return IsTracingEnabled();
+}
+
+bool ulWriteTraceFile(const char* path) {
+  return WriteTraceFile(path);
+}
+
+void ulSetTraceSignal(int signal, const char* path) {
+  SetTraceSignal(signal, path);
+}
@@ -0,0 +1,41 @@
+#include "CommandArena.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ultralight {
+
+void CommandArena::Append(const CommandList& list) {
+  if (!list.size)
+    return;
+
+  Buffer& buffer = buffers_[back_];
+  size_t required = buffer.size + list.size;
+  if (required > buffer.storage.size()) {
+    // Grow geometrically so that pages which grow a few commands per frame
+    // don't reallocate every frame.
+    buffer.storage.resize(std::max(required, buffer.storage.size() * 2));
+  }
+
+  memcpy(&buffer.storage[buffer.size], list.commands, sizeof(Command) * list.size);
+  buffer.size = required;
+}
+
+CommandArena::Frame CommandArena::Acquire() {
+  back_ ^= 1;
+  buffers_[back_].size = 0;
+  return front();
+}
+
+CommandArena::Frame CommandArena::front() const {
+  const Buffer& buffer = buffers_[back_ ^ 1];
+  Frame frame;
+  frame.commands = buffer.storage.data();
+  frame.size = buffer.size;
+  return frame;
+}
+
+size_t CommandArena::capacity_bytes() const {
+  return (buffers_[0].storage.size() + buffers_[1].storage.size()) * sizeof(Command);
+}
+
+}  // namespace ultralight
@@ -0,0 +1,66 @@
+#pragma once
+#include <Ultralight/platform/GPUDriver.h>
+#include <cstddef>
+#include <vector>
+
+namespace ultralight {
+
+///
+/// Double-buffered storage for the command lists handed to GPUDriverImpl.
+///
+/// The CommandList passed to GPUDriver::UpdateCommandList() is only valid for
+/// the duration of that call, so commands are still copied once. Unlike a plain
+/// std::vector that is cleared and resized every frame, the arena keeps its
+/// storage between frames and never value-initializes commands that are about
+/// to be overwritten: a steady-state frame costs exactly one memcpy and no heap
+/// allocation.
+///
+/// Acquire() flips the buffers and hands out the recorded frame. That frame
+/// stays valid and unmodified until the next call to Acquire(), so passes that
+/// run after drawing (batching, trace capture) can reference it in place.
+///
+class CommandArena {
+public:
+  /// Read-only view of a recorded frame.
+  struct Frame {
+    const Command* commands = nullptr;
+    size_t size = 0;
+
+    const Command* begin() const { return commands; }
+    const Command* end() const { return commands + size; }
+    bool empty() const { return size == 0; }
+  };
+
+  CommandArena() = default;
+
+  /// Append a renderer command list to the frame being recorded.
+  void Append(const CommandList& list);
+
+  /// Whether any commands have been recorded since the last Acquire().
+  bool has_pending() const { return buffers_[back_].size != 0; }
+
+  /// Finish recording: the recorded frame becomes the front frame and the
+  /// back buffer is reset for the next frame. The returned frame is valid
+  /// until the next call to Acquire().
+  Frame Acquire();
+
+  /// The most recently acquired frame (empty before the first Acquire()).
+  Frame front() const;
+
+  /// Total bytes reserved by both buffers.
+  size_t capacity_bytes() const;
+
+private:
+  CommandArena(const CommandArena&) = delete;
+  CommandArena& operator=(const CommandArena&) = delete;
+
+  struct Buffer {
+    std::vector<Command> storage; // Only ever grows, elements past 'size' are stale.
+    size_t size = 0;
+  };
+
+  Buffer buffers_[2];
+  int back_ = 0;
+};
+
+}  // namespace ultralight
@@ -0,0 +1,98 @@
+#include "FileSystemEmbedded.h"
+#include "FileUtils.h"
+#include <Ultralight/platform/Platform.h>
+#include <Ultralight/platform/Logger.h>
+
+namespace ultralight {
+
+// Plain array so mounting before main() doesn't depend on static init order.
+static const size_t kMaxEmbeddedAssetTables = 16;
+static const EmbeddedAssetTable* g_embedded_asset_tables[kMaxEmbeddedAssetTables];
+static size_t g_embedded_asset_table_count = 0;
+
+void MountEmbeddedAssets(const EmbeddedAssetTable* table) {
+  if (!table)
+    return;
+
+  if (g_embedded_asset_table_count == kMaxEmbeddedAssetTables) {
+    if (Logger* logger = Platform::instance().logger())
+      logger->LogMessage(LogLevel::Warning, "Too many embedded asset tables, ignoring table.");
+    return;
+  }
+
+  g_embedded_asset_tables[g_embedded_asset_table_count++] = table;
+}
+
+const EmbeddedAssetTable* const* FileSystemEmbedded::mounted_tables(size_t* count) {
+  *count = g_embedded_asset_table_count;
+  return g_embedded_asset_tables;
+}
+
+static void EmbeddedAsset_NoOpDestroyCallback(void* user_data, void* data) {}
+
+// Compares a request path against a table path without allocating, treating
+// backslashes as forward slashes (same as the platform file systems).
+static int ComparePath(const char* request, size_t length, const char* path) {
+  for (size_t i = 0; i < length; i++) {
+    unsigned char a = request[i] == '\\' ? '/' : (unsigned char)request[i];
+    unsigned char b = (unsigned char)path[i];
+    if (a != b)
+      return (int)a - (int)b;
+  }
+  return path[length] ? -1 : 0;
+}
+
+FileSystemEmbedded::FileSystemEmbedded(const EmbeddedAssetTable* table) : table_(table) {}
+
+const EmbeddedAsset* FileSystemEmbedded::Find(const String& path) const {
+  String8 utf8 = path.utf8();
+  const char* relative = utf8.data();
+  size_t length = utf8.length();
+  if (length && (relative[0] == '/' || relative[0] == '\\')) {
+    relative++;
+    length--;
+  }
+
+  size_t low = 0;
+  size_t high = table_->count;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    int result = ComparePath(relative, length, table_->assets[mid].path);
+    if (result == 0)
+      return &table_->assets[mid];
+    if (result < 0)
+      high = mid;
+    else
+      low = mid + 1;
+  }
+
+  return nullptr;
+}
+
+bool FileSystemEmbedded::FileExists(const String& path) {
+  return Find(path) != nullptr;
+}
+
+String FileSystemEmbedded::GetFileMimeType(const String& file_path) {
+  String8 utf8 = file_path.utf8();
+  const EmbeddedAsset* asset = Find(file_path);
+  return String(FileUtils::FileMimeType(std::string_view(utf8.data(), utf8.length()),
+                                        asset ? asset->data : nullptr, asset ? asset->size : 0));
+}
+
+String FileSystemEmbedded::GetFileCharset(const String& file_path) {
+  return "utf-8";
+}
+
+RefPtr<Buffer> FileSystemEmbedded::OpenFile(const String& file_path) {
+  const EmbeddedAsset* asset = Find(file_path);
+  if (!asset)
+    return nullptr;
+
+  if (!asset->size)
+    return Buffer::CreateFromCopy("", 0);
+
+  return Buffer::Create((void*)asset->data, asset->size, nullptr, EmbeddedAsset_NoOpDestroyCallback);
+}
+
+}  // namespace ultralight
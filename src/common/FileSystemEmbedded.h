@@ -0,0 +1,37 @@
+#pragma once
+#include <AppCore/EmbeddedAssets.h>
+#include <Ultralight/platform/FileSystem.h>
+
+namespace ultralight {
+
+///
+/// FileSystem that serves an EmbeddedAssetTable compiled into the binary by
+/// appcore_embed_assets().
+///
+/// Lookups are a binary search over the sorted table and OpenFile() returns
+/// Buffers that point directly into read-only data, so nothing is copied or
+/// freed. Layer it over other file systems with FileSystemPak.
+///
+class FileSystemEmbedded : public FileSystem {
+ public:
+  explicit FileSystemEmbedded(const EmbeddedAssetTable* table);
+  virtual ~FileSystemEmbedded() = default;
+
+  virtual bool FileExists(const String& path) override;
+
+  virtual String GetFileMimeType(const String& file_path) override;
+
+  virtual String GetFileCharset(const String& file_path) override;
+
+  virtual RefPtr<Buffer> OpenFile(const String& file_path) override;
+
+  // Tables passed to MountEmbeddedAssets(), in mount order.
+  static const EmbeddedAssetTable* const* mounted_tables(size_t* count);
+
+ protected:
+  const EmbeddedAsset* Find(const String& path) const;
+
+  const EmbeddedAssetTable* table_;
+};
+
+}  // namespace ultralight
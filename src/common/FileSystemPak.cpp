@@ -0,0 +1,420 @@
+#include "FileSystemPak.h"
+#include "FileUtils.h"
+#include "PakFormat.h"
+#include "TraceRecorder.h"
+#include <Ultralight/platform/Platform.h>
+#include <Ultralight/platform/Logger.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <Windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace ultralight {
+
+struct FileSystemPak::Archive {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+  const PakEntry* entries = nullptr;
+  uint32_t entry_count = 0;
+  const char* strings = nullptr;
+  uint64_t strings_size = 0;
+#if defined(_WIN32)
+  HANDLE file = INVALID_HANDLE_VALUE;
+  HANDLE mapping = nullptr;
+#endif
+
+  ~Archive() {
+#if defined(_WIN32)
+    if (data)
+      UnmapViewOfFile(data);
+    if (mapping)
+      CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE)
+      CloseHandle(file);
+#else
+    if (data)
+      munmap((void*)data, size);
+#endif
+  }
+
+  bool Map(const String& path) {
+#if defined(_WIN32)
+    String16 path16 = path.utf16();
+    file = CreateFileW((LPCWSTR)path16.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+      return false;
+
+    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+      return false;
+
+    data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    size = (size_t)file_size.QuadPart;
+    return data != nullptr;
+#else
+    int fd = open(path.utf8().data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return false;
+
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0 || !S_ISREG(file_info.st_mode) || file_info.st_size == 0) {
+      close(fd);
+      return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    void* mapped = mmap(nullptr, (size_t)file_info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+      return false;
+
+    data = (const uint8_t*)mapped;
+    size = (size_t)file_info.st_size;
+    return true;
+#endif
+  }
+
+  // Checks that every offset in the archive stays within the mapping, so
+  // lookups and reads don't need to.
+  const char* Validate() {
+    if (size < sizeof(PakHeader))
+      return "file too small";
+
+    const PakHeader* header = (const PakHeader*)data;
+    if (memcmp(header->magic, kPakMagic, sizeof(kPakMagic)) != 0)
+      return "not an asset archive";
+    if (header->version != kPakVersion)
+      return "unsupported archive version";
+
+    if (header->index_offset % alignof(PakEntry) != 0 || header->index_offset > size ||
+        (size - header->index_offset) / sizeof(PakEntry) < header->entry_count)
+      return "index out of bounds";
+    if (header->strings_offset > size || header->strings_size > size - header->strings_offset ||
+        header->strings_size > UINT32_MAX)
+      return "string table out of bounds";
+
+    entries = (const PakEntry*)(data + header->index_offset);
+    entry_count = header->entry_count;
+    strings = (const char*)(data + header->strings_offset);
+    strings_size = header->strings_size;
+
+    for (uint32_t i = 0; i < entry_count; i++) {
+      const PakEntry& entry = entries[i];
+      if (i && entry.path_hash < entries[i - 1].path_hash)
+        return "index not sorted";
+      if (entry.data_offset > size || entry.stored_size > size - entry.data_offset)
+        return "entry data out of bounds";
+      if ((uint64_t)entry.path_offset + entry.path_length > strings_size ||
+          entry.mime_offset >= strings_size ||
+          !memchr(strings + entry.mime_offset, 0, (size_t)(strings_size - entry.mime_offset)))
+        return "entry strings out of bounds";
+      if (entry.compression > (uint16_t)PakCompression::Zstd)
+        return "unknown compression";
+      if (!PakIsCompressionSupported((PakCompression)entry.compression))
+        return entry.compression == (uint16_t)PakCompression::LZ4 ?
+          "entries use LZ4, which this build can't decompress" :
+          "entries use zstd, which this build can't decompress";
+      if (entry.compression == (uint16_t)PakCompression::None && entry.stored_size != entry.size)
+        return "stored entry size mismatch";
+    }
+
+    return nullptr;
+  }
+
+  // 'path' must be stripped of its leading slash.
+  const PakEntry* Find(const char* path, size_t length) const {
+    uint64_t hash = PakHashPath(path, length);
+    const PakEntry* end = entries + entry_count;
+    const PakEntry* it = std::lower_bound(entries, end, hash,
+      [](const PakEntry& entry, uint64_t hash) { return entry.path_hash < hash; });
+
+    for (; it != end && it->path_hash == hash; ++it) {
+      if (it->path_length != length)
+        continue;
+
+      const char* entry_path = strings + it->path_offset;
+      size_t i = 0;
+      for (; i < length; i++) {
+        char c = path[i] == '\\' ? '/' : path[i];
+        if (entry_path[i] != c)
+          break;
+      }
+      if (i == length)
+        return it;
+    }
+
+    return nullptr;
+  }
+};
+
+static void LogArchiveError(const String& path, const char* reason) {
+  if (Logger* logger = Platform::instance().logger())
+    logger->LogMessage(LogLevel::Warning, "Failed to mount asset archive '" + path + "': " + reason);
+}
+
+static void FileSystemPak_ReleaseArchiveCallback(void* user_data, void* data) {
+  delete reinterpret_cast<std::shared_ptr<void>*>(user_data);
+}
+
+static void FileSystemPak_FreeBufferCallback(void* user_data, void* data) {
+  free(data);
+}
+
+FileSystemPak::FileSystemPak() {}
+
+FileSystemPak::~FileSystemPak() {
+  {
+    std::lock_guard<std::mutex> lock(decompression_mutex_);
+    stop_worker_ = true;
+  }
+  decompression_cv_.notify_all();
+  if (worker_.joinable())
+    worker_.join();
+}
+
+bool FileSystemPak::MountArchive(const String& path) {
+  TraceZone("FileSystemPak::MountArchive");
+  auto archive = std::make_shared<Archive>();
+  if (!archive->Map(path)) {
+    LogArchiveError(path, "could not map file");
+    return false;
+  }
+
+  if (const char* error = archive->Validate()) {
+    LogArchiveError(path, error);
+    return false;
+  }
+
+  Layer layer;
+  layer.archive = archive;
+  layers_.push_back(layer);
+  return true;
+}
+
+void FileSystemPak::MountFileSystem(FileSystem* file_system) {
+  Layer layer;
+  layer.file_system = file_system;
+  layers_.push_back(layer);
+}
+
+const FileSystemPak::Layer* FileSystemPak::FindLayer(const String& path, const PakEntry** entry) {
+  String8 utf8 = path.utf8();
+  const char* relative = utf8.data();
+  size_t length = utf8.length();
+  if (length && (relative[0] == '/' || relative[0] == '\\')) {
+    relative++;
+    length--;
+  }
+
+  for (auto layer = layers_.rbegin(); layer != layers_.rend(); ++layer) {
+    if (layer->archive) {
+      if (const PakEntry* found = layer->archive->Find(relative, length)) {
+        *entry = found;
+        return &*layer;
+      }
+    } else if (layer->file_system->FileExists(path)) {
+      *entry = nullptr;
+      return &*layer;
+    }
+  }
+
+  return nullptr;
+}
+
+bool FileSystemPak::FileExists(const String& path) {
+  const PakEntry* entry;
+  return FindLayer(path, &entry) != nullptr;
+}
+
+String FileSystemPak::GetFileMimeType(const String& file_path) {
+  const PakEntry* entry;
+  if (const Layer* layer = FindLayer(file_path, &entry)) {
+    if (entry)
+      return String(layer->archive->strings + entry->mime_offset);
+    return layer->file_system->GetFileMimeType(file_path);
+  }
+
+  String8 utf8 = file_path.utf8();
+  std::string_view filepath(utf8.data(), utf8.length());
+  return String(FileUtils::FileExtensionToMimeType(FileUtils::FileExtension(filepath)));
+}
+
+String FileSystemPak::GetFileCharset(const String& file_path) {
+  const PakEntry* entry;
+  const Layer* layer = FindLayer(file_path, &entry);
+  if (layer && layer->file_system)
+    return layer->file_system->GetFileCharset(file_path);
+  return "utf-8";
+}
+
+RefPtr<Buffer> FileSystemPak::OpenFile(const String& file_path) {
+  TraceZone("FileSystemPak::OpenFile");
+  String8 utf8 = file_path.utf8();
+  const char* relative = utf8.data();
+  size_t length = utf8.length();
+  if (length && (relative[0] == '/' || relative[0] == '\\')) {
+    relative++;
+    length--;
+  }
+
+  for (auto layer = layers_.rbegin(); layer != layers_.rend(); ++layer) {
+    if (layer->file_system) {
+      if (RefPtr<Buffer> buffer = layer->file_system->OpenFile(file_path))
+        return buffer;
+      continue;
+    }
+
+    const PakEntry* entry = layer->archive->Find(relative, length);
+    if (!entry)
+      continue;
+
+    if (entry->compression != (uint16_t)PakCompression::None) {
+      std::unique_lock<std::mutex> lock(decompression_mutex_);
+      auto it = decompressions_.find(entry);
+      if (it != decompressions_.end()) {
+        std::shared_ptr<Decompression> decompression = it->second;
+        if (decompression->state == Decompression::State::Queued) {
+          // Not started yet, faster to do it here than to wait. The worker
+          // skips entries that are no longer in the map.
+          EraseDecompression(it);
+        } else {
+          decompression_cv_.wait(lock, [&] { return decompression->state == Decompression::State::Done; });
+          it = decompressions_.find(entry);
+          if (it != decompressions_.end() && it->second == decompression)
+            EraseDecompression(it);
+          return decompression->buffer;
+        }
+      }
+    }
+
+    return ReadEntry(layer->archive, *entry);
+  }
+
+  return nullptr;
+}
+
+void FileSystemPak::Prefetch(const String& path) {
+  const PakEntry* entry;
+  const Layer* layer = FindLayer(path, &entry);
+  if (!layer || !entry || entry->compression == (uint16_t)PakCompression::None || !entry->size ||
+      entry->size > kMaxDecompressionBytes)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(decompression_mutex_);
+    if (decompressions_.count(entry))
+      return;
+
+    // Results nobody opens would otherwise pile up, make room by dropping
+    // the oldest finished ones. Skip the entry if the rest is still pending.
+    while (decompression_bytes_ + entry->size > kMaxDecompressionBytes) {
+      if (!EvictOldestDecompression())
+        return;
+    }
+
+    auto decompression = std::make_shared<Decompression>();
+    decompression->archive = layer->archive;
+    decompressions_[entry] = decompression;
+    decompression_bytes_ += entry->size;
+    decompression_queue_.push_back(entry);
+
+    if (!worker_.joinable())
+      worker_ = std::thread(&FileSystemPak::WorkerMain, this);
+  }
+  decompression_cv_.notify_all();
+}
+
+void FileSystemPak::EraseDecompression(DecompressionMap::iterator it) {
+  decompression_bytes_ -= it->first->size;
+  decompressions_.erase(it);
+}
+
+bool FileSystemPak::EvictOldestDecompression() {
+  auto oldest = decompressions_.end();
+  for (auto it = decompressions_.begin(); it != decompressions_.end(); ++it) {
+    if (it->second->state == Decompression::State::Done &&
+        (oldest == decompressions_.end() || it->second->finish_order < oldest->second->finish_order))
+      oldest = it;
+  }
+
+  if (oldest == decompressions_.end())
+    return false;
+
+  EraseDecompression(oldest);
+  return true;
+}
+
+RefPtr<Buffer> FileSystemPak::ReadEntry(const std::shared_ptr<Archive>& archive, const PakEntry& entry) {
+  if (!entry.size)
+    return Buffer::CreateFromCopy("", 0);
+
+  const uint8_t* stored = archive->data + entry.data_offset;
+  PakCompression compression = (PakCompression)entry.compression;
+
+  if (compression == PakCompression::None) {
+    // Served from the mapping, which the Buffer keeps alive.
+    return Buffer::Create((void*)stored, (size_t)entry.size, new std::shared_ptr<void>(archive),
+                          FileSystemPak_ReleaseArchiveCallback);
+  }
+
+  TraceZone("FileSystemPak::Decompress");
+  void* data = malloc((size_t)entry.size);
+  if (!data)
+    return nullptr;
+
+  if (!PakDecompress(compression, stored, (size_t)entry.stored_size, data, (size_t)entry.size)) {
+    free(data);
+    return nullptr;
+  }
+
+  return Buffer::Create(data, (size_t)entry.size, nullptr, FileSystemPak_FreeBufferCallback);
+}
+
+void FileSystemPak::WorkerMain() {
+  TraceRecorder::SetThreadName("Asset Decompressor");
+
+  std::unique_lock<std::mutex> lock(decompression_mutex_);
+  for (;;) {
+    decompression_cv_.wait(lock, [&] { return stop_worker_ || !decompression_queue_.empty(); });
+    if (stop_worker_)
+      return;
+
+    // Newest first: a caller that queues a list and then opens it in order
+    // decompresses from the front while this thread works from the back.
+    const PakEntry* entry = decompression_queue_.back();
+    decompression_queue_.pop_back();
+
+    auto it = decompressions_.find(entry);
+    if (it == decompressions_.end() || it->second->state != Decompression::State::Queued)
+      continue;
+
+    std::shared_ptr<Decompression> decompression = it->second;
+    decompression->state = Decompression::State::Running;
+
+    lock.unlock();
+    RefPtr<Buffer> buffer = ReadEntry(decompression->archive, *entry);
+    lock.lock();
+
+    decompression->buffer = buffer;
+    decompression->state = Decompression::State::Done;
+    decompression->finish_order = finished_count_++;
+    decompression_cv_.notify_all();
+  }
+}
+
+}  // namespace ultralight
@@ -0,0 +1,108 @@
+#pragma once
+#include <Ultralight/platform/FileSystem.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ultralight {
+
+struct PakEntry;
+
+///
+/// FileSystem that serves files out of memory-mapped asset archives (see
+/// PakFormat.h), layered over other file systems.
+///
+/// Layers are searched from the most recently mounted to the first, so an
+/// archive mounted over the platform file system shadows loose files with
+/// the same path, while files missing from the archive still load from disk.
+/// Mount a directory over an archive instead to iterate on loose files.
+///
+/// Stored (uncompressed) entries are returned as Buffers that point directly
+/// into the mapping. Compressed entries are decompressed on the calling
+/// thread unless Prefetch() already started them on the worker thread.
+/// Prefetched results wait for OpenFile() up to kMaxDecompressionBytes, after
+/// that the oldest unclaimed ones are dropped.
+///
+/// Archives using a codec this build wasn't compiled with (see
+/// APPCORE_ENABLE_LZ4 / APPCORE_ENABLE_ZSTD) fail to mount.
+///
+/// Mount everything before handing the file system to the Platform; the
+/// FileSystem methods are thread-safe, mounting is not.
+///
+class FileSystemPak : public FileSystem {
+ public:
+  FileSystemPak();
+  virtual ~FileSystemPak();
+
+  // Maps the archive at 'path' and layers it over everything mounted so far.
+  // Returns false (and logs why) if it can't be opened or is malformed.
+  bool MountArchive(const String& path);
+
+  // Layers 'file_system' over everything mounted so far. Ownership remains
+  // with the caller.
+  void MountFileSystem(FileSystem* file_system);
+
+  // Starts decompressing 'path' on the worker thread so that a later
+  // OpenFile() can return it right away. Does nothing for paths that aren't
+  // compressed entries of a mounted archive, or when kMaxDecompressionBytes
+  // are queued or in progress.
+  void Prefetch(const String& path);
+
+  static const uint64_t kMaxDecompressionBytes = 32 * 1024 * 1024;
+
+  virtual bool FileExists(const String& path) override;
+
+  virtual String GetFileMimeType(const String& file_path) override;
+
+  virtual String GetFileCharset(const String& file_path) override;
+
+  virtual RefPtr<Buffer> OpenFile(const String& file_path) override;
+
+ protected:
+  struct Archive;
+
+  struct Layer {
+    std::shared_ptr<Archive> archive;
+    FileSystem* file_system = nullptr;
+  };
+
+  struct Decompression {
+    enum class State { Queued, Running, Done } state = State::Queued;
+    std::shared_ptr<Archive> archive;
+    RefPtr<Buffer> buffer;
+    uint64_t finish_order = 0; // Eviction order once Done
+  };
+
+  typedef std::unordered_map<const PakEntry*, std::shared_ptr<Decompression>> DecompressionMap;
+
+  // Finds the topmost layer serving 'path'. Sets 'entry' if it's an archive.
+  const Layer* FindLayer(const String& path, const PakEntry** entry);
+
+  // Call with decompression_mutex_ held.
+  void EraseDecompression(DecompressionMap::iterator it);
+
+  // Drops the oldest finished decompression. Returns false if none is
+  // finished. Call with decompression_mutex_ held.
+  bool EvictOldestDecompression();
+
+  static RefPtr<Buffer> ReadEntry(const std::shared_ptr<Archive>& archive, const PakEntry& entry);
+
+  void WorkerMain();
+
+  std::vector<Layer> layers_;
+
+  std::mutex decompression_mutex_;
+  std::condition_variable decompression_cv_;
+  std::deque<const PakEntry*> decompression_queue_;
+  DecompressionMap decompressions_;
+  uint64_t decompression_bytes_ = 0; // Decompressed size of everything in decompressions_
+  uint64_t finished_count_ = 0;
+  std::thread worker_;
+  bool stop_worker_ = false;
+};
+
+}  // namespace ultralight
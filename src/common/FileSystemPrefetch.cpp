@@ -0,0 +1,249 @@
+#include "FileSystemPrefetch.h"
+#include "TraceRecorder.h"
+#include <Ultralight/platform/Platform.h>
+#include <Ultralight/platform/Logger.h>
+#include <cstdio>
+#include <sstream>
+
+namespace ultralight {
+
+static const char kManifestHeader[] = "# AppCore prefetch manifest v1";
+
+// Touching one byte per page faults memory-mapped files in on the worker
+// thread instead of on the first read.
+static const size_t kPageSize = 4096;
+
+FileSystemPrefetch::FileSystemPrefetch(FileSystem* file_system, const String& manifest_path, double record_time)
+    : file_system_(file_system), manifest_path_(manifest_path.utf8().data()) {
+  deadline_ = std::chrono::steady_clock::now() +
+              std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(record_time));
+}
+
+FileSystemPrefetch::~FileSystemPrefetch() {
+  // Exiting early still leaves a useful manifest for the next run.
+  FinishRecording();
+  StopWorker();
+}
+
+void FileSystemPrefetch::Start() {
+  TraceZone("FileSystemPrefetch::Start");
+  FILE* file = fopen(manifest_path_.c_str(), "rb");
+  if (!file)
+    return;
+
+  std::string contents;
+  char chunk[16384];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    contents.append(chunk, read);
+  fclose(file);
+
+  std::istringstream lines(contents);
+  std::string line;
+  if (!std::getline(lines, line) || line != kManifestHeader)
+    return;
+
+  while (std::getline(lines, line)) {
+    if (!line.empty())
+      manifest_.push_back(line);
+  }
+
+  if (!manifest_.empty())
+    worker_ = std::thread(&FileSystemPrefetch::WorkerMain, this);
+}
+
+void FileSystemPrefetch::Update() {
+  if (std::chrono::steady_clock::now() < deadline_)
+    return;
+
+  size_t prefetched_count = FinishRecording();
+  if (prefetched_count) {
+    if (Logger* logger = Platform::instance().logger()) {
+      std::ostringstream info;
+      info << "Asset prefetch: " << prefetch_hits_ << " of " << prefetched_count
+           << " prefetched files were used.";
+      logger->LogMessage(LogLevel::Info, info.str().c_str());
+    }
+  }
+}
+
+size_t FileSystemPrefetch::FinishRecording() {
+  std::unordered_map<std::string, RefPtr<Buffer>> unclaimed;
+  size_t prefetched_count;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!recording_)
+      return 0;
+
+    recording_ = false;
+    unclaimed.swap(prefetched_);
+    prefetched_count = prefetch_hits_ + unclaimed.size();
+    prefetched_bytes_ = 0;
+  }
+  cv_.notify_all();
+  StopWorker();
+  WriteManifest();
+  return prefetched_count;
+}
+
+void FileSystemPrefetch::StopWorker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_worker_ = true;
+  }
+  cv_.notify_all();
+  if (worker_.joinable())
+    worker_.join();
+}
+
+void FileSystemPrefetch::WriteManifest() {
+  // Nothing was opened (or the window ended before anything loaded), keep
+  // the previous manifest.
+  if (recorded_.empty())
+    return;
+
+  std::string temp_path = manifest_path_ + ".tmp";
+  FILE* file = fopen(temp_path.c_str(), "wb");
+  if (!file)
+    return;
+
+  bool written = fprintf(file, "%s\n", kManifestHeader) > 0;
+  for (const std::string& path : recorded_)
+    written = written && fwrite(path.data(), 1, path.size(), file) == path.size() && fputc('\n', file) != EOF;
+
+  if (fclose(file) != 0 || !written) {
+    remove(temp_path.c_str());
+    return;
+  }
+
+  // rename() doesn't replace existing files on Windows.
+  remove(manifest_path_.c_str());
+  rename(temp_path.c_str(), manifest_path_.c_str());
+}
+
+void FileSystemPrefetch::AddPrefetched(const std::string& path, RefPtr<Buffer> buffer) {
+  in_flight_.erase(path);
+  if (buffer && recording_ && !recorded_set_.count(path) && prefetched_bytes_ < kMaxPrefetchBytes) {
+    prefetched_bytes_ += buffer->size();
+    prefetched_[path] = buffer;
+  }
+}
+
+void FileSystemPrefetch::WorkerMain() {
+  TraceRecorder::SetThreadName("Asset Prefetch");
+  if (prefetch_hint_ && !async_open_) {
+    for (const std::string& path : manifest_)
+      prefetch_hint_(String(path.c_str()));
+  }
+
+  for (const std::string& path : manifest_) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      // Reads still in flight count against the budget too, at the average
+      // size of the ones that finished, so a few are submitted at a time.
+      cv_.wait(lock, [&] {
+        if (stop_worker_ || !recording_ || !pending_async_opens_)
+          return true;
+        size_t average_size = async_read_count_ ? async_read_bytes_ / async_read_count_ : 0;
+        return pending_async_opens_ < kMaxPendingAsyncOpens &&
+               prefetched_bytes_ + pending_async_opens_ * average_size < kMaxPrefetchBytes;
+      });
+      if (stop_worker_ || !recording_ || prefetched_bytes_ >= kMaxPrefetchBytes)
+        break;
+      // Already requested, prefetching it now would only waste memory.
+      if (recorded_set_.count(path) || in_flight_.count(path))
+        continue;
+      in_flight_.insert(path);
+      if (async_open_)
+        pending_async_opens_++;
+    }
+
+    if (async_open_) {
+      async_open_(String(path.c_str()), [this, path](RefPtr<Buffer> buffer) {
+        // Notified with the lock held, this object may be destroyed as soon
+        // as the worker sees the last read finish.
+        std::lock_guard<std::mutex> lock(mutex_);
+        AddPrefetched(path, buffer);
+        pending_async_opens_--;
+        if (buffer) {
+          async_read_bytes_ += buffer->size();
+          async_read_count_++;
+        }
+        cv_.notify_all();
+      });
+      continue;
+    }
+
+    RefPtr<Buffer> buffer = file_system_->OpenFile(String(path.c_str()));
+    if (buffer) {
+      const volatile uint8_t* data = (const volatile uint8_t*)buffer->data();
+      uint8_t sum = 0;
+      for (size_t offset = 0; offset < buffer->size(); offset += kPageSize)
+        sum += data[offset];
+      (void)sum;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      AddPrefetched(path, buffer);
+    }
+    cv_.notify_all();
+  }
+
+  // The callbacks reference this object.
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&] { return pending_async_opens_ == 0; });
+}
+
+bool FileSystemPrefetch::FileExists(const String& path) {
+  return file_system_->FileExists(path);
+}
+
+String FileSystemPrefetch::GetFileMimeType(const String& file_path) {
+  return file_system_->GetFileMimeType(file_path);
+}
+
+String FileSystemPrefetch::GetFileCharset(const String& file_path) {
+  return file_system_->GetFileCharset(file_path);
+}
+
+RefPtr<Buffer> FileSystemPrefetch::OpenFile(const String& file_path) {
+  TraceZone("FileSystemPrefetch::OpenFile");
+  String8 utf8 = file_path.utf8();
+  std::string path(utf8.data(), utf8.length());
+
+  RefPtr<Buffer> buffer;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!recording_) {
+      lock.unlock();
+      return file_system_->OpenFile(file_path);
+    }
+
+    // The worker is already reading it, waiting is cheaper than reading it twice.
+    cv_.wait(lock, [&] { return !in_flight_.count(path); });
+
+    auto it = prefetched_.find(path);
+    if (it != prefetched_.end()) {
+      buffer = it->second;
+      prefetched_bytes_ -= buffer->size();
+      prefetch_hits_++;
+      prefetched_.erase(it);
+    }
+  }
+
+  if (!buffer)
+    buffer = file_system_->OpenFile(file_path);
+
+  // Only files that exist are worth prefetching. Paths containing line
+  // breaks can't be stored in the manifest.
+  if (buffer && path.find_first_of("\r\n") == std::string::npos) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (recording_ && std::chrono::steady_clock::now() < deadline_ && recorded_set_.insert(path).second)
+      recorded_.push_back(path);
+  }
+
+  return buffer;
+}
+
+}  // namespace ultralight
@@ -0,0 +1,114 @@
+#pragma once
+#include <Ultralight/platform/FileSystem.h>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ultralight {
+
+///
+/// FileSystem that speeds up cold starts by replaying the files a previous
+/// run opened at startup.
+///
+/// For the first 'record_time' seconds every path opened through it is
+/// appended to a manifest (one UTF-8 path per line), which is written to
+/// 'manifest_path' when the window ends. On the next launch Start() reads
+/// the manifest back and opens those files, in order, on a worker thread;
+/// their Buffers are held until the first OpenFile() for the same path
+/// takes them, so requests made while loading the first page mostly find
+/// their data already in memory.
+///
+/// Prefetched Buffers that are still unclaimed when the window ends are
+/// released, and prefetching stops once kMaxPrefetchBytes are held.
+///
+/// With set_async_open() up to kMaxPendingAsyncOpens reads are submitted at
+/// a time instead, letting the platform batch them. Reads in flight count
+/// against kMaxPrefetchBytes at the average size of those that finished.
+///
+class FileSystemPrefetch : public FileSystem {
+ public:
+  // Ownership of 'file_system' remains with the caller. It must be safe to
+  // call from multiple threads.
+  FileSystemPrefetch(FileSystem* file_system, const String& manifest_path, double record_time);
+  virtual ~FileSystemPrefetch();
+
+  // Reads 'path' from the wrapped file system without blocking and passes
+  // the contents (or null) to the callback, on any thread.
+  typedef std::function<void(const String& path, std::function<void(RefPtr<Buffer>)> callback)>
+    AsyncOpenFunction;
+
+  // Prefetches through 'async_open' instead of OpenFile(). Call before Start().
+  void set_async_open(AsyncOpenFunction async_open) { async_open_ = std::move(async_open); }
+
+  // Tells the wrapped file system which paths are about to be opened, so it
+  // can start expensive work (eg, FileSystemPak::Prefetch) on threads of its
+  // own. Called for the whole manifest before the first OpenFile(). Call
+  // before Start().
+  typedef std::function<void(const String& path)> PrefetchHintFunction;
+  void set_prefetch_hint(PrefetchHintFunction prefetch_hint) { prefetch_hint_ = std::move(prefetch_hint); }
+
+  // Loads the manifest left by the previous run, if any, and starts
+  // prefetching it.
+  void Start();
+
+  // Call periodically from the main thread. Writes the manifest and
+  // releases unclaimed Buffers once the window ends.
+  void Update();
+
+  virtual bool FileExists(const String& path) override;
+
+  virtual String GetFileMimeType(const String& file_path) override;
+
+  virtual String GetFileCharset(const String& file_path) override;
+
+  virtual RefPtr<Buffer> OpenFile(const String& file_path) override;
+
+  static const size_t kMaxPrefetchBytes = 64 * 1024 * 1024;
+  static const size_t kMaxPendingAsyncOpens = 32;
+
+ protected:
+  void WorkerMain();
+
+  // Stores a prefetched Buffer unless it's no longer wanted. Call with mutex_ held.
+  void AddPrefetched(const std::string& path, RefPtr<Buffer> buffer);
+
+  // Returns the number of files that were prefetched.
+  size_t FinishRecording();
+
+  void StopWorker();
+
+  void WriteManifest();
+
+  FileSystem* file_system_;
+  std::string manifest_path_;
+  std::chrono::steady_clock::time_point deadline_;
+  AsyncOpenFunction async_open_;
+  PrefetchHintFunction prefetch_hint_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+
+  // Guarded by mutex_
+  bool recording_ = true;
+  std::vector<std::string> recorded_;
+  std::unordered_set<std::string> recorded_set_;
+  std::vector<std::string> manifest_;
+  std::unordered_map<std::string, RefPtr<Buffer>> prefetched_;
+  std::unordered_set<std::string> in_flight_;
+  size_t pending_async_opens_ = 0;
+  size_t async_read_bytes_ = 0;
+  size_t async_read_count_ = 0;
+  size_t prefetched_bytes_ = 0;
+  size_t prefetch_hits_ = 0;
+  bool stop_worker_ = false;
+
+  std::thread worker_;
+};
+
+}  // namespace ultralight
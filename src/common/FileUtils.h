@@ -1,16 +1,49 @@
 #pragma once
 #include <AppCore/Defines.h>
+#include <cstddef>
+#include <string_view>
 
 namespace ultralight {
 namespace FileUtils {
 
 /**
 * @brief Get the mime type of a file based on its extension.
-* 
-* @param ext The file extension.
-* @return const char* The mime type of the file.
+*
+* @param ext The file extension (without the dot), case-insensitive.
+* @return const char* The mime type of the file, "application/octet-stream" if unknown.
 */
-const char* FileExtensionToMimeType(const char* ext);
+const char* FileExtensionToMimeType(std::string_view ext);
+
+/**
+* @brief Same as FileExtensionToMimeType() but returns nullptr for unknown extensions.
+*/
+const char* LookupMimeType(std::string_view ext);
+
+/**
+* @brief Get the extension of the file at 'path' (without the dot), empty if it has none.
+*/
+std::string_view FileExtension(std::string_view path);
+
+/**
+* @brief Number of leading bytes of a file that SniffMimeType() looks at.
+*/
+constexpr size_t kMimeSniffLength = 512;
+
+/**
+* @brief Guess the mime type of a file from its first bytes (magic numbers, HTML/XML
+*        markup, or text without binary bytes).
+*
+* @param data The start of the file (kMimeSniffLength bytes are enough).
+* @param size Number of bytes at 'data'.
+* @return const char* The mime type of the file, nullptr if unrecognized.
+*/
+const char* SniffMimeType(const void* data, size_t size);
+
+/**
+* @brief Get the mime type of a file from the extension of 'path', or by sniffing its
+*        contents if the extension is missing or unknown.
+*/
+const char* FileMimeType(std::string_view path, const void* data, size_t size);
 
 } // namespace FileUtils
-} // namespace ultralight
\ No newline at end of file
+} // namespace ultralight
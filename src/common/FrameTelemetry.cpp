@@ -0,0 +1,271 @@
+#include "FrameTelemetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ultralight {
+
+static double ToMs(uint64_t ns) {
+  return ns / 1000000.0;
+}
+
+static int CountLeadingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return 63 - (int)index;
+#else
+  return __builtin_clzll(value);
+#endif
+}
+
+void LatencyHistogram::Record(uint64_t ns) {
+  // Single writer: plain load/store pairs are enough, the atomics only keep
+  // concurrent readers well-defined.
+  auto& bucket = buckets_[BucketIndex(ns)];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  sum_ns_.store(sum_ns_.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+  if (ns > max_ns_.load(std::memory_order_relaxed))
+    max_ns_.store(ns, std::memory_order_relaxed);
+  count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets_)
+    bucket.store(0, std::memory_order_relaxed);
+  count_.store(0, std::memory_order_relaxed);
+  max_ns_.store(0, std::memory_order_relaxed);
+  sum_ns_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+  uint64_t total = 0;
+  for (auto& bucket : buckets_)
+    total += bucket.load(std::memory_order_relaxed);
+  if (!total)
+    return 0;
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil(percentile / 100.0 * total));
+
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < kBucketCount; i++) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= target)
+      return std::min(BucketValue(i), max_ns());
+  }
+
+  return max_ns();
+}
+
+FrameTimingPercentiles LatencyHistogram::Percentiles() const {
+  FrameTimingPercentiles result;
+  uint64_t samples = count();
+  if (!samples)
+    return result;
+
+  result.mean_ms = ToMs(sum_ns() / samples);
+  result.p50_ms = ToMs(ValueAtPercentile(50.0));
+  result.p95_ms = ToMs(ValueAtPercentile(95.0));
+  result.p99_ms = ToMs(ValueAtPercentile(99.0));
+  result.max_ms = ToMs(max_ns());
+  return result;
+}
+
+uint32_t LatencyHistogram::BucketIndex(uint64_t ns) {
+  // The first 2 * kSubBucketCount values get a bucket each, after that every
+  // power of two is split into kSubBucketCount linear buckets.
+  if (ns < 2 * kSubBucketCount)
+    return (uint32_t)ns;
+
+  uint32_t shift = (63 - CountLeadingZeros(ns)) - kSubBucketBits;
+  if (shift > kMaxShift)
+    return kBucketCount - 1;
+
+  return (shift + 1) * kSubBucketCount + (uint32_t)(ns >> shift) - kSubBucketCount;
+}
+
+uint64_t LatencyHistogram::BucketValue(uint32_t index) {
+  if (index < 2 * kSubBucketCount)
+    return index;
+
+  uint32_t shift = index / kSubBucketCount - 1;
+  uint64_t sub_bucket = index % kSubBucketCount + kSubBucketCount;
+  // Middle of the bucket's range.
+  return (sub_bucket << shift) + ((1ull << shift) >> 1);
+}
+
+FrameTelemetry::FrameTelemetry() : reset_time_ns_(NowNs()) {}
+
+void FrameTelemetry::Record(const FrameRecord& record) {
+  uint64_t index = write_count_.load(std::memory_order_relaxed);
+
+  // Seqlock-style publish: readers compare against writing_count_ after
+  // copying to find slots that may have been overwritten under them.
+  writing_count_.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  ring_[index % kRingCapacity] = record;
+  write_count_.store(index + 1, std::memory_order_release);
+
+  uint64_t requested = reset_requests_.load(std::memory_order_acquire);
+  if (requested != resets_applied_.load(std::memory_order_relaxed)) {
+    for (auto& histogram : histograms_)
+      histogram.Reset();
+    resets_applied_.store(requested, std::memory_order_release);
+  }
+
+  histograms_[kUpdate].Record(record.update_ns);
+  histograms_[kRender].Record(record.render_ns);
+  histograms_[kDraw].Record(record.draw_ns);
+  histograms_[kSwap].Record(record.swap_ns);
+  histograms_[kIdle].Record(record.idle_ns);
+  histograms_[kTotal].Record(record.total_ns);
+}
+
+void FrameTelemetry::Reset() {
+  // Clearing the histograms here would race the writer's read-modify-write
+  // updates and let old counts reappear, so the writer does it.
+  reset_time_ns_.store(NowNs(), std::memory_order_relaxed);
+  reset_requests_.fetch_add(1, std::memory_order_release);
+}
+
+FrameTimingSnapshot FrameTelemetry::Snapshot() const {
+  FrameTimingSnapshot snapshot;
+  snapshot.total_frames = write_count_.load(std::memory_order_acquire);
+
+  // Same handshake as RecentFrames(): bail out if the histograms were cleared
+  // while copying or still hold counts from before a pending Reset().
+  uint64_t applied = resets_applied_.load(std::memory_order_acquire);
+  if (applied != reset_requests_.load(std::memory_order_acquire))
+    return snapshot;
+
+  snapshot.frame_count = histograms_[kTotal].count();
+
+  uint64_t elapsed_ns = NowNs() - reset_time_ns_.load(std::memory_order_relaxed);
+  if (elapsed_ns)
+    snapshot.fps = snapshot.frame_count / (elapsed_ns / 1000000000.0);
+
+  snapshot.update = histograms_[kUpdate].Percentiles();
+  snapshot.render = histograms_[kRender].Percentiles();
+  snapshot.draw = histograms_[kDraw].Percentiles();
+  snapshot.swap = histograms_[kSwap].Percentiles();
+  snapshot.idle = histograms_[kIdle].Percentiles();
+  snapshot.total = histograms_[kTotal].Percentiles();
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (resets_applied_.load(std::memory_order_relaxed) != applied) {
+    FrameTimingSnapshot empty;
+    empty.total_frames = snapshot.total_frames;
+    return empty;
+  }
+
+  return snapshot;
+}
+
+std::vector<FrameRecord> FrameTelemetry::RecentFrames() const {
+  uint64_t end = write_count_.load(std::memory_order_acquire);
+  uint64_t begin = end > kRingCapacity ? end - kRingCapacity : 0;
+
+  std::vector<FrameRecord> frames;
+  frames.reserve((size_t)(end - begin));
+  for (uint64_t i = begin; i < end; i++)
+    frames.push_back(ring_[i % kRingCapacity]);
+
+  // Drop the oldest records if the writer lapped us while copying.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t writing = writing_count_.load(std::memory_order_relaxed);
+  uint64_t first_valid = writing > kRingCapacity ? writing - kRingCapacity : 0;
+  if (first_valid > begin)
+    frames.erase(frames.begin(), frames.begin() + (size_t)std::min(first_valid - begin, end - begin));
+
+  return frames;
+}
+
+std::string FrameTelemetry::ToCSV() const {
+  std::vector<FrameRecord> frames = RecentFrames();
+  uint64_t origin_ns = frames.empty() ? 0 : frames.front().start_ns;
+
+  std::string result = "frame,start_ms,update_ms,render_ms,draw_ms,swap_ms,idle_ms,total_ms\n";
+  char line[256];
+  for (auto& frame : frames) {
+    snprintf(line, sizeof(line), "%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+      (unsigned long long)frame.frame_index, ToMs(frame.start_ns - origin_ns),
+      ToMs(frame.update_ns), ToMs(frame.render_ns), ToMs(frame.draw_ns), ToMs(frame.swap_ns),
+      ToMs(frame.idle_ns), ToMs(frame.total_ns));
+    result += line;
+  }
+
+  return result;
+}
+
+static void AppendPercentilesJSON(std::string& out, const char* name,
+                                  const FrameTimingPercentiles& p, bool last) {
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+    "    \"%s\": { \"mean_ms\": %.3f, \"p50_ms\": %.3f, \"p95_ms\": %.3f, "
+    "\"p99_ms\": %.3f, \"max_ms\": %.3f }%s\n",
+    name, p.mean_ms, p.p50_ms, p.p95_ms, p.p99_ms, p.max_ms, last ? "" : ",");
+  out += buffer;
+}
+
+std::string FrameTelemetry::ToJSON() const {
+  FrameTimingSnapshot snapshot = Snapshot();
+  std::vector<FrameRecord> frames = RecentFrames();
+  uint64_t origin_ns = frames.empty() ? 0 : frames.front().start_ns;
+
+  std::string result;
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+    "{\n  \"frame_count\": %llu,\n  \"total_frames\": %llu,\n  \"fps\": %.2f,\n  \"phases\": {\n",
+    (unsigned long long)snapshot.frame_count, (unsigned long long)snapshot.total_frames,
+    snapshot.fps);
+  result += buffer;
+
+  AppendPercentilesJSON(result, "update", snapshot.update, false);
+  AppendPercentilesJSON(result, "render", snapshot.render, false);
+  AppendPercentilesJSON(result, "draw", snapshot.draw, false);
+  AppendPercentilesJSON(result, "swap", snapshot.swap, false);
+  AppendPercentilesJSON(result, "idle", snapshot.idle, false);
+  AppendPercentilesJSON(result, "total", snapshot.total, true);
+  result += "  },\n  \"frames\": [\n";
+
+  for (size_t i = 0; i < frames.size(); i++) {
+    const FrameRecord& frame = frames[i];
+    snprintf(buffer, sizeof(buffer),
+      "    { \"frame\": %llu, \"start_ms\": %.3f, \"update_ms\": %.3f, \"render_ms\": %.3f, "
+      "\"draw_ms\": %.3f, \"swap_ms\": %.3f, \"idle_ms\": %.3f, \"total_ms\": %.3f }%s\n",
+      (unsigned long long)frame.frame_index, ToMs(frame.start_ns - origin_ns),
+      ToMs(frame.update_ns), ToMs(frame.render_ns), ToMs(frame.draw_ns), ToMs(frame.swap_ns),
+      ToMs(frame.idle_ns), ToMs(frame.total_ns), i + 1 < frames.size() ? "," : "");
+    result += buffer;
+  }
+
+  result += "  ]\n}\n";
+  return result;
+}
+
+bool FrameTelemetry::WriteReport(const char* path, FrameTimingFormat format) const {
+  if (!path)
+    return false;
+
+  std::string report = format == FrameTimingFormat::JSON ? ToJSON() : ToCSV();
+
+  FILE* file = fopen(path, "wb");
+  if (!file)
+    return false;
+
+  bool written = fwrite(report.data(), 1, report.size(), file) == report.size();
+  return fclose(file) == 0 && written;
+}
+
+uint64_t FrameTelemetry::NowNs() {
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace ultralight
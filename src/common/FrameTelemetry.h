@@ -0,0 +1,109 @@
+#pragma once
+#include <AppCore/Window.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ultralight {
+
+/// Per-frame timings recorded by a window, in nanoseconds.
+struct FrameRecord {
+  uint64_t frame_index = 0;
+  uint64_t start_ns = 0;  // CLOCK_MONOTONIC-style timestamp of the frame start
+  uint64_t update_ns = 0; // App updates since the previous frame
+  uint64_t render_ns = 0; // Overlay rendering + command list generation
+  uint64_t draw_ns = 0;   // Command list execution + overlay painting
+  uint64_t swap_ns = 0;   // Buffer swap / present
+  uint64_t idle_ns = 0;   // Time between frames not spent in updates
+  uint64_t total_ns = 0;  // Frame start to frame end
+};
+
+/// Log-linear latency histogram in the spirit of HdrHistogram.
+///
+/// Values are nanoseconds, bucketed with 32 sub-buckets per power of two
+/// (~3% relative error) up to ~60s. Counters are relaxed atomics so a single
+/// writer can record while other threads read approximate percentiles.
+class LatencyHistogram {
+public:
+  void Record(uint64_t ns);
+  void Reset();
+
+  /// Value (ns) at the given percentile (0-100). Returns 0 when empty.
+  uint64_t ValueAtPercentile(double percentile) const;
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t max_ns() const { return max_ns_.load(std::memory_order_relaxed); }
+  uint64_t sum_ns() const { return sum_ns_.load(std::memory_order_relaxed); }
+
+  FrameTimingPercentiles Percentiles() const;
+
+private:
+  static constexpr uint32_t kSubBucketBits = 5;
+  static constexpr uint32_t kSubBucketCount = 1 << kSubBucketBits;
+  static constexpr uint32_t kMaxShift = 30;
+  static constexpr uint32_t kBucketCount = (kMaxShift + 2) * kSubBucketCount;
+
+  static uint32_t BucketIndex(uint64_t ns);
+  static uint64_t BucketValue(uint32_t index);
+
+  std::atomic<uint32_t> buckets_[kBucketCount] = {};
+  std::atomic<uint64_t> count_{ 0 };
+  std::atomic<uint64_t> max_ns_{ 0 };
+  std::atomic<uint64_t> sum_ns_{ 0 };
+};
+
+///
+/// Frame-timing telemetry for a single window.
+///
+/// The window's thread calls Record() once per frame. Each record goes into a
+/// fixed-size ring (for raw per-frame dumps) and into one histogram per phase
+/// (for percentiles since the last Reset()). Neither takes a lock: the ring is
+/// a single-producer seqlock, so Snapshot() and the dump functions can run on
+/// any thread and simply skip records that were overwritten while copying.
+///
+/// Only the writer touches the histograms. Reset() can be called from any
+/// thread: it bumps reset_requests_ and the next Record() clears them, readers
+/// report empty percentiles until it has.
+///
+class FrameTelemetry {
+public:
+  static constexpr size_t kRingCapacity = 1024;
+
+  FrameTelemetry();
+
+  void Record(const FrameRecord& record);
+
+  /// Clears the histograms before the next Record(). The ring keeps its
+  /// records.
+  void Reset();
+
+  FrameTimingSnapshot Snapshot() const;
+
+  /// Most recent records (up to kRingCapacity), oldest first.
+  std::vector<FrameRecord> RecentFrames() const;
+
+  /// Per-frame rows for the frames still in the ring.
+  std::string ToCSV() const;
+
+  /// Snapshot summary followed by the frames still in the ring.
+  std::string ToJSON() const;
+
+  bool WriteReport(const char* path, FrameTimingFormat format) const;
+
+  static uint64_t NowNs();
+
+private:
+  enum Phase { kUpdate, kRender, kDraw, kSwap, kIdle, kTotal, kPhaseCount };
+
+  FrameRecord ring_[kRingCapacity];
+  std::atomic<uint64_t> write_count_{ 0 };   // Records published
+  std::atomic<uint64_t> writing_count_{ 0 }; // Records published or being written
+  std::atomic<uint64_t> reset_time_ns_;
+  std::atomic<uint64_t> reset_requests_{ 0 }; // Reset() calls
+  std::atomic<uint64_t> resets_applied_{ 0 }; // Reset() calls the histograms reflect
+  LatencyHistogram histograms_[kPhaseCount];
+};
+
+}  // namespace ultralight
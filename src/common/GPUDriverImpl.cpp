@@ -8,18 +8,18 @@ GPUDriverImpl::GPUDriverImpl() : batch_count_(0) {}
 GPUDriverImpl::~GPUDriverImpl() {}
 
 bool GPUDriverImpl::HasCommandsPending() {
-  return !command_list_.empty();
+  return command_arena_.has_pending();
 }
 
 void GPUDriverImpl::DrawCommandList() {
   ProfiledZone;
 
-  if (command_list_.empty())
+  if (!command_arena_.has_pending())
     return;
 
   batch_count_ = 0;
 
-  for (auto& cmd : command_list_) {
+  for (auto& cmd : command_arena_.Acquire()) {
     if (cmd.command_type == CommandType::DrawGeometry) {
       ZoneScopedN("ProcessDrawGeometryCmd");
       DrawGeometry(cmd.geometry_id, cmd.indices_count, cmd.indices_offset, cmd.gpu_state);
@@ -29,14 +29,26 @@ void GPUDriverImpl::DrawCommandList() {
     }
     batch_count_++;
   }
-
-  command_list_.clear();
 }
 
 int GPUDriverImpl::batch_count() const {
   return batch_count_;
 }
 
+GPUMemoryStats GPUDriverImpl::memory_stats() const {
+  return GPUMemoryStats();
+}
+
+GPUDriverStats GPUDriverImpl::driver_stats() const {
+  return GPUDriverStats();
+}
+
+std::vector<GPUDriverImpl::ResourceUsage> GPUDriverImpl::TopMemoryConsumers(size_t max_count) const {
+  return std::vector<ResourceUsage>();
+}
+
+void GPUDriverImpl::PurgeCaches() {}
+
 void GPUDriverImpl::BeginSynchronize() {}
 
 void GPUDriverImpl::EndSynchronize() {}
@@ -48,10 +60,7 @@ uint32_t GPUDriverImpl::NextRenderBufferId() { return next_render_buffer_id_++;
 uint32_t GPUDriverImpl::NextGeometryId() { return next_geometry_id_++; }
 
 void GPUDriverImpl::UpdateCommandList(const CommandList& list) {
-  if (list.size) {
-    command_list_.resize(list.size);
-    memcpy(&command_list_[0], list.commands, sizeof(Command) * list.size);
-  }
+  command_arena_.Append(list);
 }
 
 }  // namespace ultralight
@@ -1,6 +1,8 @@
 #pragma once
 #include <AppCore/Defines.h>
+#include <AppCore/App.h>
 #include <Ultralight/platform/GPUDriver.h>
+#include "CommandArena.h"
 #include <vector>
 
 namespace ultralight {
@@ -33,6 +35,29 @@ public:
 
   virtual int batch_count() const;
 
+  // Storage for the pending and most recently drawn command lists.
+  const CommandArena& command_arena() const { return command_arena_; }
+
+  // GPU memory accounting. Drivers that don't track usage report zeros.
+  virtual GPUMemoryStats memory_stats() const;
+
+  // Counters of the driver's caches and queues, zeros if it has none.
+  virtual GPUDriverStats driver_stats() const;
+
+  struct ResourceUsage {
+    const char* kind; // "texture", "render target", "geometry", ...
+    uint32_t id;      // Ultralight resource ID
+    uint64_t bytes;
+  };
+
+  // The largest GPU resources, sorted by size (largest first).
+  virtual std::vector<ResourceUsage> TopMemoryConsumers(size_t max_count) const;
+
+  // Release resources the driver keeps around for reuse (pooled render
+  // targets, etc.). Called when the app exceeds its GPU memory budget or the
+  // OS reports memory pressure.
+  virtual void PurgeCaches();
+
   // Inherited from GPUDriver
 
   virtual void BeginSynchronize() override;
@@ -51,7 +76,7 @@ protected:
   uint32_t next_texture_id_ = 1;
   uint32_t next_render_buffer_id_ = 1; // render buffer id 0 is reserved for default render target view.
   uint32_t next_geometry_id_ = 1;
-  std::vector<Command> command_list_;
+  CommandArena command_arena_;
   int batch_count_;
 };
 
@@ -1,4 +1,5 @@
 #include "OverlayManager.h"
+#include "TraceRecorder.h"
 #include <algorithm>
 #include <AppCore/Overlay.h>
 #include <AppCore/App.h>
@@ -29,6 +30,7 @@ void OverlayManager::Remove(Overlay* overlay) {
 }
 
 void OverlayManager::Render() {
+  TraceZone("OverlayManager::Render");
   if (overlays_.empty())
     return;
 
@@ -52,6 +54,7 @@ void OverlayManager::Render() {
 }
 
 void OverlayManager::Paint() {
+  TraceZone("OverlayManager::Paint");
   for (auto& i : overlays_)
     i->Paint();
 }
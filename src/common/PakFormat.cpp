@@ -0,0 +1,93 @@
+#include "PakFormat.h"
+
+#if defined(APPCORE_ENABLE_LZ4)
+#  include <lz4.h>
+#  include <lz4hc.h>
+#endif
+
+#if defined(APPCORE_ENABLE_ZSTD)
+#  include <zstd.h>
+#endif
+
+namespace ultralight {
+
+bool PakIsCompressionSupported(PakCompression compression) {
+  switch (compression) {
+  case PakCompression::None:
+    return true;
+  case PakCompression::LZ4:
+#if defined(APPCORE_ENABLE_LZ4)
+    return true;
+#else
+    return false;
+#endif
+  case PakCompression::Zstd:
+#if defined(APPCORE_ENABLE_ZSTD)
+    return true;
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+bool PakDecompress(PakCompression compression, const void* src, size_t src_size, void* dst,
+                   size_t dst_size) {
+  switch (compression) {
+  case PakCompression::None:
+    return false;
+  case PakCompression::LZ4:
+#if defined(APPCORE_ENABLE_LZ4)
+    if (src_size > (size_t)LZ4_MAX_INPUT_SIZE || dst_size > (size_t)LZ4_MAX_INPUT_SIZE)
+      return false;
+    return LZ4_decompress_safe((const char*)src, (char*)dst, (int)src_size, (int)dst_size) ==
+           (int)dst_size;
+#else
+    return false;
+#endif
+  case PakCompression::Zstd:
+#if defined(APPCORE_ENABLE_ZSTD)
+  {
+    size_t result = ZSTD_decompress(dst, dst_size, src, src_size);
+    return !ZSTD_isError(result) && result == dst_size;
+  }
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+size_t PakCompress(PakCompression compression, int level, const void* src, size_t src_size,
+                   void* dst, size_t dst_capacity) {
+  switch (compression) {
+  case PakCompression::None:
+    return 0;
+  case PakCompression::LZ4:
+#if defined(APPCORE_ENABLE_LZ4)
+  {
+    // The HC compressor produces the same format, decompression speed is
+    // unaffected.
+    if (src_size > (size_t)LZ4_MAX_INPUT_SIZE)
+      return 0;
+    int capacity = dst_capacity > (size_t)LZ4_MAX_INPUT_SIZE ? LZ4_MAX_INPUT_SIZE : (int)dst_capacity;
+    int result = LZ4_compress_HC((const char*)src, (char*)dst, (int)src_size, capacity, level);
+    return result > 0 ? (size_t)result : 0;
+  }
+#else
+    return 0;
+#endif
+  case PakCompression::Zstd:
+#if defined(APPCORE_ENABLE_ZSTD)
+  {
+    size_t result = ZSTD_compress(dst, dst_capacity, src, src_size, level);
+    return ZSTD_isError(result) ? 0 : result;
+  }
+#else
+    return 0;
+#endif
+  }
+  return 0;
+}
+
+}  // namespace ultralight
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace ultralight {
+
+///
+/// AppCore asset archive (.pak) layout, shared by FileSystemPak and the
+/// AppCorePak packer (tools/pak).
+///
+/// An archive is a PakHeader at offset 0, followed by the file data, the
+/// entry index and the string table. All integers are little-endian.
+///
+/// Entries are sorted by (path_hash, path) so they can be binary searched in
+/// place once the archive is mapped. Paths are relative to the packed
+/// directory, use forward slashes and have no leading slash.
+///
+/// Each entry's data starts on a kPakDataAlignment boundary and is either
+/// stored as-is (and served straight from the mapping) or compressed on its
+/// own with one of the PakCompression codecs.
+///
+enum class PakCompression : uint16_t {
+  None = 0,
+  LZ4 = 1,
+  Zstd = 2,
+};
+
+static const char kPakMagic[8] = { 'U', 'L', 'P', 'A', 'K', '\r', '\n', '\x1a' };
+static const uint32_t kPakVersion = 1;
+static const uint64_t kPakDataAlignment = 16;
+
+struct PakHeader {
+  char magic[8];           // kPakMagic
+  uint32_t version;        // kPakVersion
+  uint32_t entry_count;
+  uint64_t index_offset;   // PakEntry[entry_count]
+  uint64_t strings_offset; // Paths (not null-terminated) and mime types (null-terminated)
+  uint64_t strings_size;
+  uint64_t reserved;
+};
+
+struct PakEntry {
+  uint64_t path_hash;      // PakHashPath() of the path
+  uint64_t data_offset;
+  uint64_t stored_size;    // Bytes in the archive
+  uint64_t size;           // Bytes once decompressed
+  uint32_t path_offset;    // Into the string table
+  uint32_t path_length;
+  uint32_t mime_offset;    // Into the string table
+  uint16_t compression;    // PakCompression
+  uint16_t flags;          // Reserved, 0
+};
+
+static_assert(sizeof(PakHeader) == 48, "PakHeader layout changed");
+static_assert(sizeof(PakEntry) == 48, "PakEntry layout changed");
+
+/// FNV-1a hash of a path, treating backslashes as forward slashes.
+inline uint64_t PakHashPath(const char* path, size_t length) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < length; i++) {
+    char c = path[i] == '\\' ? '/' : path[i];
+    hash = (hash ^ (unsigned char)c) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+/// Whether this build can decompress (and the packer compress) 'compression'.
+bool PakIsCompressionSupported(PakCompression compression);
+
+/// Decompresses exactly 'dst_size' bytes into 'dst'. Returns false on
+/// corrupt input or an unsupported codec.
+bool PakDecompress(PakCompression compression, const void* src, size_t src_size, void* dst,
+                   size_t dst_size);
+
+/// Compresses 'src' into 'dst', returning the compressed size or 0 when it
+/// doesn't fit in 'dst_capacity' (or the codec is unsupported).
+size_t PakCompress(PakCompression compression, int level, const void* src, size_t src_size,
+                   void* dst, size_t dst_capacity);
+
+}  // namespace ultralight
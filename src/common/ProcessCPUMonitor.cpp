@@ -0,0 +1,307 @@
+#include "ProcessCPUMonitor.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <Windows.h>
+#  include <TlHelp32.h>
+#elif defined(__APPLE__)
+#  include <mach/mach.h>
+#  include <time.h>
+#elif defined(__linux__)
+#  include <dirent.h>
+#  include <fcntl.h>
+#  include <stdlib.h>
+#  include <time.h>
+#  include <unistd.h>
+#else
+#  error "Unsupported platform"
+#endif
+
+namespace ultralight {
+
+ProcessCPUMonitor::ProcessCPUMonitor(double sample_interval_seconds, double window_seconds) {
+  assert(window_seconds >= 0.1);
+  window_ns_ = static_cast<uint64_t>(window_seconds * 1e9);
+  set_sample_interval(sample_interval_seconds);
+}
+
+void ProcessCPUMonitor::set_sample_interval(double seconds) {
+  interval_ns_ = static_cast<uint64_t>(std::max(seconds, 0.0) * 1e9);
+}
+
+void ProcessCPUMonitor::Sample() {
+  uint64_t now = WallNs();
+  if (count_ && now - last_sample_ns_ < interval_ns_)
+    return;
+  last_sample_ns_ = now;
+
+  ring_[head_] = { now, ProcessCpuNs() };
+  head_ = (head_ + 1) % kRingCapacity;
+  if (count_ < kRingCapacity)
+    count_++;
+
+  if (!last_thread_sample_ns_ || now - last_thread_sample_ns_ >= window_ns_)
+    SampleThreads(now);
+}
+
+double ProcessCPUMonitor::GetProcessUtilization() const {
+  if (count_ < 2)
+    return 1.0;
+
+  size_t newest_idx = (head_ + kRingCapacity - 1) % kRingCapacity;
+  const auto& newest = ring_[newest_idx];
+
+  // Walk backward through the ring buffer to find the oldest sample
+  // that's at least window_ns_ in the past.
+  size_t best_idx = (newest_idx + kRingCapacity - 1) % kRingCapacity;
+  for (size_t i = 2; i < count_; i++) {
+    size_t idx = (newest_idx + kRingCapacity - i) % kRingCapacity;
+    best_idx = idx;
+    if (newest.wall_ns - ring_[idx].wall_ns >= window_ns_)
+      break;
+  }
+
+  const auto& oldest = ring_[best_idx];
+  uint64_t wall_delta = newest.wall_ns - oldest.wall_ns;
+  if (wall_delta == 0)
+    return 1.0;
+
+  uint64_t cpu_delta = newest.cpu_ns - oldest.cpu_ns;
+  return static_cast<double>(cpu_delta) / static_cast<double>(wall_delta);
+}
+
+void ProcessCPUMonitor::SampleThreads(uint64_t wall_ns) {
+  thread_samples_.clear();
+  EnumerateThreads(thread_samples_);
+
+  uint64_t wall_delta = wall_ns - last_thread_sample_ns_;
+  bool have_previous = last_thread_sample_ns_ != 0 && wall_delta != 0;
+  last_thread_sample_ns_ = wall_ns;
+
+  thread_usage_.clear();
+  std::unordered_map<uint64_t, uint64_t> thread_cpu_ns;
+  thread_cpu_ns.reserve(thread_samples_.size());
+
+  for (auto& sample : thread_samples_) {
+    thread_cpu_ns[sample.thread_id] = sample.cpu_ns;
+    if (!have_previous)
+      continue;
+
+    // Threads started during the window count from zero.
+    auto prev = last_thread_cpu_ns_.find(sample.thread_id);
+    uint64_t prev_cpu_ns = prev == last_thread_cpu_ns_.end() ? 0 : prev->second;
+    uint64_t cpu_delta = sample.cpu_ns > prev_cpu_ns ? sample.cpu_ns - prev_cpu_ns : 0;
+
+    ThreadUsage usage;
+    usage.thread_id = sample.thread_id;
+    memcpy(usage.name, sample.name, sizeof(usage.name));
+    usage.utilization = std::min(static_cast<double>(cpu_delta) / static_cast<double>(wall_delta), 1.0);
+    thread_usage_.push_back(usage);
+  }
+
+  last_thread_cpu_ns_.swap(thread_cpu_ns);
+
+  std::sort(thread_usage_.begin(), thread_usage_.end(),
+    [](const ThreadUsage& a, const ThreadUsage& b) { return a.utilization > b.utilization; });
+}
+
+// ── Platform: Windows ────────────────────────────────────────────────
+
+#if defined(_WIN32)
+
+static uint64_t FileTimeToNs(const FILETIME& ft) {
+  // FILETIME is in 100-nanosecond intervals
+  uint64_t t = (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+  return t * 100;
+}
+
+uint64_t ProcessCPUMonitor::WallNs() {
+  LARGE_INTEGER freq, now;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&now);
+
+  // Convert to nanoseconds avoiding 64-bit overflow
+  uint64_t ticks = static_cast<uint64_t>(now.QuadPart);
+  uint64_t f = static_cast<uint64_t>(freq.QuadPart);
+  return ticks / f * 1'000'000'000ULL + ticks % f * 1'000'000'000ULL / f;
+}
+
+uint64_t ProcessCPUMonitor::ProcessCpuNs() {
+  FILETIME creation, exit, kernel, user;
+  GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+  return FileTimeToNs(kernel) + FileTimeToNs(user);
+}
+
+void ProcessCPUMonitor::EnumerateThreads(std::vector<ThreadSample>& samples) {
+  HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+  if (snapshot == INVALID_HANDLE_VALUE)
+    return;
+
+  DWORD pid = GetCurrentProcessId();
+  THREADENTRY32 entry;
+  entry.dwSize = sizeof(entry);
+
+  for (BOOL ok = Thread32First(snapshot, &entry); ok; ok = Thread32Next(snapshot, &entry)) {
+    if (entry.th32OwnerProcessID != pid)
+      continue;
+
+    HANDLE thread = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, entry.th32ThreadID);
+    if (!thread)
+      continue;
+
+    FILETIME creation, exit, kernel, user;
+    if (GetThreadTimes(thread, &creation, &exit, &kernel, &user)) {
+      ThreadSample sample = {};
+      sample.thread_id = entry.th32ThreadID;
+      sample.cpu_ns = FileTimeToNs(kernel) + FileTimeToNs(user);
+      samples.push_back(sample);
+    }
+
+    CloseHandle(thread);
+  }
+
+  CloseHandle(snapshot);
+}
+
+// ── Platform: macOS ──────────────────────────────────────────────────
+
+#elif defined(__APPLE__)
+
+uint64_t ProcessCPUMonitor::WallNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t ProcessCPUMonitor::ProcessCpuNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void ProcessCPUMonitor::EnumerateThreads(std::vector<ThreadSample>& samples) {
+  thread_act_array_t threads;
+  mach_msg_type_number_t thread_count = 0;
+  if (task_threads(mach_task_self(), &threads, &thread_count) != KERN_SUCCESS)
+    return;
+
+  for (mach_msg_type_number_t i = 0; i < thread_count; i++) {
+    thread_extended_info_data_t info;
+    mach_msg_type_number_t info_count = THREAD_EXTENDED_INFO_COUNT;
+    thread_identifier_info_data_t id_info;
+    mach_msg_type_number_t id_count = THREAD_IDENTIFIER_INFO_COUNT;
+
+    if (thread_info(threads[i], THREAD_EXTENDED_INFO, (thread_info_t)&info, &info_count) == KERN_SUCCESS &&
+        thread_info(threads[i], THREAD_IDENTIFIER_INFO, (thread_info_t)&id_info, &id_count) == KERN_SUCCESS) {
+      ThreadSample sample = {};
+      sample.thread_id = id_info.thread_id;
+      sample.cpu_ns = info.pth_user_time + info.pth_system_time;
+      strncpy(sample.name, info.pth_name, sizeof(sample.name) - 1);
+      samples.push_back(sample);
+    }
+
+    mach_port_deallocate(mach_task_self(), threads[i]);
+  }
+
+  vm_deallocate(mach_task_self(), (vm_address_t)threads, thread_count * sizeof(thread_act_t));
+}
+
+// ── Platform: Linux ──────────────────────────────────────────────────
+
+#else
+
+uint64_t ProcessCPUMonitor::WallNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t ProcessCPUMonitor::ProcessCpuNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// Parses the name and utime + stime (in clock ticks) out of a
+// /proc/<pid>/task/<tid>/stat line. The name is in parentheses and may
+// itself contain spaces and parentheses, so fields are counted from the
+// last ')'.
+static bool ParseTaskStat(const char* stat, char* name, size_t name_size, uint64_t& ticks) {
+  const char* open = strchr(stat, '(');
+  const char* close = strrchr(stat, ')');
+  if (!open || !close || close < open)
+    return false;
+
+  size_t name_length = std::min((size_t)(close - open - 1), name_size - 1);
+  memcpy(name, open + 1, name_length);
+  name[name_length] = 0;
+
+  // Fields after the name start at 3 (state); utime and stime are 14 and 15.
+  const char* p = close + 1;
+  for (int field = 3; field < 14; field++) {
+    p = strchr(p + 1, ' ');
+    if (!p)
+      return false;
+  }
+
+  char* end;
+  uint64_t utime = strtoull(p + 1, &end, 10);
+  uint64_t stime = strtoull(end, nullptr, 10);
+  ticks = utime + stime;
+  return true;
+}
+
+void ProcessCPUMonitor::EnumerateThreads(std::vector<ThreadSample>& samples) {
+  DIR* dir = opendir("/proc/self/task");
+  if (!dir)
+    return;
+
+  long ticks_per_second = sysconf(_SC_CLK_TCK);
+  if (ticks_per_second <= 0)
+    ticks_per_second = 100;
+
+  char path[64];
+  char stat[512];
+  while (struct dirent* entry = readdir(dir)) {
+    // Task directories are named after the TID, format the parsed number so
+    // the path always fits.
+    char* end;
+    unsigned long long tid = strtoull(entry->d_name, &end, 10);
+    if (entry->d_name[0] < '0' || entry->d_name[0] > '9' || *end)
+      continue;
+
+    snprintf(path, sizeof(path), "/proc/self/task/%llu/stat", tid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      continue; // Thread exited
+
+    ssize_t length = read(fd, stat, sizeof(stat) - 1);
+    close(fd);
+    if (length <= 0)
+      continue;
+    stat[length] = 0;
+
+    ThreadSample sample = {};
+    uint64_t ticks;
+    if (!ParseTaskStat(stat, sample.name, sizeof(sample.name), ticks))
+      continue;
+
+    sample.thread_id = tid;
+    sample.cpu_ns = ticks * 1'000'000'000ULL / (uint64_t)ticks_per_second;
+    samples.push_back(sample);
+  }
+
+  closedir(dir);
+}
+
+#endif
+
+} // namespace ultralight
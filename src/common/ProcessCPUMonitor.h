@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ultralight {
+
+/// Measures CPU utilization of the whole process and of each of its threads.
+///
+/// Unlike ThreadCPUMonitor this also sees renderer, JavaScript and worker
+/// threads, so background work keeps the app from being declared idle.
+///
+/// Call Sample() as often as convenient (eg, once per update) from one thread;
+/// it returns immediately unless the sample interval has elapsed. Process CPU
+/// time is read every interval. Threads are enumerated once per averaging
+/// window since that is far more expensive and per-thread times have coarse
+/// (scheduler tick) resolution on Linux.
+///
+/// Platform APIs:
+///   Linux:   clock_gettime(CLOCK_PROCESS_CPUTIME_ID) + /proc/self/task/*/stat
+///   macOS:   clock_gettime(CLOCK_PROCESS_CPUTIME_ID) + task_threads()/thread_info()
+///   Windows: GetProcessTimes() + Toolhelp thread snapshot/GetThreadTimes()
+class ProcessCPUMonitor {
+public:
+  struct ThreadUsage {
+    uint64_t thread_id;
+    char name[16];      // OS thread name, may be truncated or empty
+    double utilization; // Fraction of one core (0.0-1.0)
+  };
+
+  /// @param sample_interval_seconds  Minimum time between process samples.
+  /// @param window_seconds           Averaging window duration.
+  explicit ProcessCPUMonitor(double sample_interval_seconds = 0.1, double window_seconds = 1.0);
+
+  void set_sample_interval(double seconds);
+
+  /// Samples process (and periodically per-thread) CPU time if the sample
+  /// interval has elapsed.
+  void Sample();
+
+  /// Returns CPU cores in use by the process over the configured window
+  /// (1.0 = one core fully busy, can exceed 1.0 on multi-core machines).
+  /// Returns 1.0 if insufficient data.
+  double GetProcessUtilization() const;
+
+  /// Per-thread utilization over the last completed window, busiest first.
+  const std::vector<ThreadUsage>& thread_usage() const { return thread_usage_; }
+
+private:
+  struct ProcessSample {
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+  };
+
+  struct ThreadSample {
+    uint64_t thread_id;
+    uint64_t cpu_ns;
+    char name[16];
+  };
+
+  static constexpr size_t kRingCapacity = 512;
+
+  void SampleThreads(uint64_t wall_ns);
+
+  ProcessSample ring_[kRingCapacity];
+  size_t head_ = 0;
+  size_t count_ = 0;
+  uint64_t window_ns_;
+  uint64_t interval_ns_;
+  uint64_t last_sample_ns_ = 0;
+
+  uint64_t last_thread_sample_ns_ = 0;
+  std::unordered_map<uint64_t, uint64_t> last_thread_cpu_ns_;
+  std::vector<ThreadSample> thread_samples_;
+  std::vector<ThreadUsage> thread_usage_;
+
+  static uint64_t WallNs();
+  static uint64_t ProcessCpuNs();
+  // Appends the CPU time of every thread of this process to 'samples'.
+  static void EnumerateThreads(std::vector<ThreadSample>& samples);
+};
+
+} // namespace ultralight
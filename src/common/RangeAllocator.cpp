@@ -0,0 +1,59 @@
+#include "RangeAllocator.h"
+#include <algorithm>
+#include <iterator>
+
+namespace ultralight {
+
+RangeAllocator::RangeAllocator(uint32_t capacity) : capacity_(capacity), free_count_(capacity) {
+  if (capacity)
+    free_blocks_[0] = capacity;
+}
+
+uint32_t RangeAllocator::Allocate(uint32_t count) {
+  for (auto i = free_blocks_.begin(); i != free_blocks_.end(); ++i) {
+    if (i->second < count)
+      continue;
+
+    uint32_t offset = i->first;
+    uint32_t remaining = i->second - count;
+    free_blocks_.erase(i);
+    if (remaining)
+      free_blocks_[offset + count] = remaining;
+    free_count_ -= count;
+    return offset;
+  }
+
+  return kInvalidOffset;
+}
+
+void RangeAllocator::Free(uint32_t offset, uint32_t count) {
+  free_count_ += count;
+
+  auto next = free_blocks_.lower_bound(offset);
+
+  // Merge with the following block if adjacent
+  if (next != free_blocks_.end() && offset + count == next->first) {
+    count += next->second;
+    next = free_blocks_.erase(next);
+  }
+
+  // Merge with the preceding block if adjacent
+  if (next != free_blocks_.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == offset) {
+      prev->second += count;
+      return;
+    }
+  }
+
+  free_blocks_[offset] = count;
+}
+
+uint32_t RangeAllocator::largest_free_block() const {
+  uint32_t largest = 0;
+  for (auto& block : free_blocks_)
+    largest = std::max(largest, block.second);
+  return largest;
+}
+
+}  // namespace ultralight
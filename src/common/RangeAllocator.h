@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <map>
+
+namespace ultralight {
+
+// First-fit free-list allocator over a range of elements. Adjacent free blocks
+// are coalesced when ranges are freed.
+class RangeAllocator {
+public:
+  static const uint32_t kInvalidOffset = UINT32_MAX;
+
+  explicit RangeAllocator(uint32_t capacity);
+
+  // Returns the offset of the allocated range or kInvalidOffset if no free
+  // block is large enough.
+  uint32_t Allocate(uint32_t count);
+
+  void Free(uint32_t offset, uint32_t count);
+
+  uint32_t capacity() const { return capacity_; }
+
+  uint32_t free_count() const { return free_count_; }
+
+  uint32_t largest_free_block() const;
+
+  bool empty() const { return free_count_ == capacity_; }
+
+protected:
+  std::map<uint32_t, uint32_t> free_blocks_; // offset -> count
+  uint32_t capacity_;
+  uint32_t free_count_;
+};
+
+}  // namespace ultralight
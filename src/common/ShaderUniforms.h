@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+namespace ultralight {
+
+// Uniform buffer layout matching std140 in the GLSL and SPIR-V shaders.
+// Must match the type_Uniforms block in the generated GLSL headers and the
+// Uniforms cbuffer in shaders/hlsl/common.hlsli.
+#pragma pack(push, 1)
+struct alignas(16) Uniforms {
+  float State[4];           // vec4: [time, screenWidth, screenHeight, screenScale]
+  float Transform[16];      // row_major mat4
+  int32_t Integer4[8];      // ivec4[2]
+  float Scalar4[8];         // vec4[2]
+  float Vector[32];         // vec4[8]
+  int32_t ClipData[4];      // ivec4
+  float Clip[128];          // row_major mat4[8]
+};
+#pragma pack(pop)
+
+static_assert(sizeof(Uniforms) == 800, "Uniforms struct size must be 800 bytes to match std140 layout");
+
+struct UniformUploadStats {
+  uint64_t draws = 0;
+  uint64_t full_bytes = 0;     // Bytes a full-block upload per draw would have sent
+  uint64_t uploaded_bytes = 0; // Bytes actually sent
+  uint64_t skipped_uploads = 0; // Draws whose uniforms were already in the UBO
+};
+
+}  // namespace ultralight
@@ -0,0 +1,313 @@
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <Windows.h>
+#else
+#  include <pthread.h>
+#  include <signal.h>
+#  include <unistd.h>
+#  if defined(__linux__)
+#    include <sys/syscall.h>
+#  endif
+#endif
+
+namespace ultralight {
+
+std::atomic<bool> g_tracing_enabled{ false };
+
+namespace {
+
+struct TraceEvent {
+  const char* name;
+  uint64_t begin_ns;
+  uint64_t end_ns;
+};
+
+constexpr size_t kThreadRingCapacity = 16384;
+constexpr size_t kThreadNameLength = 32;
+
+// Buffers kept for finished threads whose zones haven't been written to a
+// trace file yet. Past this the oldest finished thread's zones are dropped.
+constexpr size_t kMaxThreadBuffers = 64;
+
+struct ThreadTraceBuffer {
+  uint64_t thread_id = 0;
+  char name[kThreadNameLength] = {}; // Guarded by g_buffers_mutex
+  TraceEvent ring[kThreadRingCapacity];
+  std::atomic<uint64_t> write_count{ 0 };   // Events published
+  std::atomic<uint64_t> writing_count{ 0 }; // Events published or being written
+  uint64_t finished_order = 0; // Guarded by g_buffers_mutex, 0 while the thread runs
+  bool flushed = false;        // Guarded by g_buffers_mutex, written out since finishing
+};
+
+std::mutex g_buffers_mutex;
+std::vector<ThreadTraceBuffer*> g_buffers;
+uint64_t g_finished_count = 0; // Guarded by g_buffers_mutex
+
+// Hands the thread's buffer back when the thread exits. Only constructed
+// once the thread records its first zone, so RecordZone() reads the plain
+// pointer below instead of paying for a thread_local with a destructor.
+struct ThreadBufferOwner {
+  ThreadTraceBuffer* buffer = nullptr;
+  ~ThreadBufferOwner();
+};
+
+thread_local ThreadTraceBuffer* t_buffer = nullptr;
+thread_local bool t_exited = false;
+thread_local char t_thread_name[kThreadNameLength] = {};
+
+#if !defined(_WIN32)
+std::mutex g_signal_mutex;
+std::string g_signal_path;
+volatile sig_atomic_t g_signal_pending = 0;
+#endif
+
+uint64_t CurrentThreadId() {
+#if defined(_WIN32)
+  return GetCurrentThreadId();
+#elif defined(__linux__)
+  return (uint64_t)syscall(SYS_gettid);
+#else
+  uint64_t id = 0;
+  pthread_threadid_np(nullptr, &id);
+  return id;
+#endif
+}
+
+uint64_t CurrentProcessId() {
+#if defined(_WIN32)
+  return GetCurrentProcessId();
+#else
+  return (uint64_t)getpid();
+#endif
+}
+
+ThreadBufferOwner::~ThreadBufferOwner() {
+  t_buffer = nullptr;
+  t_exited = true;
+
+  std::lock_guard<std::mutex> lock(g_buffers_mutex);
+  buffer->finished_order = ++g_finished_count;
+}
+
+// Returns a finished thread's buffer to reuse, preferring ones already
+// written to a trace file, or null. Call with g_buffers_mutex held.
+ThreadTraceBuffer* FindReusableBuffer() {
+  ThreadTraceBuffer* oldest = nullptr;
+  for (ThreadTraceBuffer* buffer : g_buffers) {
+    if (!buffer->finished_order)
+      continue;
+    if (buffer->flushed)
+      return buffer;
+    if (!oldest || buffer->finished_order < oldest->finished_order)
+      oldest = buffer;
+  }
+  return g_buffers.size() >= kMaxThreadBuffers ? oldest : nullptr;
+}
+
+ThreadTraceBuffer* GetThreadBuffer() {
+  if (t_buffer)
+    return t_buffer;
+
+  // Zones recorded by other thread_local destructors after ours ran.
+  if (t_exited)
+    return nullptr;
+
+  uint64_t thread_id = CurrentThreadId();
+  thread_local ThreadBufferOwner owner;
+
+  std::lock_guard<std::mutex> lock(g_buffers_mutex);
+  ThreadTraceBuffer* buffer = FindReusableBuffer();
+  if (buffer) {
+    buffer->write_count.store(0, std::memory_order_relaxed);
+    buffer->writing_count.store(0, std::memory_order_relaxed);
+    buffer->finished_order = 0;
+    buffer->flushed = false;
+  } else {
+    buffer = new ThreadTraceBuffer();
+    g_buffers.push_back(buffer);
+  }
+  buffer->thread_id = thread_id;
+  memcpy(buffer->name, t_thread_name, kThreadNameLength);
+  owner.buffer = buffer;
+  t_buffer = buffer;
+  return buffer;
+}
+
+void AppendEscaped(std::string& out, const char* str) {
+  for (; *str; str++) {
+    char c = *str;
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if ((unsigned char)c < 0x20) {
+      out += ' ';
+    } else {
+      out += c;
+    }
+  }
+}
+
+// Copies the events still in a thread's ring, dropping any the owning thread
+// overwrote while we were copying.
+void CopyEvents(const ThreadTraceBuffer& buffer, std::vector<TraceEvent>& events) {
+  events.clear();
+  uint64_t end = buffer.write_count.load(std::memory_order_acquire);
+  uint64_t begin = end > kThreadRingCapacity ? end - kThreadRingCapacity : 0;
+
+  for (uint64_t i = begin; i < end; i++)
+    events.push_back(buffer.ring[i % kThreadRingCapacity]);
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t writing = buffer.writing_count.load(std::memory_order_relaxed);
+  uint64_t first_valid = writing > kThreadRingCapacity ? writing - kThreadRingCapacity : 0;
+  if (first_valid > begin)
+    events.erase(events.begin(), events.begin() + (size_t)std::min(first_valid - begin, end - begin));
+}
+
+#if !defined(_WIN32)
+void TraceSignalHandler(int) {
+  g_signal_pending = 1;
+}
+#endif
+
+}  // namespace
+
+uint64_t TraceRecorder::NowNs() {
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceRecorder::RecordZone(const char* name, uint64_t begin_ns, uint64_t end_ns) {
+  ThreadTraceBuffer* buffer = GetThreadBuffer();
+  if (!buffer)
+    return;
+
+  uint64_t index = buffer->write_count.load(std::memory_order_relaxed);
+
+  buffer->writing_count.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  buffer->ring[index % kThreadRingCapacity] = { name, begin_ns, end_ns };
+  buffer->write_count.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::SetThreadName(const char* name) {
+  strncpy(t_thread_name, name, kThreadNameLength - 1);
+  t_thread_name[kThreadNameLength - 1] = 0;
+
+  if (t_buffer) {
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    memcpy(t_buffer->name, t_thread_name, kThreadNameLength);
+  }
+}
+
+void TraceRecorder::ProcessPendingSignal() {
+#if !defined(_WIN32)
+  if (!g_signal_pending)
+    return;
+  g_signal_pending = 0;
+
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(g_signal_mutex);
+    path = g_signal_path;
+  }
+
+  if (!path.empty())
+    WriteTraceFile(path.c_str());
+#endif
+}
+
+void EnableTracing(bool enabled) {
+  g_tracing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsTracingEnabled() {
+  return g_tracing_enabled.load(std::memory_order_relaxed);
+}
+
+bool WriteTraceFile(const char* path) {
+  if (!path)
+    return false;
+
+  FILE* file = fopen(path, "wb");
+  if (!file)
+    return false;
+
+  uint64_t pid = CurrentProcessId();
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  bool first = true;
+  bool written = true;
+  char buffer[128];
+  std::vector<TraceEvent> events;
+  events.reserve(kThreadRingCapacity);
+
+  std::lock_guard<std::mutex> lock(g_buffers_mutex);
+  for (ThreadTraceBuffer* thread : g_buffers) {
+    if (thread->name[0]) {
+      snprintf(buffer, sizeof(buffer),
+        "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%llu,\"tid\":%llu,\"args\":{\"name\":\"",
+        first ? "" : ",\n", (unsigned long long)pid, (unsigned long long)thread->thread_id);
+      json += buffer;
+      AppendEscaped(json, thread->name);
+      json += "\"}}";
+      first = false;
+    }
+
+    CopyEvents(*thread, events);
+    for (auto& event : events) {
+      json += first ? "{\"ph\":\"X\",\"name\":\"" : ",\n{\"ph\":\"X\",\"name\":\"";
+      AppendEscaped(json, event.name);
+      snprintf(buffer, sizeof(buffer), "\",\"pid\":%llu,\"tid\":%llu,\"ts\":%.3f,\"dur\":%.3f}",
+        (unsigned long long)pid, (unsigned long long)thread->thread_id, event.begin_ns / 1000.0,
+        (event.end_ns - event.begin_ns) / 1000.0);
+      json += buffer;
+      first = false;
+    }
+
+    // Keep memory bounded on apps with many threads.
+    if (json.size() > (1 << 20)) {
+      written &= fwrite(json.data(), 1, json.size(), file) == json.size();
+      json.clear();
+    }
+  }
+
+  json += "\n]}\n";
+  written &= fwrite(json.data(), 1, json.size(), file) == json.size();
+  written &= fclose(file) == 0;
+
+  // Finished threads' zones are on disk now, their buffers can be reused.
+  if (written) {
+    for (ThreadTraceBuffer* thread : g_buffers) {
+      if (thread->finished_order)
+        thread->flushed = true;
+    }
+  }
+  return written;
+}
+
+void SetTraceSignal(int signal, const char* path) {
+#if !defined(_WIN32)
+  {
+    std::lock_guard<std::mutex> lock(g_signal_mutex);
+    g_signal_path = path ? path : "";
+  }
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  action.sa_handler = path ? TraceSignalHandler : SIG_DFL;
+  sigaction(signal, &action, nullptr);
+#endif
+}
+
+}  // namespace ultralight
@@ -0,0 +1,61 @@
+#pragma once
+#include <AppCore/Tracing.h>
+#include <atomic>
+#include <cstdint>
+
+namespace ultralight {
+
+// Set by EnableTracing(), read on every zone.
+extern std::atomic<bool> g_tracing_enabled;
+
+///
+/// Backend of the public tracing API (AppCore/Tracing.h).
+///
+/// Zones are appended to a ring owned by the recording thread, so recording
+/// never takes a lock. A thread's ring is allocated the first time it records
+/// a zone with tracing enabled and outlives the thread, so zones of finished
+/// threads still make it into the trace file. Once they have been written,
+/// the ring is reused by the next new thread; past a fixed number of rings
+/// the oldest finished thread's zones are dropped instead.
+///
+class TraceRecorder {
+public:
+  static uint64_t NowNs();
+
+  // 'name' must outlive the recorder (use string literals).
+  static void RecordZone(const char* name, uint64_t begin_ns, uint64_t end_ns);
+
+  // Names the calling thread in trace files. 'name' is copied.
+  static void SetThreadName(const char* name);
+
+  // Writes the trace file requested by SetTraceSignal(), if the signal
+  // arrived since the last call. Called from the app's update loop.
+  static void ProcessPendingSignal();
+};
+
+// Records the enclosing scope as a zone while tracing is enabled.
+class ScopedTraceZone {
+public:
+  explicit ScopedTraceZone(const char* name)
+    : name_(g_tracing_enabled.load(std::memory_order_relaxed) ? name : nullptr),
+      begin_ns_(name_ ? TraceRecorder::NowNs() : 0) {}
+
+  ~ScopedTraceZone() {
+    if (name_)
+      TraceRecorder::RecordZone(name_, begin_ns_, TraceRecorder::NowNs());
+  }
+
+private:
+  const char* name_;
+  uint64_t begin_ns_;
+};
+
+}  // namespace ultralight
+
+#define TRACE_ZONE_CONCAT_(a, b) a##b
+#define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT_(a, b)
+
+// TraceZone("Class::Method"); at the top of a scope. Unlike ProfiledZone this
+// is compiled into every build and recorded only while tracing is enabled.
+#define TraceZone(name) \
+  ::ultralight::ScopedTraceZone TRACE_ZONE_CONCAT(trace_zone_, __LINE__)(name)
@@ -1,4 +1,5 @@
 #include "ULTextureSurface.h"
+#include "TraceRecorder.h"
 #include <Ultralight/platform/Platform.h>
 #include <Ultralight/platform/GPUDriver.h>
 #include <iostream>
@@ -70,6 +71,8 @@ public:
     if (!NeedsSynchronize()) 
       return false;
 
+    TraceZone("ULTextureSurface::Synchronize");
+
     if (texture_id_ == 0) {
       texture_id_ = gpu_driver->NextTextureId();
       gpu_driver->CreateTexture(texture_id_, bitmap_);
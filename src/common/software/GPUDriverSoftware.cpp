@@ -0,0 +1,318 @@
+#include "GPUDriverSoftware.h"
+#include <Ultralight/private/tracy/Tracy.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace ultralight {
+
+GPUDriverSoftware::GPUDriverSoftware(uint32_t worker_count) : rasterizer_(worker_count) {}
+
+GPUDriverSoftware::~GPUDriverSoftware() {}
+
+void GPUDriverSoftware::CreateTexture(uint32_t texture_id, RefPtr<Bitmap> bitmap) {
+  TextureEntry& entry = texture_map[texture_id];
+
+  if (bitmap->IsEmpty()) {
+    // Render target, starts out transparent like a freshly cleared FBO.
+    entry.bitmap = Bitmap::Create(bitmap->width(), bitmap->height(), BitmapFormat::BGRA8_UNORM_SRGB);
+    entry.is_render_target = true;
+    void* pixels = entry.bitmap->LockPixels();
+    memset(pixels, 0, entry.bitmap->size());
+    entry.bitmap->UnlockPixels();
+    return;
+  }
+
+  entry.bitmap = Bitmap::Create(bitmap->width(), bitmap->height(), bitmap->format());
+  entry.is_render_target = false;
+  CopyBitmap(bitmap.get(), entry.bitmap.get());
+}
+
+void GPUDriverSoftware::UpdateTexture(uint32_t texture_id, RefPtr<Bitmap> bitmap) {
+  auto i = texture_map.find(texture_id);
+  if (i == texture_map.end())
+    return;
+
+  TextureEntry& entry = i->second;
+  if (entry.bitmap->width() != bitmap->width() || entry.bitmap->height() != bitmap->height() ||
+      entry.bitmap->format() != bitmap->format())
+    entry.bitmap = Bitmap::Create(bitmap->width(), bitmap->height(), bitmap->format());
+
+  CopyBitmap(bitmap.get(), entry.bitmap.get());
+}
+
+void GPUDriverSoftware::DestroyTexture(uint32_t texture_id) {
+  texture_map.erase(texture_id);
+}
+
+void GPUDriverSoftware::CreateRenderBuffer(uint32_t render_buffer_id, const RenderBuffer& buffer) {
+  if (render_buffer_id == 0)
+    return;
+
+  render_buffer_map[render_buffer_id] = buffer.texture_id;
+}
+
+void GPUDriverSoftware::ClearRenderBuffer(uint32_t render_buffer_id) {
+  // Draws recorded so far have to land before the clear.
+  rasterizer_.End();
+
+  SurfaceSW surface;
+  if (!GetSurface(render_buffer_id, surface))
+    return;
+
+  for (uint32_t y = 0; y < surface.height; y++)
+    memset(surface.pixels + (size_t)y * surface.row_bytes, 0, surface.width * 4);
+}
+
+void GPUDriverSoftware::DestroyRenderBuffer(uint32_t render_buffer_id) {
+  render_buffer_map.erase(render_buffer_id);
+}
+
+void GPUDriverSoftware::CreateGeometry(uint32_t geometry_id, const VertexBuffer& vertices,
+                                       const IndexBuffer& indices) {
+  GeometryEntry& entry = geometry_map[geometry_id];
+  entry.format = vertices.format;
+  entry.vertices.assign(vertices.data, vertices.data + vertices.size);
+  entry.indices.resize(indices.size / sizeof(IndexType));
+  memcpy(entry.indices.data(), indices.data, entry.indices.size() * sizeof(IndexType));
+}
+
+void GPUDriverSoftware::UpdateGeometry(uint32_t geometry_id, const VertexBuffer& vertices,
+                                       const IndexBuffer& indices) {
+  CreateGeometry(geometry_id, vertices, indices);
+}
+
+void GPUDriverSoftware::DrawGeometry(uint32_t geometry_id, uint32_t indices_count,
+                                     uint32_t indices_offset, const GPUState& state) {
+  auto geometry = geometry_map.find(geometry_id);
+  if (geometry == geometry_map.end())
+    return;
+
+  const GeometryEntry& entry = geometry->second;
+  if ((uint64_t)indices_offset + indices_count > entry.indices.size())
+    return;
+
+  // A batch only draws to one target, and a draw that samples the target has
+  // to see everything drawn to it so far. It reads a snapshot taken after the
+  // flush, the batch's tiles write the target while other tiles are shaded.
+  uint32_t target_texture_id = 0;
+  if (state.render_buffer_id) {
+    auto i = render_buffer_map.find(state.render_buffer_id);
+    if (i == render_buffer_map.end())
+      return;
+    target_texture_id = i->second;
+  }
+
+  bool samples_target = target_texture_id &&
+    (state.texture_1_id == target_texture_id || state.texture_2_id == target_texture_id);
+
+  if (!rasterizer_.has_target() || state.render_buffer_id != current_render_buffer_id_ || samples_target) {
+    SurfaceSW surface;
+    if (!GetSurface(state.render_buffer_id, surface)) {
+      rasterizer_.End();
+      return;
+    }
+    rasterizer_.Begin(surface);
+    current_render_buffer_id_ = state.render_buffer_id;
+    if (samples_target)
+      SnapshotSurface(surface);
+  }
+
+  DrawSW draw;
+  draw.shader.shader_type = (ShaderType)state.shader_type;
+  memcpy(draw.shader.integer, state.uniform_integer, sizeof(draw.shader.integer));
+  memcpy(draw.shader.scalar, state.uniform_scalar, sizeof(draw.shader.scalar));
+  static_assert(sizeof(state.uniform_vector) == sizeof(draw.shader.vector), "vec4 must be four floats");
+  memcpy(draw.shader.vector, state.uniform_vector, sizeof(draw.shader.vector));
+  draw.shader.clip_size = std::min<uint32_t>(state.clip_size, 8);
+  for (uint32_t i = 0; i < draw.shader.clip_size; i++)
+    memcpy(draw.shader.clip[i], state.clip[i].data, sizeof(draw.shader.clip[i]));
+  draw.shader.textures[0] = GetTextureView(state.texture_1_id);
+  draw.shader.textures[1] = GetTextureView(state.texture_2_id);
+  if (samples_target && state.texture_1_id == target_texture_id)
+    draw.shader.textures[0].pixels = target_snapshot_.data();
+  if (samples_target && state.texture_2_id == target_texture_id)
+    draw.shader.textures[1].pixels = target_snapshot_.data();
+
+  memcpy(draw.transform, state.transform.data, sizeof(draw.transform));
+
+  draw.bounds.left = 0;
+  draw.bounds.top = 0;
+  draw.bounds.right = (int)state.viewport_width;
+  draw.bounds.bottom = (int)state.viewport_height;
+  if (state.enable_scissor) {
+    const IntRect& r = state.scissor_rect;
+    draw.bounds.left = std::max(draw.bounds.left, r.left);
+    draw.bounds.top = std::max(draw.bounds.top, r.top);
+    draw.bounds.right = std::min(draw.bounds.right, r.right);
+    draw.bounds.bottom = std::min(draw.bounds.bottom, r.bottom);
+  }
+
+  draw.enable_blend = state.enable_blend;
+  draw.blend_src_factor = state.blend_src_factor;
+  draw.blend_dst_factor = state.blend_dst_factor;
+  draw.blend_equation = state.blend_equation;
+
+  rasterizer_.AddDraw(draw, entry.format, entry.vertices.data(),
+    (uint32_t)(entry.vertices.size() / VertexStrideSW(entry.format)), entry.indices.data() + indices_offset,
+    indices_count);
+}
+
+void GPUDriverSoftware::DestroyGeometry(uint32_t geometry_id) {
+  geometry_map.erase(geometry_id);
+}
+
+void GPUDriverSoftware::DrawCommandList() {
+  ProfiledZone;
+
+  if (!command_arena_.has_pending())
+    return;
+
+  batch_count_ = 0;
+  LockTextures();
+
+  for (auto& cmd : command_arena_.Acquire()) {
+    if (cmd.command_type == CommandType::DrawGeometry)
+      DrawGeometry(cmd.geometry_id, cmd.indices_count, cmd.indices_offset, cmd.gpu_state);
+    else if (cmd.command_type == CommandType::ClearRenderBuffer)
+      ClearRenderBuffer(cmd.gpu_state.render_buffer_id);
+    batch_count_++;
+  }
+
+  rasterizer_.End();
+  current_render_buffer_id_ = 0;
+  UnlockTextures();
+}
+
+GPUMemoryStats GPUDriverSoftware::memory_stats() const {
+  GPUMemoryStats stats;
+
+  for (auto& i : texture_map) {
+    if (i.second.is_render_target)
+      stats.render_target_bytes += i.second.bitmap->size();
+    else
+      stats.texture_bytes += i.second.bitmap->size();
+  }
+
+  for (auto& i : geometry_map)
+    stats.geometry_bytes += i.second.vertices.size() + i.second.indices.size() * sizeof(IndexType);
+
+  stats.texture_count = (uint32_t)texture_map.size();
+  stats.render_buffer_count = (uint32_t)render_buffer_map.size();
+  stats.geometry_count = (uint32_t)geometry_map.size();
+  return stats;
+}
+
+std::vector<GPUDriverImpl::ResourceUsage> GPUDriverSoftware::TopMemoryConsumers(size_t max_count) const {
+  std::vector<ResourceUsage> result;
+  result.reserve(texture_map.size() + geometry_map.size());
+
+  for (auto& i : texture_map) {
+    result.push_back({ i.second.is_render_target ? "render target" : "texture", i.first,
+                       (uint64_t)i.second.bitmap->size() });
+  }
+
+  for (auto& i : geometry_map) {
+    result.push_back({ "geometry", i.first,
+                       i.second.vertices.size() + i.second.indices.size() * sizeof(IndexType) });
+  }
+
+  size_t count = std::min(max_count, result.size());
+  std::partial_sort(result.begin(), result.begin() + count, result.end(),
+    [](const ResourceUsage& a, const ResourceUsage& b) { return a.bytes > b.bytes; });
+  result.resize(count);
+  return result;
+}
+
+RefPtr<Bitmap> GPUDriverSoftware::texture_bitmap(uint32_t texture_id) const {
+  auto i = texture_map.find(texture_id);
+  if (i == texture_map.end())
+    return nullptr;
+  return i->second.bitmap;
+}
+
+void GPUDriverSoftware::CopyBitmap(Bitmap* source, Bitmap* dest) {
+  const uint8_t* src = (const uint8_t*)source->LockPixels();
+  uint8_t* dst = (uint8_t*)dest->LockPixels();
+  uint32_t row_size = std::min(source->row_bytes(), dest->row_bytes());
+
+  for (uint32_t y = 0; y < dest->height(); y++)
+    memcpy(dst + (size_t)y * dest->row_bytes(), src + (size_t)y * source->row_bytes(), row_size);
+
+  dest->UnlockPixels();
+  source->UnlockPixels();
+}
+
+bool GPUDriverSoftware::GetSurface(uint32_t render_buffer_id, SurfaceSW& surface) {
+  Bitmap* bitmap = nullptr;
+  uint8_t* pixels = nullptr;
+
+  if (render_buffer_id == 0) {
+    bitmap = default_render_target_.get();
+    pixels = default_render_target_pixels_;
+  } else {
+    auto rbuf = render_buffer_map.find(render_buffer_id);
+    if (rbuf == render_buffer_map.end())
+      return false;
+    auto tex = texture_map.find(rbuf->second);
+    if (tex == texture_map.end())
+      return false;
+    bitmap = tex->second.bitmap.get();
+    pixels = tex->second.locked_pixels;
+  }
+
+  if (!bitmap || !pixels || bitmap->format() != BitmapFormat::BGRA8_UNORM_SRGB)
+    return false;
+
+  surface.pixels = pixels;
+  surface.width = bitmap->width();
+  surface.height = bitmap->height();
+  surface.row_bytes = bitmap->row_bytes();
+  return true;
+}
+
+void GPUDriverSoftware::SnapshotSurface(const SurfaceSW& surface) {
+  // Same row pitch as the target so texture views can point at either.
+  target_snapshot_.resize((size_t)surface.row_bytes * surface.height);
+  memcpy(target_snapshot_.data(), surface.pixels, target_snapshot_.size());
+}
+
+TextureViewSW GPUDriverSoftware::GetTextureView(uint32_t texture_id) {
+  TextureViewSW view;
+  auto i = texture_map.find(texture_id);
+  if (i == texture_map.end() || !i->second.locked_pixels)
+    return view;
+
+  Bitmap* bitmap = i->second.bitmap.get();
+  view.pixels = i->second.locked_pixels;
+  view.width = bitmap->width();
+  view.height = bitmap->height();
+  view.row_bytes = bitmap->row_bytes();
+  view.alpha_only = bitmap->format() == BitmapFormat::A8_UNORM;
+  return view;
+}
+
+void GPUDriverSoftware::LockTextures() {
+  // Textures are only created or updated during Synchronize, so every pixel
+  // pointer stays put until UnlockTextures().
+  for (auto& i : texture_map)
+    i.second.locked_pixels = (uint8_t*)i.second.bitmap->LockPixels();
+
+  if (default_render_target_)
+    default_render_target_pixels_ = (uint8_t*)default_render_target_->LockPixels();
+}
+
+void GPUDriverSoftware::UnlockTextures() {
+  for (auto& i : texture_map) {
+    if (i.second.locked_pixels) {
+      i.second.bitmap->UnlockPixels();
+      i.second.locked_pixels = nullptr;
+    }
+  }
+
+  if (default_render_target_pixels_) {
+    default_render_target_->UnlockPixels();
+    default_render_target_pixels_ = nullptr;
+  }
+}
+
+}  // namespace ultralight
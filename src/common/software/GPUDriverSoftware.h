@@ -0,0 +1,120 @@
+#pragma once
+#include "GPUDriverImpl.h"
+#include "RasterizerSoftware.h"
+#include <Ultralight/Bitmap.h>
+#include <map>
+#include <vector>
+
+namespace ultralight {
+
+//
+// GPUDriver that executes command lists on the CPU, for machines without a
+// GPU (CI, render servers) and for comparing command list output against
+// reference images.
+//
+// Textures and render buffers live in Bitmaps owned by the driver. Draws go
+// through RasterizerSoftware, which splits each run of draws to the same
+// render buffer into tiles shaded on a thread pool. Output is deterministic:
+// it doesn't depend on the number of worker threads.
+//
+// Draws to render buffer 0 (the window) go to the bitmap set with
+// set_default_render_target(), or are dropped if there isn't one.
+//
+class GPUDriverSoftware : public GPUDriverImpl {
+public:
+  // 'worker_count' threads rasterize alongside the thread calling
+  // DrawCommandList(). Pass 0 to rasterize on that thread only.
+  explicit GPUDriverSoftware(uint32_t worker_count = TilePool::DefaultWorkerCount());
+
+  virtual ~GPUDriverSoftware();
+
+  virtual const char* name() override { return "Software"; }
+
+  virtual void BeginDrawing() override {}
+
+  virtual void EndDrawing() override {}
+
+  virtual void CreateTexture(uint32_t texture_id,
+    RefPtr<Bitmap> bitmap) override;
+
+  virtual void UpdateTexture(uint32_t texture_id,
+    RefPtr<Bitmap> bitmap) override;
+
+  virtual void BindTexture(uint8_t texture_unit,
+    uint32_t texture_id) override {}
+
+  virtual void DestroyTexture(uint32_t texture_id) override;
+
+  virtual void CreateRenderBuffer(uint32_t render_buffer_id,
+    const RenderBuffer& buffer) override;
+
+  virtual void BindRenderBuffer(uint32_t render_buffer_id) override {}
+
+  virtual void ClearRenderBuffer(uint32_t render_buffer_id) override;
+
+  virtual void DestroyRenderBuffer(uint32_t render_buffer_id) override;
+
+  virtual void CreateGeometry(uint32_t geometry_id,
+    const VertexBuffer& vertices,
+    const IndexBuffer& indices) override;
+
+  virtual void UpdateGeometry(uint32_t geometry_id,
+    const VertexBuffer& vertices,
+    const IndexBuffer& indices) override;
+
+  virtual void DrawGeometry(uint32_t geometry_id,
+    uint32_t indices_count,
+    uint32_t indices_offset,
+    const GPUState& state) override;
+
+  virtual void DestroyGeometry(uint32_t geometry_id) override;
+
+  virtual void DrawCommandList() override;
+
+  virtual GPUMemoryStats memory_stats() const override;
+
+  virtual std::vector<ResourceUsage> TopMemoryConsumers(size_t max_count) const override;
+
+  // Target for draws to render buffer 0. Must be BGRA8_UNORM_SRGB.
+  void set_default_render_target(RefPtr<Bitmap> bitmap) { default_render_target_ = bitmap; }
+
+  RefPtr<Bitmap> default_render_target() const { return default_render_target_; }
+
+  // Pixels of a texture or render buffer texture, null if the ID is unknown.
+  // Only read it between DrawCommandList() calls.
+  RefPtr<Bitmap> texture_bitmap(uint32_t texture_id) const;
+
+  const RasterizerSoftware::Stats& raster_stats() const { return rasterizer_.stats(); }
+
+protected:
+  struct TextureEntry {
+    RefPtr<Bitmap> bitmap;
+    bool is_render_target = false;
+    uint8_t* locked_pixels = nullptr; // Only set during DrawCommandList()
+  };
+
+  struct GeometryEntry {
+    VertexBufferFormat format;
+    std::vector<uint8_t> vertices;
+    std::vector<IndexType> indices;
+  };
+
+  void CopyBitmap(Bitmap* source, Bitmap* dest);
+  bool GetSurface(uint32_t render_buffer_id, SurfaceSW& surface);
+  TextureViewSW GetTextureView(uint32_t texture_id);
+  void SnapshotSurface(const SurfaceSW& surface);
+  void LockTextures();
+  void UnlockTextures();
+
+  std::map<uint32_t, TextureEntry> texture_map;
+  std::map<uint32_t, uint32_t> render_buffer_map; // Render buffer ID -> texture ID
+  std::map<uint32_t, GeometryEntry> geometry_map;
+
+  RefPtr<Bitmap> default_render_target_;
+  uint8_t* default_render_target_pixels_ = nullptr; // Only set during DrawCommandList()
+  uint32_t current_render_buffer_id_ = 0; // Target of the rasterizer's open batch
+  std::vector<uint8_t> target_snapshot_; // Sampled instead of the open batch's target
+  RasterizerSoftware rasterizer_;
+};
+
+}  // namespace ultralight
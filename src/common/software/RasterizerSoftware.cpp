@@ -0,0 +1,445 @@
+#include "RasterizerSoftware.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SW_SSE2 1
+#include <emmintrin.h>
+#endif
+// AVX2 is picked at run time, the build only targets the baseline ISA.
+#if SW_SSE2 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SW_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace ultralight {
+
+namespace {
+
+const int32_t kTileSize = 64;
+
+#if SW_SSE2
+const int32_t kLanes = 4;
+#else
+const int32_t kLanes = 1;
+#endif
+
+#if SW_AVX2
+const int32_t kAVX2Lanes = 8;
+
+bool CPUSupportsAVX2() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+#endif
+
+inline uint32_t CountTrailingZeros(uint32_t mask) {
+#if defined(__GNUC__)
+  return (uint32_t)__builtin_ctz(mask);
+#else
+  uint32_t count = 0;
+  while (!(mask & 1)) {
+    mask >>= 1;
+    count++;
+  }
+  return count;
+#endif
+}
+
+//
+// Four-wide float vector for blending, RGBA order.
+//
+
+#if SW_SSE2
+struct V4 { __m128 v; };
+inline V4 Make(float r, float g, float b, float a) { return { _mm_setr_ps(r, g, b, a) }; }
+inline V4 Splat(float s) { return { _mm_set1_ps(s) }; }
+inline V4 SplatAlpha(V4 a) { return { _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(3, 3, 3, 3)) }; }
+inline V4 operator+(V4 a, V4 b) { return { _mm_add_ps(a.v, b.v) }; }
+inline V4 operator-(V4 a, V4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline V4 operator*(V4 a, V4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline V4 Min(V4 a, V4 b) { return { _mm_min_ps(a.v, b.v) }; }
+inline V4 Max(V4 a, V4 b) { return { _mm_max_ps(a.v, b.v) }; }
+inline V4 Load(const Color4SW& c) { return { _mm_load_ps(&c.r) }; }
+inline float FirstLane(V4 a) { return _mm_cvtss_f32(a.v); }
+
+inline V4 UnpackBGRA(const uint8_t* p) {
+  int32_t packed;
+  memcpy(&packed, p, 4);
+  __m128i zero = _mm_setzero_si128();
+  __m128i px = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+  __m128 bgra = _mm_mul_ps(_mm_cvtepi32_ps(px), _mm_set1_ps(1.0f / 255.0f));
+  return { _mm_shuffle_ps(bgra, bgra, _MM_SHUFFLE(3, 0, 1, 2)) };
+}
+
+inline void PackBGRA(V4 c, uint8_t* p) {
+  __m128 rgba = _mm_min_ps(_mm_max_ps(c.v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  __m128 bgra = _mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(3, 0, 1, 2));
+  __m128i px = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(bgra, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+  px = _mm_packs_epi32(px, px);
+  px = _mm_packus_epi16(px, px);
+  int32_t packed = _mm_cvtsi128_si32(px);
+  memcpy(p, &packed, 4);
+}
+#else
+struct V4 { float v[4]; };
+inline V4 Make(float r, float g, float b, float a) { return { { r, g, b, a } }; }
+inline V4 Splat(float s) { return { { s, s, s, s } }; }
+inline V4 SplatAlpha(V4 a) { return Splat(a.v[3]); }
+#define SW_V4_OP(name, expr) \
+  inline V4 name(V4 a, V4 b) { V4 r; for (int i = 0; i < 4; i++) r.v[i] = expr; return r; }
+SW_V4_OP(operator+, a.v[i] + b.v[i])
+SW_V4_OP(operator-, a.v[i] - b.v[i])
+SW_V4_OP(operator*, a.v[i] * b.v[i])
+SW_V4_OP(Min, std::min(a.v[i], b.v[i]))
+SW_V4_OP(Max, std::max(a.v[i], b.v[i]))
+#undef SW_V4_OP
+inline V4 Load(const Color4SW& c) { return Make(c.r, c.g, c.b, c.a); }
+inline float FirstLane(V4 a) { return a.v[0]; }
+
+inline V4 UnpackBGRA(const uint8_t* p) {
+  const float s = 1.0f / 255.0f;
+  return Make(p[2] * s, p[1] * s, p[0] * s, p[3] * s);
+}
+
+inline void PackBGRA(V4 c, uint8_t* p) {
+  static const int order[4] = { 2, 1, 0, 3 };
+  for (int i = 0; i < 4; i++)
+    p[i] = (uint8_t)(std::min(std::max(c.v[order[i]], 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+#endif
+
+V4 BlendFactorValue(BlendFactor factor, V4 src, V4 dst) {
+  V4 one = Splat(1.0f);
+  switch (factor) {
+  case BlendFactor::Zero: return Splat(0.0f);
+  case BlendFactor::One: return one;
+  case BlendFactor::SrcColor: return src;
+  case BlendFactor::InvSrcColor: return one - src;
+  case BlendFactor::SrcAlpha: return SplatAlpha(src);
+  case BlendFactor::InvSrcAlpha: return one - SplatAlpha(src);
+  case BlendFactor::DestColor: return dst;
+  case BlendFactor::InvDestColor: return one - dst;
+  case BlendFactor::DestAlpha: return SplatAlpha(dst);
+  case BlendFactor::InvDestAlpha: return one - SplatAlpha(dst);
+  case BlendFactor::SrcAlphaSaturate: {
+    float f = FirstLane(Min(SplatAlpha(src), one - SplatAlpha(dst)));
+    return Make(f, f, f, 1.0f);
+  }
+  }
+  return one;
+}
+
+inline void BlendAndStore(const DrawSW& draw, const Color4SW& color, uint8_t* pixel) {
+  V4 src = Load(color);
+  if (!draw.enable_blend) {
+    PackBGRA(src, pixel);
+    return;
+  }
+
+  V4 dst = UnpackBGRA(pixel);
+  V4 s = src * BlendFactorValue(draw.blend_src_factor, src, dst);
+  V4 d = dst * BlendFactorValue(draw.blend_dst_factor, src, dst);
+  V4 result;
+
+  switch (draw.blend_equation) {
+  case BlendEquation::Subtract: result = s - d; break;
+  case BlendEquation::RevSubtract: result = d - s; break;
+  case BlendEquation::Min: result = Min(src, dst); break;
+  case BlendEquation::Max: result = Max(src, dst); break;
+  default: result = s + d; break;
+  }
+
+  PackBGRA(result, pixel);
+}
+
+#if SW_AVX2
+// CoverageMask() for 8 pixels, only call when CPUSupportsAVX2().
+__attribute__((target("avx2")))
+uint32_t CoverageMaskAVX2(const float (&edge)[3][3], const bool (&top_left)[3], int32_t x, float py) {
+  __m256 px = _mm256_add_ps(_mm256_set1_ps(x + 0.5f), _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7));
+  __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+  for (int i = 0; i < 3; i++) {
+    __m256 w = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edge[i][0]), px),
+                             _mm256_set1_ps(edge[i][1] * py + edge[i][2]));
+    __m256 covered = top_left[i] ? _mm256_cmp_ps(w, _mm256_setzero_ps(), _CMP_GE_OQ) :
+                                   _mm256_cmp_ps(w, _mm256_setzero_ps(), _CMP_GT_OQ);
+    inside = _mm256_and_ps(inside, covered);
+  }
+  return (uint32_t)_mm256_movemask_ps(inside);
+}
+#endif
+
+// Bit N is set if pixel (x + N, y) is inside the triangle. 'py' is the row's
+// pixel center.
+inline uint32_t CoverageMask(const float (&edge)[3][3], const bool (&top_left)[3], int32_t x, float py) {
+#if SW_SSE2
+  __m128 px = _mm_add_ps(_mm_set1_ps(x + 0.5f), _mm_setr_ps(0, 1, 2, 3));
+  __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+  for (int i = 0; i < 3; i++) {
+    __m128 w = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edge[i][0]), px), _mm_set1_ps(edge[i][1] * py + edge[i][2]));
+    inside = _mm_and_ps(inside, top_left[i] ? _mm_cmpge_ps(w, _mm_setzero_ps()) : _mm_cmpgt_ps(w, _mm_setzero_ps()));
+  }
+  return (uint32_t)_mm_movemask_ps(inside);
+#else
+  float px = x + 0.5f;
+  for (int i = 0; i < 3; i++) {
+    float w = edge[i][0] * px + edge[i][1] * py + edge[i][2];
+    if (top_left[i] ? w < 0.0f : w <= 0.0f)
+      return 0;
+  }
+  return 1;
+#endif
+}
+
+// out[k] = row[k] + ddx[k] * px for 'count' varyings (a multiple of 4).
+inline void EvaluatePlanes(const float* row, const float* ddx, float px, uint32_t count, float* out) {
+#if SW_SSE2
+  __m128 vx = _mm_set1_ps(px);
+  for (uint32_t k = 0; k < count; k += 4)
+    _mm_store_ps(out + k, _mm_add_ps(_mm_load_ps(row + k), _mm_mul_ps(_mm_loadu_ps(ddx + k), vx)));
+#else
+  for (uint32_t k = 0; k < count; k++)
+    out[k] = row[k] + ddx[k] * px;
+#endif
+}
+
+// Writes the vertex's target-space position to 'pos' and its outputs, in
+// VaryingsSW order, to 'varyings'.
+void FetchVertex(const DrawSW& draw, VertexBufferFormat format, const uint8_t* vertices,
+                 uint32_t index, float* pos, float* varyings) {
+  bool is_quad = format == VertexBufferFormat::_2f_4ub_2f_2f_28f;
+  const uint8_t* v = vertices + (size_t)index * VertexStrideSW(format);
+
+  float p[2];
+  memcpy(p, v, sizeof(p));
+  const float* t = draw.transform;
+  float w = t[3] * p[0] + t[7] * p[1] + t[15];
+  float inv_w = w != 0.0f ? 1.0f / w : 1.0f;
+  pos[0] = (t[0] * p[0] + t[4] * p[1] + t[12]) * inv_w;
+  pos[1] = (t[1] * p[0] + t[5] * p[1] + t[13]) * inv_w;
+
+  for (int i = 0; i < 4; i++)
+    varyings[i] = v[8 + i] * (1.0f / 255.0f);
+
+  if (is_quad) {
+    memcpy(varyings + 4, v + 12, sizeof(float) * (kQuadVaryingCount - 4));
+  } else {
+    varyings[4] = varyings[5] = 0.0f;
+    memcpy(varyings + 6, v + 12, sizeof(float) * 2);
+  }
+}
+
+}  // namespace
+
+RasterizerSoftware::RasterizerSoftware(uint32_t worker_count) : pool_(worker_count) {}
+
+void RasterizerSoftware::Begin(const SurfaceSW& target) {
+  Flush();
+  target_ = target;
+}
+
+void RasterizerSoftware::AddDraw(const DrawSW& draw, VertexBufferFormat format, const uint8_t* vertices,
+                                 uint32_t vertex_count, const IndexType* indices, uint32_t index_count) {
+  if (!target_.pixels)
+    return;
+
+  DrawSW clipped = draw;
+  IntRect& b = clipped.bounds;
+  b.left = std::max(b.left, 0);
+  b.top = std::max(b.top, 0);
+  b.right = std::min(b.right, (int)target_.width);
+  b.bottom = std::min(b.bottom, (int)target_.height);
+  if (b.left >= b.right || b.top >= b.bottom)
+    return;
+
+  uint32_t draw_index = (uint32_t)draws_.size();
+  draws_.push_back(clipped);
+
+  uint32_t varying_count = format == VertexBufferFormat::_2f_4ub_2f_2f_28f ? kQuadVaryingCount : kPathVaryingCount;
+  float pos[3][2];
+  float varyings[3][kQuadVaryingCount];
+
+  for (uint32_t i = 0; i + 2 < index_count; i += 3) {
+    if (indices[i] >= vertex_count || indices[i + 1] >= vertex_count || indices[i + 2] >= vertex_count)
+      continue;
+
+    for (int j = 0; j < 3; j++)
+      FetchVertex(clipped, format, vertices, indices[i + j], pos[j], varyings[j]);
+
+    SetupTriangle(draw_index, pos[0], pos[1], pos[2], varyings[0], varyings[1], varyings[2], varying_count);
+  }
+}
+
+void RasterizerSoftware::SetupTriangle(uint32_t draw_index, const float* p0, const float* p1, const float* p2,
+                                       const float* v0, const float* v1, const float* v2, uint32_t varying_count) {
+  float area = (p1[0] - p0[0]) * (p2[1] - p0[1]) - (p2[0] - p0[0]) * (p1[1] - p0[1]);
+  if (area == 0.0f || !std::isfinite(area))
+    return;
+
+  const IntRect& bounds = draws_[draw_index].bounds;
+  float min_x = std::min(p0[0], std::min(p1[0], p2[0]));
+  float min_y = std::min(p0[1], std::min(p1[1], p2[1]));
+  float max_x = std::max(p0[0], std::max(p1[0], p2[0]));
+  float max_y = std::max(p0[1], std::max(p1[1], p2[1]));
+
+  Triangle tri;
+  tri.draw = draw_index;
+  tri.min_x = (int32_t)std::floor(std::max(min_x, (float)bounds.left));
+  tri.min_y = (int32_t)std::floor(std::max(min_y, (float)bounds.top));
+  tri.max_x = (int32_t)std::ceil(std::min(max_x, (float)bounds.right));
+  tri.max_y = (int32_t)std::ceil(std::min(max_y, (float)bounds.bottom));
+  if (tri.min_x >= tri.max_x || tri.min_y >= tri.max_y)
+    return;
+
+  // Edge i is opposite vertex i. E(p0) for edge 0 equals the signed area, so
+  // flipping by its sign makes every edge positive on the inside.
+  const float* p[3] = { p0, p1, p2 };
+  float orientation = area > 0.0f ? 1.0f : -1.0f;
+  for (int i = 0; i < 3; i++) {
+    const float* a = p[(i + 1) % 3];
+    const float* b = p[(i + 2) % 3];
+    float A = (a[1] - b[1]) * orientation;
+    float B = (b[0] - a[0]) * orientation;
+    tri.edge[i][0] = A;
+    tri.edge[i][1] = B;
+    tri.edge[i][2] = (a[0] * b[1] - b[0] * a[1]) * orientation;
+    // Top-left rule: pixels on a left edge or a horizontal top edge (y grows
+    // downwards) belong to this triangle.
+    tri.top_left[i] = A > 0.0f || (A == 0.0f && B > 0.0f);
+  }
+
+  // Plane equations: value(x, y) = base + x * ddx + y * ddy.
+  tri.planes = (uint32_t)planes_.size();
+  tri.varying_count = varying_count;
+  planes_.resize(planes_.size() + varying_count * 3);
+  float* base = &planes_[tri.planes];
+  float* ddx = base + varying_count;
+  float* ddy = ddx + varying_count;
+  float inv_area = 1.0f / area;
+
+  for (uint32_t k = 0; k < varying_count; k++) {
+    float d1 = v1[k] - v0[k];
+    float d2 = v2[k] - v0[k];
+    ddx[k] = (d1 * (p2[1] - p0[1]) - d2 * (p1[1] - p0[1])) * inv_area;
+    ddy[k] = (d2 * (p1[0] - p0[0]) - d1 * (p2[0] - p0[0])) * inv_area;
+    base[k] = v0[k] - ddx[k] * p0[0] - ddy[k] * p0[1];
+  }
+
+  triangles_.push_back(tri);
+}
+
+void RasterizerSoftware::Flush() {
+  if (triangles_.empty()) {
+    draws_.clear();
+    planes_.clear();
+    return;
+  }
+
+  tiles_x_ = (target_.width + kTileSize - 1) / kTileSize;
+  uint32_t tiles_y = (target_.height + kTileSize - 1) / kTileSize;
+  uint32_t tile_count = tiles_x_ * tiles_y;
+  if (bins_.size() < tile_count)
+    bins_.resize(tile_count);
+  for (uint32_t i = 0; i < tile_count; i++)
+    bins_[i].clear();
+
+  for (uint32_t i = 0; i < (uint32_t)triangles_.size(); i++) {
+    const Triangle& tri = triangles_[i];
+    for (int32_t ty = tri.min_y / kTileSize; ty <= (tri.max_y - 1) / kTileSize; ty++) {
+      for (int32_t tx = tri.min_x / kTileSize; tx <= (tri.max_x - 1) / kTileSize; tx++)
+        bins_[ty * tiles_x_ + tx].push_back(i);
+    }
+  }
+
+  pixels_shaded_.store(0, std::memory_order_relaxed);
+  pool_.Run(tile_count, [this](uint32_t tile) { RasterizeTile(tile); });
+
+  stats_.batches++;
+  stats_.triangles += triangles_.size();
+  stats_.pixels_shaded += pixels_shaded_.load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i < tile_count; i++)
+    stats_.tiles += bins_[i].empty() ? 0 : 1;
+
+  triangles_.clear();
+  planes_.clear();
+  draws_.clear();
+}
+
+void RasterizerSoftware::End() {
+  Flush();
+  target_ = SurfaceSW();
+}
+
+void RasterizerSoftware::RasterizeTile(uint32_t tile) {
+  const std::vector<uint32_t>& bin = bins_[tile];
+  if (bin.empty())
+    return;
+
+  int32_t tile_x = (int32_t)(tile % tiles_x_) * kTileSize;
+  int32_t tile_y = (int32_t)(tile / tiles_x_) * kTileSize;
+  uint64_t pixels_shaded = 0;
+
+  for (uint32_t index : bin) {
+    const Triangle& tri = triangles_[index];
+    RasterizeTriangle(tri, std::max(tri.min_x, tile_x), std::max(tri.min_y, tile_y),
+                      std::min(tri.max_x, tile_x + kTileSize), std::min(tri.max_y, tile_y + kTileSize),
+                      pixels_shaded);
+  }
+
+  pixels_shaded_.fetch_add(pixels_shaded, std::memory_order_relaxed);
+}
+
+void RasterizerSoftware::RasterizeTriangle(const Triangle& tri, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                                           uint64_t& pixels_shaded) {
+  const DrawSW& draw = draws_[tri.draw];
+  uint32_t count = tri.varying_count;
+  const float* base = &planes_[tri.planes];
+  const float* ddx = base + count;
+  const float* ddy = ddx + count;
+  Vec2SW dobj_dx = { ddx[6], ddx[7] };
+  Vec2SW dobj_dy = { ddy[6], ddy[7] };
+
+  VaryingsSW in = {};
+  float* in_floats = reinterpret_cast<float*>(&in);
+  alignas(16) float row[kQuadVaryingCount];
+#if SW_AVX2
+  static const bool use_avx2 = CPUSupportsAVX2();
+  const int32_t lanes = use_avx2 ? kAVX2Lanes : kLanes;
+#else
+  const int32_t lanes = kLanes;
+#endif
+  const uint32_t lane_mask = (1u << lanes) - 1;
+
+  for (int32_t y = y0; y < y1; y++) {
+    float py = y + 0.5f;
+    for (uint32_t k = 0; k < count; k++)
+      row[k] = base[k] + ddy[k] * py;
+
+    uint8_t* pixels = target_.pixels + (size_t)y * target_.row_bytes;
+
+    for (int32_t x = x0; x < x1; x += lanes) {
+#if SW_AVX2
+      uint32_t mask = (use_avx2 ? CoverageMaskAVX2(tri.edge, tri.top_left, x, py) :
+                                  CoverageMask(tri.edge, tri.top_left, x, py)) & lane_mask;
+#else
+      uint32_t mask = CoverageMask(tri.edge, tri.top_left, x, py) & lane_mask;
+#endif
+      if (x1 - x < lanes)
+        mask &= (1u << (x1 - x)) - 1;
+
+      while (mask) {
+        int32_t px = x + (int32_t)CountTrailingZeros(mask);
+        mask &= mask - 1;
+
+        EvaluatePlanes(row, ddx, px + 0.5f, count, in_floats);
+        Color4SW color = ShadePixelSW(draw.shader, in, dobj_dx, dobj_dy);
+        BlendAndStore(draw, color, pixels + px * 4);
+        pixels_shaded++;
+      }
+    }
+  }
+}
+
+}  // namespace ultralight
@@ -0,0 +1,107 @@
+#pragma once
+#include "ShadersSoftware.h"
+#include "TilePool.h"
+#include <atomic>
+#include <vector>
+
+namespace ultralight {
+
+// Writable view of a render target's pixels (BGRA8, premultiplied).
+struct SurfaceSW {
+  uint8_t* pixels = nullptr;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t row_bytes = 0;
+};
+
+// Bytes per vertex: float2 pos, ubyte4 color, float2 obj for paths, plus
+// float2 tex and float4 data[7] for quads.
+inline uint32_t VertexStrideSW(VertexBufferFormat format) {
+  return format == VertexBufferFormat::_2f_4ub_2f_2f_28f ? 140 : 20;
+}
+
+// Everything the rasterizer needs from a GPUState, resolved by the driver.
+struct DrawSW {
+  ShaderStateSW shader;
+  float transform[16];   // Column-major, maps vertex positions to target pixels
+  IntRect bounds;        // Viewport, scissor and target bounds intersected
+  bool enable_blend;
+  BlendFactor blend_src_factor;
+  BlendFactor blend_dst_factor;
+  BlendEquation blend_equation;
+};
+
+//
+// Tile-based triangle rasterizer behind GPUDriverSoftware.
+//
+// Draws are recorded into a batch that targets a single surface. Flush()
+// transforms and bins the batch's triangles into 64x64 tiles, then the tiles
+// are shaded in parallel on a TilePool. Each tile runs its triangles in
+// submission order so results don't depend on the number of threads.
+//
+// Edge tests use AVX2 (8 pixels) on CPUs that support it, picked at run time
+// with GCC and Clang, SSE2 (4 pixels) on other x86 CPUs and plain C++
+// otherwise. Coverage is aliased: path geometry is drawn without the 4x MSAA
+// the GL driver uses.
+//
+class RasterizerSoftware {
+public:
+  struct Stats {
+    uint64_t batches = 0;
+    uint64_t triangles = 0;
+    uint64_t tiles = 0;          // Non-empty tiles shaded
+    uint64_t pixels_shaded = 0;
+  };
+
+  explicit RasterizerSoftware(uint32_t worker_count);
+
+  // Starts a batch that draws to 'target'. Flushes any pending batch first.
+  void Begin(const SurfaceSW& target);
+
+  bool has_target() const { return target_.pixels != nullptr; }
+  const uint8_t* target_pixels() const { return target_.pixels; }
+
+  // Records 'index_count' indices worth of triangles. The vertex and index
+  // data only needs to stay valid until the next Flush().
+  void AddDraw(const DrawSW& draw, VertexBufferFormat format, const uint8_t* vertices,
+               uint32_t vertex_count, const IndexType* indices, uint32_t index_count);
+
+  // Rasterizes the pending batch. The target stays bound.
+  void Flush();
+
+  // Flushes and unbinds the target.
+  void End();
+
+  const Stats& stats() const { return stats_; }
+
+  uint32_t worker_count() const { return pool_.worker_count(); }
+
+protected:
+  struct Triangle {
+    uint32_t draw;        // Index into draws_
+    int32_t min_x, min_y; // Pixel bounds, clipped to the draw bounds
+    int32_t max_x, max_y; // (exclusive)
+    float edge[3][3];     // A, B, C with A*x + B*y + C >= 0 inside
+    bool top_left[3];     // Edge owns pixels exactly on it
+    uint32_t planes;      // Offset into planes_: base, d/dx and d/dy per varying
+    uint32_t varying_count;
+  };
+
+  void SetupTriangle(uint32_t draw_index, const float* p0, const float* p1, const float* p2,
+                     const float* v0, const float* v1, const float* v2, uint32_t varying_count);
+  void RasterizeTile(uint32_t tile);
+  void RasterizeTriangle(const Triangle& tri, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                         uint64_t& pixels_shaded);
+
+  TilePool pool_;
+  SurfaceSW target_;
+  std::vector<DrawSW> draws_;
+  std::vector<Triangle> triangles_;
+  std::vector<float> planes_;
+  std::vector<std::vector<uint32_t>> bins_; // Triangle indices per tile
+  uint32_t tiles_x_ = 0;
+  std::atomic<uint64_t> pixels_shaded_{ 0 };
+  Stats stats_;
+};
+
+}  // namespace ultralight
@@ -0,0 +1,692 @@
+// CPU port of the pixel shaders in shaders/hlsl. Keep the math in step with
+// the HLSL so the software driver renders the same images as the GPU ones.
+#include "ShadersSoftware.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ultralight {
+
+namespace {
+
+typedef Vec2SW float2;
+typedef Color4SW float4;
+
+const float kPI = 3.14159265359f;
+const float kAAWidth = 0.354f;
+
+inline float2 F2(float x, float y) { return { x, y }; }
+inline float4 F4(float r, float g, float b, float a) { return { r, g, b, a }; }
+
+inline float2 operator+(float2 a, float2 b) { return { a.x + b.x, a.y + b.y }; }
+inline float2 operator-(float2 a, float2 b) { return { a.x - b.x, a.y - b.y }; }
+inline float2 operator*(float2 a, float2 b) { return { a.x * b.x, a.y * b.y }; }
+inline float2 operator/(float2 a, float2 b) { return { a.x / b.x, a.y / b.y }; }
+inline float2 operator*(float2 a, float s) { return { a.x * s, a.y * s }; }
+inline float2 operator*(float s, float2 a) { return { a.x * s, a.y * s }; }
+inline float2 operator-(float2 a, float s) { return { a.x - s, a.y - s }; }
+
+inline float4 operator+(const float4& a, const float4& b) { return { a.r + b.r, a.g + b.g, a.b + b.b, a.a + b.a }; }
+inline float4 operator*(const float4& a, const float4& b) { return { a.r * b.r, a.g * b.g, a.b * b.b, a.a * b.a }; }
+inline float4 operator*(const float4& a, float s) { return { a.r * s, a.g * s, a.b * s, a.a * s }; }
+
+inline float dot(float2 a, float2 b) { return a.x * b.x + a.y * b.y; }
+inline float length(float2 a) { return std::sqrt(dot(a, a)); }
+inline float2 abs2(float2 a) { return { std::fabs(a.x), std::fabs(a.y) }; }
+inline float2 max2(float2 a, float s) { return { std::max(a.x, s), std::max(a.y, s) }; }
+inline float2 normalize(float2 a) { float l = length(a); return l > 0.0f ? a * (1.0f / l) : a; }
+inline float frac(float x) { return x - std::floor(x); }
+inline float saturate(float x) { return std::min(std::max(x, 0.0f), 1.0f); }
+inline float sign(float x) { return (float)((x > 0.0f) - (x < 0.0f)); }
+inline float lerp(float a, float b, float t) { return a + (b - a) * t; }
+inline float4 lerp(const float4& a, const float4& b, float t) {
+  return { lerp(a.r, b.r, t), lerp(a.g, b.g, t), lerp(a.b, b.b, t), lerp(a.a, b.a, t) };
+}
+inline float4 saturate(const float4& c) { return { saturate(c.r), saturate(c.g), saturate(c.b), saturate(c.a) }; }
+
+inline float smoothstep(float e0, float e1, float x) {
+  float t = saturate((x - e0) / (e1 - e0));
+  return t * t * (3.0f - 2.0f * t);
+}
+
+float Scalar(const ShaderStateSW& s, int i) { return s.scalar[i]; }
+
+//
+// Texture sampling (linear filter, clamp to edge)
+//
+
+float4 Texel(const TextureViewSW& t, int x, int y) {
+  x = std::min(std::max(x, 0), (int)t.width - 1);
+  y = std::min(std::max(y, 0), (int)t.height - 1);
+  if (t.alpha_only)
+    return F4(0.0f, 0.0f, 0.0f, t.pixels[y * t.row_bytes + x] * (1.0f / 255.0f));
+  const uint8_t* p = t.pixels + y * t.row_bytes + x * 4;
+  const float s = 1.0f / 255.0f;
+  return F4(p[2] * s, p[1] * s, p[0] * s, p[3] * s);
+}
+
+float4 Sample(const TextureViewSW& t, float2 uv) {
+  if (!t.pixels || !t.width || !t.height)
+    return F4(0.0f, 0.0f, 0.0f, 0.0f);
+
+  float fx = uv.x * t.width - 0.5f;
+  float fy = uv.y * t.height - 0.5f;
+  float x0 = std::floor(fx), y0 = std::floor(fy);
+  float tx = fx - x0, ty = fy - y0;
+  int ix = (int)x0, iy = (int)y0;
+
+  float4 top = lerp(Texel(t, ix, iy), Texel(t, ix + 1, iy), tx);
+  float4 bottom = lerp(Texel(t, ix, iy + 1), Texel(t, ix + 1, iy + 1), tx);
+  return lerp(top, bottom, ty);
+}
+
+//
+// clip.hlsli
+//
+
+float2 transformAffine(float2 val, float2 a, float2 b, float2 c) {
+  return val.x * a + val.y * b + c;
+}
+
+void Unpack(float v, float& a, float& b) {
+  const float s = 65536.0f;
+  a = std::floor(v / s);
+  b = std::floor(v - a * s);
+}
+
+float antialias(float d, float width, float median) {
+  return smoothstep(median - width, median + width, d);
+}
+
+float sdRect(float2 p, float2 size) {
+  float2 d = abs2(p) - size;
+  return std::min(std::max(d.x, d.y), 0.0f) + length(max2(d, 0.0f));
+}
+
+// sdEllipse is MIT licensed, Copyright 2013 Inigo Quilez. See the full
+// notice in shaders/hlsl/clip.hlsli.
+float sdEllipse(float2 p, float2 ab) {
+  if (std::fabs(ab.x - ab.y) < 0.1f)
+    return length(p) - ab.x;
+
+  p = abs2(p);
+  if (p.x > p.y) {
+    std::swap(p.x, p.y);
+    std::swap(ab.x, ab.y);
+  }
+
+  float l = ab.y * ab.y - ab.x * ab.x;
+  float m = ab.x * p.x / l;
+  float n = ab.y * p.y / l;
+  float m2 = m * m;
+  float n2 = n * n;
+  float c = (m2 + n2 - 1.0f) / 3.0f;
+  float c3 = c * c * c;
+  float q = c3 + m2 * n2 * 2.0f;
+  float d = c3 + m2 * n2;
+  float g = m + m * n2;
+  float co;
+
+  if (d < 0.0f) {
+    float h = std::acos(q / c3) / 3.0f;
+    float s = std::cos(h);
+    float t = std::sin(h) * std::sqrt(3.0f);
+    float rx = std::sqrt(-c * (s + t + 2.0f) + m2);
+    float ry = std::sqrt(-c * (s - t + 2.0f) + m2);
+    co = (ry + sign(l) * rx + std::fabs(g) / (rx * ry) - m) / 2.0f;
+  } else {
+    float h = 2.0f * m * n * std::sqrt(d);
+    float s = sign(q + h) * std::pow(std::fabs(q + h), 1.0f / 3.0f);
+    float u = sign(q - h) * std::pow(std::fabs(q - h), 1.0f / 3.0f);
+    float rx = -s - u - c * 4.0f + 2.0f * m2;
+    float ry = (s - u) * std::sqrt(3.0f);
+    float rm = std::sqrt(rx * rx + ry * ry);
+    float k = ry / std::sqrt(rm - rx);
+    co = (k + 2.0f * g / rm - m) / 2.0f;
+  }
+
+  float si = std::sqrt(1.0f - co * co);
+  float2 r = F2(ab.x * co, ab.y * si);
+  return length(r - p) * sign(p.y - r.y);
+}
+
+float sdRoundRect(float2 p, float2 size, const float4& rx, const float4& ry) {
+  size = size * 0.5f;
+
+  float2 corner = F2(-size.x + rx.r, -size.y + ry.r); // Top-Left
+  if (rx.r * ry.r > 0.0f && p.x < corner.x && p.y <= corner.y)
+    return sdEllipse(p - corner, F2(rx.r, ry.r));
+
+  corner = F2(size.x - rx.g, -size.y + ry.g); // Top-Right
+  if (rx.g * ry.g > 0.0f && p.x >= corner.x && p.y <= corner.y)
+    return sdEllipse(p - corner, F2(rx.g, ry.g));
+
+  corner = F2(size.x - rx.b, size.y - ry.b); // Bottom-Right
+  if (rx.b * ry.b > 0.0f && p.x >= corner.x && p.y >= corner.y)
+    return sdEllipse(p - corner, F2(rx.b, ry.b));
+
+  corner = F2(-size.x + rx.a, size.y - ry.a); // Bottom-Left
+  if (rx.a * ry.a > 0.0f && p.x < corner.x && p.y > corner.y)
+    return sdEllipse(p - corner, F2(rx.a, ry.a));
+
+  return sdRect(p, size);
+}
+
+float ClipDistance(const float* clip, float2 obj) {
+  // GetCol(data, i) reads floats [4 * i, 4 * i + 4) of the clip matrix.
+  const float* col0 = clip;
+  const float* col1 = clip + 4;
+  const float* col2 = clip + 8;
+  const float* col3 = clip + 12;
+
+  float4 radii_x, radii_y;
+  Unpack(col1[0], radii_x.r, radii_y.r);
+  Unpack(col1[1], radii_x.g, radii_y.g);
+  Unpack(col1[2], radii_x.b, radii_y.b);
+  Unpack(col1[3], radii_x.a, radii_y.a);
+  bool inverse = col3[2] != 0.0f;
+
+  float2 p = transformAffine(obj, F2(col2[0], col2[1]), F2(col2[2], col2[3]), F2(col3[0], col3[1]));
+  p = p - F2(col0[0], col0[1]);
+  return sdRoundRect(p, F2(col0[2], col0[3]), radii_x, radii_y) * (inverse ? -1.0f : 1.0f);
+}
+
+void applyClip(const ShaderStateSW& s, float2 obj, float2 dobj_dx, float2 dobj_dy, float4& out_color) {
+  for (uint32_t i = 0; i < s.clip_size; i++) {
+    float d = -ClipDistance(s.clip[i], obj);
+    // fwidth(d) from forward differences along the pixel's x and y axes.
+    float fw = std::fabs(-ClipDistance(s.clip[i], obj + dobj_dx) - d) +
+               std::fabs(-ClipDistance(s.clip[i], obj + dobj_dy) - d);
+    float alpha = fw > 0.0f ? smoothstep(-0.6180469f, 0.6180469f, d / fw) : (d >= 0.0f ? 1.0f : 0.0f);
+    out_color = out_color * alpha;
+  }
+}
+
+float innerStroke(float stroke_width, float d) {
+  return std::min(antialias(-d, kAAWidth, 0.0f), 1.0f - antialias(-d, kAAWidth, stroke_width));
+}
+
+float ramp(float in_min, float in_max, float val) {
+  return saturate((val - in_min) / (in_max - in_min));
+}
+
+//
+// fill.hlsl
+//
+
+enum FillType : uint32_t {
+  FillType_Solid = 0,
+  FillType_Image = 1,
+  FillType_Pattern_Image = 2,
+  FillType_Pattern_Gradient = 3,
+  FillType_Rounded_Rect = 7,
+  FillType_Box_Shadow = 8,
+  FillType_Blend = 9,
+  FillType_Mask = 10,
+  FillType_Glyph = 11,
+};
+
+float4 fillImage(const ShaderStateSW& s, const VaryingsSW& in) {
+  return Sample(s.textures[0], in.tex) * in.color;
+}
+
+float4 fillPatternImage(const ShaderStateSW& s, const VaryingsSW& in) {
+  const float4& tile_rect_uv = s.vector[0];
+  float2 spacing = F2(s.vector[1].r, s.vector[1].g);
+  float2 tile_size = F2(s.vector[1].b, s.vector[1].a);
+  float2 logical_tile_size = tile_size + spacing;
+
+  float2 coords = transformAffine(in.obj, F2(s.vector[2].r, s.vector[2].g),
+    F2(s.vector[2].b, s.vector[2].a), F2(s.vector[3].r, s.vector[3].g));
+  coords = coords / logical_tile_size;
+
+  float2 pixel_in_tile = F2(frac(coords.x), frac(coords.y)) * logical_tile_size;
+  if (pixel_in_tile.x >= tile_size.x || pixel_in_tile.y >= tile_size.y)
+    return F4(0.0f, 0.0f, 0.0f, 0.0f);
+
+  float2 uv = pixel_in_tile / tile_size;
+  uv = uv * F2(tile_rect_uv.b - tile_rect_uv.r, tile_rect_uv.a - tile_rect_uv.g);
+  uv = uv + F2(tile_rect_uv.r, tile_rect_uv.g);
+  return Sample(s.textures[0], uv) * in.color;
+}
+
+void GetGradientStop(const ShaderStateSW& s, const VaryingsSW& in, uint32_t offset, float& percent, float4& color) {
+  if (offset < 3) {
+    percent = (&in.data[3].r)[offset];
+    color = in.data[4 + offset];
+  } else {
+    percent = s.scalar[offset - 3];
+    color = s.vector[offset - 3];
+  }
+}
+
+float4 fillPatternGradient(const ShaderStateSW& s, const VaryingsSW& in) {
+  uint32_t num_stops = (uint32_t)(in.data[0].g + 0.5f);
+  bool is_radial = (uint32_t)(in.data[0].b + 0.5f) != 0;
+  float2 p0 = F2(in.data[1].r, in.data[1].g);
+  float2 p1 = F2(in.data[1].b, in.data[1].a);
+  float2 r0 = F2(in.data[2].r, in.data[2].g);
+  float2 r1 = F2(in.data[2].b, in.data[2].a);
+  float2 tex = in.tex;
+  float t = 0.0f;
+
+  if (is_radial) {
+    float2 delta = tex - p0;
+    float dist_outer = length(delta / r1);
+
+    if (r0.x > 0.0001f && r0.y > 0.0001f) {
+      float dist_inner = length(delta / r0);
+      t = dist_inner <= 1.0f ? 0.0f :
+          dist_outer >= 1.0f ? 1.0f :
+          saturate((dist_inner - 1.0f) / (dist_inner - dist_outer));
+    } else {
+      t = saturate(dist_outer);
+    }
+
+    if (length(p1 - p0) > 0.0001f) {
+      float2 focal_dir = normalize(p0 - p1);
+      float2 pixel_dir = normalize(tex - p1);
+      float angle_factor = dot(pixel_dir, focal_dir);
+      t = saturate(t * (1.0f + (1.0f - angle_factor) * 0.5f));
+    }
+  } else {
+    float2 v = p1 - p0;
+    t = saturate(dot(tex - p0, v) / dot(v, v));
+  }
+
+  float prev_percent, percent;
+  float4 prev_color, color;
+  GetGradientStop(s, in, 0, prev_percent, prev_color);
+  GetGradientStop(s, in, 1, percent, color);
+  float4 out_color = lerp(prev_color, color, ramp(prev_percent, percent, t));
+
+  for (uint32_t i = 2; i < std::min(num_stops, 11u); i++) {
+    prev_percent = percent;
+    GetGradientStop(s, in, i, percent, color);
+    out_color = lerp(out_color, color, ramp(prev_percent, percent, t));
+  }
+
+  return out_color;
+}
+
+float4 blend(const float4& src, const float4& dest) {
+  return F4(src.r + dest.r * (1.0f - src.a), src.g + dest.g * (1.0f - src.a),
+            src.b + dest.b * (1.0f - src.a), src.a + dest.a * (1.0f - src.a));
+}
+
+float4 fillRoundedRect(const VaryingsSW& in) {
+  float2 size = F2(in.data[0].b, in.data[0].a);
+  float2 p = (in.tex - 0.5f) * size;
+  float d = sdRoundRect(p, size, in.data[1], in.data[2]);
+
+  float alpha = antialias(-d, kAAWidth, 0.0f) * in.color.a;
+  float4 out_color = F4(in.color.r * alpha, in.color.g * alpha, in.color.b * alpha, alpha);
+
+  float stroke_width = in.data[3].r;
+  const float4& stroke_color = in.data[4];
+  if (stroke_width > 0.0f) {
+    alpha = innerStroke(stroke_width, d) * stroke_color.a;
+    float4 stroke = F4(stroke_color.r * alpha, stroke_color.g * alpha, stroke_color.b * alpha, alpha);
+    out_color = blend(stroke, out_color);
+  }
+
+  return out_color;
+}
+
+struct Float3 {
+  float v[3];
+  float& operator[](int i) { return v[i]; }
+  float operator[](int i) const { return v[i]; }
+};
+
+Float3 blendOverlay(const Float3& src, const Float3& dest) {
+  Float3 col;
+  for (int i = 0; i < 3; ++i)
+    col[i] = dest[i] < 0.5f ? (2.0f * dest[i] * src[i]) : (1.0f - 2.0f * (1.0f - dest[i]) * (1.0f - src[i]));
+  return col;
+}
+
+Float3 blendColorDodge(const Float3& src, const Float3& dest) {
+  Float3 col;
+  for (int i = 0; i < 3; ++i)
+    col[i] = src[i] == 1.0f ? src[i] : std::min(dest[i] / (1.0f - src[i]), 1.0f);
+  return col;
+}
+
+Float3 blendColorBurn(const Float3& src, const Float3& dest) {
+  Float3 col;
+  for (int i = 0; i < 3; ++i)
+    col[i] = src[i] == 0.0f ? src[i] : std::max(1.0f - ((1.0f - dest[i]) / src[i]), 0.0f);
+  return col;
+}
+
+Float3 blendSoftLight(const Float3& src, const Float3& dest) {
+  Float3 col;
+  for (int i = 0; i < 3; ++i)
+    col[i] = src[i] < 0.5f ? (2.0f * dest[i] * src[i] + dest[i] * dest[i] * (1.0f - 2.0f * src[i])) :
+                             (std::sqrt(dest[i]) * (2.0f * src[i] - 1.0f) + 2.0f * dest[i] * (1.0f - src[i]));
+  return col;
+}
+
+Float3 rgb2hsl(const Float3& col) {
+  const float eps = 0.0000001f;
+  float minc = std::min(col[0], std::min(col[1], col[2]));
+  float maxc = std::max(col[0], std::max(col[1], col[2]));
+  // mask = step(col.grr, col.rgb) * step(col.bbg, col.rgb)
+  float mask[3] = {
+    (col[0] >= col[1] ? 1.0f : 0.0f) * (col[0] >= col[2] ? 1.0f : 0.0f),
+    (col[1] >= col[0] ? 1.0f : 0.0f) * (col[1] >= col[2] ? 1.0f : 0.0f),
+    (col[2] >= col[0] ? 1.0f : 0.0f) * (col[2] >= col[1] ? 1.0f : 0.0f) };
+  // (col.gbr - col.brg)
+  float diff[3] = { col[1] - col[2], col[2] - col[0], col[0] - col[1] };
+  const float offset[3] = { 0.0f, 2.0f, 4.0f };
+  float h = 0.0f;
+  for (int i = 0; i < 3; ++i)
+    h += mask[i] * (offset[i] + diff[i] / (maxc - minc + eps)) / 6.0f;
+  return { { frac(1.0f + h),
+             (maxc - minc) / (1.0f - std::fabs(minc + maxc - 1.0f) + eps),
+             (minc + maxc) * 0.5f } };
+}
+
+Float3 hsl2rgb(const Float3& c) {
+  const float offset[3] = { 0.0f, 4.0f, 2.0f };
+  Float3 rgb;
+  for (int i = 0; i < 3; ++i) {
+    float k = std::fmod(c[0] * 6.0f + offset[i], 6.0f);
+    float v = std::min(std::max(std::fabs(k - 3.0f) - 1.0f, 0.0f), 1.0f);
+    rgb[i] = c[2] + c[1] * (v - 0.5f) * (1.0f - std::fabs(2.0f * c[2] - 1.0f));
+  }
+  return rgb;
+}
+
+float4 fillBlend(const ShaderStateSW& s, const VaryingsSW& in) {
+  enum : uint32_t {
+    BlendOp_Clear, BlendOp_Source, BlendOp_Over, BlendOp_In, BlendOp_Out, BlendOp_Atop,
+    BlendOp_DestOver, BlendOp_DestIn, BlendOp_DestOut, BlendOp_DestAtop, BlendOp_XOR,
+    BlendOp_Darken, BlendOp_Add, BlendOp_Difference, BlendOp_Multiply, BlendOp_Screen,
+    BlendOp_Overlay, BlendOp_Lighten, BlendOp_ColorDodge, BlendOp_ColorBurn, BlendOp_HardLight,
+    BlendOp_SoftLight, BlendOp_Exclusion, BlendOp_Hue, BlendOp_Saturation, BlendOp_Color,
+    BlendOp_Luminosity,
+  };
+
+  float4 src = fillImage(s, in);
+  float4 dest = Sample(s.textures[1], in.obj);
+  Float3 src_rgb = { { src.r, src.g, src.b } };
+  Float3 dest_rgb = { { dest.r, dest.g, dest.b } };
+  auto separable = [&](const Float3& rgb) {
+    return F4(rgb[0] * src.a, rgb[1] * src.a, rgb[2] * src.a, dest.a * src.a);
+  };
+  Float3 rgb;
+
+  switch ((uint32_t)(in.data[0].g + 0.5f)) {
+  case BlendOp_Clear: return F4(0.0f, 0.0f, 0.0f, 0.0f);
+  case BlendOp_Source: return src;
+  case BlendOp_Over: return src + dest * (1.0f - src.a);
+  case BlendOp_In: return src * dest.a;
+  case BlendOp_Out: return src * (1.0f - dest.a);
+  case BlendOp_Atop: return src * dest.a + dest * (1.0f - src.a);
+  case BlendOp_DestOver: return src * (1.0f - dest.a) + dest;
+  case BlendOp_DestIn: return dest * src.a;
+  case BlendOp_DestOut: return dest * (1.0f - src.a);
+  case BlendOp_DestAtop: return src * (1.0f - dest.a) + dest * src.a;
+  case BlendOp_XOR: return saturate(src * (1.0f - dest.a) + dest * (1.0f - src.a));
+  case BlendOp_Add: return saturate(src + dest);
+  case BlendOp_Darken:
+  case BlendOp_Lighten:
+    for (int i = 0; i < 3; ++i)
+      rgb[i] = BlendOp_Darken == (uint32_t)(in.data[0].g + 0.5f) ?
+        std::min(src_rgb[i], dest_rgb[i]) : std::max(src_rgb[i], dest_rgb[i]);
+    return separable(rgb);
+  case BlendOp_Difference:
+    for (int i = 0; i < 3; ++i)
+      rgb[i] = std::fabs(dest_rgb[i] - src_rgb[i]);
+    return separable(rgb);
+  case BlendOp_Multiply:
+    for (int i = 0; i < 3; ++i)
+      rgb[i] = src_rgb[i] * dest_rgb[i];
+    return separable(rgb);
+  case BlendOp_Screen:
+    for (int i = 0; i < 3; ++i)
+      rgb[i] = 1.0f - (1.0f - dest_rgb[i]) * (1.0f - src_rgb[i]);
+    return separable(rgb);
+  case BlendOp_Exclusion:
+    for (int i = 0; i < 3; ++i)
+      rgb[i] = dest_rgb[i] + src_rgb[i] - 2.0f * dest_rgb[i] * src_rgb[i];
+    return separable(rgb);
+  case BlendOp_Overlay: return separable(blendOverlay(src_rgb, dest_rgb));
+  case BlendOp_HardLight: return separable(blendOverlay(dest_rgb, src_rgb));
+  case BlendOp_ColorDodge: return separable(blendColorDodge(src_rgb, dest_rgb));
+  case BlendOp_ColorBurn: return separable(blendColorBurn(src_rgb, dest_rgb));
+  case BlendOp_SoftLight: return separable(blendSoftLight(src_rgb, dest_rgb));
+  case BlendOp_Hue: {
+    Float3 base = rgb2hsl(dest_rgb);
+    return separable(hsl2rgb({ { rgb2hsl(src_rgb)[0], base[1], base[2] } }));
+  }
+  case BlendOp_Saturation: {
+    Float3 base = rgb2hsl(dest_rgb);
+    return separable(hsl2rgb({ { base[0], rgb2hsl(src_rgb)[1], base[2] } }));
+  }
+  case BlendOp_Color: {
+    Float3 blend_hsl = rgb2hsl(src_rgb);
+    return separable(hsl2rgb({ { blend_hsl[0], blend_hsl[1], rgb2hsl(dest_rgb)[2] } }));
+  }
+  case BlendOp_Luminosity: {
+    Float3 base = rgb2hsl(dest_rgb);
+    return separable(hsl2rgb({ { base[0], base[1], rgb2hsl(src_rgb)[2] } }));
+  }
+  }
+
+  return src;
+}
+
+float4 fillMask(const ShaderStateSW& s, const VaryingsSW& in) {
+  float4 col = fillImage(s, in);
+  return col * Sample(s.textures[1], in.obj).a;
+}
+
+// Piecewise polynomial approximation of the alpha-correction LUT, maps
+// (linear alpha, fill color luma) -> gamma-corrected alpha.
+float AlphaCorrection(float a, float l) {
+  float a2 = a * a, a3 = a2 * a, a4 = a3 * a;
+  float l2 = l * l, l3 = l2 * l, l4 = l3 * l;
+  float p;
+
+  if (a < 0.866667f) {
+    p = -0.5295142877f
+      + 0.6729336378f * l
+      - 0.9970081304f * a
+      - 6.9761895120f * l2
+      - 1.2416343696f * a * l
+      + 8.0153698029f * a2
+      + 52.6805538770f * l3
+      - 23.9237999543f * a * l2
+      + 26.8822958232f * a2 * l
+      - 31.4318707953f * a3
+      - 72.3097846202f * l4
+      + 7.1798346847f * a * l3
+      + 22.1490959100f * a2 * l2
+      - 44.2197918196f * a3 * l
+      + 45.1474487610f * a4
+      + 29.2352950634f * l4 * l
+      + 3.7994888864f * a * l4
+      - 5.7742577614f * a2 * l3
+      - 12.0929004495f * a3 * l2
+      + 27.8164399735f * a4 * l
+      - 23.5607835614f * a4 * a;
+  } else {
+    p = 359.7440629041f
+      - 192.8896711219f * l
+      - 856.5769056815f * a
+      - 309.4254650715f * l2
+      + 1099.4938500108f * a * l
+      + 75.8802629888f * a2
+      - 82.2700940268f * l3
+      + 837.4432826429f * a * l2
+      - 1796.8031907127f * a2 * l
+      + 1033.9126625702f * a3
+      - 2.5168630999f * l4
+      + 98.2029223745f * a * l3
+      - 559.1591121667f * a2 * l2
+      + 914.3739143865f * a3 * l
+      - 619.1996126173f * a4;
+  }
+
+  return saturate(a + a * (1.0f - a) * p);
+}
+
+float4 fillGlyph(const ShaderStateSW& s, const VaryingsSW& in) {
+  float alpha = Sample(s.textures[0], in.tex).a;
+  float corrected_alpha = AlphaCorrection(alpha, in.data[0].g) * in.color.a;
+  return F4(in.color.r * corrected_alpha, in.color.g * corrected_alpha, in.color.b * corrected_alpha,
+            corrected_alpha);
+}
+
+float4 ShadeFill(const ShaderStateSW& s, const VaryingsSW& in) {
+  switch ((uint32_t)(in.data[0].r + 0.5f)) {
+  case FillType_Solid: return in.color;
+  case FillType_Image: return fillImage(s, in);
+  case FillType_Pattern_Image: return fillPatternImage(s, in);
+  case FillType_Pattern_Gradient: return fillPatternGradient(s, in);
+  case FillType_Rounded_Rect: return fillRoundedRect(in);
+  case FillType_Box_Shadow: return in.color;
+  case FillType_Blend: return fillBlend(s, in);
+  case FillType_Mask: return fillMask(s, in);
+  case FillType_Glyph: return fillGlyph(s, in);
+  }
+  return in.color;
+}
+
+//
+// filter_basic.hlsl
+//
+
+float4 ShadeFilterBasic(const ShaderStateSW& s, const VaryingsSW& in) {
+  float4 c = Sample(s.textures[0], in.tex) * in.color;
+  float amount = in.data[0].g;
+  float inv = 1.0f - amount;
+
+  switch ((uint32_t)(in.data[0].r + 0.5f)) {
+  case 0: // Grayscale
+    return F4((0.2126f + 0.7874f * inv) * c.r + (0.7152f - 0.7152f * inv) * c.g + (0.0722f - 0.0722f * inv) * c.b,
+              (0.2126f - 0.2126f * inv) * c.r + (0.7152f + 0.2848f * inv) * c.g + (0.0722f - 0.0722f * inv) * c.b,
+              (0.2126f - 0.2126f * inv) * c.r + (0.7152f - 0.7152f * inv) * c.g + (0.0722f + 0.9278f * inv) * c.b,
+              c.a);
+  case 1: // Sepia
+    return F4((0.393f + 0.607f * inv) * c.r + (0.769f - 0.769f * inv) * c.g + (0.189f - 0.189f * inv) * c.b,
+              (0.349f - 0.349f * inv) * c.r + (0.686f + 0.314f * inv) * c.g + (0.168f - 0.168f * inv) * c.b,
+              (0.272f - 0.272f * inv) * c.r + (0.534f - 0.534f * inv) * c.g + (0.131f + 0.869f * inv) * c.b,
+              c.a);
+  case 2: // Saturate
+    return F4((0.213f + 0.787f * amount) * c.r + (0.715f - 0.715f * amount) * c.g + (0.072f - 0.072f * amount) * c.b,
+              (0.213f - 0.213f * amount) * c.r + (0.715f + 0.285f * amount) * c.g + (0.072f - 0.072f * amount) * c.b,
+              (0.213f - 0.213f * amount) * c.r + (0.715f - 0.715f * amount) * c.g + (0.072f + 0.928f * amount) * c.b,
+              c.a);
+  case 3: { // HueRotate
+    float cs = std::cos(amount * kPI / 180.0f);
+    float sn = std::sin(amount * kPI / 180.0f);
+    return F4(c.r * (0.213f + cs * 0.787f - sn * 0.213f) + c.g * (0.715f - cs * 0.715f - sn * 0.715f) + c.b * (0.072f - cs * 0.072f + sn * 0.928f),
+              c.r * (0.213f - cs * 0.213f + sn * 0.143f) + c.g * (0.715f + cs * 0.285f + sn * 0.140f) + c.b * (0.072f - cs * 0.072f - sn * 0.283f),
+              c.r * (0.213f - cs * 0.213f - sn * 0.787f) + c.g * (0.715f - cs * 0.715f + sn * 0.715f) + c.b * (0.072f + cs * 0.928f + sn * 0.072f),
+              c.a);
+  }
+  case 4: // Invert
+    return F4((1.0f - c.r) * amount + c.r * inv, (1.0f - c.g) * amount + c.g * inv,
+              (1.0f - c.b) * amount + c.b * inv, c.a);
+  case 5: // Opacity
+    return c * amount;
+  case 6: // Brightness
+    return F4(c.r * amount, c.g * amount, c.b * amount, c.a);
+  case 7: // Contrast
+    return F4((c.r - 0.5f) * amount + 0.5f, (c.g - 0.5f) * amount + 0.5f, (c.b - 0.5f) * amount + 0.5f, c.a);
+  }
+
+  return c;
+}
+
+//
+// blur.hlsli / filter_blur.hlsl
+//
+
+const int kGaussianHalfWidth = 11;
+const float kGaussianKernelStep = 0.2f;
+const float kGaussianKernel[kGaussianHalfWidth] = {
+  0.08271846539774f, 0.08108053004084f, 0.07635876755667f, 0.06909227008039f,
+  0.06006593399678f, 0.05017128538811f, 0.04026339964190f, 0.03104515814373f,
+  0.02299881881682f, 0.01636987669241f, 0.01119472694350f,
+};
+
+inline bool InExtents(float2 coord, float2 extents) {
+  return coord.x >= 0.0f && coord.y >= 0.0f && coord.x <= extents.x && coord.y <= extents.y;
+}
+
+float4 blur(const TextureViewSW& tex, float2 uv, float2 radius, float2 offset, float2 extents, bool alpha_only) {
+  if (radius.x < 0.001f && radius.y < 0.001f) {
+    float2 coord = uv + offset;
+    if (!alpha_only)
+      return Sample(tex, coord);
+    float a = InExtents(coord, extents) ? Sample(tex, coord).a : 0.0f;
+    return F4(a, a, a, a);
+  }
+
+  float4 total = F4(0.0f, 0.0f, 0.0f, 0.0f);
+  float total_weight = 0.0f;
+
+  for (int i = 0; i < kGaussianHalfWidth; i++) {
+    float2 step = radius * (i * kGaussianKernelStep);
+    float2 coords[2] = { uv + step + offset, uv - step + offset };
+    for (int j = 0; j < (i ? 2 : 1); j++) {
+      if (!InExtents(coords[j], extents))
+        continue;
+      total = total + Sample(tex, coords[j]) * kGaussianKernel[i];
+      total_weight += kGaussianKernel[i];
+    }
+  }
+
+  if (total_weight <= 0.0f)
+    return F4(0.0f, 0.0f, 0.0f, 0.0f);
+  if (alpha_only) {
+    float a = total.a / total_weight;
+    return F4(a, a, a, a);
+  }
+  return total * (1.0f / total_weight);
+}
+
+float4 ShadeFilterBlur(const ShaderStateSW& s, const VaryingsSW& in) {
+  float2 radius = F2(Scalar(s, 0), Scalar(s, 1));
+  float2 offset = F2(Scalar(s, 2), Scalar(s, 3));
+  float2 extents = F2(Scalar(s, 4), Scalar(s, 5));
+  bool alpha_only = s.integer[1] != 0;
+
+  float4 color = blur(s.textures[0], in.tex, radius, offset, extents, alpha_only);
+  // Second pass applies the vertex color to the blurred result.
+  if (s.integer[0] == 1)
+    color = color * in.color;
+  return color;
+}
+
+}  // namespace
+
+Color4SW ShadePixelSW(const ShaderStateSW& state, const VaryingsSW& in,
+                      Vec2SW dobj_dx, Vec2SW dobj_dy) {
+  float4 color;
+
+  switch (state.shader_type) {
+  case ShaderType::Fill:
+    color = ShadeFill(state, in);
+    applyClip(state, in.obj, dobj_dx, dobj_dy, color);
+    return color;
+  case ShaderType::FillPath:
+    color = in.color;
+    applyClip(state, in.obj, dobj_dx, dobj_dy, color);
+    return color;
+  case ShaderType::FilterBasic:
+    return ShadeFilterBasic(state, in);
+  case ShaderType::FilterBlur:
+    return ShadeFilterBlur(state, in);
+  case ShaderType::FilterDropShadow:
+    return in.color;
+  default:
+    return in.color;
+  }
+}
+
+}  // namespace ultralight
@@ -0,0 +1,56 @@
+#pragma once
+#include <Ultralight/platform/GPUDriver.h>
+#include <cstdint>
+
+namespace ultralight {
+
+struct Vec2SW {
+  float x, y;
+};
+
+// Straight port of the HLSL float4, channels are in RGBA order.
+struct alignas(16) Color4SW {
+  float r, g, b, a;
+};
+
+// Read-only view of a texture's pixels (BGRA8 or A8, rows top to bottom).
+struct TextureViewSW {
+  const uint8_t* pixels = nullptr;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t row_bytes = 0;
+  bool alpha_only = false; // A8, sampled as (0, 0, 0, a) like the GPU swizzle
+};
+
+// Interpolated vertex outputs, laid out like VS_OUTPUT in shaders/hlsl.
+// Path geometry only fills color, tex (zero) and obj.
+struct alignas(16) VaryingsSW {
+  Color4SW color;
+  Vec2SW tex;
+  Vec2SW obj;
+  Color4SW data[7];
+};
+
+static_assert(sizeof(VaryingsSW) == 36 * sizeof(float), "VaryingsSW must be tightly packed floats");
+
+const uint32_t kPathVaryingCount = 8;  // color, tex, obj
+const uint32_t kQuadVaryingCount = 36; // color, tex, obj, data0-6
+
+// Pixel shader inputs that are constant for a whole draw.
+struct ShaderStateSW {
+  ShaderType shader_type;
+  int32_t integer[8];
+  float scalar[8];
+  Color4SW vector[8];
+  uint32_t clip_size;
+  float clip[8][16];
+  TextureViewSW textures[2];
+};
+
+// Runs the pixel shader for 'shader_type'. 'dobj_dx' / 'dobj_dy' are the
+// screen-space derivatives of in.obj, used where the GPU shaders call fwidth().
+// Returns a premultiplied color.
+Color4SW ShadePixelSW(const ShaderStateSW& state, const VaryingsSW& in,
+                      Vec2SW dobj_dx, Vec2SW dobj_dy);
+
+}  // namespace ultralight
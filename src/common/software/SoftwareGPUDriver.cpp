@@ -0,0 +1,39 @@
+#include <AppCore/SoftwareGPUDriver.h>
+#include "GPUDriverSoftware.h"
+#include "RefCountedImpl.h"
+#include <memory>
+
+namespace ultralight {
+
+class SoftwareGPUDriverImpl : public SoftwareGPUDriver,
+                              public RefCountedImpl<SoftwareGPUDriverImpl> {
+public:
+  explicit SoftwareGPUDriverImpl(uint32_t worker_count)
+    : driver_(new GPUDriverSoftware(worker_count)) {}
+
+  virtual GPUDriver* driver() override { return driver_.get(); }
+
+  virtual void DrawCommandList() override { driver_->DrawCommandList(); }
+
+  virtual void set_default_render_target(RefPtr<Bitmap> bitmap) override {
+    driver_->set_default_render_target(bitmap);
+  }
+
+  virtual RefPtr<Bitmap> texture_bitmap(uint32_t texture_id) const override {
+    return driver_->texture_bitmap(texture_id);
+  }
+
+  REF_COUNTED_IMPL(SoftwareGPUDriverImpl);
+
+protected:
+  std::unique_ptr<GPUDriverSoftware> driver_;
+};
+
+RefPtr<SoftwareGPUDriver> SoftwareGPUDriver::Create(int32_t worker_count) {
+  uint32_t count = worker_count < 0 ? TilePool::DefaultWorkerCount() : (uint32_t)worker_count;
+  return AdoptRef(*static_cast<SoftwareGPUDriver*>(new SoftwareGPUDriverImpl(count)));
+}
+
+SoftwareGPUDriver::~SoftwareGPUDriver() {}
+
+}  // namespace ultralight
@@ -0,0 +1,82 @@
+#include "TilePool.h"
+#include <algorithm>
+
+namespace ultralight {
+
+TilePool::TilePool(uint32_t worker_count) {
+  for (uint32_t i = 0; i < worker_count; i++)
+    workers_.emplace_back(&TilePool::WorkerMain, this);
+}
+
+TilePool::~TilePool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_ = true;
+  }
+  work_available_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+void TilePool::Run(uint32_t count, const std::function<void(uint32_t)>& job) {
+  if (!count)
+    return;
+
+  if (workers_.empty() || count == 1) {
+    for (uint32_t i = 0; i < count; i++)
+      job(i);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = &job;
+    job_count_ = count;
+    next_index_.store(0, std::memory_order_relaxed);
+    busy_workers_ = (uint32_t)workers_.size();
+    generation_++;
+  }
+  work_available_.notify_all();
+
+  RunJobs();
+
+  // Every worker has to check in before 'job' goes out of scope, even the
+  // ones that found no indices left.
+  std::unique_lock<std::mutex> lock(mutex_);
+  work_finished_.wait(lock, [this] { return busy_workers_ == 0; });
+  job_ = nullptr;
+}
+
+uint32_t TilePool::DefaultWorkerCount() {
+  uint32_t threads = std::thread::hardware_concurrency();
+  return threads > 1 ? std::min(threads - 1, 15u) : 0;
+}
+
+void TilePool::WorkerMain() {
+  uint64_t seen_generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true) {
+    work_available_.wait(lock, [&] { return quit_ || generation_ != seen_generation; });
+    if (quit_)
+      break;
+
+    seen_generation = generation_;
+    lock.unlock();
+    RunJobs();
+    lock.lock();
+
+    if (--busy_workers_ == 0)
+      work_finished_.notify_one();
+  }
+}
+
+void TilePool::RunJobs() {
+  const std::function<void(uint32_t)>& job = *job_;
+  uint32_t count = job_count_;
+
+  for (uint32_t i = next_index_.fetch_add(1); i < count; i = next_index_.fetch_add(1))
+    job(i);
+}
+
+}  // namespace ultralight
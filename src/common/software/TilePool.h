@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ultralight {
+
+//
+// Fixed set of worker threads that run the tiles of a rasterizer batch.
+//
+// The calling thread takes part in each Run() so a pool with no workers
+// simply runs everything inline.
+//
+class TilePool {
+public:
+  explicit TilePool(uint32_t worker_count);
+  ~TilePool();
+
+  // Calls 'job' once for every index in [0, count) and returns when all calls
+  // have finished. Indices are handed out in increasing order.
+  void Run(uint32_t count, const std::function<void(uint32_t)>& job);
+
+  uint32_t worker_count() const { return (uint32_t)workers_.size(); }
+
+  // One worker per hardware thread, minus the calling thread.
+  static uint32_t DefaultWorkerCount();
+
+protected:
+  TilePool(const TilePool&) = delete;
+  TilePool& operator=(const TilePool&) = delete;
+
+  void WorkerMain();
+  void RunJobs();
+
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable work_finished_;
+  uint64_t generation_ = 0;
+  uint32_t busy_workers_ = 0;
+  bool quit_ = false;
+
+  const std::function<void(uint32_t)>* job_ = nullptr;
+  uint32_t job_count_ = 0;
+  std::atomic<uint32_t> next_index_{ 0 };
+};
+
+}  // namespace ultralight
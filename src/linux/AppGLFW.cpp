@@ -1,6 +1,8 @@
 #include "AppGLFW.h"
 #include "ClipboardGLFW.h"
 #include "FileLogger.h"
+#include "FileSystemBasic.h"
+#include "TraceRecorder.h"
 #include "WindowGLFW.h"
 #include "gl/GPUContextGL.h"
 #include "gl/GPUDriverGL.h"
@@ -10,6 +12,7 @@
 #include <Ultralight/platform/Platform.h>
 #include <Ultralight/private/PlatformFileSystem.h>
 #include <Ultralight/private/util/Debug.h>
+#include <cerrno>
 #include <chrono>
 #include <filesystem>
 #include <iostream>
@@ -97,7 +100,25 @@ AppGLFW::AppGLFW(Settings settings, Config config)
         std::string fs_str = settings.file_system_path.utf8().data();
         std::filesystem::path file_system_path = executable_path / std::filesystem::path(fs_str);
 
-        Platform::instance().set_file_system(GetPlatformFileSystem(file_system_path.string().c_str()));
+        FileSystem* file_system = GetPlatformFileSystem(file_system_path.string().c_str());
+
+        // The platform file system is always a FileSystemBasic on Linux.
+        FileSystemBasic* basic_file_system = static_cast<FileSystemBasic*>(file_system);
+        if (settings_.enable_file_system_index || settings_.file_system_cache_size) {
+            indexed_file_system_ = basic_file_system;
+            indexed_file_system_->EnableIndex();
+            if (settings_.file_system_cache_size)
+                indexed_file_system_->EnableCache((size_t)settings_.file_system_cache_size);
+        }
+
+        std::string archive_str = settings.file_system_archive.utf8().data();
+        std::filesystem::path archive_path = executable_path / std::filesystem::path(archive_str);
+
+        // Lets the prefetcher batch its reads through io_uring.
+        auto async_open = [basic_file_system](const String& path, AsyncFileReaderLinux::Callback callback) {
+            basic_file_system->OpenFileAsync(path, std::move(callback));
+        };
+        Platform::instance().set_file_system(LayerFileSystems(file_system, archive_path.string().c_str(), async_open));
     }
 
     if (!Platform::instance().font_loader()) {
@@ -107,23 +128,40 @@ AppGLFW::AppGLFW(Settings settings, Config config)
     clipboard_.reset(new ClipboardGLFW());
     Platform::instance().set_clipboard(clipboard_.get());
 
-    gpu_context_.reset(new GPUContextGL(false, true));
-    Platform::instance().set_gpu_driver(gpu_context_->driver());
-
     // We use the GPUContext's global offscreen window to maintain
     // clipboard state for the duration of the app lifetime.
-    clipboard_->set_window(gpu_context_->window());
+#if defined(APPCORE_ENABLE_VULKAN)
+    vulkan_context_ = GPUContextVulkan::Create(false);
+    if (vulkan_context_) {
+        clipboard_->set_window(vulkan_context_->window());
+    } else if (Logger* logger = Platform::instance().logger()) {
+        logger->LogMessage(LogLevel::Warning, "No usable Vulkan device, falling back to OpenGL.");
+    }
+#endif
+
+    if (!gpu_driver_impl()) {
+        gpu_context_.reset(new GPUContextGL(false, true));
+        clipboard_->set_window(gpu_context_->window());
+    }
+
+    Platform::instance().set_gpu_driver(gpu_driver_impl());
 
     surface_factory_.reset(new ULTextureSurfaceFactory());
     Platform::instance().set_surface_factory(surface_factory_.get());
 
     renderer_ = Renderer::Create();
+
+    if (settings_.enable_memory_pressure_monitor)
+        memory_pressure_monitor_.reset(new MemoryPressureMonitorLinux(settings_.memory_pressure_rss_limit));
 }
 
 AppGLFW::~AppGLFW()
 {
     windows_.clear();
     gpu_context_.reset();
+#if defined(APPCORE_ENABLE_VULKAN)
+    vulkan_context_.reset();
+#endif
     Platform::instance().set_gpu_driver(nullptr);
     glfwTerminate();
 }
@@ -140,6 +178,8 @@ void AppGLFW::Run()
 
     is_running_ = true;
 
+    TraceRecorder::SetThreadName("Main");
+
     const double update_interval_ms = 2.0; // 500Hz
     const double repaint_interval_ms = 4.0; // 250Hz
 
@@ -168,15 +208,32 @@ void AppGLFW::Run()
         FD_SET(update_timer_fd, &rfds);
         FD_SET(repaint_timer_fd, &rfds);
 
-        // Wait for timer events or input events
+        // Memory pressure sources signal through exceptional conditions (POLLPRI)
+        fd_set efds;
+        FD_ZERO(&efds);
         int max_fd = std::max(update_timer_fd, repaint_timer_fd) + 1;
-        int result = select(max_fd, &rfds, nullptr, nullptr, nullptr);
+        if (memory_pressure_monitor_) {
+            for (int fd : memory_pressure_monitor_->fds()) {
+                FD_SET(fd, &efds);
+                max_fd = std::max(max_fd, fd + 1);
+            }
+        }
+
+        // Wait for timer events, input events or memory pressure
+        int result = select(max_fd, &rfds, nullptr, &efds, nullptr);
 
         if (result == -1) {
+            // Signals (eg, the trace signal) interrupt select(), just wait again.
+            if (errno == EINTR)
+                continue;
             // Error occurred
             break;
         }
 
+        MemoryPressureLevel pressure_level;
+        if (memory_pressure_monitor_ && memory_pressure_monitor_->ProcessEvents(efds, pressure_level))
+            HandleMemoryPressure(pressure_level);
+
         if (FD_ISSET(update_timer_fd, &rfds)) {
             // Update timer event
             uint64_t expirations;
@@ -191,7 +248,10 @@ void AppGLFW::Run()
             Repaint();
         }
 
-        glfwPollEvents();
+        {
+            TraceZone("AppGLFW::PollEvents");
+            glfwPollEvents();
+        }
     }
 
     // Clean up timer file descriptors
@@ -204,14 +264,65 @@ void AppGLFW::Quit()
     is_running_ = false;
 }
 
+FileSystemIndexStats AppGLFW::file_system_index_stats() const
+{
+    FileSystemIndexStats result;
+    if (!indexed_file_system_ || !indexed_file_system_->index())
+        return result;
+
+    AssetIndexLinux::Stats stats = indexed_file_system_->index()->stats();
+    result.hits = stats.hits;
+    result.misses = stats.misses;
+    result.fallbacks = stats.fallbacks;
+    result.rebuilds = stats.rebuilds;
+    result.entries = stats.entries;
+    return result;
+}
+
+FileSystemCacheStats AppGLFW::file_system_cache_stats() const
+{
+    FileSystemCacheStats result;
+    if (!indexed_file_system_ || !indexed_file_system_->cache())
+        return result;
+
+    FileContentCache::Stats stats = indexed_file_system_->cache()->stats();
+    result.hits = stats.hits;
+    result.misses = stats.misses;
+    result.evictions = stats.evictions;
+    result.bytes = stats.bytes;
+    result.entries = stats.entries;
+    return result;
+}
+
+void AppGLFW::PurgeFileSystemCaches()
+{
+    if (indexed_file_system_ && indexed_file_system_->cache())
+        indexed_file_system_->cache()->Purge();
+}
+
+uint64_t AppGLFW::MemoryFootprint() const
+{
+    uint64_t rss = MemoryPressureMonitorLinux::ReadRSS();
+    return rss ? rss : AppImpl::MemoryFootprint();
+}
+
 void AppGLFW::Update()
 {
+    TraceZone("AppGLFW::Update");
+    auto start = std::chrono::steady_clock::now();
     UpdateBegin();
     UpdateIdleDetection();
+
+    MemoryPressureLevel pressure_level;
+    if (memory_pressure_monitor_ && memory_pressure_monitor_->Poll(pressure_level))
+        HandleMemoryPressure(pressure_level);
+
+    total_update_time_ += std::chrono::steady_clock::now() - start;
 }
 
 void AppGLFW::Repaint()
 {
+    TraceZone("AppGLFW::Repaint");
     App::instance()->renderer()->RefreshDisplay(0);
 
     bool needs_stat_update = false;
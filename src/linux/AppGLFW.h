@@ -1,9 +1,13 @@
 #pragma once
 #include "AppImpl.h"
 #include "gl/GPUContextGL.h"
+#if defined(APPCORE_ENABLE_VULKAN)
+#include "vk/GPUContextVulkan.h"
+#endif
 #include <AppCore/Window.h>
 #include "RefCountedImpl.h"
 #include "MonitorGLFW.h"
+#include "MemoryPressureMonitorLinux.h"
 #include "ULTextureSurface.h"
 #include <vector>
 #include <memory>
@@ -12,8 +16,10 @@
 namespace ultralight {
 
 class GPUContextGL;
+class GPUContextVulkan;
 class GPUDriverGL;
 class ClipboardGLFW;
+class FileSystemBasic;
 class WindowGLFW;
 
 class AppGLFW : public AppImpl,
@@ -27,6 +33,10 @@ public:
 
   virtual void Quit() override;
 
+  virtual FileSystemIndexStats file_system_index_stats() const override;
+
+  virtual FileSystemCacheStats file_system_cache_stats() const override;
+
   REF_COUNTED_IMPL(AppGLFW);
 
 protected:
@@ -36,8 +46,28 @@ protected:
   void Update();
   void Repaint();
 
+  // Null when the Vulkan driver is in use, see vulkan_context().
   GPUContextGL* gpu_context() { return gpu_context_.get(); }
-  GPUDriverImpl* gpu_driver() { return gpu_context_->driver(); }
+#if defined(APPCORE_ENABLE_VULKAN)
+  GPUContextVulkan* vulkan_context() { return vulkan_context_.get(); }
+#endif
+  GPUDriverImpl* gpu_driver() { return gpu_driver_impl(); }
+
+  // Total time spent in Update() since the app started, used to attribute
+  // update time to each window's frames.
+  std::chrono::nanoseconds total_update_time() const { return total_update_time_; }
+
+  GPUDriverImpl* gpu_driver_impl() const override {
+#if defined(APPCORE_ENABLE_VULKAN)
+    if (vulkan_context_)
+      return vulkan_context_->driver();
+#endif
+    return gpu_context_ ? gpu_context_->driver() : nullptr;
+  }
+
+  void PurgeFileSystemCaches() override;
+
+  uint64_t MemoryFootprint() const override;
 
   void AddWindow(WindowGLFW* window) { windows_.push_back(window); }
 
@@ -55,7 +85,13 @@ protected:
   RefPtr<Window> window_;
   std::unique_ptr<MonitorGLFW> main_monitor_;
   std::unique_ptr<GPUContextGL> gpu_context_;
+#if defined(APPCORE_ENABLE_VULKAN)
+  std::unique_ptr<GPUContextVulkan> vulkan_context_;
+#endif
   std::unique_ptr<ClipboardGLFW> clipboard_;
+  std::unique_ptr<MemoryPressureMonitorLinux> memory_pressure_monitor_;
+  FileSystemBasic* indexed_file_system_ = nullptr;
+  std::chrono::nanoseconds total_update_time_ = std::chrono::nanoseconds(0);
   std::unique_ptr<ULTextureSurfaceFactory> surface_factory_;
 };
 
@@ -0,0 +1,387 @@
+#include "AssetIndexLinux.h"
+#include "FileUtils.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace ultralight {
+
+// Larger trees aren't indexed, lookups go to the file system instead.
+static const size_t kMaxEntries = 1 << 20;
+
+// Time without further changes before the tree is rescanned, so a burst of
+// changes (eg, a build copying assets) causes a single rebuild.
+static const int kSettleTimeMs = 100;
+
+static const uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+  IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+static inline uint64_t HashByte(uint64_t hash, char c) {
+  // FNV-1a
+  return (hash ^ (unsigned char)c) * 1099511628211ULL;
+}
+
+static const uint64_t kHashSeed = 14695981039346656037ULL;
+
+// Normalises 'path' the same way FileSystemBasic::getRelative does, without
+// allocating. Returns false for paths that only the file system can resolve.
+static bool NormalizeAndHash(const char* path, size_t length, size_t& start, uint64_t& hash) {
+  start = 0;
+  if (length && (path[0] == '/' || path[0] == '\\'))
+    start = 1;
+  if (start == length)
+    return false;
+
+  hash = kHashSeed;
+  size_t segment_start = start;
+  for (size_t i = start; i <= length; i++) {
+    char c = i < length ? path[i] : '/';
+    if (c == '\\')
+      c = '/';
+
+    if (c == '/') {
+      // Reject empty, "." and ".." segments.
+      size_t segment_length = i - segment_start;
+      const char* segment = path + segment_start;
+      if (segment_length == 0 || (segment_length == 1 && segment[0] == '.') ||
+          (segment_length == 2 && segment[0] == '.' && segment[1] == '.'))
+        return false;
+      segment_start = i + 1;
+    }
+
+    if (i < length)
+      hash = HashByte(hash, c);
+  }
+
+  return true;
+}
+
+static bool PathEquals(const char* indexed, const char* path, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    char c = path[i] == '\\' ? '/' : path[i];
+    if (indexed[i] != c)
+      return false;
+  }
+  return true;
+}
+
+// Files without a known extension are sniffed once while indexing instead of
+// on every GetFileMimeType(). Changing a file triggers a rebuild, which sniffs
+// it again.
+static const char* SniffFileMimeType(int dir_fd, const char* name) {
+  const char* mime_type = nullptr;
+  int fd = openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+  if (fd >= 0) {
+    char head[FileUtils::kMimeSniffLength];
+    ssize_t length = pread(fd, head, sizeof(head), 0);
+    if (length > 0)
+      mime_type = FileUtils::SniffMimeType(head, (size_t)length);
+    close(fd);
+  }
+  return mime_type ? mime_type : "application/octet-stream";
+}
+
+AssetIndexLinux::AssetIndexLinux(const std::string& base_dir) : base_dir_(base_dir) {
+  wake_fd_ = eventfd(0, EFD_CLOEXEC);
+  if (wake_fd_ >= 0)
+    thread_ = std::thread(&AssetIndexLinux::ThreadMain, this);
+}
+
+AssetIndexLinux::~AssetIndexLinux() {
+  if (thread_.joinable()) {
+    uint64_t value = 1;
+    while (write(wake_fd_, &value, sizeof(value)) < 0 && errno == EINTR) {}
+    thread_.join();
+  }
+
+  if (wake_fd_ >= 0)
+    close(wake_fd_);
+}
+
+AssetIndexLinux::Result AssetIndexLinux::Lookup(const char* path, size_t length, Entry* entry) {
+  size_t start;
+  uint64_t hash;
+  if (stale_.load(std::memory_order_acquire) || !NormalizeAndHash(path, length, start, hash)) {
+    fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    return Result::Unavailable;
+  }
+
+  std::shared_ptr<const Table> table;
+  {
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    table = table_;
+  }
+
+  if (!table) {
+    fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    return Result::Unavailable;
+  }
+
+  path += start;
+  length -= start;
+
+  if (const Slot* slot = FindSlot(*table, path, length, hash)) {
+    if (entry)
+      *entry = slot->entry;
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return Result::Found;
+  }
+
+  if (table->has_opaque_directories && IsBelowOpaqueDirectory(*table, path, length)) {
+    fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    return Result::Unavailable;
+  }
+
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return Result::NotFound;
+}
+
+const AssetIndexLinux::Slot* AssetIndexLinux::FindSlot(const Table& table, const char* path,
+                                                       size_t length, uint64_t hash) {
+  size_t mask = table.slots.size() - 1;
+  for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask) {
+    const Slot& slot = table.slots[i];
+    if (!slot.used)
+      return nullptr;
+
+    if (slot.hash == hash && slot.path_length == length &&
+        PathEquals(table.paths.data() + slot.path_offset, path, length))
+      return &slot;
+  }
+}
+
+bool AssetIndexLinux::IsBelowOpaqueDirectory(const Table& table, const char* path, size_t length) {
+  uint64_t hash = kHashSeed;
+  for (size_t i = 0; i < length; i++) {
+    if (path[i] == '/' || path[i] == '\\') {
+      const Slot* slot = FindSlot(table, path, i, hash);
+      if (!slot)
+        return false;
+      if (slot->opaque)
+        return true;
+      hash = HashByte(hash, '/');
+    } else {
+      hash = HashByte(hash, path[i]);
+    }
+  }
+  return false;
+}
+
+AssetIndexLinux::Stats AssetIndexLinux::stats() const {
+  Stats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.fallbacks = fallbacks_.load(std::memory_order_relaxed);
+  stats.rebuilds = rebuilds_.load(std::memory_order_relaxed);
+  stats.entries = entries_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void AssetIndexLinux::ThreadMain() {
+  TraceRecorder::SetThreadName("Asset Index");
+
+  int inotify_fd = -1;
+  bool exit = false;
+  while (!exit) {
+    // Watches are added to a fresh inotify instance before each directory is
+    // read, so no change made during the scan can go unnoticed.
+    int new_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    std::shared_ptr<const Table> table = new_inotify_fd >= 0 ? BuildTable(new_inotify_fd) : nullptr;
+
+    if (inotify_fd >= 0)
+      close(inotify_fd);
+    inotify_fd = new_inotify_fd;
+
+    rebuilds_.fetch_add(1, std::memory_order_relaxed);
+    entries_.store(table ? table->count : 0, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(table_mutex_);
+      table_ = table;
+    }
+
+    // Without a complete, watched table lookups always go to the file system.
+    if (!table)
+      break;
+
+    if (!HasPendingEvents(inotify_fd))
+      stale_.store(false, std::memory_order_release);
+
+    struct pollfd fds[2] = { { inotify_fd, POLLIN, 0 }, { wake_fd_, POLLIN, 0 } };
+    int timeout = -1;
+    for (;;) {
+      int result = poll(fds, 2, timeout);
+      if (result < 0 && errno == EINTR)
+        continue;
+      if (result < 0 || fds[1].revents) {
+        exit = true;
+        break;
+      }
+      if (result == 0)
+        break; // Settled, rebuild
+
+      stale_.store(true, std::memory_order_release);
+      DrainEvents(inotify_fd);
+      timeout = kSettleTimeMs;
+    }
+  }
+
+  if (inotify_fd >= 0)
+    close(inotify_fd);
+
+  // Wait for the destructor if the loop ended early.
+  if (!exit) {
+    struct pollfd wake = { wake_fd_, POLLIN, 0 };
+    while (poll(&wake, 1, -1) < 0 && errno == EINTR) {}
+  }
+}
+
+std::shared_ptr<const AssetIndexLinux::Table> AssetIndexLinux::BuildTable(int inotify_fd) {
+  TraceZone("AssetIndexLinux::BuildTable");
+
+  struct PendingEntry {
+    uint64_t hash;
+    uint32_t path_offset;
+    uint32_t path_length;
+    bool opaque;
+    Entry entry;
+  };
+
+  struct PendingDirectory {
+    std::string path;
+    size_t entry_index; // SIZE_MAX for the base directory
+    std::vector<std::pair<dev_t, ino_t>> ancestors;
+  };
+
+  auto table = std::make_shared<Table>();
+  std::vector<PendingEntry> entries;
+  std::vector<PendingDirectory> directories = { { std::string(), SIZE_MAX, {} } };
+
+  while (!directories.empty()) {
+    PendingDirectory pending_dir = std::move(directories.back());
+    directories.pop_back();
+
+    // Unreadable subdirectories are left to the file system, but the index is
+    // useless if the base directory can't be scanned or anything can't be
+    // watched for lack of resources.
+    std::string dir_path = base_dir_ + pending_dir.path;
+    DIR* dir = nullptr;
+    if (inotify_add_watch(inotify_fd, dir_path.c_str(), kWatchMask) < 0 ||
+        !(dir = opendir(dir_path.c_str()))) {
+      if (pending_dir.entry_index == SIZE_MAX || (errno != EACCES && errno != ENOENT))
+        return nullptr;
+      entries[pending_dir.entry_index].opaque = true;
+      table->has_opaque_directories = true;
+      continue;
+    }
+
+    struct stat dir_info;
+    if (fstat(dirfd(dir), &dir_info) == 0)
+      pending_dir.ancestors.push_back({ dir_info.st_dev, dir_info.st_ino });
+
+    while (struct dirent* dir_entry = readdir(dir)) {
+      const char* name = dir_entry->d_name;
+      if (!strcmp(name, ".") || !strcmp(name, ".."))
+        continue;
+
+      // Follows symlinks, like opening the file would. Dangling links are
+      // left out.
+      struct stat info;
+      if (fstatat(dirfd(dir), name, &info, 0) != 0)
+        continue;
+
+      bool is_directory = S_ISDIR(info.st_mode);
+      if (!is_directory && !S_ISREG(info.st_mode))
+        continue;
+
+      std::string path = pending_dir.path + name;
+      if (entries.size() >= kMaxEntries || table->paths.size() + path.size() > UINT32_MAX) {
+        closedir(dir);
+        return nullptr;
+      }
+
+      PendingEntry pending = {};
+      pending.hash = kHashSeed;
+      for (char c : path)
+        pending.hash = HashByte(pending.hash, c);
+      pending.path_offset = (uint32_t)table->paths.size();
+      pending.path_length = (uint32_t)path.size();
+      pending.entry.size = is_directory ? 0 : (uint64_t)info.st_size;
+      pending.entry.mtime_ns = (int64_t)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+      pending.entry.is_directory = is_directory;
+      if (!is_directory) {
+        pending.entry.mime_type = FileUtils::LookupMimeType(FileUtils::FileExtension(path));
+        if (!pending.entry.mime_type)
+          pending.entry.mime_type = SniffFileMimeType(dirfd(dir), name);
+      }
+      entries.push_back(pending);
+      table->paths += path;
+
+      if (!is_directory)
+        continue;
+
+      // A symlink back to an ancestor would recurse forever.
+      auto id = std::make_pair(info.st_dev, info.st_ino);
+      if (std::find(pending_dir.ancestors.begin(), pending_dir.ancestors.end(), id) !=
+          pending_dir.ancestors.end()) {
+        entries.back().opaque = true;
+        table->has_opaque_directories = true;
+        continue;
+      }
+
+      directories.push_back({ path + "/", entries.size() - 1, pending_dir.ancestors });
+    }
+
+    closedir(dir);
+  }
+
+  size_t capacity = 16;
+  while (capacity < entries.size() * 2)
+    capacity *= 2;
+
+  table->slots.resize(capacity);
+  table->count = entries.size();
+  for (auto& pending : entries) {
+    size_t i = (size_t)pending.hash & (capacity - 1);
+    while (table->slots[i].used)
+      i = (i + 1) & (capacity - 1);
+
+    Slot& slot = table->slots[i];
+    slot.hash = pending.hash;
+    slot.path_offset = pending.path_offset;
+    slot.path_length = pending.path_length;
+    slot.used = true;
+    slot.opaque = pending.opaque;
+    slot.entry = pending.entry;
+  }
+
+  return table;
+}
+
+bool AssetIndexLinux::HasPendingEvents(int inotify_fd) {
+  struct pollfd fd = { inotify_fd, POLLIN, 0 };
+  return poll(&fd, 1, 0) != 0;
+}
+
+void AssetIndexLinux::DrainEvents(int inotify_fd) {
+  // Events only tell us that something changed, the tree is rescanned anyway.
+  alignas(struct inotify_event) char buffer[4096];
+  for (;;) {
+    ssize_t length = read(inotify_fd, buffer, sizeof(buffer));
+    if (length < 0 && errno == EINTR)
+      continue;
+    if (length <= 0)
+      break;
+  }
+}
+
+}  // namespace ultralight
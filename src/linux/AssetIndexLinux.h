@@ -0,0 +1,100 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ultralight {
+
+///
+/// In-memory index of every file and directory under FileSystemBasic's base
+/// directory, so FileExists(), GetFileMimeType() and failed OpenFile() calls
+/// can be answered without touching the disk.
+///
+/// The index is built on a watcher thread and published as an immutable
+/// table (open addressing over normalised relative paths). The thread then
+/// waits on inotify and rebuilds the table after changes settle.
+///
+/// Lookup() returns Unavailable until the first build completes, while a
+/// change is waiting to be indexed, for paths it can't resolve purely
+/// textually ("..", "./", "//"), for paths below directories that couldn't be
+/// scanned (unreadable, or a symlink back to an ancestor) and when the tree
+/// can't be watched (eg, the inotify watch limit was reached). Callers then
+/// fall back to the file system.
+///
+class AssetIndexLinux {
+public:
+  enum class Result { Found, NotFound, Unavailable };
+
+  struct Entry {
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;
+    const char* mime_type = nullptr; // Static string (sniffed if the extension is unknown), null for directories
+    bool is_directory = false;
+  };
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t fallbacks = 0;
+    uint64_t rebuilds = 0;
+    uint64_t entries = 0;
+  };
+
+  // 'base_dir' must end with a slash.
+  explicit AssetIndexLinux(const std::string& base_dir);
+  ~AssetIndexLinux();
+
+  // Looks up 'path' relative to the base directory. Backslashes are treated
+  // as forward slashes and a single leading slash is ignored (same as
+  // FileSystemBasic::getRelative). Thread-safe.
+  Result Lookup(const char* path, size_t length, Entry* entry = nullptr);
+
+  Stats stats() const;
+
+protected:
+  struct Slot {
+    uint64_t hash = 0;
+    uint32_t path_offset = 0;
+    uint32_t path_length = 0;
+    bool used = false;
+    bool opaque = false; // Directory whose contents aren't indexed
+    Entry entry;
+  };
+
+  struct Table {
+    std::vector<Slot> slots; // Power of two, at most half full
+    std::string paths;       // Normalised paths, not null-terminated
+    size_t count = 0;
+    bool has_opaque_directories = false;
+  };
+
+  // 'path' must already be stripped of its leading slash.
+  static const Slot* FindSlot(const Table& table, const char* path, size_t length, uint64_t hash);
+  static bool IsBelowOpaqueDirectory(const Table& table, const char* path, size_t length);
+
+  void ThreadMain();
+  std::shared_ptr<const Table> BuildTable(int inotify_fd);
+  static bool HasPendingEvents(int inotify_fd);
+  static void DrainEvents(int inotify_fd);
+
+  std::string base_dir_;
+  int wake_fd_ = -1;
+  std::thread thread_;
+
+  std::mutex table_mutex_;
+  std::shared_ptr<const Table> table_; // Guarded by table_mutex_
+  std::atomic<bool> stale_{ true };
+
+  std::atomic<uint64_t> hits_{ 0 };
+  std::atomic<uint64_t> misses_{ 0 };
+  std::atomic<uint64_t> fallbacks_{ 0 };
+  std::atomic<uint64_t> rebuilds_{ 0 };
+  std::atomic<uint64_t> entries_{ 0 };
+};
+
+}  // namespace ultralight
@@ -0,0 +1,492 @@
+#include "AsyncFileReaderLinux.h"
+#include "TraceRecorder.h"
+#include <Ultralight/platform/Platform.h>
+#include <Ultralight/platform/Logger.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(APPCORE_ENABLE_IO_URING)
+#  include <linux/io_uring.h>
+#  include <poll.h>
+#  include <sys/eventfd.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <unordered_set>
+#endif
+
+namespace ultralight {
+
+// Files up to this size are read into one of the registered buffers, which
+// spares the kernel pinning and unpinning the destination pages on every read.
+static const size_t kFixedBufferSize = 64 * 1024;
+static const int kFixedBufferCount = 32;
+
+static const unsigned kRingEntries = 128;
+static const int kPoolThreadCount = 4;
+
+// Largest single read, io_uring lengths are 32-bit.
+static const size_t kMaxReadSize = 1 << 30;
+
+struct AsyncFileReaderLinux::Request {
+  enum class Stage { Start, Open, Read } stage = Stage::Start;
+  std::string path;
+  Callback callback;
+  int fd = -1;
+  char* data = nullptr;
+  size_t size = 0;
+  size_t offset = 0;
+  int fixed_buffer = -1;
+};
+
+static void AsyncFileReader_FreeBufferCallback(void* user_data, void* data) {
+  free(data);
+}
+
+static RefPtr<Buffer> ReadWholeFile(const char* path) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat file_info;
+  if (fstat(fd, &file_info) != 0 || !S_ISREG(file_info.st_mode)) {
+    close(fd);
+    return nullptr;
+  }
+
+  size_t file_size = (size_t)file_info.st_size;
+  if (file_size == 0) {
+    close(fd);
+    return Buffer::CreateFromCopy("", 0);
+  }
+
+  char* data = (char*)malloc(file_size);
+  size_t offset = 0;
+  while (data && offset < file_size) {
+    ssize_t result = pread(fd, data + offset, file_size - offset, (off_t)offset);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result <= 0) {
+      free(data);
+      data = nullptr;
+      break;
+    }
+    offset += (size_t)result;
+  }
+  close(fd);
+
+  if (!data)
+    return nullptr;
+
+  return Buffer::Create(data, file_size, nullptr, AsyncFileReader_FreeBufferCallback);
+}
+
+#if defined(APPCORE_ENABLE_IO_URING)
+
+// CQE user_data of the eventfd poll that wakes the completion thread for new
+// requests (requests use their address).
+static const uint64_t kWakeUserData = 0;
+
+struct AsyncFileReaderLinux::Ring {
+  int fd = -1;
+  void* sq_ptr = MAP_FAILED;
+  size_t sq_size = 0;
+  void* cq_ptr = MAP_FAILED;
+  size_t cq_size = 0;
+  io_uring_sqe* sqes = (io_uring_sqe*)MAP_FAILED;
+  size_t sqes_size = 0;
+
+  unsigned* sq_head = nullptr;
+  unsigned* sq_tail = nullptr;
+  unsigned* sq_array = nullptr;
+  unsigned sq_mask = 0;
+  unsigned sq_entries = 0;
+  unsigned* cq_head = nullptr;
+  unsigned* cq_tail = nullptr;
+  unsigned cq_mask = 0;
+  io_uring_cqe* cqes = nullptr;
+
+  // SQEs filled in but not yet published to the kernel end at this index.
+  unsigned sqe_tail = 0;
+
+  ~Ring() {
+    if (sqes != MAP_FAILED)
+      munmap(sqes, sqes_size);
+    if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)
+      munmap(cq_ptr, cq_size);
+    if (sq_ptr != MAP_FAILED)
+      munmap(sq_ptr, sq_size);
+    if (fd >= 0)
+      close(fd);
+  }
+
+  io_uring_sqe* GetSQE() {
+    if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries)
+      return nullptr;
+
+    unsigned index = sqe_tail & sq_mask;
+    sq_array[index] = index;
+    sqe_tail++;
+    io_uring_sqe* sqe = &sqes[index];
+    memset(sqe, 0, sizeof(io_uring_sqe));
+    return sqe;
+  }
+
+  // Publishes filled SQEs, then submits them and waits for one completion.
+  int SubmitAndWait() {
+    __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+    unsigned to_submit = sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+  }
+};
+
+bool AsyncFileReaderLinux::SetupRing() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  std::unique_ptr<Ring> ring(new Ring());
+  ring->fd = (int)syscall(__NR_io_uring_setup, kRingEntries, &params);
+  if (ring->fd < 0)
+    return false;
+
+  // OPENAT and READ arrived in 5.6 along with this flag.
+  if (!(params.features & IORING_FEAT_RW_CUR_POS))
+    return false;
+
+  ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap)
+    ring->sq_size = ring->cq_size = std::max(ring->sq_size, ring->cq_size);
+
+  ring->sq_ptr = mmap(nullptr, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                      IORING_OFF_SQ_RING);
+  if (ring->sq_ptr == MAP_FAILED)
+    return false;
+
+  ring->cq_ptr = single_mmap ? ring->sq_ptr
+                             : mmap(nullptr, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                    ring->fd, IORING_OFF_CQ_RING);
+  if (ring->cq_ptr == MAP_FAILED)
+    return false;
+
+  ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  ring->sqes = (io_uring_sqe*)mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                   ring->fd, IORING_OFF_SQES);
+  if (ring->sqes == MAP_FAILED)
+    return false;
+
+  char* sq = (char*)ring->sq_ptr;
+  ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+  ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+  ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+  ring->sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+  ring->sq_entries = *(unsigned*)(sq + params.sq_off.ring_entries);
+  ring->sqe_tail = *ring->sq_tail;
+
+  char* cq = (char*)ring->cq_ptr;
+  ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+  ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+  ring->cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+  ring->cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+  wake_fd_ = eventfd(0, EFD_CLOEXEC);
+  if (wake_fd_ < 0)
+    return false;
+
+  // Optional, older kernels charge registered buffers to RLIMIT_MEMLOCK.
+  fixed_buffers_.resize(kFixedBufferSize * kFixedBufferCount);
+  struct iovec iovecs[kFixedBufferCount];
+  for (int i = 0; i < kFixedBufferCount; i++) {
+    iovecs[i].iov_base = fixed_buffers_.data() + i * kFixedBufferSize;
+    iovecs[i].iov_len = kFixedBufferSize;
+  }
+  if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iovecs, kFixedBufferCount) == 0) {
+    for (int i = kFixedBufferCount - 1; i >= 0; i--)
+      free_fixed_buffers_.push_back(i);
+  } else {
+    std::vector<char>().swap(fixed_buffers_);
+  }
+
+  ring_ = ring.release();
+  return true;
+}
+
+void AsyncFileReaderLinux::RingMain() {
+  TraceRecorder::SetThreadName("File Reader");
+  std::deque<Request*> backlog;
+
+  // Requests with an operation in flight.
+  std::unordered_set<Request*> active;
+
+  auto arm_wake = [&] {
+    io_uring_sqe* sqe = ring_->GetSQE();
+    if (!sqe)
+      return;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = wake_fd_;
+    sqe->poll_events = POLLIN;
+    sqe->user_data = kWakeUserData;
+  };
+  arm_wake();
+
+  for (;;) {
+    bool stopping;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      backlog.insert(backlog.end(), queue_.begin(), queue_.end());
+      queue_.clear();
+      stopping = stop_;
+    }
+
+    if (stopping && backlog.empty() && active.empty())
+      break;
+
+    // Each active request has at most one operation in flight, leave room
+    // for the wake poll.
+    while (!backlog.empty() && active.size() < kRingEntries - 1) {
+      Request* request = backlog.front();
+      backlog.pop_front();
+      if (Advance(request, 0))
+        active.insert(request);
+    }
+
+    if (ring_->SubmitAndWait() < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      if (Logger* logger = Platform::instance().logger())
+        logger->LogMessage(LogLevel::Warning, "io_uring failed, falling back to pread() for file reads.");
+
+      // New requests wake the pool path from here on. Swapped before taking
+      // the queue so a request either lands in it or sees the new backend.
+      backend_ = Backend::ThreadPool;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        backlog.insert(backlog.end(), queue_.begin(), queue_.end());
+        queue_.clear();
+      }
+
+      // Operations in flight can't be reaped and the kernel may still write
+      // to their destinations, so those requests are read again from the
+      // start. Their malloc'd buffers are leaked rather than reused; the
+      // registered buffers are never handed out again.
+      for (Request* request : active) {
+        request->data = nullptr;
+        request->fixed_buffer = -1;
+        Complete(request, ReadWholeFile(request->path.c_str()));
+      }
+      for (Request* request : backlog)
+        Complete(request, ReadWholeFile(request->path.c_str()));
+
+      PoolMain();
+      return;
+    }
+
+    unsigned head = *ring_->cq_head;
+    unsigned tail = __atomic_load_n(ring_->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+      const io_uring_cqe& cqe = ring_->cqes[head & ring_->cq_mask];
+      if (cqe.user_data == kWakeUserData) {
+        uint64_t value;
+        if (read(wake_fd_, &value, sizeof(value)) < 0) {
+          // Nothing to do, the counter was already drained.
+        }
+        arm_wake();
+      } else {
+        Request* request = (Request*)(uintptr_t)cqe.user_data;
+        if (!Advance(request, cqe.res))
+          active.erase(request);
+      }
+    }
+    __atomic_store_n(ring_->cq_head, head, __ATOMIC_RELEASE);
+  }
+}
+
+bool AsyncFileReaderLinux::Advance(Request* request, int result) {
+  switch (request->stage) {
+  case Request::Stage::Start:
+    break;
+  case Request::Stage::Open: {
+    if (result < 0) {
+      Complete(request, nullptr);
+      return false;
+    }
+
+    request->fd = result;
+    struct stat file_info;
+    if (fstat(request->fd, &file_info) != 0 || !S_ISREG(file_info.st_mode)) {
+      Complete(request, nullptr);
+      return false;
+    }
+
+    request->size = (size_t)file_info.st_size;
+    if (request->size == 0) {
+      Complete(request, Buffer::CreateFromCopy("", 0));
+      return false;
+    }
+
+    if (request->size <= kFixedBufferSize && !free_fixed_buffers_.empty()) {
+      request->fixed_buffer = free_fixed_buffers_.back();
+      free_fixed_buffers_.pop_back();
+    } else if (!(request->data = (char*)malloc(request->size))) {
+      Complete(request, nullptr);
+      return false;
+    }
+    request->stage = Request::Stage::Read;
+    break;
+  }
+  case Request::Stage::Read: {
+    if (result == -EINTR || result == -EAGAIN)
+      break;
+    if (result <= 0) {
+      // Read error, or the file shrank.
+      Complete(request, nullptr);
+      return false;
+    }
+
+    request->offset += (size_t)result;
+    if (request->offset < request->size)
+      break;
+
+    RefPtr<Buffer> buffer;
+    if (request->fixed_buffer >= 0) {
+      buffer = Buffer::CreateFromCopy(fixed_buffers_.data() + request->fixed_buffer * kFixedBufferSize,
+                                      request->size);
+    } else {
+      buffer = Buffer::Create(request->data, request->size, nullptr, AsyncFileReader_FreeBufferCallback);
+      request->data = nullptr;
+    }
+    Complete(request, buffer);
+    return false;
+  }
+  }
+
+  io_uring_sqe* sqe = ring_->GetSQE();
+  if (!sqe) {
+    Complete(request, nullptr);
+    return false;
+  }
+
+  sqe->user_data = (uint64_t)(uintptr_t)request;
+  if (request->stage == Request::Stage::Start) {
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t)(uintptr_t)request->path.c_str();
+    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    request->stage = Request::Stage::Open;
+    return true;
+  }
+
+  char* destination = request->fixed_buffer >= 0 ? fixed_buffers_.data() + request->fixed_buffer * kFixedBufferSize
+                                                 : request->data;
+  sqe->opcode = request->fixed_buffer >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+  sqe->fd = request->fd;
+  sqe->addr = (uint64_t)(uintptr_t)(destination + request->offset);
+  sqe->len = (uint32_t)std::min(request->size - request->offset, kMaxReadSize);
+  sqe->off = request->offset;
+  if (request->fixed_buffer >= 0)
+    sqe->buf_index = (uint16_t)request->fixed_buffer;
+  return true;
+}
+
+#else
+
+struct AsyncFileReaderLinux::Ring {};
+
+bool AsyncFileReaderLinux::SetupRing() {
+  return false;
+}
+
+void AsyncFileReaderLinux::RingMain() {}
+
+bool AsyncFileReaderLinux::Advance(Request* request, int result) {
+  return false;
+}
+
+#endif
+
+AsyncFileReaderLinux::AsyncFileReaderLinux(Backend backend) {
+  if (backend == Backend::IoUring && SetupRing()) {
+    backend_ = Backend::IoUring;
+    threads_.emplace_back(&AsyncFileReaderLinux::RingMain, this);
+    return;
+  }
+
+  for (int i = 0; i < kPoolThreadCount; i++)
+    threads_.emplace_back(&AsyncFileReaderLinux::PoolMain, this);
+}
+
+AsyncFileReaderLinux::~AsyncFileReaderLinux() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (wake_fd_ >= 0) {
+    uint64_t value = 1;
+    if (write(wake_fd_, &value, sizeof(value)) < 0) {
+      // Can only fail if the counter overflows, the thread is awake then.
+    }
+  }
+
+  for (std::thread& thread : threads_)
+    thread.join();
+
+  delete ring_;
+  if (wake_fd_ >= 0)
+    close(wake_fd_);
+}
+
+void AsyncFileReaderLinux::ReadFile(std::string path, Callback callback) {
+  Request* request = new Request();
+  request->path = std::move(path);
+  request->callback = std::move(callback);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(request);
+  }
+
+  if (backend_ == Backend::IoUring) {
+    uint64_t value = 1;
+    if (write(wake_fd_, &value, sizeof(value)) < 0) {
+      // Can only fail if the counter overflows, the thread is awake then.
+    }
+  } else {
+    cv_.notify_one();
+  }
+}
+
+void AsyncFileReaderLinux::PoolMain() {
+  TraceRecorder::SetThreadName("File Reader");
+  for (;;) {
+    Request* request;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+      if (queue_.empty())
+        return;
+      request = queue_.front();
+      queue_.pop_front();
+    }
+
+    Complete(request, ReadWholeFile(request->path.c_str()));
+  }
+}
+
+void AsyncFileReaderLinux::Complete(Request* request, RefPtr<Buffer> buffer) {
+  if (request->fd >= 0)
+    close(request->fd);
+  if (request->fixed_buffer >= 0)
+    free_fixed_buffers_.push_back(request->fixed_buffer);
+  free(request->data);
+
+  if (request->callback)
+    request->callback(buffer);
+  delete request;
+}
+
+}  // namespace ultralight
@@ -0,0 +1,83 @@
+#pragma once
+#include <Ultralight/Buffer.h>
+#include <Ultralight/RefPtr.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ultralight {
+
+///
+/// Reads whole files into memory without blocking the caller.
+///
+/// Reads are queued from any thread and submitted in batches to an io_uring
+/// by a completion thread, which opens and reads them asynchronously (into
+/// registered buffers for small files). Files are closed with a plain close()
+/// on the completion thread once read. When io_uring is unavailable (kernels
+/// older than 5.6, seccomp filters, the io_uring_disabled sysctl, or built
+/// without APPCORE_ENABLE_IO_URING) a small pool of threads does the same
+/// with open() and pread() instead.
+///
+/// If the ring fails later on, the completion thread reads everything still
+/// pending with pread() and keeps serving requests that way.
+///
+class AsyncFileReaderLinux {
+public:
+  enum class Backend { IoUring, ThreadPool };
+
+  // Receives the file contents, or null if the file couldn't be read. Runs on
+  // the completion (or a pool) thread, so it should return quickly.
+  typedef std::function<void(RefPtr<Buffer>)> Callback;
+
+  // Uses io_uring if 'backend' is IoUring and the kernel supports it.
+  explicit AsyncFileReaderLinux(Backend backend = Backend::IoUring);
+
+  // Waits for queued reads to complete.
+  ~AsyncFileReaderLinux();
+
+  Backend backend() const { return backend_; }
+
+  // Queues a read of the entire file at 'path'. Thread-safe.
+  void ReadFile(std::string path, Callback callback);
+
+protected:
+  struct Request;
+  struct Ring;
+
+  bool SetupRing();
+
+  void RingMain();
+
+  // Queues the next io_uring operation for 'request'. Returns false when the
+  // request is finished (and completed).
+  bool Advance(Request* request, int result);
+
+  void PoolMain();
+
+  // Releases the request's resources and runs its callback.
+  void Complete(Request* request, RefPtr<Buffer> buffer);
+
+  // Read by ReadFile() without the lock, switches to ThreadPool if the
+  // ring fails.
+  std::atomic<Backend> backend_{Backend::ThreadPool};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request*> queue_;
+  bool stop_ = false;
+
+  // io_uring backend
+  Ring* ring_ = nullptr;
+  int wake_fd_ = -1;
+  std::vector<char> fixed_buffers_;
+  std::vector<int> free_fixed_buffers_;
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace ultralight
@@ -0,0 +1,75 @@
+#include "FileContentCache.h"
+#include <iterator>
+#include <utility>
+
+namespace ultralight {
+
+RefPtr<Buffer> FileContentCache::Get(const std::string& path, uint64_t size, int64_t mtime_ns) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = map_.find(path);
+  if (it == map_.end()) {
+    misses_++;
+    return nullptr;
+  }
+
+  EntryList::iterator entry = it->second;
+  if (entry->size != size || entry->mtime_ns != mtime_ns) {
+    // Changed on disk since it was cached.
+    Remove(entry);
+    misses_++;
+    return nullptr;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry);
+  hits_++;
+  return entry->buffer;
+}
+
+void FileContentCache::Put(const std::string& path, uint64_t size, int64_t mtime_ns, RefPtr<Buffer> buffer) {
+  if (!buffer || buffer->size() > capacity_)
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = map_.find(path);
+  if (it != map_.end())
+    Remove(it->second);
+
+  while (!entries_.empty() && bytes_ + buffer->size() > capacity_) {
+    Remove(std::prev(entries_.end()));
+    evictions_++;
+  }
+
+  bytes_ += buffer->size();
+  entries_.push_front(Entry { path, size, mtime_ns, std::move(buffer) });
+  map_[path] = entries_.begin();
+}
+
+void FileContentCache::Purge() {
+  EntryList entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.swap(entries_);
+    map_.clear();
+    bytes_ = 0;
+  }
+  // Buffers are released here, outside the lock.
+}
+
+FileContentCache::Stats FileContentCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats result;
+  result.hits = hits_;
+  result.misses = misses_;
+  result.evictions = evictions_;
+  result.bytes = bytes_;
+  result.entries = map_.size();
+  return result;
+}
+
+void FileContentCache::Remove(EntryList::iterator entry) {
+  bytes_ -= entry->buffer->size();
+  map_.erase(entry->path);
+  entries_.erase(entry);
+}
+
+}  // namespace ultralight
@@ -0,0 +1,72 @@
+#pragma once
+#include <Ultralight/Buffer.h>
+#include <Ultralight/RefPtr.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ultralight {
+
+///
+/// Byte-capped LRU cache of file contents for FileSystemBasic.
+///
+/// Entries are keyed by normalised path and remember the size and mtime the
+/// AssetIndexLinux reported when they were read; Get() only returns an entry
+/// if the index still reports the same, so files rewritten on disk (which the
+/// index picks up through inotify) are read again. The same Buffer is handed
+/// out to every caller, nothing is copied.
+///
+class FileContentCache {
+public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t bytes = 0;
+    uint64_t entries = 0;
+  };
+
+  explicit FileContentCache(size_t capacity) : capacity_(capacity) {}
+
+  // Returns the cached contents of 'path' if they were cached with the same
+  // 'size' and 'mtime_ns', otherwise drops the entry and returns null.
+  RefPtr<Buffer> Get(const std::string& path, uint64_t size, int64_t mtime_ns);
+
+  // Caches 'buffer' as the contents of 'path', evicting the least recently
+  // used entries to stay under the capacity. Files larger than the capacity
+  // aren't cached.
+  void Put(const std::string& path, uint64_t size, int64_t mtime_ns, RefPtr<Buffer> buffer);
+
+  // Drops every entry.
+  void Purge();
+
+  Stats stats() const;
+
+protected:
+  struct Entry {
+    std::string path;
+    uint64_t size;
+    int64_t mtime_ns;
+    RefPtr<Buffer> buffer;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  // Call with mutex_ held.
+  void Remove(EntryList::iterator entry);
+
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  EntryList entries_; // Most recently used first
+  std::unordered_map<std::string, EntryList::iterator> map_;
+  size_t bytes_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+};
+
+}  // namespace ultralight
@@ -1,10 +1,16 @@
 #include "FileSystemBasic.h"
 #include "FileUtils.h"
+#include "TraceRecorder.h"
 #include <Ultralight/String.h>
 #include <fstream>
-#include <memory>
-#include <vector>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace ultralight {
 
@@ -42,58 +48,182 @@ std::string FileSystemBasic::getRelative(const String& path) {
   return baseDir_ + relPath;
 }
 
+void FileSystemBasic::EnableIndex() {
+  if (!index_)
+    index_.reset(new AssetIndexLinux(baseDir_));
+}
+
+void FileSystemBasic::EnableCache(size_t capacity) {
+  EnableIndex();
+  if (!cache_)
+    cache_.reset(new FileContentCache(capacity));
+}
+
 bool FileSystemBasic::FileExists(const String& path) {
+  if (index_) {
+    String8 utf8 = path.utf8();
+    auto result = index_->Lookup(utf8.data(), utf8.length());
+    if (result != AssetIndexLinux::Result::Unavailable)
+      return result == AssetIndexLinux::Result::Found;
+  }
+
   std::ifstream filestream(getRelative(path));
   return filestream.good();
 }
 
 String FileSystemBasic::GetFileMimeType(const String& file_path) {
   String8 utf8 = file_path.utf8();
-  std::string filepath(utf8.data(), utf8.length()); 
-  std::string ext = filepath.substr(filepath.find_last_of(".") + 1);
-  return String(FileUtils::FileExtensionToMimeType(ext.c_str()));
+
+  AssetIndexLinux::Entry entry;
+  if (index_ && index_->Lookup(utf8.data(), utf8.length(), &entry) == AssetIndexLinux::Result::Found &&
+      entry.mime_type)
+    return String(entry.mime_type);
+
+  std::string_view filepath(utf8.data(), utf8.length());
+  if (const char* mime_type = FileUtils::LookupMimeType(FileUtils::FileExtension(filepath)))
+    return String(mime_type);
+
+  // Missing or unknown extension, look at the contents instead. The index
+  // caches this, so it only happens while the index is unavailable.
+  char head[FileUtils::kMimeSniffLength];
+  ssize_t length = 0;
+  int fd = open(getRelative(file_path).c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd != -1) {
+    length = pread(fd, head, sizeof(head), 0);
+    close(fd);
+  }
+  return String(FileUtils::FileMimeType(filepath, head, length > 0 ? (size_t)length : 0));
 }
 
 String FileSystemBasic::GetFileCharset(const String& file_path) {
   return "utf-8";
 }
 
-struct FileSystemBasic_BufferData {
-  std::unique_ptr<std::ifstream> file_handle;
-  int64_t file_size;
-  std::unique_ptr<std::vector<char>> file_contents;
-};
-
-void FileSystemBasic_DestroyBufferCallback(void* user_data, void* data) {
-  FileSystemBasic_BufferData* buffer_data = reinterpret_cast<FileSystemBasic_BufferData*>(user_data);
-  buffer_data->file_contents.reset();
-  buffer_data->file_handle.reset();
-  delete buffer_data;
+// Files up to this size are read into a heap buffer, mapping them would cost
+// more (mmap, page faults, munmap) than the copy.
+static const size_t kMapThreshold = 64 * 1024;
+
+static void FileSystemBasic_FreeBufferCallback(void* user_data, void* data) {
+  free(data);
 }
 
-RefPtr<Buffer> FileSystemBasic::OpenFile(const String& file_path) {
-  std::unique_ptr<std::ifstream> file(new std::ifstream(getRelative(file_path), std::ifstream::ate | std::ifstream::binary));
-  if (!file->good())
+static void FileSystemBasic_UnmapBufferCallback(void* user_data, void* data) {
+  // user_data holds the mapping length.
+  munmap(data, (size_t)(uintptr_t)user_data);
+}
+
+static RefPtr<Buffer> ReadFileCopy(int fd, size_t file_size) {
+  char* data = (char*)malloc(file_size);
+  if (!data)
     return nullptr;
 
-  file->seekg(0, file->end);
-  int64_t file_size = (int64_t)file->tellg();
+  size_t offset = 0;
+  while (offset < file_size) {
+    ssize_t result = pread(fd, data + offset, file_size - offset, (off_t)offset);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result <= 0) {
+      free(data);
+      return nullptr;
+    }
+    offset += (size_t)result;
+  }
 
-  if (file_size <= 0)
+  return Buffer::Create(data, file_size, nullptr, FileSystemBasic_FreeBufferCallback);
+}
+
+static RefPtr<Buffer> MapFile(int fd, size_t file_size) {
+  void* data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED)
     return nullptr;
 
-  std::unique_ptr<std::vector<char>> buffer(new std::vector<char>(file_size));
+  // Consumers (decoders, font parsers, the WASM compiler) touch most of the
+  // file soon after loading it, start reading it in now.
+  madvise(data, file_size, MADV_WILLNEED);
+
+  return Buffer::Create(data, file_size, (void*)(uintptr_t)file_size,
+    FileSystemBasic_UnmapBufferCallback);
+}
 
-  file->seekg(0, file->beg);
-  file->read(buffer->data(), (std::streamsize)file_size);
+RefPtr<Buffer> FileSystemBasic::OpenFile(const String& file_path) {
+  TraceZone("FileSystemBasic::OpenFile");
+  std::string path = getRelative(file_path);
+
+  // Only files the index vouches for are cached, the cache relies on it to
+  // notice changes.
+  bool cacheable = false;
+  AssetIndexLinux::Entry entry;
+  if (index_) {
+    // Skip the open() for files that aren't there (WebCore probes a lot).
+    String8 utf8 = file_path.utf8();
+    auto result = index_->Lookup(utf8.data(), utf8.length(), &entry);
+    if (result == AssetIndexLinux::Result::NotFound ||
+        (result == AssetIndexLinux::Result::Found && entry.is_directory))
+      return nullptr;
+
+    cacheable = cache_ && result == AssetIndexLinux::Result::Found;
+    if (cacheable) {
+      if (RefPtr<Buffer> buffer = cache_->Get(path, entry.size, entry.mtime_ns))
+        return buffer;
+    }
+  }
+
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat file_info;
+  if (fstat(fd, &file_info) != 0 || !S_ISREG(file_info.st_mode)) {
+    close(fd);
+    return nullptr;
+  }
+
+  size_t file_size = (size_t)file_info.st_size;
+  RefPtr<Buffer> buffer;
+
+  if (file_size == 0) {
+    // Empty files are valid (eg, an empty stylesheet) but can't be mapped.
+    buffer = Buffer::CreateFromCopy("", 0);
+  } else if (file_size <= kMapThreshold || cacheable) {
+    // Cached contents outlive the file on disk: a mapping would fault
+    // (SIGBUS) once the file is truncated, so cache only copies.
+    buffer = ReadFileCopy(fd, file_size);
+  } else {
+    // The mapping stays valid after the descriptor is closed.
+    buffer = MapFile(fd, file_size);
+  }
+
+  close(fd);
+
+  // A size mismatch means it changed after it was indexed, don't cache
+  // contents the index hasn't seen.
+  if (cacheable && buffer && buffer->size() == entry.size)
+    cache_->Put(path, entry.size, entry.mtime_ns, buffer);
+
+  return buffer;
+}
+
+void FileSystemBasic::OpenFileAsync(const String& file_path, AsyncFileReaderLinux::Callback callback) {
+  if (index_) {
+    String8 utf8 = file_path.utf8();
+    AssetIndexLinux::Entry entry;
+    auto result = index_->Lookup(utf8.data(), utf8.length(), &entry);
+    if (result == AssetIndexLinux::Result::NotFound ||
+        (result == AssetIndexLinux::Result::Found && entry.is_directory)) {
+      callback(nullptr);
+      return;
+    }
+  }
+
+  AsyncFileReaderLinux* reader;
+  {
+    std::lock_guard<std::mutex> lock(async_reader_mutex_);
+    if (!async_reader_)
+      async_reader_.reset(new AsyncFileReaderLinux());
+    reader = async_reader_.get();
+  }
 
-  FileSystemBasic_BufferData* buffer_data = new FileSystemBasic_BufferData();
-  buffer_data->file_handle = std::move(file);
-  buffer_data->file_size = file_size;
-  buffer_data->file_contents = std::move(buffer);
-  
-  return Buffer::Create(buffer_data->file_contents->data(), buffer_data->file_size,
-    buffer_data, FileSystemBasic_DestroyBufferCallback);
+  reader->ReadFile(getRelative(file_path), std::move(callback));
 }
 
 FileSystem* CreatePlatformFileSystem(const String& baseDir) {
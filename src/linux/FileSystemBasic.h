@@ -1,11 +1,33 @@
 #pragma once
+#include "AssetIndexLinux.h"
+#include "AsyncFileReaderLinux.h"
+#include "FileContentCache.h"
 #include <Ultralight/platform/FileSystem.h>
+#include <memory>
+#include <mutex>
 #include <string>
 
 namespace ultralight {
 
 /**
- * Basic FileSystem interface, implemented using the C++ STL.
+ * Basic FileSystem interface, implemented using POSIX file APIs.
+ *
+ * Large files are memory-mapped read-only instead of copied, so the pages
+ * are shared with the OS page cache and only loaded as they are read. The
+ * mapping is not a snapshot: if the file is truncated while a Buffer for it
+ * is alive, touching the missing pages raises SIGBUS, so only hand mapped
+ * Buffers to consumers that are done with them before the file changes.
+ *
+ * With EnableIndex(), existence and mime type queries are answered from an
+ * AssetIndexLinux of the base directory instead of the disk.
+ *
+ * With EnableCache(), file contents are also kept in a FileContentCache,
+ * validated against the index, so repeated loads share one Buffer. Files
+ * read for the cache are always copied to the heap, never mapped, since a
+ * cached Buffer may outlive any number of rewrites of the file.
+ *
+ * OpenFileAsync() reads through an AsyncFileReaderLinux (io_uring, or a
+ * thread pool) without blocking the caller.
  */
 class FileSystemBasic : public FileSystem {
  public:
@@ -20,8 +42,28 @@ class FileSystemBasic : public FileSystem {
 
     virtual RefPtr<Buffer> OpenFile(const String& file_path) override;
 
+    // Reads the whole file without blocking, 'callback' receives the contents
+    // (or null) on the reader's thread. Thread-safe.
+    void OpenFileAsync(const String& file_path, AsyncFileReaderLinux::Callback callback);
+
+    // Starts indexing the base directory on a background thread.
+    void EnableIndex();
+
+    // Returns null unless EnableIndex() was called.
+    AssetIndexLinux* index() { return index_.get(); }
+
+    // Caches up to 'capacity' bytes of file contents. Enables the index.
+    void EnableCache(size_t capacity);
+
+    // Returns null unless EnableCache() was called.
+    FileContentCache* cache() { return cache_.get(); }
+
 protected:
     std::string baseDir_;
+    std::unique_ptr<AssetIndexLinux> index_;
+    std::unique_ptr<FileContentCache> cache_;
+    std::mutex async_reader_mutex_;
+    std::unique_ptr<AsyncFileReaderLinux> async_reader_;
     std::string getRelative(const String& path);
 };
     
@@ -0,0 +1,146 @@
+#include "FontCoverageIndex.h"
+#include "TraceRecorder.h"
+#include <fontconfig/fontconfig.h>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace ultralight {
+
+static_assert(FC_CHARSET_MAP_SIZE == 8, "Unexpected fontconfig charset page size");
+
+static inline bool HasChar(const uint32_t* bits, char32_t c) {
+  return (bits[(c >> 5) & 7] >> (c & 31)) & 1;
+}
+
+std::shared_ptr<const FontCoverageIndex> FontCoverageIndex::Build() {
+  TraceZone("FontCoverageIndex::Build");
+
+  // Sorting against the default pattern orders faces the way the user's
+  // configuration prefers them when nothing more specific is asked for.
+  FcPattern* pattern = FcPatternCreate();
+  FcConfigSubstitute(nullptr, pattern, FcMatchPattern);
+  FcDefaultSubstitute(pattern);
+  FcResult result;
+  FcFontSet* fonts = FcFontSort(nullptr, pattern, FcFalse, nullptr, &result);
+  FcPatternDestroy(pattern);
+  if (!fonts)
+    return nullptr;
+
+  std::shared_ptr<FontCoverageIndex> index(new FontCoverageIndex());
+  std::unordered_map<std::string, uint32_t> family_ids;
+  for (int i = 0; i < fonts->nfont; i++) {
+    FcPattern* font = fonts->fonts[i];
+
+    // Same as FontLoaderLinux::Load, which never picks unscalable fonts.
+    FcBool scalable;
+    if (FcPatternGetBool(font, FC_SCALABLE, 0, &scalable) == FcResultMatch && !scalable)
+      continue;
+
+    FcChar8* family;
+    FcCharSet* charset;
+    if (FcPatternGetString(font, FC_FAMILY, 0, &family) != FcResultMatch ||
+        FcPatternGetCharSet(font, FC_CHARSET, 0, &charset) != FcResultMatch)
+      continue;
+
+    // Variable fonts report ranges here, they are left at the defaults.
+    int weight = FC_WEIGHT_REGULAR;
+    int slant = FC_SLANT_ROMAN;
+    FcPatternGetInteger(font, FC_WEIGHT, 0, &weight);
+    FcPatternGetInteger(font, FC_SLANT, 0, &slant);
+
+    auto inserted = family_ids.emplace(reinterpret_cast<const char*>(family),
+                                       (uint32_t)index->families_.size());
+    if (inserted.second)
+      index->families_.push_back(inserted.first->first);
+
+    uint32_t face = (uint32_t)index->faces_.size();
+    index->faces_.push_back({ inserted.first->second, slant != FC_SLANT_ROMAN,
+                              weight >= FC_WEIGHT_SEMIBOLD });
+
+    FcChar32 map[FC_CHARSET_MAP_SIZE];
+    FcChar32 next;
+    for (FcChar32 base = FcCharSetFirstPage(charset, map, &next); base != FC_CHARSET_DONE;
+         base = FcCharSetNextPage(charset, map, &next)) {
+      Page page;
+      page.page = base >> 8;
+      page.face = face;
+      memcpy(page.bits, map, sizeof(page.bits));
+      index->pages_.push_back(page);
+    }
+  }
+  FcFontSetDestroy(fonts);
+
+  if (index->faces_.empty())
+    return nullptr;
+
+  std::sort(index->pages_.begin(), index->pages_.end(), [](const Page& a, const Page& b) {
+    return a.page != b.page ? a.page < b.page : a.face < b.face;
+  });
+
+  return index;
+}
+
+const std::string* FontCoverageIndex::FallbackFamily(const char32_t* characters, size_t length,
+                                                     int weight, bool italic) const {
+  // Every face covering any of the characters is a candidate. Collecting the
+  // face of each covering page and sorting groups them, one run per face with
+  // a length of the number of characters it covers.
+  // Reused, lookups happen on few threads but often.
+  thread_local std::vector<uint32_t> covering;
+  covering.clear();
+  for (size_t i = 0; i < length; i++) {
+    const Page* end;
+    for (const Page* page = FindPages(characters[i] >> 8, &end); page < end; page++) {
+      if (HasChar(page->bits, characters[i]))
+        covering.push_back(page->face);
+    }
+  }
+  if (covering.empty())
+    return nullptr;
+  std::sort(covering.begin(), covering.end());
+
+  bool bold = weight >= FC_WEIGHT_SEMIBOLD;
+  size_t best_covered = 0;
+  bool best_style = false;
+  uint32_t best_face = 0;
+
+  // Faces are visited in preference order, so ties keep the earlier face.
+  for (size_t run = 0; run < covering.size();) {
+    uint32_t face_id = covering[run];
+    size_t run_end = run;
+    while (run_end < covering.size() && covering[run_end] == face_id)
+      run_end++;
+    size_t covered = run_end - run;
+    run = run_end;
+
+    const Face& face = faces_[face_id];
+    bool style = face.italic == italic && face.bold == bold;
+    if (covered > best_covered || (covered == best_covered && style && !best_style)) {
+      best_covered = covered;
+      best_style = style;
+      best_face = face_id;
+    }
+  }
+
+  return &families_[faces_[best_face].family];
+}
+
+size_t FontCoverageIndex::memory_usage() const {
+  size_t bytes = families_.capacity() * sizeof(std::string) + faces_.capacity() * sizeof(Face) +
+                 pages_.capacity() * sizeof(Page);
+  for (const std::string& family : families_)
+    bytes += family.capacity() + 1;
+  return bytes;
+}
+
+const FontCoverageIndex::Page* FontCoverageIndex::FindPages(uint32_t page, const Page** end) const {
+  const Page* pages_end = pages_.data() + pages_.size();
+  const Page* begin = std::lower_bound(pages_.data(), pages_end, page,
+                                       [](const Page& a, uint32_t page) { return a.page < page; });
+  *end = std::upper_bound(begin, pages_end, page,
+                          [](uint32_t page, const Page& a) { return page < a.page; });
+  return begin;
+}
+
+}  // namespace ultralight
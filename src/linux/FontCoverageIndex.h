@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ultralight {
+
+///
+/// Immutable map from codepoints to the installed fonts that cover them, so
+/// FontLoaderLinux can pick fallback fonts without a full FcFontMatch.
+///
+/// Build() lists every scalable face once (FcFontSort, so faces are ordered
+/// by the user's fontconfig preferences) and copies each face's FC_CHARSET as
+/// 256-codepoint pages. Lookups binary search those pages and never call into
+/// fontconfig.
+///
+class FontCoverageIndex {
+public:
+  // Returns null if fontconfig lists no usable fonts.
+  static std::shared_ptr<const FontCoverageIndex> Build();
+
+  // Picks the family to render 'characters' with, like FcFontMatch would for
+  // a pattern of just their charset, weight and slant: the face covering the
+  // most characters wins, then faces matching the requested slant and
+  // boldness, then fontconfig's preference order. 'weight' is a fontconfig
+  // weight (FC_WEIGHT_*). Returns null if no face covers any character.
+  // Thread-safe.
+  const std::string* FallbackFamily(const char32_t* characters, size_t length, int weight,
+                                    bool italic) const;
+
+  size_t face_count() const { return faces_.size(); }
+  size_t family_count() const { return families_.size(); }
+  size_t page_count() const { return pages_.size(); }
+
+  // Approximate heap bytes held by the index.
+  size_t memory_usage() const;
+
+protected:
+  struct Face {
+    uint32_t family; // Index into families_
+    bool italic;
+    bool bold;
+  };
+
+  // One per (page, face) with any coverage, sorted by page then face.
+  struct Page {
+    uint32_t page; // Codepoint >> 8
+    uint32_t face; // Index into faces_, lower is preferred
+    uint32_t bits[8];
+  };
+
+  FontCoverageIndex() = default;
+
+  // Range of pages_ for 'page', in face order.
+  const Page* FindPages(uint32_t page, const Page** end) const;
+
+  std::vector<std::string> families_;
+  std::vector<Face> faces_;
+  std::vector<Page> pages_;
+};
+
+}  // namespace ultralight
@@ -1,5 +1,7 @@
 #include "FontLoaderLinux.h"
+#include "TraceRecorder.h"
 #include <fontconfig/fontconfig.h>
+#include <chrono>
 #include <memory>
 #include <map>
 #include <string.h>
@@ -10,11 +12,26 @@
 
 namespace ultralight {
 
+// How often the memoised matches are checked against fontconfig's configuration.
+static const std::chrono::seconds kConfigCheckInterval(5);
+
+// Fallback lookups are keyed by arbitrary runs of text, so that cache is
+// bounded (it is simply dropped when full).
+static const size_t kMaxFallbackFonts = 4096;
+
 FontLoaderLinux::FontLoaderLinux() {
     FcInit();
+    last_config_check_ = std::chrono::steady_clock::now();
 }
 
-FontLoaderLinux::~FontLoaderLinux() {}
+FontLoaderLinux::~FontLoaderLinux() {
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        stop_index_ = true;
+    }
+    if (index_thread_.joinable())
+        index_thread_.join();
+}
 
 template<typename T>
 struct FcPtrDeleter {
@@ -335,12 +352,60 @@ FcUniquePtr<FcPattern> GetPatternForDescription(const std::string& family, int w
 
 String FontLoaderLinux::fallback_font() const { return "sans"; }
 
-String FontLoaderLinux::fallback_font_for_characters(const String& characters, int weight, bool italic) const {
-    FcUniquePtr<FcCharSet> charset(FcCharSetCreate());
+void FontLoaderLinux::RevalidateCache() const {
+  auto now = std::chrono::steady_clock::now();
+  if (now - last_config_check_ < kConfigCheckInterval)
+    return;
+  last_config_check_ = now;
+
+  // FcConfigUptoDate() stats every config file and font directory, hence the
+  // interval above.
+  if (FcConfigUptoDate(nullptr))
+    return;
+
+  FcInitReinitialize();
+  font_files_.clear();
+  fallback_fonts_.clear();
+  config_generation_++;
+
+  // A build in progress notices the new generation and starts over.
+  coverage_index_.reset();
+  index_generation_++;
+  if (!index_building_)
+    index_requested_ = false;
+}
 
-    // Obtain UTF-32 representation of the input string
-    const char32_t* utf32_characters = characters.utf32().data();
-    size_t utf32_length = characters.utf32().length();
+void FontLoaderLinux::RequestCoverageIndex() const {
+  if (index_requested_)
+    return;
+  index_requested_ = true;
+  index_building_ = true;
+
+  // A previous build thread has already finished (index_building_ was false).
+  if (index_thread_.joinable())
+    index_thread_.join();
+  index_thread_ = std::thread(&FontLoaderLinux::IndexMain, this);
+}
+
+void FontLoaderLinux::IndexMain() const {
+  TraceRecorder::SetThreadName("Font Index");
+  std::unique_lock<std::mutex> lock(cache_mutex_);
+  while (!stop_index_) {
+    uint64_t generation = index_generation_;
+    lock.unlock();
+    std::shared_ptr<const FontCoverageIndex> index = FontCoverageIndex::Build();
+    lock.lock();
+    if (generation == index_generation_) {
+      coverage_index_ = std::move(index);
+      break;
+    }
+  }
+  index_building_ = false;
+}
+
+static String fallbackFontForCharacters(const char32_t* utf32_characters, size_t utf32_length,
+                                        int weight, bool italic, const String& fallback_font) {
+    FcUniquePtr<FcCharSet> charset(FcCharSetCreate());
 
     // Add UTF-32 characters to the charset
     for (size_t i = 0; i < utf32_length; i++) {
@@ -358,7 +423,7 @@ String FontLoaderLinux::fallback_font_for_characters(const String& characters, i
     FcResult result;
     FcUniquePtr<FcPattern> matched(FcFontMatch(nullptr, pat.get(), &result));
 
-    String fallback = fallback_font(); // Use existing fallback font logic
+    String fallback = fallback_font; // Use existing fallback font logic
 
     if (matched) {
         // Extract font family
@@ -377,17 +442,93 @@ String FontLoaderLinux::fallback_font_for_characters(const String& characters, i
     return fallback;
 }
 
-RefPtr<FontFile> FontLoaderLinux::Load(const String& family, int weight, bool italic) {
-  FcUniquePtr<FcPattern> pattern = GetPatternForDescription(ToAscii(family), weight, italic, 12.0);
+String FontLoaderLinux::fallback_font_for_characters(const String& characters, int weight, bool italic) const {
+    TraceZone("FontLoaderLinux::fallback_font_for_characters");
+
+    // Obtain UTF-32 representation of the input string
+    String32 utf32 = characters.utf32();
+    CharactersKey key(std::u32string(utf32.data(), utf32.length()),
+                      fontWeightToFontconfigWeight(weight), italic);
+    std::shared_ptr<const FontCoverageIndex> index;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        RevalidateCache();
+        auto it = fallback_fonts_.find(key);
+        if (it != fallback_fonts_.end())
+            return it->second;
+        generation = config_generation_;
+        index = coverage_index_;
+        if (!index)
+            RequestCoverageIndex();
+    }
+
+    // Matching runs unlocked, fontconfig is thread-safe. Two threads may match
+    // the same key at once, they will agree on the result.
+    String fallback = fallback_font();
+    if (index) {
+        const std::string* family = index->FallbackFamily(utf32.data(), utf32.length(),
+                                                          std::get<1>(key), italic);
+        if (family && !isCommonlyUsedGenericFamily(family->c_str()))
+            fallback = String(family->c_str());
+    } else {
+        fallback = fallbackFontForCharacters(utf32.data(), utf32.length(), weight, italic,
+                                             fallback);
+    }
+
+    // Not memoised if fontconfig was reinitialised meanwhile, the match may
+    // be from the old configuration.
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (generation != config_generation_)
+        return fallback;
+    if (fallback_fonts_.size() >= kMaxFallbackFonts)
+        fallback_fonts_.clear();
+    fallback_fonts_.emplace(std::move(key), fallback);
+    return fallback;
+}
+
+static std::string fontFileForDescription(const std::string& family, int weight, bool italic) {
+  FcUniquePtr<FcPattern> pattern = GetPatternForDescription(family, weight, italic, 12.0);
 
   if (pattern) {
     FcChar8* filepath = NULL;
-	if (FcPatternGetString(pattern.get(), FC_FILE, 0, &filepath) == FcResultMatch) {
-      return FontFile::Create(String((const char*)filepath));
+    if (FcPatternGetString(pattern.get(), FC_FILE, 0, &filepath) == FcResultMatch)
+      return std::string((const char*)filepath);
+  }
+
+  return std::string();
+}
+
+RefPtr<FontFile> FontLoaderLinux::Load(const String& family, int weight, bool italic) {
+  TraceZone("FontLoaderLinux::Load");
+  FamilyKey key(ToAscii(family), fontWeightToFontconfigWeight(weight), italic);
+
+  std::string filepath;
+  bool cached = false;
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    RevalidateCache();
+    auto it = font_files_.find(key);
+    if (it != font_files_.end()) {
+      filepath = it->second;
+      cached = true;
     }
+    generation = config_generation_;
+  }
+
+  if (!cached) {
+    filepath = fontFileForDescription(std::get<0>(key), weight, italic);
+    // Same as in fallback_font_for_characters().
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (generation == config_generation_)
+      font_files_.emplace(std::move(key), filepath);
   }
 
-  return nullptr;
+  if (filepath.empty())
+    return nullptr;
+
+  return FontFile::Create(String(filepath.c_str()));
 }
 
 // Called from Platform.cpp
@@ -1,9 +1,16 @@
 #pragma once
 #include <Ultralight/platform/FontLoader.h>
+#include "FontCoverageIndex.h"
+#include <chrono>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
 
 namespace ultralight {
-    
+
 class FontLoaderLinux : public FontLoader {
 public:
     FontLoaderLinux();
@@ -12,7 +19,39 @@ public:
     virtual String fallback_font_for_characters(const String& characters, int weight, bool italic) const override;
     virtual RefPtr<FontFile> Load(const String& family, int weight, bool italic) override;
 protected:
+    // Drops the memoised matches if fontconfig's configuration or font
+    // directories changed since they were made. Call with cache_mutex_ held.
+    void RevalidateCache() const;
+
+    // Builds the coverage index on index_thread_ unless it exists or is being
+    // built. Call with cache_mutex_ held.
+    void RequestCoverageIndex() const;
+
+    void IndexMain() const;
+
     std::map<uint64_t, RefPtr<Buffer>> fonts_;
-}; 
+
+    // Memoised fontconfig matches. Weights are keyed by the fontconfig weight
+    // they map to, and failed matches are cached too (as empty strings).
+    typedef std::tuple<std::string, int, bool> FamilyKey;
+    typedef std::tuple<std::u32string, int, bool> CharactersKey;
+    mutable std::mutex cache_mutex_;
+    mutable std::map<FamilyKey, std::string> font_files_;
+    mutable std::map<CharactersKey, String> fallback_fonts_;
+    mutable std::chrono::steady_clock::time_point last_config_check_;
+
+    // Bumped by FcInitReinitialize(). Matches made unlocked are only
+    // memoised if it didn't change while they ran.
+    mutable uint64_t config_generation_ = 0;
+
+    // Built once on first use, fallback fonts are matched with FcFontMatch
+    // until it is ready. Rebuilt when fontconfig's configuration changes.
+    mutable std::shared_ptr<const FontCoverageIndex> coverage_index_;
+    mutable uint64_t index_generation_ = 0;
+    mutable bool index_requested_ = false;
+    mutable bool index_building_ = false;
+    mutable bool stop_index_ = false;
+    mutable std::thread index_thread_;
+};
 
 }  // namespace ultralight
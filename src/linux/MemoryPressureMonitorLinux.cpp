@@ -0,0 +1,192 @@
+#include "MemoryPressureMonitorLinux.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <unistd.h>
+
+namespace ultralight {
+
+// Stall thresholds per 2 second window. Unprivileged processes may only
+// create triggers whose window is a multiple of 2 seconds.
+static const char* kPSISomeTrigger = "some 150000 2000000";
+static const char* kPSIFullTrigger = "full 50000 2000000";
+
+MemoryPressureMonitorLinux::MemoryPressureMonitorLinux(uint64_t rss_limit) : rss_limit_(rss_limit) {
+  psi_some_fd_ = OpenPSITrigger(kPSISomeTrigger);
+  psi_full_fd_ = OpenPSITrigger(kPSIFullTrigger);
+
+  // cgroup v2 processes have a single "0::<path>" entry.
+  std::ifstream cgroup("/proc/self/cgroup");
+  std::string line;
+  while (std::getline(cgroup, line)) {
+    if (line.compare(0, 3, "0::") == 0) {
+      cgroup_path_ = "/sys/fs/cgroup" + line.substr(3);
+      break;
+    }
+  }
+
+  if (!cgroup_path_.empty()) {
+    cgroup_events_fd_ = open((cgroup_path_ + "/memory.events").c_str(), O_RDONLY | O_CLOEXEC);
+    if (cgroup_events_fd_ >= 0 && !ReadCgroupEvents(cgroup_events_)) {
+      close(cgroup_events_fd_);
+      cgroup_events_fd_ = -1;
+    }
+  }
+
+  for (int fd : { psi_some_fd_, psi_full_fd_, cgroup_events_fd_ }) {
+    if (fd >= 0)
+      fds_.push_back(fd);
+  }
+}
+
+MemoryPressureMonitorLinux::~MemoryPressureMonitorLinux() {
+  for (int fd : fds_)
+    close(fd);
+}
+
+bool MemoryPressureMonitorLinux::ProcessEvents(const fd_set& exceptfds, MemoryPressureLevel& level) {
+  bool pressure = false;
+  level = MemoryPressureLevel::Moderate;
+
+  if (psi_some_fd_ >= 0 && FD_ISSET(psi_some_fd_, &exceptfds))
+    pressure = true;
+
+  if (psi_full_fd_ >= 0 && FD_ISSET(psi_full_fd_, &exceptfds)) {
+    pressure = true;
+    level = MemoryPressureLevel::Critical;
+  }
+
+  if (cgroup_events_fd_ >= 0 && FD_ISSET(cgroup_events_fd_, &exceptfds)) {
+    CgroupEvents events;
+    if (ReadCgroupEvents(events)) {
+      if (events.max > cgroup_events_.max || events.oom > cgroup_events_.oom ||
+          events.oom_kill > cgroup_events_.oom_kill) {
+        pressure = true;
+        level = MemoryPressureLevel::Critical;
+      } else if (events.high > cgroup_events_.high) {
+        pressure = true;
+      }
+      cgroup_events_ = events;
+    }
+  }
+
+  return pressure;
+}
+
+bool MemoryPressureMonitorLinux::Poll(MemoryPressureLevel& level) {
+  constexpr auto kPollInterval = std::chrono::seconds(1);
+  auto now = std::chrono::steady_clock::now();
+  if (now - last_poll_ < kPollInterval)
+    return false;
+  last_poll_ = now;
+
+  bool pressure = false;
+  level = MemoryPressureLevel::Moderate;
+
+  if (rss_limit_) {
+    uint64_t rss = ReadRSS();
+    if (rss > rss_limit_) {
+      pressure = true;
+      level = MemoryPressureLevel::Critical;
+    } else if (rss > rss_limit_ - rss_limit_ / 10) {
+      pressure = true;
+    }
+  }
+
+  uint64_t current;
+  if (!cgroup_path_.empty() && ReadCgroupValue(cgroup_path_ + "/memory.current", current)) {
+    uint64_t limit;
+    if (ReadCgroupValue(cgroup_path_ + "/memory.max", limit) && current > limit - limit / 20) {
+      pressure = true;
+      level = MemoryPressureLevel::Critical;
+    } else if (ReadCgroupValue(cgroup_path_ + "/memory.high", limit) && current > limit) {
+      pressure = true;
+    }
+  }
+
+  return pressure;
+}
+
+int MemoryPressureMonitorLinux::OpenPSITrigger(const char* trigger) {
+  int fd = open("/proc/pressure/memory", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0)
+    return -1;
+
+  // The trigger string is written with its null terminator.
+  if (write(fd, trigger, strlen(trigger) + 1) < 0) {
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+bool MemoryPressureMonitorLinux::ReadCgroupEvents(CgroupEvents& events) {
+  char buffer[512];
+  ssize_t length = pread(cgroup_events_fd_, buffer, sizeof(buffer) - 1, 0);
+  if (length <= 0)
+    return false;
+  buffer[length] = 0;
+
+  events = CgroupEvents();
+  char* save = nullptr;
+  for (char* line = strtok_r(buffer, "\n", &save); line; line = strtok_r(nullptr, "\n", &save)) {
+    char key[32];
+    unsigned long long value;
+    if (sscanf(line, "%31s %llu", key, &value) != 2)
+      continue;
+
+    if (!strcmp(key, "high"))
+      events.high = value;
+    else if (!strcmp(key, "max"))
+      events.max = value;
+    else if (!strcmp(key, "oom"))
+      events.oom = value;
+    else if (!strcmp(key, "oom_kill"))
+      events.oom_kill = value;
+  }
+
+  return true;
+}
+
+bool MemoryPressureMonitorLinux::ReadCgroupValue(const std::string& path, uint64_t& value) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  char buffer[32];
+  ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+  close(fd);
+  if (length <= 0)
+    return false;
+  buffer[length] = 0;
+
+  // Unlimited values read as "max".
+  char* end;
+  value = strtoull(buffer, &end, 10);
+  return end != buffer;
+}
+
+uint64_t MemoryPressureMonitorLinux::ReadRSS() {
+  int fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return 0;
+
+  char buffer[128];
+  ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+  close(fd);
+  if (length <= 0)
+    return 0;
+  buffer[length] = 0;
+
+  unsigned long long size_pages, resident_pages;
+  if (sscanf(buffer, "%llu %llu", &size_pages, &resident_pages) != 2)
+    return 0;
+
+  return resident_pages * (uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+}  // namespace ultralight
@@ -0,0 +1,65 @@
+#pragma once
+#include <AppCore/App.h>
+#include <sys/select.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace ultralight {
+
+///
+/// Watches Linux memory pressure for AppGLFW.
+///
+/// Event sources, each optional (missing files or permissions are skipped):
+///   - PSI triggers on /proc/pressure/memory: a "some" stall trigger reports
+///     Moderate pressure and a "full" stall trigger reports Critical.
+///   - memory.events of the app's cgroup v2: a rise in "high" is Moderate,
+///     a rise in "max", "oom" or "oom_kill" is Critical.
+///
+/// Both are pollable files that signal POLLPRI, so the run loop adds fds()
+/// to select()'s exception set and calls ProcessEvents() when one fires.
+///
+/// Poll() additionally compares RSS against the configured limit and the
+/// cgroup's memory.current against memory.high/memory.max, once a second.
+///
+class MemoryPressureMonitorLinux {
+public:
+  explicit MemoryPressureMonitorLinux(uint64_t rss_limit);
+  ~MemoryPressureMonitorLinux();
+
+  // Descriptors to add to select()'s exception set.
+  const std::vector<int>& fds() const { return fds_; }
+
+  // Handles fds() flagged in 'exceptfds'. Returns whether there is pressure.
+  bool ProcessEvents(const fd_set& exceptfds, MemoryPressureLevel& level);
+
+  // Rate-limited limit checks, call once per update. Returns whether there
+  // is pressure.
+  bool Poll(MemoryPressureLevel& level);
+
+  // Resident set size of the process in bytes, 0 if it can't be read.
+  static uint64_t ReadRSS();
+
+protected:
+  struct CgroupEvents {
+    uint64_t high = 0;
+    uint64_t max = 0;
+    uint64_t oom = 0;
+    uint64_t oom_kill = 0;
+  };
+
+  int OpenPSITrigger(const char* trigger);
+  bool ReadCgroupEvents(CgroupEvents& events);
+  static bool ReadCgroupValue(const std::string& path, uint64_t& value);
+
+  uint64_t rss_limit_;
+  int psi_some_fd_ = -1;
+  int psi_full_fd_ = -1;
+  int cgroup_events_fd_ = -1;
+  std::string cgroup_path_;
+  CgroupEvents cgroup_events_;
+  std::vector<int> fds_;
+  std::chrono::steady_clock::time_point last_poll_;
+};
+
+}  // namespace ultralight
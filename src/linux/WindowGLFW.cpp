@@ -3,6 +3,7 @@
 #include <AppCore/App.h>
 #include "AppGLFW.h"
 #include "AppImpl.h"
+#include "TraceRecorder.h"
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <sstream>
@@ -152,16 +153,34 @@ WindowGLFW::WindowGLFW(Monitor* monitor, uint32_t width, uint32_t height,
   auto gpu_context = static_cast<AppGLFW*>(App::instance())->gpu_context();
   auto gpu_driver = static_cast<AppGLFW*>(App::instance())->gpu_driver();
 
-  if (!gpu_context) {
+  if (!gpu_driver) {
     glfwTerminate();
     exit(EXIT_FAILURE);
   }
 
+#if defined(APPCORE_ENABLE_VULKAN)
+  // Vulkan windows have no GL context, they present through a swap chain.
+  auto vulkan_context = static_cast<AppGLFW*>(App::instance())->vulkan_context();
+  if (vulkan_context)
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+#endif
+
   // This window will share the GL context of GPUContextGL's offscreen window
   GLFWwindow* win = glfwCreateWindow(ScreenToPixels(width), ScreenToPixels(height),
-    "", NULL, gpu_context->window());
+    "", NULL, gpu_context ? gpu_context->window() : NULL);
 
   window_ = win;
+
+#if defined(APPCORE_ENABLE_VULKAN)
+  if (vulkan_context) {
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
+    if (window_ && !vulkan_context->AddWindow(window_)) {
+      glfwDestroyWindow(window_);
+      window_ = nullptr;
+    }
+  }
+#endif
+
   if (!window_)
   {
     glfwTerminate();
@@ -208,6 +227,13 @@ WindowGLFW::~WindowGLFW() {
     glfwDestroyCursor(cursor_hresize_);
     glfwDestroyCursor(cursor_vresize_);
 
+    if (auto gpu_context = static_cast<AppGLFW*>(App::instance())->gpu_context())
+      gpu_context->OnWindowDestroyed(window_);
+#if defined(APPCORE_ENABLE_VULKAN)
+    if (auto vulkan_context = static_cast<AppGLFW*>(App::instance())->vulkan_context())
+      vulkan_context->OnWindowDestroyed(window_);
+#endif
+
     glfwDestroyWindow(window_);
     static_cast<AppGLFW*>(App::instance())->RemoveWindow(this);
   }
@@ -376,6 +402,14 @@ void WindowGLFW::OnResize(uint32_t width, uint32_t height) {
 }
 
 void WindowGLFW::Repaint() {
+  TraceZone("WindowGLFW::Repaint");
+#if defined(APPCORE_ENABLE_VULKAN)
+  if (auto vulkan_context = static_cast<AppGLFW*>(App::instance())->vulkan_context()) {
+    RepaintVulkan(vulkan_context);
+    return;
+  }
+#endif
+
   auto gpu_context = static_cast<AppGLFW*>(App::instance())->gpu_context();
   auto gpu_driver = static_cast<AppGLFW*>(App::instance())->gpu_driver();
 
@@ -397,8 +431,13 @@ void WindowGLFW::Repaint() {
     OverlayManager::Paint();
     MarkEndDraw();
 
-    glfwSwapBuffers(window_);
-    gpu_context->EndDrawing();
+    MarkBeginSwap();
+    {
+      TraceZone("WindowGLFW::SwapBuffers");
+      glfwSwapBuffers(window_);
+      gpu_context->EndDrawing();
+    }
+    MarkEndSwap();
   }
 
   MarkEndFrame();
@@ -406,9 +445,63 @@ void WindowGLFW::Repaint() {
   window_needs_repaint_ = false;
 }
 
+#if defined(APPCORE_ENABLE_VULKAN)
+void WindowGLFW::RepaintVulkan(GPUContextVulkan* gpu_context) {
+  auto gpu_driver = static_cast<AppGLFW*>(App::instance())->gpu_driver();
+
+  gpu_context->set_active_window(window_);
+
+  MarkBeginFrame();
+  MarkBeginRender();
+  gpu_driver->BeginSynchronize();
+  OverlayManager::Render();
+  gpu_driver->EndSynchronize();
+  MarkEndRender();
+
+  if (gpu_driver->HasCommandsPending() || OverlayManager::NeedsRepaint() || window_needs_repaint_) {
+    MarkBeginDraw();
+    gpu_context->BeginDrawing();
+    gpu_driver->DrawCommandList();
+    OverlayManager::Paint();
+    MarkEndDraw();
+
+    MarkBeginSwap();
+    {
+      TraceZone("WindowGLFW::Present");
+      gpu_context->EndDrawing();
+    }
+    MarkEndSwap();
+  } else {
+    // Submit texture uploads recorded during synchronization.
+    gpu_context->Flush();
+  }
+
+  MarkEndFrame();
+
+  window_needs_repaint_ = false;
+}
+#endif
+
 void WindowGLFW::MarkBeginFrame()
 {
+    using namespace std::chrono;
+
     frame_start_time_ = std::chrono::steady_clock::now();
+
+    current_frame_ = FrameRecord();
+    current_frame_.frame_index = frame_index_++;
+    current_frame_.start_ns = duration_cast<nanoseconds>(frame_start_time_.time_since_epoch()).count();
+
+    // Updates run between frames on the same thread, so whatever part of the
+    // gap since our last frame wasn't spent updating was spent idle.
+    auto total_update_time = static_cast<AppGLFW*>(App::instance())->total_update_time();
+    if (current_frame_.frame_index > 0) {
+        auto update_time = total_update_time - last_total_update_time_;
+        auto gap = duration_cast<nanoseconds>(frame_start_time_ - last_frame_end_time_);
+        current_frame_.update_ns = update_time.count();
+        current_frame_.idle_ns = gap > update_time ? (gap - update_time).count() : 0;
+    }
+    last_total_update_time_ = total_update_time;
 }
 
 void WindowGLFW::MarkEndFrame()
@@ -422,6 +515,10 @@ void WindowGLFW::MarkEndFrame()
     sum_frame_time_ += frame_duration;
 
     frame_count_++;
+
+    current_frame_.total_ns = frame_duration.count();
+    telemetry_.Record(current_frame_);
+    last_frame_end_time_ = now;
 }
 
 void WindowGLFW::MarkBeginRender()
@@ -435,6 +532,7 @@ void WindowGLFW::MarkEndRender()
     auto now = std::chrono::steady_clock::now();
     auto render_duration = duration_cast<nanoseconds>(now - render_start_time_);
     sum_render_time_ += render_duration;
+    current_frame_.render_ns = render_duration.count();
 }
 
 void WindowGLFW::MarkBeginDraw()
@@ -448,6 +546,19 @@ void WindowGLFW::MarkEndDraw()
     auto now = std::chrono::steady_clock::now();
     auto draw_duration = duration_cast<nanoseconds>(now - draw_start_time_);
     sum_draw_time_ += draw_duration;
+    current_frame_.draw_ns = draw_duration.count();
+}
+
+void WindowGLFW::MarkBeginSwap()
+{
+    swap_start_time_ = std::chrono::steady_clock::now();
+}
+
+void WindowGLFW::MarkEndSwap()
+{
+    using namespace std::chrono;
+    auto now = std::chrono::steady_clock::now();
+    current_frame_.swap_ns = duration_cast<nanoseconds>(now - swap_start_time_).count();
 }
 
 void WindowGLFW::UpdateTitleWithStatistics()
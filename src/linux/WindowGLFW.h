@@ -3,6 +3,7 @@
 #include <Ultralight/Listener.h>
 #include "RefCountedImpl.h"
 #include "OverlayManager.h"
+#include "FrameTelemetry.h"
 #include <cmath>
 #include <chrono>
 
@@ -11,6 +12,8 @@ typedef struct GLFWcursor GLFWcursor;
 
 namespace ultralight {
 
+class GPUContextVulkan;
+
 class WindowGLFW : public Window,
                   public RefCountedImpl<WindowGLFW>,
                   public OverlayManager {
@@ -67,6 +70,14 @@ public:
 
   virtual void EnableFrameStatistics() override { frame_stats_enabled_ = true; }
 
+  virtual FrameTimingSnapshot frame_timing_snapshot() const override { return telemetry_.Snapshot(); }
+
+  virtual void ResetFrameTiming() override { telemetry_.Reset(); }
+
+  virtual bool WriteFrameTimingReport(const char* path, FrameTimingFormat format) const override {
+    return telemetry_.WriteReport(path, format);
+  }
+
   virtual OverlayManager* overlay_manager() const override { return const_cast<WindowGLFW*>(this); }
 
   virtual void FireKeyEvent(const ultralight::KeyEvent& evt) override;
@@ -83,6 +94,11 @@ public:
   void OnResize(uint32_t width, uint32_t height);
   void Repaint();
 
+#if defined(APPCORE_ENABLE_VULKAN)
+  // Repaint() when the app uses the Vulkan driver.
+  void RepaintVulkan(GPUContextVulkan* gpu_context);
+#endif
+
   void InvalidateWindow() { window_needs_repaint_ = true; }
 
   void UpdateTitleWithStatistics();
@@ -106,6 +122,9 @@ protected:
   void MarkBeginDraw();
   void MarkEndDraw();
 
+  void MarkBeginSwap();
+  void MarkEndSwap();
+
   friend class Window;
   friend class AppGLFW;
 
@@ -124,13 +143,20 @@ protected:
   bool window_needs_repaint_ = false;
 
   bool frame_stats_enabled_ = false;
-  std::chrono::steady_clock::time_point frame_start_time_, render_start_time_, draw_start_time_;
+  std::chrono::steady_clock::time_point frame_start_time_, render_start_time_, draw_start_time_,
+    swap_start_time_;
   std::chrono::nanoseconds sum_frame_time_ = std::chrono::nanoseconds(0);
   std::chrono::nanoseconds sum_render_time_ = std::chrono::nanoseconds(0);
   std::chrono::nanoseconds sum_draw_time_ = std::chrono::nanoseconds(0);
   uint32_t frame_count_ = 0;
   std::chrono::steady_clock::time_point last_statistics_update_;
 
+  FrameTelemetry telemetry_;
+  FrameRecord current_frame_;
+  std::chrono::steady_clock::time_point last_frame_end_time_;
+  std::chrono::nanoseconds last_total_update_time_ = std::chrono::nanoseconds(0);
+  uint64_t frame_index_ = 0;
+
   std::string base_title_;
   std::string statistics_text_;
 };
@@ -0,0 +1,165 @@
+#include "DeletionQueueGL.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <tuple>
+
+namespace ultralight {
+
+DeletionQueueGL::~DeletionQueueGL() {
+  // Windows may already be gone at this point, only delete shared objects
+  // (per-context objects are released along with their context).
+  for (GLsync sync : forgotten_fences_)
+    glDeleteSync(sync);
+  for (auto& frame : frames_) {
+    for (auto& fence : frame.fences)
+      glDeleteSync(fence.sync);
+    recording_.insert(recording_.end(), frame.objects.begin(), frame.objects.end());
+  }
+
+  recording_.erase(std::remove_if(recording_.begin(), recording_.end(),
+    [](const Object& object) { return object.context != nullptr; }), recording_.end());
+  Delete(recording_);
+}
+
+void DeletionQueueGL::Enqueue(ObjectType type, GLuint id, GLFWwindow* context) {
+  if (!id)
+    return;
+
+  recording_.push_back({ context, type, id });
+  stats_.pending_objects++;
+  stats_.peak_pending_objects = std::max(stats_.peak_pending_objects, stats_.pending_objects);
+}
+
+void DeletionQueueGL::AddContext(GLFWwindow* context) {
+  if (context && std::find(contexts_.begin(), contexts_.end(), context) == contexts_.end())
+    contexts_.push_back(context);
+}
+
+void DeletionQueueGL::Submit() {
+  if (recording_.empty())
+    return;
+
+  Frame frame;
+  frame.objects.swap(recording_);
+
+  auto previous_context = glfwGetCurrentContext();
+  auto fence = [&](GLFWwindow* context) {
+    frame.fences.push_back({ context, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+    // Make sure the fence actually reaches the GPU, otherwise it may never
+    // signal if nothing else is submitted in this context for a while.
+    glFlush();
+  };
+
+  fence(previous_context);
+  for (GLFWwindow* context : contexts_) {
+    if (context == previous_context)
+      continue;
+    glfwMakeContextCurrent(context);
+    fence(context);
+  }
+
+  if (glfwGetCurrentContext() != previous_context)
+    glfwMakeContextCurrent(previous_context);
+
+  frames_.push_back(std::move(frame));
+  stats_.pending_frames++;
+}
+
+void DeletionQueueGL::Collect() {
+  for (GLsync sync : forgotten_fences_)
+    glDeleteSync(sync);
+  forgotten_fences_.clear();
+
+  std::vector<Object> retired;
+
+  // Fences of a context signal in submission order, stop at the first frame
+  // still waiting on any context.
+  while (!frames_.empty()) {
+    Frame& frame = frames_.front();
+    bool signaled = std::all_of(frame.fences.begin(), frame.fences.end(), [](const Fence& fence) {
+      GLenum result = glClientWaitSync(fence.sync, 0, 0);
+      return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    });
+    if (!signaled)
+      break;
+
+    for (auto& fence : frame.fences)
+      glDeleteSync(fence.sync);
+    retired.insert(retired.end(), frame.objects.begin(), frame.objects.end());
+    frames_.pop_front();
+    stats_.pending_frames--;
+  }
+
+  if (retired.empty())
+    return;
+
+  stats_.pending_objects -= (uint32_t)retired.size();
+  stats_.deleted_objects += retired.size();
+  Delete(retired);
+}
+
+void DeletionQueueGL::ForgetContext(GLFWwindow* context) {
+  auto forget = [&](std::vector<Object>& objects) {
+    size_t count = objects.size();
+    objects.erase(std::remove_if(objects.begin(), objects.end(),
+      [&](const Object& object) { return object.context == context; }), objects.end());
+    stats_.pending_objects -= (uint32_t)(count - objects.size());
+  };
+
+  forget(recording_);
+  for (auto& frame : frames_) {
+    forget(frame.objects);
+
+    // Destroying the context finishes or discards its commands, its fences
+    // no longer guard anything. No context may be current here, delete them
+    // in the next Collect().
+    frame.fences.erase(std::remove_if(frame.fences.begin(), frame.fences.end(), [&](const Fence& fence) {
+      if (fence.context != context)
+        return false;
+      forgotten_fences_.push_back(fence.sync);
+      return true;
+    }), frame.fences.end());
+  }
+
+  contexts_.erase(std::remove(contexts_.begin(), contexts_.end(), context), contexts_.end());
+}
+
+void DeletionQueueGL::Delete(std::vector<Object>& objects) {
+  // Group by context then type so each context is made current once and
+  // each object type is deleted with a single call.
+  std::sort(objects.begin(), objects.end(), [](const Object& a, const Object& b) {
+    return std::tie(a.context, a.type) < std::tie(b.context, b.type);
+  });
+
+  auto previous_context = glfwGetCurrentContext();
+  std::vector<GLuint> ids;
+
+  for (size_t begin = 0; begin < objects.size();) {
+    size_t end = begin;
+    ids.clear();
+    while (end < objects.size() && objects[end].context == objects[begin].context &&
+           objects[end].type == objects[begin].type) {
+      ids.push_back(objects[end].id);
+      end++;
+    }
+
+    GLFWwindow* context = objects[begin].context;
+    if (context && context != glfwGetCurrentContext())
+      glfwMakeContextCurrent(context);
+
+    GLsizei count = (GLsizei)ids.size();
+    switch (objects[begin].type) {
+    case ObjectType::Texture:     glDeleteTextures(count, ids.data()); break;
+    case ObjectType::Buffer:      glDeleteBuffers(count, ids.data()); break;
+    case ObjectType::Framebuffer: glDeleteFramebuffers(count, ids.data()); break;
+    case ObjectType::VertexArray: glDeleteVertexArrays(count, ids.data()); break;
+    }
+
+    begin = end;
+  }
+
+  if (glfwGetCurrentContext() != previous_context)
+    glfwMakeContextCurrent(previous_context);
+}
+
+}  // namespace ultralight
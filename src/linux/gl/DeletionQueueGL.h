@@ -0,0 +1,93 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+typedef struct GLFWwindow GLFWwindow;
+
+namespace ultralight {
+
+//
+// Defers deletion of GL objects until the GPU is done with them.
+//
+// Objects released during a frame are recorded and, when the frame is
+// submitted, gated behind a fence in each context that draws. Contexts run
+// their commands in order but not in order with each other, so an object is
+// only deleted once the fences of every context have signaled. Collect()
+// deletes the objects of retired frames without blocking, batching deletions
+// by context and object type so each context is made current at most once.
+//
+// Textures and buffers are shared between our contexts and are deleted in
+// whichever context is current. Framebuffers and vertex arrays must be
+// deleted in the context that created them.
+//
+class DeletionQueueGL {
+public:
+  enum class ObjectType : uint8_t {
+    Texture,
+    Buffer,
+    Framebuffer,
+    VertexArray,
+  };
+
+  struct Stats {
+    uint32_t pending_objects = 0; // Recorded or waiting on a fence
+    uint32_t pending_frames = 0;  // Fences not yet signaled
+    uint32_t peak_pending_objects = 0;
+    uint64_t deleted_objects = 0;
+  };
+
+  DeletionQueueGL() = default;
+  ~DeletionQueueGL();
+
+  // Shared objects (textures, buffers) pass a null context.
+  void Enqueue(ObjectType type, GLuint id, GLFWwindow* context = nullptr);
+
+  // Registers a context that draws with queued objects, Submit() fences it
+  // along with the current context.
+  void AddContext(GLFWwindow* context);
+
+  // Gates everything recorded since the last call behind a new fence in the
+  // current context and in every added one.
+  void Submit();
+
+  // Deletes objects whose fence has signaled. Never blocks on the GPU.
+  void Collect();
+
+  // Drops the queued objects and fences of 'context', which is about to be
+  // destroyed (its objects are released along with it).
+  void ForgetContext(GLFWwindow* context);
+
+  const Stats& stats() const { return stats_; }
+
+protected:
+  DeletionQueueGL(const DeletionQueueGL&) = delete;
+  DeletionQueueGL& operator=(const DeletionQueueGL&) = delete;
+
+  struct Object {
+    GLFWwindow* context;
+    ObjectType type;
+    GLuint id;
+  };
+
+  struct Fence {
+    GLFWwindow* context;
+    GLsync sync;
+  };
+
+  struct Frame {
+    std::vector<Fence> fences;
+    std::vector<Object> objects;
+  };
+
+  static void Delete(std::vector<Object>& objects);
+
+  std::vector<GLFWwindow*> contexts_;
+  std::vector<GLsync> forgotten_fences_;
+  std::vector<Object> recording_;
+  std::deque<Frame> frames_;
+  Stats stats_;
+};
+
+}  // namespace ultralight
@@ -0,0 +1,49 @@
+#include "DirectStateAccessGL.h"
+#include <GLFW/glfw3.h>
+
+namespace ultralight {
+
+static DirectStateAccessGL g_direct_state_access;
+
+const DirectStateAccessGL& DirectStateAccess() {
+  return g_direct_state_access;
+}
+
+template<typename Proc>
+static bool LoadProc(Proc& proc, const char* name) {
+  proc = (Proc)glfwGetProcAddress(name);
+  return proc != nullptr;
+}
+
+void LoadDirectStateAccessGL() {
+  DirectStateAccessGL& dsa = g_direct_state_access;
+  dsa = DirectStateAccessGL();
+
+  // glXGetProcAddress returns non-null for any name, so check the version or
+  // extension string before trusting the pointers.
+  bool available = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 5) ||
+    glfwExtensionSupported("GL_ARB_direct_state_access");
+  if (!available)
+    return;
+
+  bool loaded = true;
+  loaded &= LoadProc(dsa.CreateTextures, "glCreateTextures");
+  loaded &= LoadProc(dsa.TextureStorage2D, "glTextureStorage2D");
+  loaded &= LoadProc(dsa.TextureSubImage2D, "glTextureSubImage2D");
+  loaded &= LoadProc(dsa.TextureParameteri, "glTextureParameteri");
+  loaded &= LoadProc(dsa.GenerateTextureMipmap, "glGenerateTextureMipmap");
+  loaded &= LoadProc(dsa.BindTextureUnit, "glBindTextureUnit");
+  loaded &= LoadProc(dsa.CreateBuffers, "glCreateBuffers");
+  loaded &= LoadProc(dsa.NamedBufferData, "glNamedBufferData");
+  loaded &= LoadProc(dsa.NamedBufferSubData, "glNamedBufferSubData");
+  loaded &= LoadProc(dsa.BlitNamedFramebuffer, "glBlitNamedFramebuffer");
+
+  if (!loaded) {
+    dsa = DirectStateAccessGL();
+    return;
+  }
+
+  dsa.supported = true;
+}
+
+}  // namespace ultralight
@@ -0,0 +1,49 @@
+#pragma once
+#include <glad/glad.h>
+
+namespace ultralight {
+
+//
+// GL 4.5 / ARB_direct_state_access entry points. GLAD was generated for GL 3.2
+// so these are loaded at runtime; callers check 'supported' and fall back to
+// the bind-to-edit path otherwise.
+//
+struct DirectStateAccessGL {
+  typedef void (APIENTRYP CreateTexturesProc)(GLenum target, GLsizei n, GLuint* textures);
+  typedef void (APIENTRYP TextureStorage2DProc)(GLuint texture, GLsizei levels, GLenum internalformat,
+    GLsizei width, GLsizei height);
+  typedef void (APIENTRYP TextureSubImage2DProc)(GLuint texture, GLint level, GLint xoffset, GLint yoffset,
+    GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels);
+  typedef void (APIENTRYP TextureParameteriProc)(GLuint texture, GLenum pname, GLint param);
+  typedef void (APIENTRYP GenerateTextureMipmapProc)(GLuint texture);
+  typedef void (APIENTRYP BindTextureUnitProc)(GLuint unit, GLuint texture);
+  typedef void (APIENTRYP CreateBuffersProc)(GLsizei n, GLuint* buffers);
+  typedef void (APIENTRYP NamedBufferDataProc)(GLuint buffer, GLsizeiptr size, const void* data, GLenum usage);
+  typedef void (APIENTRYP NamedBufferSubDataProc)(GLuint buffer, GLintptr offset, GLsizeiptr size,
+    const void* data);
+  typedef void (APIENTRYP BlitNamedFramebufferProc)(GLuint readFramebuffer, GLuint drawFramebuffer,
+    GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1,
+    GLbitfield mask, GLenum filter);
+
+  bool supported = false;
+
+  CreateTexturesProc CreateTextures = nullptr;
+  TextureStorage2DProc TextureStorage2D = nullptr;
+  TextureSubImage2DProc TextureSubImage2D = nullptr;
+  TextureParameteriProc TextureParameteri = nullptr;
+  GenerateTextureMipmapProc GenerateTextureMipmap = nullptr;
+  BindTextureUnitProc BindTextureUnit = nullptr;
+  CreateBuffersProc CreateBuffers = nullptr;
+  NamedBufferDataProc NamedBufferData = nullptr;
+  NamedBufferSubDataProc NamedBufferSubData = nullptr;
+  BlitNamedFramebufferProc BlitNamedFramebuffer = nullptr;
+};
+
+// Process-wide entry points, filled in by LoadDirectStateAccessGL().
+const DirectStateAccessGL& DirectStateAccess();
+
+// Must be called with a GL context current, before any other thread uses
+// DirectStateAccess().
+void LoadDirectStateAccessGL();
+
+}  // namespace ultralight
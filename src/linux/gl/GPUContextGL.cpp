@@ -44,7 +44,26 @@ GPUContextGL::GPUContextGL(bool enable_vsync, bool enable_msaa) :
     glEnable(GL_MULTISAMPLE);
   }
 
+  // Secondary context for background texture uploads, the driver falls back
+  // to uploading on this thread if it can't be created.
+  upload_window_ = glfwCreateWindow(1, 1, "", NULL, window_);
+
   driver_.reset(new ultralight::GPUDriverGL(this));
 }
 
+void GPUContextGL::OnWindowDestroyed(GLFWwindow* win) {
+  if (active_window_ == win)
+    active_window_ = window_;
+
+  static_cast<GPUDriverGL*>(driver_.get())->ForgetContext(win);
+}
+
+GPUContextGL::~GPUContextGL() {
+  // The driver joins its upload thread before we destroy the upload context.
+  driver_.reset();
+
+  if (upload_window_)
+    glfwDestroyWindow(upload_window_);
+}
+
 }  // namespace ultralight
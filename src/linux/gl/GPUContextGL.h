@@ -14,12 +14,13 @@ class GPUContextGL {
 protected:
   std::unique_ptr<ultralight::GPUDriverImpl> driver_;
   GLFWwindow* window_;
+  GLFWwindow* upload_window_ = nullptr;
   GLFWwindow* active_window_ = nullptr;
   bool msaa_enabled_;
 public:
   GPUContextGL(bool enable_vsync, bool enable_msaa);
 
-  virtual ~GPUContextGL() {}
+  virtual ~GPUContextGL();
 
   virtual ultralight::GPUDriverImpl* driver() const { return driver_.get(); }
 
@@ -35,12 +36,20 @@ public:
   // All other windows created during lifetime of the app share this context.
   virtual GLFWwindow* window() { return window_; }
 
+  // A hidden window whose context shares objects with window() and is only
+  // ever made current on the driver's upload thread (null if unavailable).
+  virtual GLFWwindow* upload_window() { return upload_window_; }
+
   // FBOs are not shared across contexts in OpenGL 3.2 (AFAIK), we luckily
   // don't need to share them across multiple windows anyways so we temporarily
   // set the active GL context to the "active window" when creating FBOs.
   virtual void set_active_window(GLFWwindow* win) { active_window_ = win; }
 
   virtual GLFWwindow* active_window() { return active_window_; }
+
+  // Call before destroying a window that shares our context, the driver
+  // forgets the objects it created in the window's context.
+  virtual void OnWindowDestroyed(GLFWwindow* win);
 };
 
 }  // namespace ultralight
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "GPUDriverGL.h"
 #include "GPUContextGL.h"
+#include "DirectStateAccessGL.h"
+#include "TraceRecorder.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 // Include generated GLSL shader headers
@@ -14,6 +17,10 @@
 #define GL_TEXTURE_SWIZZLE_A 0x8E45
 #endif
 
+// glInvalidateFramebuffer (GL 4.3 / ARB_invalidate_subdata) is loaded at runtime
+typedef void (APIENTRYP PFNGLINVALIDATEFRAMEBUFFERPROC_UL)(GLenum target, GLsizei num_attachments,
+  const GLenum* attachments);
+
 #ifdef _DEBUG
 #if _WIN32
 #define INFO(x) { std::cerr << "[INFO] " << __FUNCSIG__ << " @ Line " << __LINE__ << ":\n\t" << x << std::endl; }
@@ -121,15 +128,94 @@ static GLenum MapBlendEquation(BlendEquation equation) {
   }
 }
 
-GPUDriverGL::GPUDriverGL(GPUContextGL* context) : context_(context) {
+// Uniform block fields read by each program (vertex + fragment stage), taken
+// from the generated GLSL. Must be updated if the shaders change.
+static uint32_t UniformFieldsForProgram(ProgramType type) {
+  switch (type) {
+  case ShaderType::Fill:             return kUniformTransform | kUniformScalar4 | kUniformVector | kUniformClip;
+  case ShaderType::FillPath:         return kUniformTransform | kUniformClip;
+  case ShaderType::FilterBasic:      return kUniformTransform;
+  case ShaderType::FilterBlur:       return kUniformTransform | kUniformInteger4 | kUniformScalar4;
+  case ShaderType::FilterDropShadow: return kUniformTransform;
+  default:                           return kUniformAll;
+  }
+}
+
+// Bitmaps at least this large are uploaded on the background upload context.
+static const size_t kAsyncUploadMinBytes = 256 * 1024;
+
+// Number of samples used for MSAA render targets.
+static const GLsizei kMSAASampleCount = 4;
+
+static uint64_t MSAABytes(uint32_t width, uint32_t height) {
+  return (uint64_t)width * height * 4 * kMSAASampleCount;
+}
+
+static IntRect FullRect(uint32_t width, uint32_t height) {
+  IntRect rect;
+  rect.left = 0;
+  rect.top = 0;
+  rect.right = (int)width;
+  rect.bottom = (int)height;
+  return rect;
+}
+
+// Used to seed a multisampled attachment with the contents of its resolve
+// texture when a render buffer switches to MSAA part way through a pass.
+static const char* msaa_copy_vs_source = R"GLSL(#version 420
+void main() {
+  vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+  gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+}
+)GLSL";
+
+static const char* msaa_copy_fs_source = R"GLSL(#version 420
+layout(binding = 0) uniform sampler2D src;
+layout(location = 0) out vec4 out_color;
+void main() {
+  out_color = texelFetch(src, ivec2(gl_FragCoord.xy), 0);
+}
+)GLSL";
+
+// Bytes used by a texture and its full mip chain (glGenerateMipmap is always called).
+static uint64_t MipChainBytes(uint32_t width, uint32_t height, uint32_t bytes_per_pixel) {
+  uint64_t total = 0;
+  while (true) {
+    total += (uint64_t)width * height * bytes_per_pixel;
+    if (width <= 1 && height <= 1)
+      break;
+    width = std::max(width / 2, 1u);
+    height = std::max(height / 2, 1u);
+  }
+  return total;
+}
+
+GPUDriverGL::GPUDriverGL(GPUContextGL* context)
+  : geometry_arena_(deletion_queue_), render_target_pool_(deletion_queue_), context_(context) {
+  LoadDirectStateAccessGL();
+
+  // The UBO starts zeroed so uniforms_shadow_ mirrors its contents exactly.
+  memset(&uniforms_shadow_, 0, sizeof(Uniforms));
   glGenBuffers(1, &ubo_id_);
   glBindBuffer(GL_UNIFORM_BUFFER, ubo_id_);
-  glBufferData(GL_UNIFORM_BUFFER, sizeof(Uniforms), nullptr, GL_DYNAMIC_DRAW);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(Uniforms), &uniforms_shadow_, GL_DYNAMIC_DRAW);
   glBindBuffer(GL_UNIFORM_BUFFER, 0);
   CHECK_GL();
+
+  if (GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 3) ||
+      glfwExtensionSupported("GL_ARB_invalidate_subdata")) {
+    invalidate_framebuffer_ = (void*)glfwGetProcAddress("glInvalidateFramebuffer");
+  }
+
+  if (context_->upload_window())
+    texture_uploader_.reset(new TextureUploaderGL(context_->upload_window()));
 }
 
 GPUDriverGL::~GPUDriverGL() {
+  texture_uploader_.reset();
+
+  if (placeholder_tex_id_)
+    glDeleteTextures(1, &placeholder_tex_id_);
   if (ubo_id_)
     glDeleteBuffers(1, &ubo_id_);
 }
@@ -143,8 +229,10 @@ void GPUDriverGL::SetRenderBufferBitmap(uint32_t render_buffer_id,
   CHECK_GL();
 
   // Delete any existing PBOs
-  if (entry.bitmap)
+  if (entry.bitmap) {
     glDeleteBuffers(1, &entry.pbo_id);
+    memory_stats_.pixel_buffer_bytes -= entry.bitmap->size();
+  }
 
   entry.bitmap = bitmap;
 
@@ -155,6 +243,7 @@ void GPUDriverGL::SetRenderBufferBitmap(uint32_t render_buffer_id,
     // Setup PBOs
     glBindBuffer(GL_PIXEL_PACK_BUFFER, entry.pbo_id);
     glBufferData(GL_PIXEL_PACK_BUFFER, bitmap->size(), 0, GL_STREAM_READ);
+    memory_stats_.pixel_buffer_bytes += bitmap->size();
     
     CHECK_GL();
 
@@ -204,69 +293,80 @@ void GPUDriverGL::CreateTexture(uint32_t texture_id,
   CHECK_GL();
 
   TextureEntry& entry = texture_map[texture_id];
-  glGenTextures(1, &entry.tex_id);
-  glActiveTexture(GL_TEXTURE0 + 0);
-  glBindTexture(GL_TEXTURE_2D, entry.tex_id);
-  CHECK_GL();
-  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-  glPixelStorei(GL_UNPACK_ROW_LENGTH, bitmap->row_bytes() / bitmap->bpp());
-  CHECK_GL();
-  if (bitmap->format() == BitmapFormat::A8_UNORM) {
-    const void* pixels = bitmap->LockPixels();
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, bitmap->width(), bitmap->height(), 0,
-      GL_RED, GL_UNSIGNED_BYTE, pixels);
-    bitmap->UnlockPixels();
-    // GL_R8 stores data in .r, but HLSL A8_UNORM reads .a — set up swizzle to match
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ZERO);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ZERO);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ZERO);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_RED);
-  } else if (bitmap->format() == BitmapFormat::BGRA8_UNORM_SRGB) {
-    const void* pixels = bitmap->LockPixels();
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, bitmap->width(), bitmap->height(), 0,
-      GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-    bitmap->UnlockPixels();
-  } else {
+
+  bool supported_format = bitmap->format() == BitmapFormat::A8_UNORM ||
+    bitmap->format() == BitmapFormat::BGRA8_UNORM_SRGB;
+  if (!supported_format)
     FATAL("Unhandled texture format: " << (int)bitmap->format())
-  }
 
+  if (texture_uploader_ && bitmap->size() >= kAsyncUploadMinBytes) {
+    // Upload large bitmaps in the background and draw a placeholder until
+    // the upload lands, see CollectTextureUploads().
+    entry.tex_id = PlaceholderTexture();
+    entry.upload_pending = true;
+    texture_uploader_->Enqueue(texture_id, bitmap);
+  } else {
+    entry.tex_id = CreateTextureFromBitmapGL(bitmap.get());
+  }
   CHECK_GL();
-  glGenerateMipmap(GL_TEXTURE_2D);
-  CHECK_GL();
+
+  entry.width = bitmap->width();
+  entry.height = bitmap->height();
+  entry.format = bitmap->format();
+
+  memory_stats_.texture_count++;
+  TrackTextureBytes(entry, MipChainBytes(bitmap->width(), bitmap->height(), bitmap->bpp()), 0);
 }
 
 void GPUDriverGL::UpdateTexture(uint32_t texture_id,
   RefPtr<Bitmap> bitmap) {
   glActiveTexture(GL_TEXTURE0 + 0);
   TextureEntry& entry = texture_map[texture_id];
-  glBindTexture(GL_TEXTURE_2D, entry.tex_id);
+  FinishTextureUpload(entry, texture_id);
   CHECK_GL();
-  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-  glPixelStorei(GL_UNPACK_ROW_LENGTH, bitmap->row_bytes() / bitmap->bpp());
 
   if (!bitmap->IsEmpty()) {
-    if (bitmap->format() == BitmapFormat::A8_UNORM) {
-      const void* pixels = bitmap->LockPixels();
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, bitmap->width(), bitmap->height(), 0,
-        GL_RED, GL_UNSIGNED_BYTE, pixels);
-      bitmap->UnlockPixels();
-    } else if (bitmap->format() == BitmapFormat::BGRA8_UNORM_SRGB) {
-      const void* pixels = bitmap->LockPixels();
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, bitmap->width(), bitmap->height(), 0,
-        GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-      bitmap->UnlockPixels();
-    } else {
+    if (bitmap->format() != BitmapFormat::A8_UNORM && bitmap->format() != BitmapFormat::BGRA8_UNORM_SRGB)
       FATAL("Unhandled texture format: " << (int)bitmap->format());
+
+    bool same_storage = bitmap->width() == entry.width && bitmap->height() == entry.height &&
+      bitmap->format() == entry.format;
+    if (DirectStateAccess().supported && !same_storage) {
+      // Textures created with direct state access have immutable storage,
+      // replace the texture instead of re-specifying it.
+      deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Texture, entry.tex_id);
+      entry.tex_id = CreateTextureFromBitmapGL(bitmap.get());
+    } else {
+      UpdateTextureFromBitmapGL(entry.tex_id, bitmap.get());
     }
 
+    entry.width = bitmap->width();
+    entry.height = bitmap->height();
+    entry.format = bitmap->format();
     CHECK_GL();
-    glGenerateMipmap(GL_TEXTURE_2D);
+
+    TrackTextureBytes(entry, MipChainBytes(bitmap->width(), bitmap->height(), bitmap->bpp()), 0);
   }
 
   CHECK_GL();
 }
 
 void GPUDriverGL::BindTexture(uint8_t texture_unit, uint32_t texture_id) {
+  const DirectStateAccessGL& dsa = DirectStateAccess();
+  if (dsa.supported) {
+    TextureEntry& entry = texture_map[texture_id];
+    ResolveIfNeeded(entry.render_buffer_id);
+    dsa.BindTextureUnit(texture_unit, entry.tex_id);
+    if (entry.tex_id) {
+      dsa.TextureParameteri(entry.tex_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      dsa.TextureParameteri(entry.tex_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      dsa.TextureParameteri(entry.tex_id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      dsa.TextureParameteri(entry.tex_id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    CHECK_GL();
+    return;
+  }
+
   glActiveTexture(GL_TEXTURE0 + texture_unit);
   BindUltralightTexture(texture_id);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -279,11 +379,45 @@ void GPUDriverGL::BindTexture(uint8_t texture_unit, uint32_t texture_id) {
 
 void GPUDriverGL::DestroyTexture(uint32_t texture_id) {
   TextureEntry& entry = texture_map[texture_id];
-  glDeleteTextures(1, &entry.tex_id);
-  CHECK_GL();
-  if (entry.msaa_tex_id)
-    glDeleteTextures(1, &entry.msaa_tex_id);
-  CHECK_GL();
+
+  if (entry.upload_pending) {
+    // The uploaded texture is retired once the upload thread is done with it.
+    texture_uploader_->Cancel(texture_id);
+    entry.upload_pending = false;
+    entry.tex_id = 0; // The placeholder is shared
+    memory_stats_.texture_count--;
+    TrackTextureBytes(entry, 0, 0);
+    return;
+  }
+
+  if (IsPoolableRenderTarget(entry)) {
+    RenderTargetPoolGL::RenderTarget target;
+    target.tex_id = entry.tex_id;
+    target.msaa_tex_id = entry.msaa_tex_id;
+    target.width = entry.width;
+    target.height = entry.height;
+    target.bytes = entry.bytes;
+    target.msaa_bytes = entry.msaa_bytes;
+    target.fbo_map = std::move(entry.pooled_fbos);
+
+    memory_stats_.texture_count--;
+    TrackTextureBytes(entry, 0, 0);
+    entry.tex_id = 0;
+    entry.msaa_tex_id = 0;
+    entry.pooled_fbos.clear();
+
+    render_target_pool_.Release(std::move(target));
+    return;
+  }
+
+  deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Texture, entry.tex_id);
+  deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Texture, entry.msaa_tex_id);
+
+  if (entry.tex_id)
+    memory_stats_.texture_count--;
+  TrackTextureBytes(entry, 0, 0);
+  entry.tex_id = 0;
+  entry.msaa_tex_id = 0;
 }
 
 void GPUDriverGL::CreateRenderBuffer(uint32_t render_buffer_id,
@@ -299,6 +433,16 @@ void GPUDriverGL::CreateRenderBuffer(uint32_t render_buffer_id,
   TextureEntry& textureEntry = texture_map[buffer.texture_id];
   textureEntry.render_buffer_id = render_buffer_id;
 
+  // Adopt any FBOs that were recycled along with a pooled texture.
+  for (auto& i : textureEntry.pooled_fbos) {
+    FBOEntry& fbo_entry = entry.fbo_map[i.first];
+    fbo_entry.fbo_id = i.second.fbo_id;
+    fbo_entry.msaa_fbo_id = i.second.msaa_fbo_id;
+  }
+  textureEntry.pooled_fbos.clear();
+
+  memory_stats_.render_buffer_count++;
+
   // We don't actually create FBOs here-- they are lazily-created
   // for each active window during BindRenderBuffer (this is because
   // FBOs are not shared between contexts in GL 3.2)
@@ -321,11 +465,10 @@ void GPUDriverGL::BindRenderBuffer(uint32_t render_buffer_id) {
 
   auto& fbo_entry = i->second;
 
-  if (context_->msaa_enabled()) {
+  if (entry.msaa_active && fbo_entry.msaa_fbo_id) {
     // We use the MSAA FBO when doing multisampled rendering.
     // The other FBO (entry.fbo_id) is used for resolving.
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_entry.msaa_fbo_id);
-    fbo_entry.needs_resolve = true;
   } else {
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_entry.fbo_id);
   }
@@ -336,9 +479,34 @@ void GPUDriverGL::BindRenderBuffer(uint32_t render_buffer_id) {
 void GPUDriverGL::ClearRenderBuffer(uint32_t render_buffer_id) {
     glfwMakeContextCurrent(context_->active_window());
 
+  RenderBufferEntry* entry = nullptr;
+  if (render_buffer_id) {
+    entry = &render_buffer_map[render_buffer_id];
+
+    // A clear starts a new pass over the whole buffer. Only keep rendering
+    // multisampled if the previous pass drew paths, the multisampled
+    // contents are discarded either way.
+    bool use_msaa = entry->paths_drawn;
+    if (entry->msaa_active && !use_msaa) {
+      BindRenderBuffer(render_buffer_id);
+      InvalidateBoundFramebuffer();
+    }
+
+    entry->msaa_active = use_msaa;
+    entry->paths_drawn = false;
+    entry->needs_resolve = false;
+  }
+
   BindRenderBuffer(render_buffer_id);
   glDisable(GL_SCISSOR_TEST);
   CHECK_GL();
+
+  if (entry && entry->msaa_active) {
+    InvalidateBoundFramebuffer();
+    TextureEntry& textureEntry = texture_map[entry->texture_id];
+    MarkResolveRegion(*entry, FullRect(textureEntry.width, textureEntry.height));
+  }
+
   glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
   CHECK_GL();
   glClear(GL_COLOR_BUFFER_BIT);
@@ -349,48 +517,53 @@ void GPUDriverGL::DestroyRenderBuffer(uint32_t render_buffer_id) {
   if (render_buffer_id == 0)
     return;
 
-  auto previous_context = glfwGetCurrentContext();
-  
   RenderBufferEntry& entry = render_buffer_map[render_buffer_id];
+
+  // Keep the FBOs attached to the texture if it's going back to the pool,
+  // they're deleted along with it if the pool evicts it.
+  TextureEntry& textureEntry = texture_map[entry.texture_id];
+  if (IsPoolableRenderTarget(textureEntry)) {
+    for (auto& i : entry.fbo_map) {
+      RenderTargetFBOs& fbos = textureEntry.pooled_fbos[i.first];
+      fbos.fbo_id = i.second.fbo_id;
+      fbos.msaa_fbo_id = i.second.msaa_fbo_id;
+    }
+    entry.fbo_map.clear();
+  }
+
+  // FBOs are deleted later in the context that created them, see EndSynchronize()
   for (auto i = entry.fbo_map.begin(); i != entry.fbo_map.end(); ++i) {
     auto context = i->first;
-    auto fbo_entry = i->second;
-    glfwMakeContextCurrent(context);
-    glDeleteFramebuffers(1, &fbo_entry.fbo_id);
-    CHECK_GL();
-    if (context_->msaa_enabled())
-      glDeleteFramebuffers(1, &fbo_entry.msaa_fbo_id);
-    CHECK_GL();
+    auto& fbo_entry = i->second;
+    deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Framebuffer, fbo_entry.fbo_id, context);
+    deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Framebuffer, fbo_entry.msaa_fbo_id, context);
   }
 
 #if ENABLE_OFFSCREEN_GL
   // Clean up PBOs if a bitmap is bound
-  if (entry.bitmap)
-    glDeleteBuffers(1, &entry.pbo_id);
+  if (entry.bitmap) {
+    deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Buffer, entry.pbo_id);
+    memory_stats_.pixel_buffer_bytes -= entry.bitmap->size();
+  }
 #endif
-  CHECK_GL();
   render_buffer_map.erase(render_buffer_id);
-
-  glfwMakeContextCurrent(previous_context);
+  memory_stats_.render_buffer_count--;
 }
 
 void GPUDriverGL::CreateGeometry(uint32_t geometry_id,
   const VertexBuffer& vertices,
   const IndexBuffer& indices) {
+  if (!GeometryArenaGL::StrideForFormat(vertices.format))
+    FATAL("Unhandled vertex format: " << (int)vertices.format);
 
   GeometryEntry geometry;
   geometry.vertex_format = vertices.format;
-
-  glGenBuffers(1, &geometry.vbo_vertices);
-  glBindBuffer(GL_ARRAY_BUFFER, geometry.vbo_vertices);
-  glBufferData(GL_ARRAY_BUFFER, vertices.size, vertices.data, GL_DYNAMIC_DRAW);
+  geometry.allocation = geometry_arena_.Allocate(vertices, indices);
   CHECK_GL();
 
-  glGenBuffers(1, &geometry.vbo_indices);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry.vbo_indices);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size, indices.data,
-    GL_STATIC_DRAW);
-  CHECK_GL();
+  geometry.bytes = (uint64_t)vertices.size + indices.size;
+  memory_stats_.geometry_bytes = geometry_arena_.reserved_bytes();
+  memory_stats_.geometry_count++;
 
   geometry_map[geometry_id] = geometry;
 }
@@ -401,14 +574,12 @@ void GPUDriverGL::UpdateGeometry(uint32_t geometry_id,
 
   GeometryEntry& geometry = geometry_map[geometry_id];
   CHECK_GL();
-  glBindBuffer(GL_ARRAY_BUFFER, geometry.vbo_vertices);
-  glBufferData(GL_ARRAY_BUFFER, vertices.size, vertices.data, GL_DYNAMIC_DRAW);
-  CHECK_GL();
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry.vbo_indices);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size, indices.data, GL_STATIC_DRAW);
-  CHECK_GL();
+  geometry_arena_.Update(geometry.allocation, vertices, indices);
   CHECK_GL();
 
+  geometry.vertex_format = vertices.format;
+  geometry.bytes = (uint64_t)vertices.size + indices.size;
+  memory_stats_.geometry_bytes = geometry_arena_.reserved_bytes();
 }
 
 void GPUDriverGL::DrawGeometry(uint32_t geometry_id,
@@ -421,6 +592,11 @@ void GPUDriverGL::DrawGeometry(uint32_t geometry_id,
   if (programs_.empty())
     LoadPrograms();
 
+  // Only render buffers that contain path geometry need multisampling,
+  // everything else is axis-aligned quads that are antialiased in the shader.
+  if ((ShaderType)state.shader_type == ShaderType::FillPath)
+    EnableMSAAIfNeeded(state.render_buffer_id);
+
   BindRenderBuffer(state.render_buffer_id);
 
   SetViewport(state.viewport_width, state.viewport_height);
@@ -431,9 +607,13 @@ void GPUDriverGL::DrawGeometry(uint32_t geometry_id,
   
   CHECK_GL();
 
-  CreateVAOIfNeededForActiveContext(geometry_id);
-  auto vao_entry = geometry.vao_map[glfwGetCurrentContext()];
-  glBindVertexArray(vao_entry);
+  // Geometry in the same arena page shares a VAO, only rebind when the page
+  // changes between consecutive draws.
+  GLuint vao = geometry_arena_.GetVAOForActiveContext(geometry.allocation);
+  if (vao != bound_vao_) {
+    glBindVertexArray(vao);
+    bound_vao_ = vao;
+  }
   CHECK_GL();
 
   BindTexture(0, state.texture_1_id);
@@ -450,6 +630,14 @@ void GPUDriverGL::DrawGeometry(uint32_t geometry_id,
     glDisable(GL_SCISSOR_TEST);
   }
 
+  if (state.render_buffer_id) {
+    RenderBufferEntry& rbuf = render_buffer_map[state.render_buffer_id];
+    if (rbuf.msaa_active) {
+      MarkResolveRegion(rbuf, state.enable_scissor ? state.scissor_rect :
+        FullRect(state.viewport_width, state.viewport_height));
+    }
+  }
+
   if (state.enable_blend) {
     glEnable(GL_BLEND);
     glBlendFunc(MapBlendFactor(state.blend_src_factor),
@@ -459,10 +647,10 @@ void GPUDriverGL::DrawGeometry(uint32_t geometry_id,
     glDisable(GL_BLEND);
   }
   CHECK_GL();
-  glDrawElements(GL_TRIANGLES, indices_count, GL_UNSIGNED_INT,
-    (GLvoid*)(indices_offset * sizeof(unsigned int)));
+  glDrawElementsBaseVertex(GL_TRIANGLES, indices_count, GL_UNSIGNED_INT,
+    (GLvoid*)((size_t)(geometry.allocation.index_offset + indices_offset) * sizeof(unsigned int)),
+    geometry.allocation.vertex_offset);
   CHECK_GL();
-  glBindVertexArray(0);
 
 #if ENABLE_OFFSCREEN_GL
   auto& rbuf = render_buffer_map[state.render_buffer_id];
@@ -478,35 +666,27 @@ void GPUDriverGL::DrawGeometry(uint32_t geometry_id,
 void GPUDriverGL::DestroyGeometry(uint32_t geometry_id) {
   GeometryEntry& geometry = geometry_map[geometry_id];
   CHECK_GL();
-  glDeleteBuffers(1, &geometry.vbo_indices);
-  glDeleteBuffers(1, &geometry.vbo_vertices);
+  geometry_arena_.Free(geometry.allocation);
   CHECK_GL();
 
-  auto previous_context = glfwGetCurrentContext();
-
-  for (auto i = geometry.vao_map.begin(); i != geometry.vao_map.end(); ++i) {
-    auto context = i->first;
-    auto vao_entry = i->second;
-    glfwMakeContextCurrent(context);
-    glDeleteVertexArrays(1, &vao_entry);
-    CHECK_GL();
-  }
-
-  CHECK_GL();
+  memory_stats_.geometry_bytes = geometry_arena_.reserved_bytes();
+  memory_stats_.geometry_count--;
   geometry_map.erase(geometry_id);
-
-  glfwMakeContextCurrent(previous_context);
 }
 
 void GPUDriverGL::DrawCommandList() {
-  if (command_list_.empty())
+  if (!command_arena_.has_pending())
     return;
 
+  TraceZone("GPUDriverGL::DrawCommandList");
+
   glfwMakeContextCurrent(context_->active_window());
+  deletion_queue_.AddContext(context_->active_window());
 
   CHECK_GL();
 
   batch_count_ = 0;
+  bound_vao_ = 0;
 
   glDisable(GL_SCISSOR_TEST);
   glDisable(GL_DEPTH_TEST);
@@ -514,20 +694,25 @@ void GPUDriverGL::DrawCommandList() {
 
   CHECK_GL();
 
-  for (auto i = command_list_.begin(); i != command_list_.end(); ++i) {
-    switch (i->command_type) {
+  for (auto& cmd : command_arena_.Acquire()) {
+    switch (cmd.command_type) {
     case CommandType::DrawGeometry:
-      DrawGeometry(i->geometry_id, i->indices_count, i->indices_offset, i->gpu_state);
+      DrawGeometry(cmd.geometry_id, cmd.indices_count, cmd.indices_offset, cmd.gpu_state);
       break;
     case CommandType::ClearRenderBuffer:
-      ClearRenderBuffer(i->gpu_state.render_buffer_id);
+      ClearRenderBuffer(cmd.gpu_state.render_buffer_id);
       break;
     };
   }
 
-  command_list_.clear();
+  glBindVertexArray(0);
+  bound_vao_ = 0;
   glDisable(GL_SCISSOR_TEST);
 
+  render_target_pool_.NextFrame();
+  last_frame_uniform_stats_ = uniform_stats_;
+  uniform_stats_ = UniformUploadStats();
+
 #if ENABLE_OFFSCREEN_GL
   GLenum format = Platform::instance().config().use_bgra_for_offscreen_rendering ?
     GL_BGRA : GL_RGBA;
@@ -554,6 +739,155 @@ void GPUDriverGL::DrawCommandList() {
   CHECK_GL();
 }
 
+void GPUDriverGL::EndSynchronize() {
+  GPUDriverImpl::EndSynchronize();
+
+  CollectTextureUploads();
+
+  // Objects destroyed while the renderer was updating were last referenced
+  // by commands already issued, but possibly in any window's context (draws
+  // happen there, not in this sync context). The queue fences each of them.
+  deletion_queue_.Collect();
+  deletion_queue_.Submit();
+}
+
+void GPUDriverGL::CollectTextureUploads() {
+  if (!texture_uploader_)
+    return;
+
+  for (auto& upload : texture_uploader_->Collect()) {
+    if (upload.cancelled) {
+      deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Texture, upload.tex_id);
+      continue;
+    }
+
+    TextureEntry& entry = texture_map[upload.texture_id];
+    entry.tex_id = upload.tex_id;
+    entry.upload_pending = false;
+  }
+}
+
+void GPUDriverGL::FinishTextureUpload(TextureEntry& entry, uint32_t texture_id) {
+  if (!entry.upload_pending)
+    return;
+
+  TextureUploaderGL::Upload upload = texture_uploader_->Finish(texture_id);
+  entry.tex_id = upload.tex_id;
+  entry.upload_pending = false;
+
+  if (!entry.tex_id) {
+    // The upload thread never got to it, do it here.
+    entry.tex_id = CreateTextureFromBitmapGL(upload.bitmap.get());
+    CHECK_GL();
+  }
+}
+
+GLuint GPUDriverGL::PlaceholderTexture() {
+  if (!placeholder_tex_id_) {
+    const uint32_t transparent = 0;
+    glGenTextures(1, &placeholder_tex_id_);
+    glActiveTexture(GL_TEXTURE0 + 0);
+    glBindTexture(GL_TEXTURE_2D, placeholder_tex_id_);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_BGRA, GL_UNSIGNED_BYTE, &transparent);
+    CHECK_GL();
+  }
+
+  return placeholder_tex_id_;
+}
+
+TextureUploaderGL::Stats GPUDriverGL::texture_upload_stats() const {
+  return texture_uploader_ ? texture_uploader_->stats() : TextureUploaderGL::Stats();
+}
+
+GPUMemoryStats GPUDriverGL::memory_stats() const {
+  // Pooled render targets are no longer Ultralight textures but still hold
+  // GPU memory.
+  GPUMemoryStats stats = memory_stats_;
+  const RenderTargetPoolGL::Stats& pool = render_target_pool_.stats();
+  stats.render_target_bytes += pool.pooled_bytes - pool.pooled_msaa_bytes;
+  stats.msaa_bytes += pool.pooled_msaa_bytes;
+
+  GeometryArenaGL::Stats geometry = geometry_arena_.stats();
+  stats.geometry_used_bytes = geometry.used_bytes;
+  stats.geometry_largest_free_bytes = geometry.largest_free_bytes;
+  stats.geometry_fragmentation = geometry.fragmentation;
+  return stats;
+}
+
+GPUDriverStats GPUDriverGL::driver_stats() const {
+  GPUDriverStats stats;
+  const RenderTargetPoolGL::Stats& pool = render_target_pool_.stats();
+  stats.render_target_pool_hits = pool.hits;
+  stats.render_target_pool_misses = pool.misses;
+  stats.render_target_pool_evictions = pool.evictions;
+
+  const DeletionQueueGL::Stats& deletions = deletion_queue_.stats();
+  stats.pending_deletion_objects = deletions.pending_objects;
+  stats.pending_deletion_frames = deletions.pending_frames;
+
+  stats.uniform_full_bytes = last_frame_uniform_stats_.full_bytes;
+  stats.uniform_uploaded_bytes = last_frame_uniform_stats_.uploaded_bytes;
+  stats.uniform_skipped_uploads = last_frame_uniform_stats_.skipped_uploads;
+  return stats;
+}
+
+std::vector<GPUDriverImpl::ResourceUsage> GPUDriverGL::TopMemoryConsumers(size_t max_count) const {
+  std::vector<ResourceUsage> result;
+  result.reserve(texture_map.size() + geometry_map.size());
+
+  for (auto& i : texture_map) {
+    const TextureEntry& entry = i.second;
+    if (entry.bytes)
+      result.push_back({ entry.is_render_target ? "render target" : "texture", i.first, entry.bytes });
+    if (entry.msaa_bytes)
+      result.push_back({ "msaa render target", i.first, entry.msaa_bytes });
+  }
+
+  for (auto& i : geometry_map) {
+    if (i.second.bytes)
+      result.push_back({ "geometry", i.first, i.second.bytes });
+  }
+
+  if (render_target_pool_.stats().pooled_bytes)
+    result.push_back({ "render target pool", 0, render_target_pool_.stats().pooled_bytes });
+
+  size_t count = std::min(max_count, result.size());
+  std::partial_sort(result.begin(), result.begin() + count, result.end(),
+    [](const ResourceUsage& a, const ResourceUsage& b) { return a.bytes > b.bytes; });
+  result.resize(count);
+  return result;
+}
+
+void GPUDriverGL::PurgeCaches() {
+  glfwMakeContextCurrent(context_->active_window());
+  render_target_pool_.Purge();
+}
+
+void GPUDriverGL::ForgetContext(GLFWwindow* context) {
+  for (auto& i : texture_map)
+    i.second.pooled_fbos.erase(context);
+  for (auto& i : render_buffer_map)
+    i.second.fbo_map.erase(context);
+  msaa_copy_vao_map_.erase(context);
+  geometry_arena_.ForgetContext(context);
+  render_target_pool_.ForgetContext(context);
+  deletion_queue_.ForgetContext(context);
+}
+
+bool GPUDriverGL::IsPoolableRenderTarget(const TextureEntry& entry) const {
+  return entry.tex_id && entry.is_render_target && !entry.is_sRGB;
+}
+
+void GPUDriverGL::TrackTextureBytes(TextureEntry& entry, uint64_t bytes, uint64_t msaa_bytes) {
+  uint64_t& bucket = entry.is_render_target ? memory_stats_.render_target_bytes : memory_stats_.texture_bytes;
+  bucket = bucket - entry.bytes + bytes;
+  memory_stats_.msaa_bytes = memory_stats_.msaa_bytes - entry.msaa_bytes + msaa_bytes;
+  entry.bytes = bytes;
+  entry.msaa_bytes = msaa_bytes;
+}
+
 void GPUDriverGL::BindUltralightTexture(uint32_t ultralight_texture_id) {
   TextureEntry& entry = texture_map[ultralight_texture_id];
   ResolveIfNeeded(entry.render_buffer_id);
@@ -567,6 +901,20 @@ void GPUDriverGL::LoadPrograms(void) {
   LoadProgram(ultralight::ShaderType::FilterBasic);
   LoadProgram(ultralight::ShaderType::FilterBlur);
   LoadProgram(ultralight::ShaderType::FilterDropShadow);
+
+  msaa_copy_program_.vert_shader_id = LoadShaderFromSource(GL_VERTEX_SHADER,
+    msaa_copy_vs_source, "msaa_copy.vs");
+  msaa_copy_program_.frag_shader_id = LoadShaderFromSource(GL_FRAGMENT_SHADER,
+    msaa_copy_fs_source, "msaa_copy.fs");
+  msaa_copy_program_.program_id = glCreateProgram();
+  glAttachShader(msaa_copy_program_.program_id, msaa_copy_program_.vert_shader_id);
+  glAttachShader(msaa_copy_program_.program_id, msaa_copy_program_.frag_shader_id);
+  glLinkProgram(msaa_copy_program_.program_id);
+
+  GLint linkStatus;
+  glGetProgramiv(msaa_copy_program_.program_id, GL_LINK_STATUS, &linkStatus);
+  if (linkStatus == GL_FALSE)
+    FATAL("Unable to link shader.\n\tError:" << glErrorString(glGetError()) << "\n\tLog: " << GetProgramLog(msaa_copy_program_.program_id))
 }
 
 void GPUDriverGL::DestroyPrograms(void) {
@@ -580,6 +928,15 @@ void GPUDriverGL::DestroyPrograms(void) {
     glDeleteProgram(prog.program_id);
   }
   programs_.clear();
+
+  if (msaa_copy_program_.program_id) {
+    glDetachShader(msaa_copy_program_.program_id, msaa_copy_program_.vert_shader_id);
+    glDetachShader(msaa_copy_program_.program_id, msaa_copy_program_.frag_shader_id);
+    glDeleteShader(msaa_copy_program_.vert_shader_id);
+    glDeleteShader(msaa_copy_program_.frag_shader_id);
+    glDeleteProgram(msaa_copy_program_.program_id);
+    msaa_copy_program_ = ProgramEntry();
+  }
 }
 
 void GPUDriverGL::LoadProgram(ProgramType type) {
@@ -680,43 +1037,88 @@ void GPUDriverGL::SelectProgram(ProgramType type) {
 }
 
 void GPUDriverGL::UpdateUniforms(const GPUState& state) {
-  bool flip_y = state.render_buffer_id != 0;
-  Matrix model_view_projection = ApplyProjection(state.transform,
-    (float)state.viewport_width, (float)state.viewport_height, flip_y);
-
-  Uniforms uniforms;
+  ProgramType type = (ProgramType)state.shader_type;
+  uint32_t fields = UniformFieldsForProgram(type);
+
+  // Start from what's already in the UBO so fields this program doesn't read
+  // (and the unused tail of Clip) keep their current contents.
+  Uniforms uniforms = uniforms_shadow_;
+
+  if (fields & kUniformState) {
+    // State: [time, screenWidth, screenHeight, screenScale]
+    uniforms.State[0] = 0.0f;
+    uniforms.State[1] = (float)state.viewport_width;
+    uniforms.State[2] = (float)state.viewport_height;
+    uniforms.State[3] = 1.0f;
+  }
 
-  // State: [time, screenWidth, screenHeight, screenScale]
-  uniforms.State[0] = 0.0f;
-  uniforms.State[1] = (float)state.viewport_width;
-  uniforms.State[2] = (float)state.viewport_height;
-  uniforms.State[3] = 1.0f;
+  if (fields & kUniformTransform) {
+    bool flip_y = state.render_buffer_id != 0;
+    Matrix model_view_projection = ApplyProjection(state.transform,
+      (float)state.viewport_width, (float)state.viewport_height, flip_y);
 
-  // Transform (row-major mat4)
-  Matrix4x4 mat = model_view_projection.GetMatrix4x4();
-  memcpy(uniforms.Transform, mat.data, sizeof(uniforms.Transform));
+    // Transform (row-major mat4)
+    Matrix4x4 mat = model_view_projection.GetMatrix4x4();
+    memcpy(uniforms.Transform, mat.data, sizeof(uniforms.Transform));
+  }
 
   // Integer4 (ivec4[2])
-  memcpy(uniforms.Integer4, state.uniform_integer, sizeof(uniforms.Integer4));
+  if (fields & kUniformInteger4)
+    memcpy(uniforms.Integer4, state.uniform_integer, sizeof(uniforms.Integer4));
 
   // Scalar4 (vec4[2])
-  memcpy(uniforms.Scalar4, state.uniform_scalar, sizeof(uniforms.Scalar4));
+  if (fields & kUniformScalar4)
+    memcpy(uniforms.Scalar4, state.uniform_scalar, sizeof(uniforms.Scalar4));
 
   // Vector (vec4[8])
-  memcpy(uniforms.Vector, &state.uniform_vector[0].x, sizeof(uniforms.Vector));
+  if (fields & kUniformVector)
+    memcpy(uniforms.Vector, &state.uniform_vector[0].x, sizeof(uniforms.Vector));
+
+  // Only the first clip_size clip matrices are read by the shaders.
+  size_t clip_bytes = 0;
+  if (fields & kUniformClip) {
+    // ClipData (ivec4)
+    uniforms.ClipData[0] = (int32_t)state.clip_size;
+    uniforms.ClipData[1] = 0;
+    uniforms.ClipData[2] = 0;
+    uniforms.ClipData[3] = 0;
+
+    // Clip matrices (row-major mat4[8])
+    clip_bytes = std::min((size_t)state.clip_size, (size_t)8) * sizeof(float) * 16;
+    memcpy(uniforms.Clip, &state.clip[0].data[0], clip_bytes);
+  }
 
-  // ClipData (ivec4)
-  uniforms.ClipData[0] = (int32_t)state.clip_size;
-  uniforms.ClipData[1] = 0;
-  uniforms.ClipData[2] = 0;
-  uniforms.ClipData[3] = 0;
+  uniform_stats_.draws++;
+  uniform_stats_.full_bytes += sizeof(Uniforms);
+
+  // Upload the smallest span covering every byte that changed.
+  const uint8_t* src = (const uint8_t*)&uniforms;
+  const uint8_t* shadow = (const uint8_t*)&uniforms_shadow_;
+  size_t used_end = clip_bytes ? offsetof(Uniforms, Clip) + clip_bytes : sizeof(Uniforms);
+  size_t begin = 0;
+  while (begin < used_end && src[begin] == shadow[begin])
+    begin++;
+
+  if (begin < used_end) {
+    size_t end = used_end;
+    while (end > begin && src[end - 1] == shadow[end - 1])
+      end--;
+
+    const DirectStateAccessGL& dsa = DirectStateAccess();
+    if (dsa.supported) {
+      dsa.NamedBufferSubData(ubo_id_, begin, end - begin, src + begin);
+    } else {
+      glBindBuffer(GL_UNIFORM_BUFFER, ubo_id_);
+      glBufferSubData(GL_UNIFORM_BUFFER, begin, end - begin, src + begin);
+    }
 
-  // Clip matrices (row-major mat4[8])
-  memcpy(uniforms.Clip, &state.clip[0].data[0], sizeof(uniforms.Clip));
+    memcpy(&uniforms_shadow_, &uniforms, sizeof(Uniforms));
+    uniform_stats_.uploaded_bytes += end - begin;
+  } else {
+    uniform_stats_.skipped_uploads++;
+  }
 
-  // Upload to UBO and bind
-  glBindBuffer(GL_UNIFORM_BUFFER, ubo_id_);
-  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Uniforms), &uniforms);
+  // Bind
   glBindBufferBase(GL_UNIFORM_BUFFER, 0, ubo_id_);
 
   CHECK_GL();
@@ -750,6 +1152,17 @@ void GPUDriverGL::CreateFBOTexture(uint32_t texture_id, RefPtr<Bitmap> bitmap) {
   TextureEntry& entry = texture_map[texture_id];
   entry.width = bitmap->width();
   entry.height = bitmap->height();
+  entry.is_render_target = true;
+
+  RenderTargetPoolGL::RenderTarget pooled;
+  if (render_target_pool_.Acquire(entry.width, entry.height, false, pooled)) {
+    entry.tex_id = pooled.tex_id;
+    entry.msaa_tex_id = pooled.msaa_tex_id;
+    entry.pooled_fbos = std::move(pooled.fbo_map);
+    memory_stats_.texture_count++;
+    TrackTextureBytes(entry, pooled.bytes, pooled.msaa_bytes);
+    return;
+  }
 
   // Allocate a single-sampled texture
   glGenTextures(1, &entry.tex_id);
@@ -761,16 +1174,83 @@ void GPUDriverGL::CreateFBOTexture(uint32_t texture_id, RefPtr<Bitmap> bitmap) {
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, entry.width, entry.height, 0,
     GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
 
-  if (context_->msaa_enabled()) {
-    // Allocate the multisampled texture
-    glGenTextures(1, &entry.msaa_tex_id);
+  // The multisampled texture is allocated on demand, see EnableMSAAIfNeeded()
+
+  CHECK_GL();
+  glGenerateMipmap(GL_TEXTURE_2D);
+  CHECK_GL();
+
+  memory_stats_.texture_count++;
+  TrackTextureBytes(entry, MipChainBytes(entry.width, entry.height, 4), 0);
+}
+
+void GPUDriverGL::EnableMSAAIfNeeded(uint32_t render_buffer_id) {
+  if (!context_->msaa_enabled() || render_buffer_id == 0)
+    return;
+
+  RenderBufferEntry& entry = render_buffer_map[render_buffer_id];
+  entry.paths_drawn = true;
+  if (entry.msaa_active)
+    return;
+
+  TextureEntry& textureEntry = texture_map[entry.texture_id];
+  if (!textureEntry.msaa_tex_id) {
+    glGenTextures(1, &textureEntry.msaa_tex_id);
     glActiveTexture(GL_TEXTURE0 + 0);
-    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, entry.msaa_tex_id);
-    glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, 4, GL_RGBA8, entry.width, entry.height, false);
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, textureEntry.msaa_tex_id);
+    glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, kMSAASampleCount, GL_RGBA8,
+      textureEntry.width, textureEntry.height, false);
+    CHECK_GL();
+    TrackTextureBytes(textureEntry, textureEntry.bytes, MSAABytes(textureEntry.width, textureEntry.height));
   }
 
+  entry.msaa_active = true;
+  CreateFBOIfNeededForActiveContext(render_buffer_id);
+
+  // Anything drawn earlier in this pass only exists in the resolve texture,
+  // copy it into the multisampled attachment before drawing on top of it.
+  FBOEntry& fbo_entry = entry.fbo_map[glfwGetCurrentContext()];
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_entry.msaa_fbo_id);
+  glDisable(GL_SCISSOR_TEST);
+  glDisable(GL_BLEND);
+  SetViewport(textureEntry.width, textureEntry.height);
+
+  auto vao = msaa_copy_vao_map_.find(glfwGetCurrentContext());
+  if (vao == msaa_copy_vao_map_.end()) {
+    GLuint vao_id;
+    glGenVertexArrays(1, &vao_id);
+    vao = msaa_copy_vao_map_.emplace(glfwGetCurrentContext(), vao_id).first;
+  }
+
+  glUseProgram(msaa_copy_program_.program_id);
+  glActiveTexture(GL_TEXTURE0 + 0);
+  glBindTexture(GL_TEXTURE_2D, textureEntry.tex_id);
+  glBindVertexArray(vao->second);
+  bound_vao_ = vao->second;
+  glDrawArrays(GL_TRIANGLES, 0, 3);
   CHECK_GL();
-  glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void GPUDriverGL::MarkResolveRegion(RenderBufferEntry& entry, const IntRect& rect) {
+  if (!entry.needs_resolve) {
+    entry.resolve_rect = rect;
+    entry.needs_resolve = true;
+    return;
+  }
+
+  IntRect& r = entry.resolve_rect;
+  r.left = std::min(r.left, rect.left);
+  r.top = std::min(r.top, rect.top);
+  r.right = std::max(r.right, rect.right);
+  r.bottom = std::max(r.bottom, rect.bottom);
+}
+
+void GPUDriverGL::InvalidateBoundFramebuffer() {
+  if (!invalidate_framebuffer_)
+    return;
+
+  const GLenum attachments[1] = { GL_COLOR_ATTACHMENT0 };
+  ((PFNGLINVALIDATEFRAMEBUFFERPROC_UL)invalidate_framebuffer_)(GL_FRAMEBUFFER, 1, attachments);
   CHECK_GL();
 }
 
@@ -785,43 +1265,45 @@ void GPUDriverGL::CreateFBOIfNeededForActiveContext(uint32_t render_buffer_id) {
   }
 
   RenderBufferEntry& entry = i->second;
-  auto j = entry.fbo_map.find(glfwGetCurrentContext());
-  if (j != entry.fbo_map.end())
-    return; // Already exists, we can return
+  TextureEntry& textureEntry = texture_map[entry.texture_id];
 
   FBOEntry& fbo_entry = entry.fbo_map[glfwGetCurrentContext()];
+  bool needs_msaa_fbo = entry.msaa_active && !fbo_entry.msaa_fbo_id;
+  if (fbo_entry.fbo_id && !needs_msaa_fbo)
+    return; // Already exists, we can return
 
-  glGenFramebuffers(1, &fbo_entry.fbo_id);
-  CHECK_GL();
-  glBindFramebuffer(GL_FRAMEBUFFER, fbo_entry.fbo_id);
-  CHECK_GL();
+  GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
+  GLenum result;
 
-  TextureEntry& textureEntry = texture_map[entry.texture_id];
+  if (!fbo_entry.fbo_id) {
+    glGenFramebuffers(1, &fbo_entry.fbo_id);
+    CHECK_GL();
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_entry.fbo_id);
+    CHECK_GL();
 
 #if ENABLE_OFFSCREEN_GL
-  if (entry.bitmap)
-    MakeTextureSRGBIfNeeded(entry.texture_id);
+    if (entry.bitmap)
+      MakeTextureSRGBIfNeeded(entry.texture_id);
 #endif
 
-  glBindTexture(GL_TEXTURE_2D, textureEntry.tex_id);
-  CHECK_GL();
-  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureEntry.tex_id, 0);
-  CHECK_GL();
+    glBindTexture(GL_TEXTURE_2D, textureEntry.tex_id);
+    CHECK_GL();
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureEntry.tex_id, 0);
+    CHECK_GL();
 
-  GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
-  glDrawBuffers(1, drawBuffers);
-  CHECK_GL();
+    glDrawBuffers(1, drawBuffers);
+    CHECK_GL();
 
-  GLenum result = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-  if (result != GL_FRAMEBUFFER_COMPLETE)
-    FATAL("Error creating FBO, this usually fails if your DPI scale is invalid or View dimensions are massive: " << result);
-  CHECK_GL();
+    result = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (result != GL_FRAMEBUFFER_COMPLETE)
+      FATAL("Error creating FBO, this usually fails if your DPI scale is invalid or View dimensions are massive: " << result);
+    CHECK_GL();
+  }
 
-  if (!context_->msaa_enabled()) {
+  if (!needs_msaa_fbo)
     return;
-  }
 
-  // Create MSAA FBO
+  // Create MSAA FBO, only render buffers that have drawn paths get one.
   glGenFramebuffers(1, &fbo_entry.msaa_fbo_id);
   CHECK_GL();
   glBindFramebuffer(GL_FRAMEBUFFER, fbo_entry.msaa_fbo_id);
@@ -841,79 +1323,6 @@ void GPUDriverGL::CreateFBOIfNeededForActiveContext(uint32_t render_buffer_id) {
   CHECK_GL();
 }
 
-void GPUDriverGL::CreateVAOIfNeededForActiveContext(uint32_t geometry_id) {
-  auto i = geometry_map.find(geometry_id);
-  if (i == geometry_map.end()) {
-    FATAL("Geometry ID doesn't exist.");
-    return;
-  }
-
-  auto& geometry_entry = i->second;
-
-  auto j = geometry_entry.vao_map.find(glfwGetCurrentContext());
-  if (j != geometry_entry.vao_map.end())
-    return; // Already exists, we can return
-
-  GLuint vao_entry;
-
-  glGenVertexArrays(1, &vao_entry);
-  glBindVertexArray(vao_entry);
-
-  glBindBuffer(GL_ARRAY_BUFFER, geometry_entry.vbo_vertices);
-  CHECK_GL();
-
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry_entry.vbo_indices);
-  CHECK_GL();
-
-  if (geometry_entry.vertex_format == VertexBufferFormat::_2f_4ub_2f_2f_28f) {
-    GLsizei stride = 140;
-
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)0);
-    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)8);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)12);
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)20);
-    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)28);
-    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)44);
-    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)60);
-    glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)76);
-    glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)92);
-    glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)108);
-    glVertexAttribPointer(10, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)124);
-
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-    glEnableVertexAttribArray(3);
-    glEnableVertexAttribArray(4);
-    glEnableVertexAttribArray(5);
-    glEnableVertexAttribArray(6);
-    glEnableVertexAttribArray(7);
-    glEnableVertexAttribArray(8);
-    glEnableVertexAttribArray(9);
-    glEnableVertexAttribArray(10);
-
-    CHECK_GL();
-  } else if (geometry_entry.vertex_format == VertexBufferFormat::_2f_4ub_2f) {
-    GLsizei stride = 20;
-
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)0);
-    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)8);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)12);
-
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-
-    CHECK_GL();
-  } else {
-    FATAL("Unhandled vertex format: " << (int)geometry_entry.vertex_format);
-  }
-
-  glBindVertexArray(0);
-
-  geometry_entry.vao_map[glfwGetCurrentContext()] = vao_entry;
-}
-  
 void GPUDriverGL::ResolveIfNeeded(uint32_t render_buffer_id) {
   if (!context_->msaa_enabled())
     return;
@@ -922,32 +1331,51 @@ void GPUDriverGL::ResolveIfNeeded(uint32_t render_buffer_id) {
     return;
 
   RenderBufferEntry& renderBufferEntry = render_buffer_map[render_buffer_id];
-  if (!renderBufferEntry.texture_id)
+  if (!renderBufferEntry.texture_id || !renderBufferEntry.needs_resolve)
     return;
 
   auto i = renderBufferEntry.fbo_map.find(glfwGetCurrentContext());
-  if (i == renderBufferEntry.fbo_map.end())
+  if (i == renderBufferEntry.fbo_map.end() || !i->second.msaa_fbo_id)
     return;
 
   FBOEntry& fbo_entry = i->second;
 
+  // Only blit the region drawn since the last resolve.
   TextureEntry& textureEntry = texture_map[renderBufferEntry.texture_id];
-  if (fbo_entry.needs_resolve) {
-    GLint drawFboId = 0, readFboId = 0;
-    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFboId);
-    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFboId);
-    CHECK_GL();
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo_entry.fbo_id);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_entry.msaa_fbo_id);
-    CHECK_GL();
-    glBlitFramebuffer(0, 0, textureEntry.width, textureEntry.height, 0, 0, 
-      textureEntry.width, textureEntry.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
-    CHECK_GL();
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFboId);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFboId);
+  const IntRect& dirty = renderBufferEntry.resolve_rect;
+  GLint left = std::max(dirty.left, 0);
+  GLint top = std::max(dirty.top, 0);
+  GLint right = std::min(dirty.right, (int)textureEntry.width);
+  GLint bottom = std::min(dirty.bottom, (int)textureEntry.height);
+  renderBufferEntry.needs_resolve = false;
+  if (left >= right || top >= bottom)
+    return;
+
+  // Blits are clipped by the scissor test, DrawGeometry() restores it.
+  glDisable(GL_SCISSOR_TEST);
+
+  const DirectStateAccessGL& dsa = DirectStateAccess();
+  if (dsa.supported) {
+    // No need to save and restore framebuffer bindings.
+    dsa.BlitNamedFramebuffer(fbo_entry.msaa_fbo_id, fbo_entry.fbo_id, left, top, right, bottom,
+      left, top, right, bottom, GL_COLOR_BUFFER_BIT, GL_NEAREST);
     CHECK_GL();
-    fbo_entry.needs_resolve = false;
+    return;
   }
+
+  GLint drawFboId = 0, readFboId = 0;
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFboId);
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFboId);
+  CHECK_GL();
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo_entry.fbo_id);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_entry.msaa_fbo_id);
+  CHECK_GL();
+  glBlitFramebuffer(left, top, right, bottom, left, top, right, bottom,
+    GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  CHECK_GL();
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFboId);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, readFboId);
+  CHECK_GL();
 }
 
 void GPUDriverGL::MakeTextureSRGBIfNeeded(uint32_t texture_id) {
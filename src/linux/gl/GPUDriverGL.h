@@ -4,30 +4,31 @@
 #include <GLFW/glfw3.h>
 #include "GPUContextGL.h"
 #include "GPUDriverImpl.h"
+#include "DeletionQueueGL.h"
+#include "GeometryArenaGL.h"
+#include "RenderTargetPoolGL.h"
+#include "TextureUploaderGL.h"
+#include "ShaderUniforms.h"
 #include <vector>
 #include <map>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 
 namespace ultralight {
 
 typedef ShaderType ProgramType;
 
-// Uniform buffer layout matching std140 in GLSL shaders.
-// Must match the type_Uniforms block in the generated GLSL headers.
-#pragma pack(push, 1)
-struct alignas(16) Uniforms {
-  float State[4];           // vec4: [time, screenWidth, screenHeight, screenScale]
-  float Transform[16];      // row_major mat4
-  int32_t Integer4[8];      // ivec4[2]
-  float Scalar4[8];         // vec4[2]
-  float Vector[32];         // vec4[8]
-  int32_t ClipData[4];      // ivec4
-  float Clip[128];          // row_major mat4[8]
+// Fields of Uniforms, used to describe which parts of the block a program reads.
+enum UniformField : uint32_t {
+  kUniformState     = 1 << 0,
+  kUniformTransform = 1 << 1,
+  kUniformInteger4  = 1 << 2,
+  kUniformScalar4   = 1 << 3,
+  kUniformVector    = 1 << 4,
+  kUniformClip      = 1 << 5, // ClipData and the used prefix of Clip
+  kUniformAll       = 0x3F,
 };
-#pragma pack(pop)
-
-static_assert(sizeof(Uniforms) == 800, "Uniforms struct size must be 800 bytes to match std140 layout");
 
 class GPUDriverGL : public GPUDriverImpl {
 public:
@@ -88,6 +89,32 @@ public:
 
   virtual void DrawCommandList() override;
 
+  virtual void EndSynchronize() override;
+
+  virtual GPUMemoryStats memory_stats() const override;
+
+  virtual GPUDriverStats driver_stats() const override;
+
+  virtual std::vector<ResourceUsage> TopMemoryConsumers(size_t max_count) const override;
+
+  virtual void PurgeCaches() override;
+
+  // Drops every reference to the per-context objects (FBOs, VAOs) of
+  // 'context', including queued deletions. Call before destroying a window,
+  // its objects are released along with its context.
+  void ForgetContext(GLFWwindow* context);
+
+  const RenderTargetPoolGL::Stats& render_target_pool_stats() const { return render_target_pool_.stats(); }
+
+  const DeletionQueueGL::Stats& deletion_queue_stats() const { return deletion_queue_.stats(); }
+
+  TextureUploaderGL::Stats texture_upload_stats() const;
+
+  // Uniform traffic during the most recent DrawCommandList().
+  const UniformUploadStats& uniform_upload_stats() const { return last_frame_uniform_stats_; }
+
+  GeometryArenaGL::Stats geometry_arena_stats() const { return geometry_arena_.stats(); }
+
   void BindUltralightTexture(uint32_t ultralight_texture_id);
 
   void LoadPrograms();
@@ -107,32 +134,49 @@ protected:
     GLuint tex_id = 0; // GL Texture ID
     GLuint msaa_tex_id = 0; // GL Texture ID (only used if MSAA is enabled)
     uint32_t render_buffer_id = 0; // Used to check if we need to perform MSAA resolve
-    GLuint width, height; // Used when resolving MSAA FBO, only valid if FBO
+    GLuint width = 0, height = 0; // Texture dimensions
+    BitmapFormat format = BitmapFormat::BGRA8_UNORM_SRGB;
     bool is_sRGB = false; // Whether or not the primary texture is sRGB or not.
+    bool is_render_target = false; // Whether or not this texture was created by CreateFBOTexture
+    uint64_t bytes = 0; // Estimated GPU memory used by tex_id (including mip chain)
+    uint64_t msaa_bytes = 0; // Estimated GPU memory used by msaa_tex_id
+    // FBOs recycled along with a pooled render target, adopted by the next
+    // render buffer created for this texture.
+    std::map<GLFWwindow*, RenderTargetFBOs> pooled_fbos;
+    bool upload_pending = false; // tex_id is the placeholder until the background upload lands
   };
 
   // Maps Ultralight Texture IDs to OpenGL texture handles
   std::map<uint32_t, TextureEntry> texture_map;
+
+  // Destroyed GL objects wait here until the GPU is done with them. Declared
+  // before the arena and pool which retire objects through it.
+  DeletionQueueGL deletion_queue_;
   
   struct GeometryEntry {
-    // VAOs are not shared across GL contexts so we create them lazily for each
-    std::map<GLFWwindow*, GLuint> vao_map;
     VertexBufferFormat vertex_format;
-    GLuint vbo_vertices = 0; // VBO id for vertices
-    GLuint vbo_indices = 0; // VBO id for indices
+    GeometryAllocation allocation; // Range within a geometry_arena_ page
+    uint64_t bytes = 0; // Size of vertex + index buffer data
   };
   std::map<uint32_t, GeometryEntry> geometry_map;
 
+  // Vertex/index buffers backing all geometry in geometry_map.
+  GeometryArenaGL geometry_arena_;
+  GLuint bound_vao_ = 0; // Only valid during DrawCommandList()
+
   struct FBOEntry {
     GLuint fbo_id = 0; // GL FBO ID (if MSAA is enabled, this will be used for resolve)
-    GLuint msaa_fbo_id = 0; // GL FBO ID for MSAA
-    bool needs_resolve = false; // Whether or not we need to perform MSAA resolve
+    GLuint msaa_fbo_id = 0; // GL FBO ID for MSAA (created once the render buffer draws paths)
   };
 
   struct RenderBufferEntry {
     // FBOs are not shared across GL contexts so we create them lazily for each
     std::map<GLFWwindow*, FBOEntry> fbo_map;
     uint32_t texture_id = 0; // The Ultralight texture ID backing this RenderBuffer.
+    bool msaa_active = false; // Whether draws currently go to the MSAA FBO
+    bool paths_drawn = false; // Whether FillPath geometry was drawn since the last clear
+    bool needs_resolve = false; // Whether resolve_rect needs to be resolved
+    IntRect resolve_rect = {}; // Union of regions drawn to the MSAA FBO since the last resolve
 #if ENABLE_OFFSCREEN_GL
     RefPtr<Bitmap> bitmap;
     GLuint pbo_id = 0;
@@ -144,12 +188,37 @@ protected:
 
   void CreateFBOIfNeededForActiveContext(uint32_t render_buffer_id);
 
-  void CreateVAOIfNeededForActiveContext(uint32_t geometry_id);
-
   void ResolveIfNeeded(uint32_t render_buffer_id);
 
+  // Switches a render buffer to multisampled rendering for the rest of the
+  // current pass (until the next ClearRenderBuffer).
+  void EnableMSAAIfNeeded(uint32_t render_buffer_id);
+
+  void MarkResolveRegion(RenderBufferEntry& entry, const IntRect& rect);
+
+  // Discards the color attachment of the bound FBO (no-op without GL 4.3 or
+  // ARB_invalidate_subdata).
+  void InvalidateBoundFramebuffer();
+
   void MakeTextureSRGBIfNeeded(uint32_t texture_id);
 
+  // Whether a texture's GL objects can be handed back to render_target_pool_
+  // when it's destroyed (sRGB offscreen targets are never pooled).
+  bool IsPoolableRenderTarget(const TextureEntry& entry) const;
+
+  RenderTargetPoolGL render_target_pool_;
+
+  // Swaps in textures whose background upload has completed.
+  void CollectTextureUploads();
+
+  // Waits for a pending background upload so the texture can be modified.
+  void FinishTextureUpload(TextureEntry& entry, uint32_t texture_id);
+
+  GLuint PlaceholderTexture();
+
+  std::unique_ptr<TextureUploaderGL> texture_uploader_;
+  GLuint placeholder_tex_id_ = 0; // 1x1 transparent texture drawn while uploads are pending
+
 #if ENABLE_OFFSCREEN_GL
   void UpdateBitmap(RenderBufferEntry& entry, GLuint pbo_id);
 #endif
@@ -164,6 +233,18 @@ protected:
   std::map<ProgramType, ProgramEntry> programs_;
   GLuint cur_program_id_ = 0;
   GLuint ubo_id_ = 0;
+  Uniforms uniforms_shadow_; // Current contents of ubo_id_
+  UniformUploadStats uniform_stats_;
+  UniformUploadStats last_frame_uniform_stats_;
+
+  ProgramEntry msaa_copy_program_ = {};
+  std::map<GLFWwindow*, GLuint> msaa_copy_vao_map_;
+  void* invalidate_framebuffer_ = nullptr; // glInvalidateFramebuffer, if supported
+
+  // Tracks estimated GPU memory for every resource type, updated as resources
+  // are created, updated and destroyed.
+  GPUMemoryStats memory_stats_;
+  void TrackTextureBytes(TextureEntry& entry, uint64_t bytes, uint64_t msaa_bytes);
 
   GPUContextGL* context_;
 };
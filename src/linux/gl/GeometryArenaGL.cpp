@@ -0,0 +1,278 @@
+#include "GeometryArenaGL.h"
+#include "DirectStateAccessGL.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+
+namespace ultralight {
+
+// Default page sizes, geometry larger than a page gets a dedicated page.
+static const uint32_t kVertexPageBytes = 4 * 1024 * 1024;
+static const uint32_t kIndexPageCount = 256 * 1024;
+
+// Reservations are rounded up to this many elements so that geometry which
+// grows slightly between updates can usually be updated in place.
+static const uint32_t kAllocationGranularity = 4;
+
+static uint32_t RoundUpCount(uint32_t count) {
+  count = std::max(count, 1u);
+  return (count + kAllocationGranularity - 1) / kAllocationGranularity * kAllocationGranularity;
+}
+
+GeometryArenaGL::Page::Page(VertexBufferFormat format, uint32_t vertex_capacity, uint32_t index_capacity)
+  : format(format), stride(StrideForFormat(format)), vertices(vertex_capacity), indices(index_capacity) {
+  const DirectStateAccessGL& dsa = DirectStateAccess();
+  if (dsa.supported) {
+    dsa.CreateBuffers(1, &vbo);
+    dsa.NamedBufferData(vbo, (GLsizeiptr)vertex_capacity * stride, nullptr, GL_DYNAMIC_DRAW);
+    dsa.CreateBuffers(1, &ibo);
+    dsa.NamedBufferData(ibo, (GLsizeiptr)index_capacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+    return;
+  }
+
+  // The element array binding is VAO state, make sure we don't clobber one.
+  glBindVertexArray(0);
+
+  glGenBuffers(1, &vbo);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertex_capacity * stride, nullptr, GL_DYNAMIC_DRAW);
+
+  glGenBuffers(1, &ibo);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)index_capacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+}
+
+GeometryArenaGL::GeometryArenaGL(DeletionQueueGL& deletion_queue) : deletion_queue_(deletion_queue) {}
+
+GeometryArenaGL::~GeometryArenaGL() {
+  // Windows may already be gone at this point so don't hop contexts to delete
+  // VAOs, they're released along with their context.
+  for (auto& i : pages_) {
+    glDeleteBuffers(1, &i.second->vbo);
+    glDeleteBuffers(1, &i.second->ibo);
+  }
+}
+
+GLsizei GeometryArenaGL::StrideForFormat(VertexBufferFormat format) {
+  switch (format) {
+  case VertexBufferFormat::_2f_4ub_2f_2f_28f: return 140;
+  case VertexBufferFormat::_2f_4ub_2f:        return 20;
+  default:                                    return 0;
+  }
+}
+
+GeometryAllocation GeometryArenaGL::Allocate(const VertexBuffer& vertices, const IndexBuffer& indices) {
+  GLsizei stride = StrideForFormat(vertices.format);
+  uint32_t vertex_count = RoundUpCount(vertices.size / stride);
+  uint32_t index_count = RoundUpCount(indices.size / sizeof(uint32_t));
+
+  GeometryAllocation allocation;
+  allocation.vertex_count = vertex_count;
+  allocation.index_count = index_count;
+
+  Page* page = nullptr;
+  for (auto& i : pages_) {
+    Page& candidate = *i.second;
+    if (candidate.format != vertices.format)
+      continue;
+
+    uint32_t vertex_offset = candidate.vertices.Allocate(vertex_count);
+    if (vertex_offset == RangeAllocator::kInvalidOffset)
+      continue;
+
+    uint32_t index_offset = candidate.indices.Allocate(index_count);
+    if (index_offset == RangeAllocator::kInvalidOffset) {
+      candidate.vertices.Free(vertex_offset, vertex_count);
+      continue;
+    }
+
+    allocation.page_id = i.first;
+    allocation.vertex_offset = vertex_offset;
+    allocation.index_offset = index_offset;
+    page = &candidate;
+    break;
+  }
+
+  if (!page) {
+    allocation.page_id = next_page_id_;
+    page = CreatePage(vertices.format, vertex_count, index_count);
+    allocation.vertex_offset = page->vertices.Allocate(vertex_count);
+    allocation.index_offset = page->indices.Allocate(index_count);
+  }
+
+  page->allocation_count++;
+  Upload(*page, allocation, vertices, indices);
+  return allocation;
+}
+
+void GeometryArenaGL::Update(GeometryAllocation& allocation, const VertexBuffer& vertices,
+  const IndexBuffer& indices) {
+  auto i = pages_.find(allocation.page_id);
+  if (i != pages_.end()) {
+    Page& page = *i->second;
+    uint32_t vertex_count = vertices.size / page.stride;
+    uint32_t index_count = indices.size / sizeof(uint32_t);
+    if (page.format == vertices.format && vertex_count <= allocation.vertex_count &&
+        index_count <= allocation.index_count) {
+      Upload(page, allocation, vertices, indices);
+      in_place_updates_++;
+      return;
+    }
+  }
+
+  // Doesn't fit, allocate the new range before freeing the old one so that
+  // the page isn't destroyed and re-created in between.
+  GeometryAllocation new_allocation = Allocate(vertices, indices);
+  Free(allocation);
+  allocation = new_allocation;
+  reallocations_++;
+}
+
+void GeometryArenaGL::Free(const GeometryAllocation& allocation) {
+  auto i = pages_.find(allocation.page_id);
+  if (i == pages_.end())
+    return;
+
+  Page& page = *i->second;
+  page.vertices.Free(allocation.vertex_offset, allocation.vertex_count);
+  page.indices.Free(allocation.index_offset, allocation.index_count);
+  page.allocation_count--;
+
+  if (page.allocation_count)
+    return;
+
+  // Keep one empty page per vertex format around to avoid churning pages
+  // when a single geometry is repeatedly created and destroyed.
+  for (auto& j : pages_) {
+    if (j.first != allocation.page_id && j.second->format == page.format) {
+      DestroyPage(allocation.page_id);
+      return;
+    }
+  }
+}
+
+void GeometryArenaGL::ForgetContext(GLFWwindow* context) {
+  for (auto& i : pages_)
+    i.second->vao_map.erase(context);
+}
+
+GLuint GeometryArenaGL::GetVAOForActiveContext(const GeometryAllocation& allocation) {
+  auto i = pages_.find(allocation.page_id);
+  if (i == pages_.end())
+    return 0;
+
+  Page& page = *i->second;
+  GLFWwindow* context = glfwGetCurrentContext();
+  auto j = page.vao_map.find(context);
+  if (j != page.vao_map.end())
+    return j->second;
+
+  GLuint vao;
+  glGenVertexArrays(1, &vao);
+  glBindVertexArray(vao);
+
+  glBindBuffer(GL_ARRAY_BUFFER, page.vbo);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.ibo);
+
+  GLsizei stride = page.stride;
+  if (page.format == VertexBufferFormat::_2f_4ub_2f_2f_28f) {
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)0);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)8);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)12);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)20);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)28);
+    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)44);
+    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)60);
+    glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)76);
+    glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)92);
+    glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)108);
+    glVertexAttribPointer(10, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)124);
+
+    for (GLuint attrib = 0; attrib <= 10; attrib++)
+      glEnableVertexAttribArray(attrib);
+  } else {
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)0);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)8);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)12);
+
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+  }
+
+  glBindVertexArray(0);
+
+  page.vao_map[context] = vao;
+  return vao;
+}
+
+GeometryArenaGL::Stats GeometryArenaGL::stats() const {
+  Stats result;
+  uint64_t free_vertex_bytes = 0;
+  for (auto& i : pages_) {
+    const Page& page = *i.second;
+    result.page_count++;
+    result.allocation_count += page.allocation_count;
+    uint64_t used_vertices = page.vertices.capacity() - page.vertices.free_count();
+    uint64_t used_indices = page.indices.capacity() - page.indices.free_count();
+    result.used_bytes += used_vertices * page.stride + used_indices * sizeof(uint32_t);
+    free_vertex_bytes += (uint64_t)page.vertices.free_count() * page.stride;
+    result.largest_free_bytes = std::max(result.largest_free_bytes,
+      (uint64_t)page.vertices.largest_free_block() * page.stride);
+  }
+  result.reserved_bytes = reserved_bytes_;
+  if (free_vertex_bytes)
+    result.fragmentation = 1.0 - (double)result.largest_free_bytes / (double)free_vertex_bytes;
+  result.in_place_updates = in_place_updates_;
+  result.reallocations = reallocations_;
+  return result;
+}
+
+GeometryArenaGL::Page* GeometryArenaGL::CreatePage(VertexBufferFormat format, uint32_t min_vertices,
+  uint32_t min_indices) {
+  uint32_t vertex_capacity = std::max(min_vertices, kVertexPageBytes / (uint32_t)StrideForFormat(format));
+  uint32_t index_capacity = std::max(min_indices, kIndexPageCount);
+
+  Page* page = new Page(format, vertex_capacity, index_capacity);
+  pages_[next_page_id_++].reset(page);
+  reserved_bytes_ += (uint64_t)vertex_capacity * page->stride + (uint64_t)index_capacity * sizeof(uint32_t);
+  return page;
+}
+
+void GeometryArenaGL::DestroyPage(uint32_t page_id) {
+  auto i = pages_.find(page_id);
+  if (i == pages_.end())
+    return;
+
+  Page& page = *i->second;
+  deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Buffer, page.vbo);
+  deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Buffer, page.ibo);
+
+  for (auto j = page.vao_map.begin(); j != page.vao_map.end(); ++j)
+    deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::VertexArray, j->second, j->first);
+
+  reserved_bytes_ -= (uint64_t)page.vertices.capacity() * page.stride +
+    (uint64_t)page.indices.capacity() * sizeof(uint32_t);
+  pages_.erase(i);
+}
+
+void GeometryArenaGL::Upload(Page& page, const GeometryAllocation& allocation,
+  const VertexBuffer& vertices, const IndexBuffer& indices) {
+  const DirectStateAccessGL& dsa = DirectStateAccess();
+  if (dsa.supported) {
+    dsa.NamedBufferSubData(page.vbo, (GLintptr)allocation.vertex_offset * page.stride,
+      vertices.size, vertices.data);
+    dsa.NamedBufferSubData(page.ibo, (GLintptr)allocation.index_offset * sizeof(uint32_t),
+      indices.size, indices.data);
+    return;
+  }
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, page.vbo);
+  glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)allocation.vertex_offset * page.stride,
+    vertices.size, vertices.data);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.ibo);
+  glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)allocation.index_offset * sizeof(uint32_t),
+    indices.size, indices.data);
+}
+
+}  // namespace ultralight
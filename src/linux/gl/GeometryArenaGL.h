@@ -0,0 +1,100 @@
+#pragma once
+#include <Ultralight/platform/GPUDriver.h>
+#include <glad/glad.h>
+#include "DeletionQueueGL.h"
+#include "RangeAllocator.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+
+typedef struct GLFWwindow GLFWwindow;
+
+namespace ultralight {
+
+// A geometry's reservation inside a GeometryArenaGL page. Offsets and counts
+// are in elements (vertices / 32-bit indices), not bytes.
+struct GeometryAllocation {
+  uint32_t page_id = 0;
+  uint32_t vertex_offset = 0;
+  uint32_t vertex_count = 0;
+  uint32_t index_offset = 0;
+  uint32_t index_count = 0;
+};
+
+//
+// Sub-allocates geometry out of a few large vertex/index buffer pages instead of
+// creating two buffer objects per geometry.
+//
+// Each page holds geometry of a single vertex format, so all geometry in a page
+// shares one VAO per GL context. Draws select their range with the allocation's
+// index offset and glDrawElementsBaseVertex(). Updates that fit inside the
+// existing reservation are uploaded in place with glBufferSubData().
+//
+class GeometryArenaGL {
+public:
+  struct Stats {
+    uint32_t page_count = 0;
+    uint32_t allocation_count = 0;
+    uint64_t reserved_bytes = 0;     // Size of all page buffers
+    uint64_t used_bytes = 0;         // Bytes covered by live allocations
+    uint64_t largest_free_bytes = 0; // Largest contiguous free vertex range
+    double fragmentation = 0.0;      // 1 - largest free block / total free (vertex pages)
+    uint64_t in_place_updates = 0;
+    uint64_t reallocations = 0;
+  };
+
+  // Buffers and VAOs of destroyed pages are retired through 'deletion_queue'.
+  explicit GeometryArenaGL(DeletionQueueGL& deletion_queue);
+  ~GeometryArenaGL();
+
+  // Bytes per vertex for a vertex format, 0 if the format is unknown.
+  static GLsizei StrideForFormat(VertexBufferFormat format);
+
+  GeometryAllocation Allocate(const VertexBuffer& vertices, const IndexBuffer& indices);
+
+  // Uploads in place when the new data fits the current reservation, otherwise
+  // the geometry is moved to a new range (possibly in another page).
+  void Update(GeometryAllocation& allocation, const VertexBuffer& vertices,
+    const IndexBuffer& indices);
+
+  void Free(const GeometryAllocation& allocation);
+
+  // VAOs are not shared across GL contexts so we create them lazily for each
+  // page and context.
+  GLuint GetVAOForActiveContext(const GeometryAllocation& allocation);
+
+  // Forgets the VAOs of 'context', which is about to be destroyed.
+  void ForgetContext(GLFWwindow* context);
+
+  uint64_t reserved_bytes() const { return reserved_bytes_; }
+
+  Stats stats() const;
+
+protected:
+  struct Page {
+    Page(VertexBufferFormat format, uint32_t vertex_capacity, uint32_t index_capacity);
+
+    VertexBufferFormat format;
+    GLsizei stride;
+    GLuint vbo = 0;
+    GLuint ibo = 0;
+    RangeAllocator vertices;
+    RangeAllocator indices;
+    uint32_t allocation_count = 0;
+    std::map<GLFWwindow*, GLuint> vao_map;
+  };
+
+  Page* CreatePage(VertexBufferFormat format, uint32_t min_vertices, uint32_t min_indices);
+  void DestroyPage(uint32_t page_id);
+  void Upload(Page& page, const GeometryAllocation& allocation,
+    const VertexBuffer& vertices, const IndexBuffer& indices);
+
+  DeletionQueueGL& deletion_queue_;
+  std::map<uint32_t, std::unique_ptr<Page>> pages_;
+  uint32_t next_page_id_ = 1;
+  uint64_t reserved_bytes_ = 0;
+  uint64_t in_place_updates_ = 0;
+  uint64_t reallocations_ = 0;
+};
+
+}  // namespace ultralight
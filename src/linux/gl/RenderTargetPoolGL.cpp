@@ -0,0 +1,124 @@
+#include "RenderTargetPoolGL.h"
+#include <utility>
+
+namespace ultralight {
+
+// Pooled targets that haven't been reused for this many frames are destroyed.
+static const uint64_t kMaxIdleFrames = 120;
+
+// Upper bound on memory held by targets sitting in the pool.
+static const uint64_t kMaxPooledBytes = 64 * 1024 * 1024;
+
+RenderTargetPoolGL::~RenderTargetPoolGL() {
+  // Windows may already be gone at this point, only release textures (FBOs are
+  // released along with their context).
+  for (auto& i : pool_) {
+    RenderTarget& target = i.second;
+    glDeleteTextures(1, &target.tex_id);
+    if (target.msaa_tex_id)
+      glDeleteTextures(1, &target.msaa_tex_id);
+  }
+}
+
+bool RenderTargetPoolGL::Acquire(uint32_t width, uint32_t height, bool msaa, RenderTarget& result) {
+  // Fall back to the other MSAA variant, a spare multisampled texture is
+  // harmless and a missing one is allocated on demand by the driver.
+  auto range = pool_.equal_range(Key(width, height, msaa));
+  if (range.first == range.second)
+    range = pool_.equal_range(Key(width, height, !msaa));
+
+  if (range.first == range.second) {
+    stats_.misses++;
+    return false;
+  }
+
+  // Hand out the most recently released match, it's the most likely to still
+  // be resident.
+  auto best = range.first;
+  for (auto i = range.first; i != range.second; ++i) {
+    if (i->second.released_frame > best->second.released_frame)
+      best = i;
+  }
+
+  result = std::move(best->second);
+  pool_.erase(best);
+
+  stats_.hits++;
+  stats_.pooled_count--;
+  stats_.pooled_bytes -= result.bytes + result.msaa_bytes;
+  stats_.pooled_msaa_bytes -= result.msaa_bytes;
+  return true;
+}
+
+void RenderTargetPoolGL::Release(RenderTarget&& target) {
+  target.released_frame = frame_;
+
+  stats_.pooled_count++;
+  stats_.pooled_bytes += target.bytes + target.msaa_bytes;
+  stats_.pooled_msaa_bytes += target.msaa_bytes;
+
+  Key key(target.width, target.height, target.msaa_tex_id != 0);
+  pool_.emplace(key, std::move(target));
+
+  while (stats_.pooled_bytes > kMaxPooledBytes && !pool_.empty())
+    EvictOldest();
+}
+
+void RenderTargetPoolGL::NextFrame() {
+  frame_++;
+
+  if (frame_ <= kMaxIdleFrames)
+    return;
+
+  for (auto i = pool_.begin(); i != pool_.end();) {
+    if (i->second.released_frame < frame_ - kMaxIdleFrames)
+      i = Evict(i);
+    else
+      ++i;
+  }
+}
+
+void RenderTargetPoolGL::Purge() {
+  for (auto i = pool_.begin(); i != pool_.end();)
+    i = Evict(i);
+}
+
+void RenderTargetPoolGL::ForgetContext(GLFWwindow* context) {
+  for (auto& i : pool_)
+    i.second.fbo_map.erase(context);
+}
+
+RenderTargetPoolGL::Pool::iterator RenderTargetPoolGL::Evict(Pool::iterator i) {
+  RenderTarget& target = i->second;
+
+  stats_.evictions++;
+  stats_.pooled_count--;
+  stats_.pooled_bytes -= target.bytes + target.msaa_bytes;
+  stats_.pooled_msaa_bytes -= target.msaa_bytes;
+
+  Destroy(target);
+  return pool_.erase(i);
+}
+
+void RenderTargetPoolGL::EvictOldest() {
+  auto oldest = pool_.begin();
+  for (auto i = pool_.begin(); i != pool_.end(); ++i) {
+    if (i->second.released_frame < oldest->second.released_frame)
+      oldest = i;
+  }
+  Evict(oldest);
+}
+
+void RenderTargetPoolGL::Destroy(RenderTarget& target) {
+  deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Texture, target.tex_id);
+  deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Texture, target.msaa_tex_id);
+
+  // FBOs are not shared across GL contexts, they're deleted in the context
+  // they were created in.
+  for (auto i = target.fbo_map.begin(); i != target.fbo_map.end(); ++i) {
+    deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Framebuffer, i->second.fbo_id, i->first);
+    deletion_queue_.Enqueue(DeletionQueueGL::ObjectType::Framebuffer, i->second.msaa_fbo_id, i->first);
+  }
+}
+
+}  // namespace ultralight
@@ -0,0 +1,90 @@
+#pragma once
+#include <glad/glad.h>
+#include "DeletionQueueGL.h"
+#include <cstdint>
+#include <map>
+#include <tuple>
+
+typedef struct GLFWwindow GLFWwindow;
+
+namespace ultralight {
+
+// Framebuffers created for a render target in a single GL context.
+struct RenderTargetFBOs {
+  GLuint fbo_id = 0;
+  GLuint msaa_fbo_id = 0;
+};
+
+//
+// Recycles render target textures (and the FBOs attached to them) across
+// create/destroy cycles so that filters, masks and compositor layers that are
+// re-created every frame don't churn driver allocations.
+//
+// Targets are matched on exact dimensions since Ultralight computes texture
+// coordinates from the size it requested. Targets that go unused for a number
+// of frames, or that exceed the pool's byte limit, are destroyed.
+//
+class RenderTargetPoolGL {
+public:
+  struct RenderTarget {
+    GLuint tex_id = 0;
+    GLuint msaa_tex_id = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint64_t bytes = 0;
+    uint64_t msaa_bytes = 0;
+    std::map<GLFWwindow*, RenderTargetFBOs> fbo_map;
+    uint64_t released_frame = 0;
+  };
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint32_t pooled_count = 0;
+    uint64_t pooled_bytes = 0; // Includes pooled_msaa_bytes
+    uint64_t pooled_msaa_bytes = 0;
+
+    double hit_rate() const { return hits + misses ? (double)hits / (double)(hits + misses) : 0.0; }
+  };
+
+  // Evicted targets are retired through 'deletion_queue'.
+  explicit RenderTargetPoolGL(DeletionQueueGL& deletion_queue) : deletion_queue_(deletion_queue) {}
+  ~RenderTargetPoolGL();
+
+  // Returns true and fills 'result' if a target with matching dimensions was
+  // pooled, preferring one whose MSAA state matches.
+  bool Acquire(uint32_t width, uint32_t height, bool msaa, RenderTarget& result);
+
+  void Release(RenderTarget&& target);
+
+  // Advances the pool's frame counter and evicts targets that have been idle
+  // for too long. Called once per DrawCommandList().
+  void NextFrame();
+
+  // Destroys every pooled target.
+  void Purge();
+
+  // Forgets the FBOs of 'context', which is about to be destroyed.
+  void ForgetContext(GLFWwindow* context);
+
+  const Stats& stats() const { return stats_; }
+
+protected:
+  RenderTargetPoolGL(const RenderTargetPoolGL&) = delete;
+  RenderTargetPoolGL& operator=(const RenderTargetPoolGL&) = delete;
+
+  typedef std::tuple<uint32_t, uint32_t, bool> Key; // width, height, msaa
+  typedef std::multimap<Key, RenderTarget> Pool;
+
+  Pool::iterator Evict(Pool::iterator i);
+  void EvictOldest();
+  void Destroy(RenderTarget& target);
+
+  DeletionQueueGL& deletion_queue_;
+  Pool pool_;
+  uint64_t frame_ = 0;
+  Stats stats_;
+};
+
+}  // namespace ultralight
@@ -0,0 +1,266 @@
+#include "TextureUploaderGL.h"
+#include "DirectStateAccessGL.h"
+#include "TraceRecorder.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+
+// GL 3.3+ texture swizzle constants (GLAD was generated for GL 3.2)
+#ifndef GL_TEXTURE_SWIZZLE_R
+#define GL_TEXTURE_SWIZZLE_R 0x8E42
+#define GL_TEXTURE_SWIZZLE_G 0x8E43
+#define GL_TEXTURE_SWIZZLE_B 0x8E44
+#define GL_TEXTURE_SWIZZLE_A 0x8E45
+#endif
+
+namespace ultralight {
+
+static GLsizei MipLevelCount(uint32_t width, uint32_t height) {
+  GLsizei levels = 1;
+  for (uint32_t size = std::max(width, height); size > 1; size /= 2)
+    levels++;
+  return levels;
+}
+
+static bool PixelFormatForBitmap(Bitmap* bitmap, GLenum& internal_format, GLenum& format) {
+  switch (bitmap->format()) {
+  case BitmapFormat::A8_UNORM:
+    internal_format = GL_R8;
+    format = GL_RED;
+    return true;
+  case BitmapFormat::BGRA8_UNORM_SRGB:
+    internal_format = GL_RGBA8;
+    format = GL_BGRA;
+    return true;
+  default:
+    return false;
+  }
+}
+
+GLuint CreateTextureFromBitmapGL(Bitmap* bitmap) {
+  GLenum internal_format, format;
+  if (!PixelFormatForBitmap(bitmap, internal_format, format))
+    return 0;
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, bitmap->row_bytes() / bitmap->bpp());
+
+  GLuint tex_id = 0;
+  const DirectStateAccessGL& dsa = DirectStateAccess();
+  const void* pixels = bitmap->LockPixels();
+
+  if (dsa.supported) {
+    dsa.CreateTextures(GL_TEXTURE_2D, 1, &tex_id);
+    dsa.TextureStorage2D(tex_id, MipLevelCount(bitmap->width(), bitmap->height()), internal_format,
+      bitmap->width(), bitmap->height());
+    dsa.TextureSubImage2D(tex_id, 0, 0, 0, bitmap->width(), bitmap->height(), format,
+      GL_UNSIGNED_BYTE, pixels);
+  } else {
+    glGenTextures(1, &tex_id);
+    glActiveTexture(GL_TEXTURE0 + 0);
+    glBindTexture(GL_TEXTURE_2D, tex_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, bitmap->width(), bitmap->height(), 0,
+      format, GL_UNSIGNED_BYTE, pixels);
+  }
+
+  bitmap->UnlockPixels();
+
+  if (bitmap->format() == BitmapFormat::A8_UNORM) {
+    // GL_R8 stores data in .r, but HLSL A8_UNORM reads .a — set up swizzle to match
+    const GLenum swizzle[4][2] = {
+      { GL_TEXTURE_SWIZZLE_R, GL_ZERO }, { GL_TEXTURE_SWIZZLE_G, GL_ZERO },
+      { GL_TEXTURE_SWIZZLE_B, GL_ZERO }, { GL_TEXTURE_SWIZZLE_A, GL_RED } };
+    for (auto& param : swizzle) {
+      if (dsa.supported)
+        dsa.TextureParameteri(tex_id, param[0], param[1]);
+      else
+        glTexParameteri(GL_TEXTURE_2D, param[0], param[1]);
+    }
+  }
+
+  if (dsa.supported)
+    dsa.GenerateTextureMipmap(tex_id);
+  else
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+  return tex_id;
+}
+
+void UpdateTextureFromBitmapGL(GLuint tex_id, Bitmap* bitmap) {
+  GLenum internal_format, format;
+  if (!PixelFormatForBitmap(bitmap, internal_format, format))
+    return;
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, bitmap->row_bytes() / bitmap->bpp());
+
+  const DirectStateAccessGL& dsa = DirectStateAccess();
+  const void* pixels = bitmap->LockPixels();
+
+  if (dsa.supported) {
+    dsa.TextureSubImage2D(tex_id, 0, 0, 0, bitmap->width(), bitmap->height(), format,
+      GL_UNSIGNED_BYTE, pixels);
+    dsa.GenerateTextureMipmap(tex_id);
+  } else {
+    glActiveTexture(GL_TEXTURE0 + 0);
+    glBindTexture(GL_TEXTURE_2D, tex_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, bitmap->width(), bitmap->height(), 0,
+      format, GL_UNSIGNED_BYTE, pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+  }
+
+  bitmap->UnlockPixels();
+}
+
+TextureUploaderGL::TextureUploaderGL(GLFWwindow* upload_context) : upload_context_(upload_context) {
+  thread_ = std::thread(&TextureUploaderGL::Run, this);
+}
+
+TextureUploaderGL::~TextureUploaderGL() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_ = true;
+  }
+  work_available_.notify_one();
+  thread_.join();
+
+  // Only shared objects are left, delete them from the main context.
+  for (auto& upload : finished_) {
+    glDeleteSync(upload.fence);
+    glDeleteTextures(1, &upload.tex_id);
+  }
+}
+
+void TextureUploaderGL::Enqueue(uint32_t texture_id, RefPtr<Bitmap> bitmap) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Upload upload;
+    upload.texture_id = texture_id;
+    upload.bitmap = bitmap;
+    queued_.push_back(std::move(upload));
+    pending_.insert(texture_id);
+    stats_.queued++;
+  }
+  work_available_.notify_one();
+}
+
+std::vector<TextureUploaderGL::Upload> TextureUploaderGL::Collect() {
+  std::vector<Upload> result;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (auto i = finished_.begin(); i != finished_.end();) {
+    GLenum status = glClientWaitSync(i->fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+      ++i;
+      continue;
+    }
+
+    glDeleteSync(i->fence);
+    i->fence = 0;
+    i->cancelled = cancelled_.erase(i->texture_id) != 0;
+    pending_.erase(i->texture_id);
+    result.push_back(std::move(*i));
+    i = finished_.erase(i);
+  }
+
+  return result;
+}
+
+TextureUploaderGL::Upload TextureUploaderGL::Finish(uint32_t texture_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  Upload result;
+
+  auto queued = std::find_if(queued_.begin(), queued_.end(),
+    [=](const Upload& upload) { return upload.texture_id == texture_id; });
+  if (queued != queued_.end()) {
+    result = std::move(*queued);
+    queued_.erase(queued);
+    pending_.erase(texture_id);
+    return result;
+  }
+
+  work_finished_.wait(lock, [this, texture_id] { return in_progress_ != texture_id; });
+
+  auto finished = std::find_if(finished_.begin(), finished_.end(),
+    [=](const Upload& upload) { return upload.texture_id == texture_id; });
+  if (finished == finished_.end())
+    return result;
+
+  // The upload was flushed by the worker, wait for the GPU to complete it.
+  glClientWaitSync(finished->fence, 0, GL_TIMEOUT_IGNORED);
+  glDeleteSync(finished->fence);
+  finished->fence = 0;
+
+  result = std::move(*finished);
+  finished_.erase(finished);
+  pending_.erase(texture_id);
+  return result;
+}
+
+void TextureUploaderGL::Cancel(uint32_t texture_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto queued = std::find_if(queued_.begin(), queued_.end(),
+    [=](const Upload& upload) { return upload.texture_id == texture_id; });
+  if (queued != queued_.end()) {
+    queued_.erase(queued);
+    pending_.erase(texture_id);
+    stats_.cancelled++;
+    return;
+  }
+
+  if (pending_.count(texture_id)) {
+    cancelled_.insert(texture_id);
+    stats_.cancelled++;
+  }
+}
+
+bool TextureUploaderGL::is_pending(uint32_t texture_id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.count(texture_id) != 0;
+}
+
+TextureUploaderGL::Stats TextureUploaderGL::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats result = stats_;
+  result.pending = (uint32_t)pending_.size();
+  return result;
+}
+
+void TextureUploaderGL::Run() {
+  TraceRecorder::SetThreadName("Texture Uploader");
+  glfwMakeContextCurrent(upload_context_);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_available_.wait(lock, [this] { return quit_ || !queued_.empty(); });
+    if (quit_)
+      break;
+
+    Upload upload = std::move(queued_.front());
+    queued_.pop_front();
+    in_progress_ = upload.texture_id;
+    lock.unlock();
+
+    {
+      TraceZone("TextureUploaderGL::Upload");
+      upload.tex_id = CreateTextureFromBitmapGL(upload.bitmap.get());
+      glBindTexture(GL_TEXTURE_2D, 0);
+      upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      // Fences only signal once their commands reach the GPU, and nothing else
+      // will flush this context.
+      glFlush();
+    }
+
+    lock.lock();
+    stats_.completed++;
+    stats_.bytes_uploaded += upload.bitmap->size();
+    finished_.push_back(std::move(upload));
+    in_progress_ = 0;
+    work_finished_.notify_all();
+  }
+
+  lock.unlock();
+  glfwMakeContextCurrent(nullptr);
+}
+
+}  // namespace ultralight
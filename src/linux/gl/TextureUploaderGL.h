@@ -0,0 +1,96 @@
+#pragma once
+#include <Ultralight/Bitmap.h>
+#include <glad/glad.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+typedef struct GLFWwindow GLFWwindow;
+
+namespace ultralight {
+
+// Creates a texture from a bitmap and generates its mip chain. Uses immutable
+// storage when direct state access is available (re-specify by creating a new
+// texture), otherwise the texture is left bound to unit 0. Returns 0 if the
+// bitmap format isn't supported.
+GLuint CreateTextureFromBitmapGL(Bitmap* bitmap);
+
+// Uploads new contents into a texture created by CreateTextureFromBitmapGL()
+// with the same dimensions and format.
+void UpdateTextureFromBitmapGL(GLuint tex_id, Bitmap* bitmap);
+
+//
+// Uploads large textures on a worker thread using a GL context that shares
+// objects with the main context.
+//
+// Each finished upload is followed by a fence. The driver keeps drawing with a
+// placeholder until Collect() sees the fence signal, so big image decodes
+// don't stall the UI thread in glTexImage2D / glGenerateMipmap.
+//
+class TextureUploaderGL {
+public:
+  struct Upload {
+    uint32_t texture_id = 0; // Ultralight texture ID
+    RefPtr<Bitmap> bitmap;   // Released on the main thread once collected
+    GLuint tex_id = 0;
+    GLsync fence = 0;
+    bool cancelled = false;  // Texture was destroyed while uploading, tex_id should be deleted
+  };
+
+  struct Stats {
+    uint64_t queued = 0;
+    uint64_t completed = 0;
+    uint64_t cancelled = 0;
+    uint64_t bytes_uploaded = 0;
+    uint32_t pending = 0;
+  };
+
+  // 'upload_context' must share objects with the main context and must not be
+  // current on any other thread.
+  explicit TextureUploaderGL(GLFWwindow* upload_context);
+  ~TextureUploaderGL();
+
+  void Enqueue(uint32_t texture_id, RefPtr<Bitmap> bitmap);
+
+  // Returns uploads whose fence has signaled, never blocks.
+  std::vector<Upload> Collect();
+
+  // Blocks until the upload for 'texture_id' finishes and returns it. If the
+  // upload hadn't started yet it is removed from the queue and returned with
+  // a zero tex_id so the caller can upload the bitmap itself.
+  Upload Finish(uint32_t texture_id);
+
+  // The texture was destroyed, its upload will be returned from Collect()
+  // flagged as cancelled (or dropped if it hadn't started).
+  void Cancel(uint32_t texture_id);
+
+  bool is_pending(uint32_t texture_id) const;
+
+  Stats stats() const;
+
+protected:
+  TextureUploaderGL(const TextureUploaderGL&) = delete;
+  TextureUploaderGL& operator=(const TextureUploaderGL&) = delete;
+
+  void Run();
+
+  GLFWwindow* upload_context_;
+  std::thread thread_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable work_finished_;
+  std::deque<Upload> queued_;
+  std::vector<Upload> finished_;
+  std::set<uint32_t> pending_;   // Queued, in progress or finished but not collected
+  std::set<uint32_t> cancelled_;
+  uint32_t in_progress_ = 0;     // Texture ID being uploaded by the worker, 0 if idle
+  bool quit_ = false;
+  Stats stats_;
+};
+
+}  // namespace ultralight
@@ -0,0 +1,107 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#include "BufferRingVulkan.h"
+#include "GPUContextVulkan.h"
+#include <algorithm>
+
+namespace ultralight {
+
+static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+BufferRingVulkan::BufferRingVulkan(GPUContextVulkan& context, VkBufferUsageFlags usage,
+  VkDeviceSize chunk_size) : context_(context), usage_(usage), chunk_size_(chunk_size) {}
+
+BufferRingVulkan::~BufferRingVulkan() {
+  for (auto& chunk : chunks_)
+    DestroyChunk(chunk);
+}
+
+BufferRingVulkan::Allocation BufferRingVulkan::Allocate(VkDeviceSize size, VkDeviceSize alignment) {
+  Allocation result;
+
+  while (chunk_index_ < chunks_.size()) {
+    Chunk& chunk = chunks_[chunk_index_];
+    VkDeviceSize offset = AlignUp(offset_, alignment);
+    if (offset + size <= chunk.size) {
+      result.buffer = chunk.buffer;
+      result.offset = offset;
+      result.data = chunk.data + offset;
+      offset_ = offset + size;
+      return result;
+    }
+
+    chunk_index_++;
+    offset_ = 0;
+  }
+
+  Chunk chunk;
+  if (!CreateChunk(std::max(size, chunk_size_), chunk))
+    return result;
+
+  chunks_.push_back(chunk);
+  chunk_index_ = chunks_.size() - 1;
+  result.buffer = chunk.buffer;
+  result.offset = 0;
+  result.data = chunk.data;
+  offset_ = size;
+  return result;
+}
+
+void BufferRingVulkan::Reset() {
+  // Keep the regular chunks, oversized ones were for a one-off upload.
+  auto oversized = std::remove_if(chunks_.begin(), chunks_.end(), [this](Chunk& chunk) {
+    if (chunk.size <= chunk_size_)
+      return false;
+    DestroyChunk(chunk);
+    return true;
+  });
+  chunks_.erase(oversized, chunks_.end());
+
+  chunk_index_ = 0;
+  offset_ = 0;
+}
+
+bool BufferRingVulkan::CreateChunk(VkDeviceSize size, Chunk& chunk) {
+  VkBufferCreateInfo buffer_info = {};
+  buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  buffer_info.size = size;
+  buffer_info.usage = usage_;
+  buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  if (vkCreateBuffer(context_.device(), &buffer_info, nullptr, &chunk.buffer) != VK_SUCCESS)
+    return false;
+
+  VkMemoryRequirements requirements;
+  vkGetBufferMemoryRequirements(context_.device(), chunk.buffer, &requirements);
+  chunk.memory = context_.AllocateMemory(requirements,
+    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  if (!chunk.memory) {
+    DestroyChunk(chunk);
+    return false;
+  }
+
+  void* data = nullptr;
+  if (vkBindBufferMemory(context_.device(), chunk.buffer, chunk.memory, 0) != VK_SUCCESS ||
+      vkMapMemory(context_.device(), chunk.memory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS) {
+    DestroyChunk(chunk);
+    return false;
+  }
+
+  chunk.data = (uint8_t*)data;
+  chunk.size = size;
+  reserved_bytes_ += size;
+  return true;
+}
+
+void BufferRingVulkan::DestroyChunk(Chunk& chunk) {
+  if (chunk.buffer)
+    vkDestroyBuffer(context_.device(), chunk.buffer, nullptr);
+  if (chunk.memory)
+    vkFreeMemory(context_.device(), chunk.memory, nullptr);
+  reserved_bytes_ -= chunk.size;
+  chunk = Chunk();
+}
+
+}  // namespace ultralight
+
+#endif
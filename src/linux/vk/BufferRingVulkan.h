@@ -0,0 +1,61 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#pragma once
+#include "FunctionsVulkan.h"
+#include <cstdint>
+#include <vector>
+
+namespace ultralight {
+
+class GPUContextVulkan;
+
+//
+// Linear allocator over persistently-mapped, host-coherent buffers. Each
+// in-flight frame owns one ring for uniforms and one for upload staging, the
+// ring is rewound once the GPU has finished the frame (see Reset()).
+//
+// Chunks are only added when a frame outgrows the ones it has, so after the
+// first few frames allocation is a pointer bump.
+//
+class BufferRingVulkan {
+public:
+  struct Allocation {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    uint8_t* data = nullptr; // Mapped pointer to 'offset'
+  };
+
+  BufferRingVulkan(GPUContextVulkan& context, VkBufferUsageFlags usage, VkDeviceSize chunk_size);
+  ~BufferRingVulkan();
+
+  // Returns an allocation with a null buffer if memory is exhausted.
+  Allocation Allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+  // Rewinds to the first chunk. Chunks that were created for oversized
+  // allocations are destroyed, the GPU must be done with all of them.
+  void Reset();
+
+  VkDeviceSize reserved_bytes() const { return reserved_bytes_; }
+
+protected:
+  struct Chunk {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    uint8_t* data = nullptr;
+    VkDeviceSize size = 0;
+  };
+
+  bool CreateChunk(VkDeviceSize size, Chunk& chunk);
+  void DestroyChunk(Chunk& chunk);
+
+  GPUContextVulkan& context_;
+  VkBufferUsageFlags usage_;
+  VkDeviceSize chunk_size_;
+  std::vector<Chunk> chunks_;
+  size_t chunk_index_ = 0;
+  VkDeviceSize offset_ = 0;
+  VkDeviceSize reserved_bytes_ = 0;
+};
+
+}  // namespace ultralight
+
+#endif
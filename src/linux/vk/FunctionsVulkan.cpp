@@ -0,0 +1,73 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#include "FunctionsVulkan.h"
+#include <GLFW/glfw3.h>
+
+namespace ultralight {
+
+#define UL_VK_DEFINE_FUNCTION(name) PFN_##name name = nullptr;
+UL_VK_GLOBAL_FUNCTIONS(UL_VK_DEFINE_FUNCTION)
+UL_VK_INSTANCE_FUNCTIONS(UL_VK_DEFINE_FUNCTION)
+UL_VK_DEVICE_FUNCTIONS(UL_VK_DEFINE_FUNCTION)
+#undef UL_VK_DEFINE_FUNCTION
+
+bool LoadGlobalFunctionsVulkan() {
+  bool loaded = true;
+#define UL_VK_LOAD_FUNCTION(name) \
+  name = (PFN_##name)glfwGetInstanceProcAddress(VK_NULL_HANDLE, #name); \
+  loaded &= name != nullptr;
+  UL_VK_GLOBAL_FUNCTIONS(UL_VK_LOAD_FUNCTION)
+#undef UL_VK_LOAD_FUNCTION
+  return loaded;
+}
+
+bool LoadInstanceFunctionsVulkan(VkInstance instance) {
+  bool loaded = true;
+#define UL_VK_LOAD_FUNCTION(name) \
+  name = (PFN_##name)glfwGetInstanceProcAddress(instance, #name); \
+  loaded &= name != nullptr;
+  UL_VK_INSTANCE_FUNCTIONS(UL_VK_LOAD_FUNCTION)
+#undef UL_VK_LOAD_FUNCTION
+  return loaded;
+}
+
+bool LoadDeviceFunctionsVulkan(VkDevice device) {
+  // Device-level pointers skip the loader's dispatch trampoline.
+  bool loaded = true;
+#define UL_VK_LOAD_FUNCTION(name) \
+  name = (PFN_##name)vkGetDeviceProcAddr(device, #name); \
+  loaded &= name != nullptr;
+  UL_VK_DEVICE_FUNCTIONS(UL_VK_LOAD_FUNCTION)
+#undef UL_VK_LOAD_FUNCTION
+  return loaded;
+}
+
+const char* VkResultString(VkResult result) {
+  switch (result) {
+  case VK_SUCCESS:                        return "VK_SUCCESS";
+  case VK_NOT_READY:                      return "VK_NOT_READY";
+  case VK_TIMEOUT:                        return "VK_TIMEOUT";
+  case VK_INCOMPLETE:                     return "VK_INCOMPLETE";
+  case VK_SUBOPTIMAL_KHR:                 return "VK_SUBOPTIMAL_KHR";
+  case VK_ERROR_OUT_OF_HOST_MEMORY:       return "VK_ERROR_OUT_OF_HOST_MEMORY";
+  case VK_ERROR_OUT_OF_DEVICE_MEMORY:     return "VK_ERROR_OUT_OF_DEVICE_MEMORY";
+  case VK_ERROR_INITIALIZATION_FAILED:    return "VK_ERROR_INITIALIZATION_FAILED";
+  case VK_ERROR_DEVICE_LOST:              return "VK_ERROR_DEVICE_LOST";
+  case VK_ERROR_MEMORY_MAP_FAILED:        return "VK_ERROR_MEMORY_MAP_FAILED";
+  case VK_ERROR_LAYER_NOT_PRESENT:        return "VK_ERROR_LAYER_NOT_PRESENT";
+  case VK_ERROR_EXTENSION_NOT_PRESENT:    return "VK_ERROR_EXTENSION_NOT_PRESENT";
+  case VK_ERROR_FEATURE_NOT_PRESENT:      return "VK_ERROR_FEATURE_NOT_PRESENT";
+  case VK_ERROR_INCOMPATIBLE_DRIVER:      return "VK_ERROR_INCOMPATIBLE_DRIVER";
+  case VK_ERROR_TOO_MANY_OBJECTS:         return "VK_ERROR_TOO_MANY_OBJECTS";
+  case VK_ERROR_FORMAT_NOT_SUPPORTED:     return "VK_ERROR_FORMAT_NOT_SUPPORTED";
+  case VK_ERROR_FRAGMENTED_POOL:          return "VK_ERROR_FRAGMENTED_POOL";
+  case VK_ERROR_OUT_OF_POOL_MEMORY:       return "VK_ERROR_OUT_OF_POOL_MEMORY";
+  case VK_ERROR_SURFACE_LOST_KHR:         return "VK_ERROR_SURFACE_LOST_KHR";
+  case VK_ERROR_NATIVE_WINDOW_IN_USE_KHR: return "VK_ERROR_NATIVE_WINDOW_IN_USE_KHR";
+  case VK_ERROR_OUT_OF_DATE_KHR:          return "VK_ERROR_OUT_OF_DATE_KHR";
+  default:                                return "VK_ERROR_UNKNOWN";
+  }
+}
+
+}  // namespace ultralight
+
+#endif
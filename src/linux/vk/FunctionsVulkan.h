@@ -0,0 +1,118 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#pragma once
+
+// The Vulkan loader is opened by GLFW at runtime, we never link against it.
+// Every entry point is fetched through glfwGetInstanceProcAddress() and
+// vkGetDeviceProcAddr() into the globals declared below.
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+
+#define UL_VK_GLOBAL_FUNCTIONS(X) \
+  X(vkCreateInstance) \
+  X(vkEnumerateInstanceExtensionProperties)
+
+#define UL_VK_INSTANCE_FUNCTIONS(X) \
+  X(vkDestroyInstance) \
+  X(vkEnumeratePhysicalDevices) \
+  X(vkGetPhysicalDeviceProperties) \
+  X(vkGetPhysicalDeviceQueueFamilyProperties) \
+  X(vkGetPhysicalDeviceMemoryProperties) \
+  X(vkEnumerateDeviceExtensionProperties) \
+  X(vkCreateDevice) \
+  X(vkGetDeviceProcAddr) \
+  X(vkDestroySurfaceKHR) \
+  X(vkGetPhysicalDeviceSurfaceSupportKHR) \
+  X(vkGetPhysicalDeviceSurfaceCapabilitiesKHR) \
+  X(vkGetPhysicalDeviceSurfaceFormatsKHR) \
+  X(vkGetPhysicalDeviceSurfacePresentModesKHR)
+
+#define UL_VK_DEVICE_FUNCTIONS(X) \
+  X(vkDestroyDevice) \
+  X(vkGetDeviceQueue) \
+  X(vkDeviceWaitIdle) \
+  X(vkQueueSubmit) \
+  X(vkQueuePresentKHR) \
+  X(vkCreateSwapchainKHR) \
+  X(vkDestroySwapchainKHR) \
+  X(vkGetSwapchainImagesKHR) \
+  X(vkAcquireNextImageKHR) \
+  X(vkCreateCommandPool) \
+  X(vkDestroyCommandPool) \
+  X(vkResetCommandPool) \
+  X(vkAllocateCommandBuffers) \
+  X(vkBeginCommandBuffer) \
+  X(vkEndCommandBuffer) \
+  X(vkCreateFence) \
+  X(vkDestroyFence) \
+  X(vkWaitForFences) \
+  X(vkResetFences) \
+  X(vkCreateSemaphore) \
+  X(vkDestroySemaphore) \
+  X(vkAllocateMemory) \
+  X(vkFreeMemory) \
+  X(vkMapMemory) \
+  X(vkUnmapMemory) \
+  X(vkCreateBuffer) \
+  X(vkDestroyBuffer) \
+  X(vkGetBufferMemoryRequirements) \
+  X(vkBindBufferMemory) \
+  X(vkCreateImage) \
+  X(vkDestroyImage) \
+  X(vkGetImageMemoryRequirements) \
+  X(vkBindImageMemory) \
+  X(vkCreateImageView) \
+  X(vkDestroyImageView) \
+  X(vkCreateSampler) \
+  X(vkDestroySampler) \
+  X(vkCreateRenderPass) \
+  X(vkDestroyRenderPass) \
+  X(vkCreateFramebuffer) \
+  X(vkDestroyFramebuffer) \
+  X(vkCreateShaderModule) \
+  X(vkDestroyShaderModule) \
+  X(vkCreatePipelineCache) \
+  X(vkDestroyPipelineCache) \
+  X(vkCreateGraphicsPipelines) \
+  X(vkDestroyPipeline) \
+  X(vkCreatePipelineLayout) \
+  X(vkDestroyPipelineLayout) \
+  X(vkCreateDescriptorSetLayout) \
+  X(vkDestroyDescriptorSetLayout) \
+  X(vkCreateDescriptorPool) \
+  X(vkDestroyDescriptorPool) \
+  X(vkResetDescriptorPool) \
+  X(vkAllocateDescriptorSets) \
+  X(vkUpdateDescriptorSets) \
+  X(vkCmdBeginRenderPass) \
+  X(vkCmdEndRenderPass) \
+  X(vkCmdBindPipeline) \
+  X(vkCmdBindDescriptorSets) \
+  X(vkCmdBindVertexBuffers) \
+  X(vkCmdBindIndexBuffer) \
+  X(vkCmdDrawIndexed) \
+  X(vkCmdSetViewport) \
+  X(vkCmdSetScissor) \
+  X(vkCmdClearAttachments) \
+  X(vkCmdClearColorImage) \
+  X(vkCmdPipelineBarrier) \
+  X(vkCmdCopyBufferToImage)
+
+namespace ultralight {
+
+#define UL_VK_DECLARE_FUNCTION(name) extern PFN_##name name;
+UL_VK_GLOBAL_FUNCTIONS(UL_VK_DECLARE_FUNCTION)
+UL_VK_INSTANCE_FUNCTIONS(UL_VK_DECLARE_FUNCTION)
+UL_VK_DEVICE_FUNCTIONS(UL_VK_DECLARE_FUNCTION)
+#undef UL_VK_DECLARE_FUNCTION
+
+// Each returns false if a required entry point is missing. glfwInit() must
+// have been called before LoadGlobalFunctionsVulkan().
+bool LoadGlobalFunctionsVulkan();
+bool LoadInstanceFunctionsVulkan(VkInstance instance);
+bool LoadDeviceFunctionsVulkan(VkDevice device);
+
+const char* VkResultString(VkResult result);
+
+}  // namespace ultralight
+
+#endif
@@ -0,0 +1,905 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#include "GPUContextVulkan.h"
+#include "GPUDriverVulkan.h"
+#include "SwapChainVulkan.h"
+#include "TraceRecorder.h"
+#include <GLFW/glfw3.h>
+#include <Ultralight/platform/Platform.h>
+#include <Ultralight/platform/Logger.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+// Include generated SPIR-V shader headers
+#include "spirv/shaders.h"
+
+namespace ultralight {
+
+// Uniform ring chunks hold ~300 draws, staging chunks a 1024x1024 BGRA upload.
+static const VkDeviceSize kUniformChunkBytes = 256 * 1024;
+static const VkDeviceSize kStagingChunkBytes = 4 * 1024 * 1024;
+
+// Descriptor sets are cached per frame by (uniform chunk, textures) so a pool
+// rarely needs more than a few hundred.
+static const uint32_t kDescriptorSetsPerPool = 512;
+
+static void LogVulkanError(const char* what, VkResult result) {
+  if (Logger* logger = Platform::instance().logger())
+    logger->LogMessage(LogLevel::Error, (std::string(what) + " failed: " + VkResultString(result)).c_str());
+}
+
+static VkBlendFactor MapBlendFactor(BlendFactor factor) {
+  switch (factor) {
+  case BlendFactor::Zero:             return VK_BLEND_FACTOR_ZERO;
+  case BlendFactor::One:              return VK_BLEND_FACTOR_ONE;
+  case BlendFactor::SrcColor:         return VK_BLEND_FACTOR_SRC_COLOR;
+  case BlendFactor::InvSrcColor:      return VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+  case BlendFactor::SrcAlpha:         return VK_BLEND_FACTOR_SRC_ALPHA;
+  case BlendFactor::InvSrcAlpha:      return VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+  case BlendFactor::DestColor:        return VK_BLEND_FACTOR_DST_COLOR;
+  case BlendFactor::InvDestColor:     return VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR;
+  case BlendFactor::DestAlpha:        return VK_BLEND_FACTOR_DST_ALPHA;
+  case BlendFactor::InvDestAlpha:     return VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA;
+  case BlendFactor::SrcAlphaSaturate: return VK_BLEND_FACTOR_SRC_ALPHA_SATURATE;
+  default:                            return VK_BLEND_FACTOR_ONE;
+  }
+}
+
+static VkBlendOp MapBlendEquation(BlendEquation equation) {
+  switch (equation) {
+  case BlendEquation::Add:         return VK_BLEND_OP_ADD;
+  case BlendEquation::Subtract:    return VK_BLEND_OP_SUBTRACT;
+  case BlendEquation::RevSubtract: return VK_BLEND_OP_REVERSE_SUBTRACT;
+  case BlendEquation::Min:         return VK_BLEND_OP_MIN;
+  case BlendEquation::Max:         return VK_BLEND_OP_MAX;
+  default:                         return VK_BLEND_OP_ADD;
+  }
+}
+
+uint64_t PipelineKeyVulkan::Hash() const {
+  uint64_t hash = (uint64_t)shader_type;
+  hash |= (uint64_t)blend_enabled << 4;
+  if (blend_enabled) {
+    hash |= (uint64_t)blend_src_factor << 5;
+    hash |= (uint64_t)blend_dst_factor << 9;
+    hash |= (uint64_t)blend_equation << 13;
+  }
+  hash |= (uint64_t)samples << 16;
+  hash |= (uint64_t)format << 32;
+  return hash;
+}
+
+std::unique_ptr<GPUContextVulkan> GPUContextVulkan::Create(bool enable_vsync) {
+  if (!glfwVulkanSupported())
+    return nullptr;
+
+  std::unique_ptr<GPUContextVulkan> context(new GPUContextVulkan(enable_vsync));
+  if (!context->Initialize())
+    return nullptr;
+
+  return context;
+}
+
+GPUContextVulkan::GPUContextVulkan(bool enable_vsync) : enable_vsync_(enable_vsync) {}
+
+GPUContextVulkan::~GPUContextVulkan() {
+  if (device_) {
+    vkDeviceWaitIdle(device_);
+
+    driver_.reset();
+    swap_chains_.clear();
+
+    ReleaseCompletedObjects(true);
+
+    for (auto& frame : frames_) {
+      frame.uniforms.reset();
+      frame.staging.reset();
+      for (auto pool : frame.descriptor_pools)
+        vkDestroyDescriptorPool(device_, pool, nullptr);
+      if (frame.fence)
+        vkDestroyFence(device_, frame.fence, nullptr);
+      if (frame.command_pool)
+        vkDestroyCommandPool(device_, frame.command_pool, nullptr);
+    }
+
+    for (auto& i : pipelines_)
+      vkDestroyPipeline(device_, i.second, nullptr);
+    for (auto& i : render_passes_)
+      vkDestroyRenderPass(device_, i.second, nullptr);
+    for (auto module : shader_modules_)
+      vkDestroyShaderModule(device_, module, nullptr);
+
+    if (pipeline_cache_)
+      vkDestroyPipelineCache(device_, pipeline_cache_, nullptr);
+    if (pipeline_layout_)
+      vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
+    if (descriptor_set_layout_)
+      vkDestroyDescriptorSetLayout(device_, descriptor_set_layout_, nullptr);
+    if (sampler_)
+      vkDestroySampler(device_, sampler_, nullptr);
+
+    vkDestroyDevice(device_, nullptr);
+  }
+
+  if (instance_)
+    vkDestroyInstance(instance_, nullptr);
+
+  if (window_)
+    glfwDestroyWindow(window_);
+}
+
+GPUDriverImpl* GPUContextVulkan::driver() const {
+  return driver_.get();
+}
+
+bool GPUContextVulkan::Initialize() {
+  if (!LoadGlobalFunctionsVulkan())
+    return false;
+
+  if (!CreateInstance() || !SelectPhysicalDevice() || !CreateDevice() || !CreateFrames() ||
+      !CreatePipelineObjects() || !CreateShaderModules())
+    return false;
+
+  PrebuildPipelines();
+
+  // Nothing renders to this window, it only keeps clipboard access alive.
+  glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  window_ = glfwCreateWindow(10, 10, "", NULL, NULL);
+  glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API); // In case we fall back to OpenGL
+  if (!window_)
+    return false;
+
+  active_window_ = window_;
+  driver_.reset(new GPUDriverVulkan(this));
+
+  if (Logger* logger = Platform::instance().logger()) {
+    std::string msg = std::string("Using Vulkan GPU driver on ") + device_properties_.deviceName;
+    logger->LogMessage(LogLevel::Info, msg.c_str());
+  }
+
+  return true;
+}
+
+bool GPUContextVulkan::CreateInstance() {
+  uint32_t extension_count = 0;
+  const char** extensions = glfwGetRequiredInstanceExtensions(&extension_count);
+  if (!extensions)
+    return false;
+
+  VkApplicationInfo app_info = {};
+  app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+  app_info.pApplicationName = "Ultralight";
+  app_info.pEngineName = "AppCore";
+  app_info.apiVersion = VK_API_VERSION_1_0;
+
+  VkInstanceCreateInfo create_info = {};
+  create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+  create_info.pApplicationInfo = &app_info;
+  create_info.enabledExtensionCount = extension_count;
+  create_info.ppEnabledExtensionNames = extensions;
+
+  VkResult result = vkCreateInstance(&create_info, nullptr, &instance_);
+  if (result != VK_SUCCESS) {
+    instance_ = VK_NULL_HANDLE;
+    LogVulkanError("vkCreateInstance", result);
+    return false;
+  }
+
+  return LoadInstanceFunctionsVulkan(instance_);
+}
+
+bool GPUContextVulkan::SelectPhysicalDevice() {
+  uint32_t count = 0;
+  vkEnumeratePhysicalDevices(instance_, &count, nullptr);
+  std::vector<VkPhysicalDevice> devices(count);
+  vkEnumeratePhysicalDevices(instance_, &count, devices.data());
+
+  // Prefer real GPUs, but accept CPU implementations such as Mesa's lavapipe
+  // so that the driver can be exercised on machines without one.
+  auto rank = [](VkPhysicalDeviceType type) {
+    switch (type) {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   return 4;
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 3;
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    return 2;
+    case VK_PHYSICAL_DEVICE_TYPE_CPU:            return 1;
+    default:                                     return 0;
+    }
+  };
+
+  int best_rank = -1;
+  for (auto device : devices) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+
+    uint32_t extension_count = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+    std::vector<VkExtensionProperties> extensions(extension_count);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, extensions.data());
+    bool has_swap_chain = std::any_of(extensions.begin(), extensions.end(), [](const VkExtensionProperties& e) {
+      return strcmp(e.extensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0;
+    });
+    if (!has_swap_chain)
+      continue;
+
+    uint32_t family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> families(family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count, families.data());
+
+    for (uint32_t family = 0; family < family_count; family++) {
+      if (!(families[family].queueFlags & VK_QUEUE_GRAPHICS_BIT) ||
+          !glfwGetPhysicalDevicePresentationSupport(instance_, device, family))
+        continue;
+
+      if (rank(properties.deviceType) > best_rank) {
+        best_rank = rank(properties.deviceType);
+        physical_device_ = device;
+        queue_family_ = family;
+        device_properties_ = properties;
+      }
+      break;
+    }
+  }
+
+  if (!physical_device_)
+    return false;
+
+  vkGetPhysicalDeviceMemoryProperties(physical_device_, &memory_properties_);
+
+  // Every implementation supports 4x color attachments (required limit).
+  render_target_samples_ = VK_SAMPLE_COUNT_4_BIT;
+  return true;
+}
+
+bool GPUContextVulkan::CreateDevice() {
+  float priority = 1.0f;
+  VkDeviceQueueCreateInfo queue_info = {};
+  queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+  queue_info.queueFamilyIndex = queue_family_;
+  queue_info.queueCount = 1;
+  queue_info.pQueuePriorities = &priority;
+
+  const char* extensions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+
+  VkDeviceCreateInfo create_info = {};
+  create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+  create_info.queueCreateInfoCount = 1;
+  create_info.pQueueCreateInfos = &queue_info;
+  create_info.enabledExtensionCount = 1;
+  create_info.ppEnabledExtensionNames = extensions;
+
+  VkResult result = vkCreateDevice(physical_device_, &create_info, nullptr, &device_);
+  if (result != VK_SUCCESS) {
+    device_ = VK_NULL_HANDLE;
+    LogVulkanError("vkCreateDevice", result);
+    return false;
+  }
+
+  if (!LoadDeviceFunctionsVulkan(device_))
+    return false;
+
+  vkGetDeviceQueue(device_, queue_family_, 0, &queue_);
+  return true;
+}
+
+bool GPUContextVulkan::CreateFrames() {
+  for (auto& frame : frames_) {
+    VkCommandPoolCreateInfo pool_info = {};
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    pool_info.queueFamilyIndex = queue_family_;
+    if (vkCreateCommandPool(device_, &pool_info, nullptr, &frame.command_pool) != VK_SUCCESS)
+      return false;
+
+    VkCommandBufferAllocateInfo alloc_info = {};
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.commandPool = frame.command_pool;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(device_, &alloc_info, &frame.command_buffer) != VK_SUCCESS)
+      return false;
+
+    VkFenceCreateInfo fence_info = {};
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    if (vkCreateFence(device_, &fence_info, nullptr, &frame.fence) != VK_SUCCESS)
+      return false;
+
+    frame.uniforms.reset(new BufferRingVulkan(*this, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, kUniformChunkBytes));
+    frame.staging.reset(new BufferRingVulkan(*this, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, kStagingChunkBytes));
+  }
+
+  return true;
+}
+
+bool GPUContextVulkan::CreatePipelineObjects() {
+  // Bindings match the -fvk-*-shift options in build-shaders.ps1.
+  VkDescriptorSetLayoutBinding bindings[4] = {};
+  bindings[0].binding = 0;
+  bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  bindings[0].descriptorCount = 1;
+  bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+  for (uint32_t i = 1; i <= 2; i++) {
+    bindings[i].binding = i;
+    bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    bindings[i].descriptorCount = 1;
+    bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+  }
+  bindings[3].binding = 3;
+  bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+  bindings[3].descriptorCount = 1;
+  bindings[3].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  VkDescriptorSetLayoutCreateInfo layout_info = {};
+  layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  layout_info.bindingCount = 4;
+  layout_info.pBindings = bindings;
+  if (vkCreateDescriptorSetLayout(device_, &layout_info, nullptr, &descriptor_set_layout_) != VK_SUCCESS)
+    return false;
+
+  VkPipelineLayoutCreateInfo pipeline_layout_info = {};
+  pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipeline_layout_info.setLayoutCount = 1;
+  pipeline_layout_info.pSetLayouts = &descriptor_set_layout_;
+  if (vkCreatePipelineLayout(device_, &pipeline_layout_info, nullptr, &pipeline_layout_) != VK_SUCCESS)
+    return false;
+
+  VkPipelineCacheCreateInfo cache_info = {};
+  cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  if (vkCreatePipelineCache(device_, &cache_info, nullptr, &pipeline_cache_) != VK_SUCCESS)
+    return false;
+
+  // Same sampling as the GL driver: bilinear, clamped to edge, no mips.
+  VkSamplerCreateInfo sampler_info = {};
+  sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  sampler_info.magFilter = VK_FILTER_LINEAR;
+  sampler_info.minFilter = VK_FILTER_LINEAR;
+  sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  sampler_info.maxLod = 0.0f;
+  return vkCreateSampler(device_, &sampler_info, nullptr, &sampler_) == VK_SUCCESS;
+}
+
+bool GPUContextVulkan::CreateShaderModules() {
+  auto create_module = [this](const unsigned char* data, unsigned int size) -> VkShaderModule {
+    // The generated arrays are bytes, pCode must be 4-byte aligned.
+    std::vector<uint32_t> code((size + 3) / 4);
+    memcpy(code.data(), data, size);
+
+    VkShaderModuleCreateInfo module_info = {};
+    module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    module_info.codeSize = size;
+    module_info.pCode = code.data();
+
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(device_, &module_info, nullptr, &module) != VK_SUCCESS)
+      return VK_NULL_HANDLE;
+    shader_modules_.push_back(module);
+    return module;
+  };
+
+  VkShaderModule vertex_quad = create_module(vertex_quad_vs_data, vertex_quad_vs_size);
+  VkShaderModule vertex_path = create_module(vertex_path_vs_data, vertex_path_vs_size);
+
+  shaders_[ShaderType::Fill] = { vertex_quad, create_module(fill_ps_data, fill_ps_size) };
+  shaders_[ShaderType::FillPath] = { vertex_path, create_module(fill_path_ps_data, fill_path_ps_size) };
+  shaders_[ShaderType::FilterBasic] = { vertex_quad, create_module(filter_basic_ps_data, filter_basic_ps_size) };
+  shaders_[ShaderType::FilterBlur] = { vertex_quad, create_module(filter_blur_ps_data, filter_blur_ps_size) };
+  shaders_[ShaderType::FilterDropShadow] = { vertex_quad,
+    create_module(filter_dropshadow_ps_data, filter_dropshadow_ps_size) };
+
+  for (auto& i : shaders_) {
+    if (!i.second.vertex || !i.second.fragment)
+      return false;
+  }
+
+  return true;
+}
+
+void GPUContextVulkan::PrebuildPipelines() {
+  // Offscreen targets get nearly all draws, and either no blending or
+  // premultiplied-alpha "source over".
+  for (auto& i : shaders_) {
+    PipelineKeyVulkan key;
+    key.shader_type = i.first;
+    key.format = render_target_format();
+    key.samples = render_target_samples_;
+
+    key.blend_enabled = false;
+    GetPipeline(key);
+
+    key.blend_enabled = true;
+    key.blend_src_factor = BlendFactor::One;
+    key.blend_dst_factor = BlendFactor::InvSrcAlpha;
+    key.blend_equation = BlendEquation::Add;
+    GetPipeline(key);
+  }
+}
+
+bool GPUContextVulkan::AddWindow(GLFWwindow* win) {
+  std::unique_ptr<SwapChainVulkan> swap_chain(new SwapChainVulkan(*this, win));
+  if (!swap_chain->Initialize())
+    return false;
+
+  swap_chains_[win] = std::move(swap_chain);
+  return true;
+}
+
+void GPUContextVulkan::OnWindowDestroyed(GLFWwindow* win) {
+  if (active_window_ == win)
+    active_window_ = window_;
+
+  auto i = swap_chains_.find(win);
+  if (i == swap_chains_.end())
+    return;
+
+  // Submitted frames may still render to the swap chain's images.
+  vkDeviceWaitIdle(device_);
+  swap_chains_.erase(i);
+}
+
+SwapChainVulkan* GPUContextVulkan::active_swap_chain() {
+  auto i = swap_chains_.find(active_window_);
+  return i == swap_chains_.end() ? nullptr : i->second.get();
+}
+
+void GPUContextVulkan::BeginDrawing() {
+  // Start the frame first, the acquire semaphore belongs to its slot.
+  command_buffer();
+
+  if (SwapChainVulkan* swap_chain = active_swap_chain())
+    swap_chain->AcquireNextImage();
+}
+
+void GPUContextVulkan::EndDrawing() {
+  TraceZone("GPUContextVulkan::EndDrawing");
+  driver_->FinishRendering();
+
+  SwapChainVulkan* swap_chain = active_swap_chain();
+  if (!swap_chain || !swap_chain->image_acquired()) {
+    Flush();
+    return;
+  }
+
+  SubmitFrame(swap_chain->acquire_semaphore(), swap_chain->render_finished_semaphore());
+  swap_chain->Present();
+}
+
+void GPUContextVulkan::Flush() {
+  driver_->FinishRendering();
+
+  if (recording_)
+    SubmitFrame(VK_NULL_HANDLE, VK_NULL_HANDLE);
+}
+
+VkCommandBuffer GPUContextVulkan::command_buffer() {
+  if (!recording_)
+    BeginFrame();
+
+  return frame().command_buffer;
+}
+
+void GPUContextVulkan::BeginFrame() {
+  TraceZone("GPUContextVulkan::BeginFrame");
+  Frame& frame = this->frame();
+
+  // Usually long done, we're kFrameCount submissions ahead of it.
+  vkWaitForFences(device_, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+  vkResetFences(device_, 1, &frame.fence);
+  completed_serial_ = std::max(completed_serial_, frame.serial);
+
+  ReleaseCompletedObjects(false);
+  vkResetCommandPool(device_, frame.command_pool, 0);
+  for (auto pool : frame.descriptor_pools)
+    vkResetDescriptorPool(device_, pool, 0);
+  frame.descriptor_pool_index = 0;
+  frame.uniforms->Reset();
+  frame.staging->Reset();
+
+  VkCommandBufferBeginInfo begin_info = {};
+  begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(frame.command_buffer, &begin_info);
+
+  frame.serial = frame_serial_;
+  recording_ = true;
+
+  // Null while the driver itself is being created or destroyed.
+  if (driver_)
+    driver_->OnFrameBegin();
+}
+
+void GPUContextVulkan::SubmitFrame(VkSemaphore wait_semaphore, VkSemaphore signal_semaphore) {
+  TraceZone("GPUContextVulkan::SubmitFrame");
+  Frame& frame = this->frame();
+  vkEndCommandBuffer(frame.command_buffer);
+
+  VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  VkSubmitInfo submit_info = {};
+  submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submit_info.commandBufferCount = 1;
+  submit_info.pCommandBuffers = &frame.command_buffer;
+  if (wait_semaphore) {
+    submit_info.waitSemaphoreCount = 1;
+    submit_info.pWaitSemaphores = &wait_semaphore;
+    submit_info.pWaitDstStageMask = &wait_stage;
+  }
+  if (signal_semaphore) {
+    submit_info.signalSemaphoreCount = 1;
+    submit_info.pSignalSemaphores = &signal_semaphore;
+  }
+
+  VkResult result = vkQueueSubmit(queue_, 1, &submit_info, frame.fence);
+  if (result != VK_SUCCESS)
+    LogVulkanError("vkQueueSubmit", result);
+
+  recording_ = false;
+  frame_serial_++;
+  frame_index_ = (frame_index_ + 1) % kFrameCount;
+}
+
+void GPUContextVulkan::QueueRelease(PendingRelease release) {
+  // Objects may be used by the frame being recorded, or if none is, by the
+  // last one submitted. Either way every frame that can reference them has
+  // a serial below the next one.
+  release.serial = frame_serial_;
+  pending_releases_.push_back(release);
+}
+
+void GPUContextVulkan::ReleaseCompletedObjects(bool release_all) {
+  while (!pending_releases_.empty()) {
+    PendingRelease& release = pending_releases_.front();
+    if (!release_all && release.serial > completed_serial_)
+      break;
+
+    if (release.framebuffer)
+      vkDestroyFramebuffer(device_, release.framebuffer, nullptr);
+    if (release.view)
+      vkDestroyImageView(device_, release.view, nullptr);
+    if (release.image)
+      vkDestroyImage(device_, release.image, nullptr);
+    if (release.buffer)
+      vkDestroyBuffer(device_, release.buffer, nullptr);
+    if (release.memory)
+      vkFreeMemory(device_, release.memory, nullptr);
+    pending_releases_.pop_front();
+  }
+}
+
+BufferRingVulkan::Allocation GPUContextVulkan::AllocateUniforms(VkDeviceSize size) {
+  command_buffer();
+  return frame().uniforms->Allocate(size, limits().minUniformBufferOffsetAlignment);
+}
+
+BufferRingVulkan::Allocation GPUContextVulkan::AllocateStaging(VkDeviceSize size) {
+  command_buffer();
+  VkDeviceSize alignment = std::max<VkDeviceSize>(16, limits().optimalBufferCopyOffsetAlignment);
+  return frame().staging->Allocate(size, alignment);
+}
+
+VkDescriptorSet GPUContextVulkan::AllocateDescriptorSet() {
+  command_buffer();
+  Frame& frame = this->frame();
+
+  VkDescriptorSetAllocateInfo alloc_info = {};
+  alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  alloc_info.descriptorSetCount = 1;
+  alloc_info.pSetLayouts = &descriptor_set_layout_;
+
+  while (true) {
+    if (frame.descriptor_pool_index == frame.descriptor_pools.size()) {
+      VkDescriptorPool pool = CreateDescriptorPool();
+      if (!pool)
+        return VK_NULL_HANDLE;
+      frame.descriptor_pools.push_back(pool);
+    }
+
+    alloc_info.descriptorPool = frame.descriptor_pools[frame.descriptor_pool_index];
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (vkAllocateDescriptorSets(device_, &alloc_info, &set) == VK_SUCCESS)
+      return set;
+
+    // Pool exhausted, move on to the next one.
+    frame.descriptor_pool_index++;
+  }
+}
+
+VkDescriptorPool GPUContextVulkan::CreateDescriptorPool() {
+  VkDescriptorPoolSize sizes[3] = {};
+  sizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  sizes[0].descriptorCount = kDescriptorSetsPerPool;
+  sizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  sizes[1].descriptorCount = kDescriptorSetsPerPool * 2;
+  sizes[2].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+  sizes[2].descriptorCount = kDescriptorSetsPerPool;
+
+  VkDescriptorPoolCreateInfo pool_info = {};
+  pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  pool_info.maxSets = kDescriptorSetsPerPool;
+  pool_info.poolSizeCount = 3;
+  pool_info.pPoolSizes = sizes;
+
+  VkDescriptorPool pool = VK_NULL_HANDLE;
+  if (vkCreateDescriptorPool(device_, &pool_info, nullptr, &pool) != VK_SUCCESS)
+    return VK_NULL_HANDLE;
+  return pool;
+}
+
+void GPUContextVulkan::ReleaseWhenFrameComplete(VkBuffer buffer) {
+  PendingRelease release;
+  release.buffer = buffer;
+  if (buffer)
+    QueueRelease(release);
+}
+
+void GPUContextVulkan::ReleaseWhenFrameComplete(VkImage image) {
+  PendingRelease release;
+  release.image = image;
+  if (image)
+    QueueRelease(release);
+}
+
+void GPUContextVulkan::ReleaseWhenFrameComplete(VkImageView view) {
+  PendingRelease release;
+  release.view = view;
+  if (view)
+    QueueRelease(release);
+}
+
+void GPUContextVulkan::ReleaseWhenFrameComplete(VkFramebuffer framebuffer) {
+  PendingRelease release;
+  release.framebuffer = framebuffer;
+  if (framebuffer)
+    QueueRelease(release);
+}
+
+void GPUContextVulkan::ReleaseWhenFrameComplete(VkDeviceMemory memory) {
+  PendingRelease release;
+  release.memory = memory;
+  if (memory)
+    QueueRelease(release);
+}
+
+VkDeviceMemory GPUContextVulkan::AllocateMemory(const VkMemoryRequirements& requirements,
+  VkMemoryPropertyFlags properties) {
+  for (uint32_t i = 0; i < memory_properties_.memoryTypeCount; i++) {
+    if (!(requirements.memoryTypeBits & (1u << i)) ||
+        (memory_properties_.memoryTypes[i].propertyFlags & properties) != properties)
+      continue;
+
+    VkMemoryAllocateInfo alloc_info = {};
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = requirements.size;
+    alloc_info.memoryTypeIndex = i;
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkResult result = vkAllocateMemory(device_, &alloc_info, nullptr, &memory);
+    if (result == VK_SUCCESS)
+      return memory;
+
+    LogVulkanError("vkAllocateMemory", result);
+    return VK_NULL_HANDLE;
+  }
+
+  return VK_NULL_HANDLE;
+}
+
+VkRenderPass GPUContextVulkan::GetRenderPass(VkFormat format, VkSampleCountFlagBits samples, bool clear) {
+  uint64_t key = ((uint64_t)format << 32) | ((uint64_t)samples << 1) | (clear ? 1 : 0);
+  auto i = render_passes_.find(key);
+  if (i != render_passes_.end())
+    return i->second;
+
+  bool multisampled = samples != VK_SAMPLE_COUNT_1_BIT;
+
+  VkAttachmentDescription attachments[2] = {};
+  VkAttachmentDescription& color = attachments[0];
+  color.format = format;
+  color.samples = samples;
+  color.loadOp = clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+  color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  if (multisampled) {
+    // The multisampled image stays a color attachment for its lifetime.
+    color.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  } else {
+    // Single-sampled passes only target swap chain images.
+    color.initialLayout = clear ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    color.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  }
+
+  // Every pass covers the whole target, so the resolve overwrites all of it.
+  VkAttachmentDescription& resolve = attachments[1];
+  resolve.format = format;
+  resolve.samples = VK_SAMPLE_COUNT_1_BIT;
+  resolve.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  resolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  resolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  resolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  resolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  resolve.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  VkAttachmentReference color_ref = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+  VkAttachmentReference resolve_ref = { 1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+
+  VkSubpassDescription subpass = {};
+  subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  subpass.colorAttachmentCount = 1;
+  subpass.pColorAttachments = &color_ref;
+  subpass.pResolveAttachments = multisampled ? &resolve_ref : nullptr;
+
+  // Order against earlier draws, clears and uploads on the way in, and make
+  // the resolved image visible to later passes that sample it on the way out.
+  VkSubpassDependency dependencies[2] = {};
+  dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+  dependencies[0].dstSubpass = 0;
+  dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+  dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  dependencies[1].srcSubpass = 0;
+  dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+  dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+  VkRenderPassCreateInfo create_info = {};
+  create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+  create_info.attachmentCount = multisampled ? 2 : 1;
+  create_info.pAttachments = attachments;
+  create_info.subpassCount = 1;
+  create_info.pSubpasses = &subpass;
+  create_info.dependencyCount = 2;
+  create_info.pDependencies = dependencies;
+
+  VkRenderPass render_pass = VK_NULL_HANDLE;
+  VkResult result = vkCreateRenderPass(device_, &create_info, nullptr, &render_pass);
+  if (result != VK_SUCCESS) {
+    LogVulkanError("vkCreateRenderPass", result);
+    return VK_NULL_HANDLE;
+  }
+
+  render_passes_[key] = render_pass;
+  return render_pass;
+}
+
+VkPipeline GPUContextVulkan::GetPipeline(const PipelineKeyVulkan& key) {
+  uint64_t hash = key.Hash();
+  auto i = pipelines_.find(hash);
+  if (i != pipelines_.end())
+    return i->second;
+
+  VkPipeline pipeline = CreatePipeline(key);
+  pipelines_[hash] = pipeline;
+  return pipeline;
+}
+
+VkPipeline GPUContextVulkan::CreatePipeline(const PipelineKeyVulkan& key) {
+  TraceZone("GPUContextVulkan::CreatePipeline");
+  auto shaders = shaders_.find(key.shader_type);
+  if (shaders == shaders_.end())
+    return VK_NULL_HANDLE;
+
+  VkPipelineShaderStageCreateInfo stages[2] = {};
+  stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+  stages[0].module = shaders->second.vertex;
+  stages[0].pName = "main";
+  stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+  stages[1].module = shaders->second.fragment;
+  stages[1].pName = "main";
+
+  // Same attribute layout as GeometryArenaGL's VAOs.
+  VkVertexInputBindingDescription binding = {};
+  VkVertexInputAttributeDescription attributes[11] = {};
+  uint32_t attribute_count = 0;
+  auto add_attribute = [&](VkFormat format, uint32_t offset) {
+    attributes[attribute_count].location = attribute_count;
+    attributes[attribute_count].binding = 0;
+    attributes[attribute_count].format = format;
+    attributes[attribute_count].offset = offset;
+    attribute_count++;
+  };
+
+  add_attribute(VK_FORMAT_R32G32_SFLOAT, 0);
+  add_attribute(VK_FORMAT_R8G8B8A8_UNORM, 8);
+  add_attribute(VK_FORMAT_R32G32_SFLOAT, 12);
+  if (key.shader_type == ShaderType::FillPath) {
+    binding.stride = 20;
+  } else {
+    binding.stride = 140;
+    add_attribute(VK_FORMAT_R32G32_SFLOAT, 20);
+    for (uint32_t offset = 28; offset <= 124; offset += 16)
+      add_attribute(VK_FORMAT_R32G32B32A32_SFLOAT, offset);
+  }
+  binding.binding = 0;
+  binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+  VkPipelineVertexInputStateCreateInfo vertex_input = {};
+  vertex_input.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+  vertex_input.vertexBindingDescriptionCount = 1;
+  vertex_input.pVertexBindingDescriptions = &binding;
+  vertex_input.vertexAttributeDescriptionCount = attribute_count;
+  vertex_input.pVertexAttributeDescriptions = attributes;
+
+  VkPipelineInputAssemblyStateCreateInfo input_assembly = {};
+  input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+  input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+  VkPipelineViewportStateCreateInfo viewport = {};
+  viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+  viewport.viewportCount = 1;
+  viewport.scissorCount = 1;
+
+  VkPipelineRasterizationStateCreateInfo rasterization = {};
+  rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+  rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+  rasterization.cullMode = VK_CULL_MODE_NONE;
+  rasterization.frontFace = VK_FRONT_FACE_CLOCKWISE;
+  rasterization.lineWidth = 1.0f;
+
+  VkPipelineMultisampleStateCreateInfo multisample = {};
+  multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+  multisample.rasterizationSamples = key.samples;
+
+  VkPipelineColorBlendAttachmentState blend = {};
+  blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+    VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+  if (key.blend_enabled) {
+    // glBlendFunc() semantics, the same factors for color and alpha.
+    blend.blendEnable = VK_TRUE;
+    blend.srcColorBlendFactor = MapBlendFactor(key.blend_src_factor);
+    blend.dstColorBlendFactor = MapBlendFactor(key.blend_dst_factor);
+    blend.colorBlendOp = MapBlendEquation(key.blend_equation);
+    blend.srcAlphaBlendFactor = blend.srcColorBlendFactor;
+    blend.dstAlphaBlendFactor = blend.dstColorBlendFactor;
+    blend.alphaBlendOp = blend.colorBlendOp;
+  }
+
+  VkPipelineColorBlendStateCreateInfo color_blend = {};
+  color_blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+  color_blend.attachmentCount = 1;
+  color_blend.pAttachments = &blend;
+
+  VkDynamicState dynamic_states[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+  VkPipelineDynamicStateCreateInfo dynamic = {};
+  dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+  dynamic.dynamicStateCount = 2;
+  dynamic.pDynamicStates = dynamic_states;
+
+  VkGraphicsPipelineCreateInfo create_info = {};
+  create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  create_info.stageCount = 2;
+  create_info.pStages = stages;
+  create_info.pVertexInputState = &vertex_input;
+  create_info.pInputAssemblyState = &input_assembly;
+  create_info.pViewportState = &viewport;
+  create_info.pRasterizationState = &rasterization;
+  create_info.pMultisampleState = &multisample;
+  create_info.pColorBlendState = &color_blend;
+  create_info.pDynamicState = &dynamic;
+  create_info.layout = pipeline_layout_;
+  create_info.renderPass = GetRenderPass(key.format, key.samples, false);
+  create_info.subpass = 0;
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  VkResult result = vkCreateGraphicsPipelines(device_, pipeline_cache_, 1, &create_info, nullptr, &pipeline);
+  if (result != VK_SUCCESS) {
+    LogVulkanError("vkCreateGraphicsPipelines", result);
+    return VK_NULL_HANDLE;
+  }
+
+  return pipeline;
+}
+
+}  // namespace ultralight
+
+#endif
@@ -0,0 +1,223 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#pragma once
+#include <Ultralight/platform/GPUDriver.h>
+#include "FunctionsVulkan.h"
+#include "BufferRingVulkan.h"
+#include "GPUDriverImpl.h"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+typedef struct GLFWwindow GLFWwindow;
+
+namespace ultralight {
+
+class GPUDriverVulkan;
+class SwapChainVulkan;
+
+// Everything that selects a VkPipeline for a draw. Blend factors are ignored
+// when blending is disabled.
+struct PipelineKeyVulkan {
+  ShaderType shader_type = ShaderType::Fill;
+  bool blend_enabled = false;
+  BlendFactor blend_src_factor = BlendFactor::One;
+  BlendFactor blend_dst_factor = BlendFactor::InvSrcAlpha;
+  BlendEquation blend_equation = BlendEquation::Add;
+  VkFormat format = VK_FORMAT_UNDEFINED;
+  VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+
+  uint64_t Hash() const;
+};
+
+//
+// Owns the Vulkan instance, device, queue and the per-frame resources shared
+// by every window, the Vulkan counterpart of GPUContextGL.
+//
+// Each submission (a window's frame, or a flush of uploads when nothing was
+// drawn) uses the next of kFrameCount frame slots. A slot's command buffer,
+// descriptor pools and buffer rings are recycled once the GPU has finished
+// the submission that last used them, tracked with a monotonic serial.
+//
+class GPUContextVulkan {
+public:
+  static const uint32_t kFrameCount = 2;
+
+  // Returns null if no Vulkan device can render to GLFW windows, the app
+  // falls back to OpenGL then. glfwInit() must have been called.
+  static std::unique_ptr<GPUContextVulkan> Create(bool enable_vsync);
+
+  ~GPUContextVulkan();
+
+  GPUDriverImpl* driver() const;
+
+  // A hidden window that lives as long as the context, used for clipboard
+  // access like GPUContextGL's offscreen window.
+  GLFWwindow* window() { return window_; }
+
+  // Creates the swap chain for a window created with GLFW_NO_API.
+  bool AddWindow(GLFWwindow* win);
+
+  // Call before destroying a window passed to AddWindow().
+  void OnWindowDestroyed(GLFWwindow* win);
+
+  void set_active_window(GLFWwindow* win) { active_window_ = win; }
+
+  GLFWwindow* active_window() { return active_window_; }
+
+  // The swap chain of active_window(), render buffer 0 draws into its
+  // current image.
+  SwapChainVulkan* active_swap_chain();
+
+  // Acquires the next image of the active window's swap chain.
+  void BeginDrawing();
+
+  // Submits the frame and presents the active window's image.
+  void EndDrawing();
+
+  // Submits recorded work (texture uploads) when nothing was drawn.
+  void Flush();
+
+  VkInstance instance() const { return instance_; }
+  VkPhysicalDevice physical_device() const { return physical_device_; }
+  VkDevice device() const { return device_; }
+  VkQueue queue() const { return queue_; }
+  uint32_t queue_family() const { return queue_family_; }
+  const VkPhysicalDeviceLimits& limits() const { return device_properties_.limits; }
+  bool enable_vsync() const { return enable_vsync_; }
+
+  // The command buffer of the frame being recorded. Starts the frame if
+  // needed, which waits for the GPU to finish the slot's previous frame.
+  VkCommandBuffer command_buffer();
+
+  uint32_t frame_index() const { return frame_index_; }
+
+  // Serial of the frame being recorded, resources used by it can be reused
+  // once completed_serial() reaches it.
+  uint64_t frame_serial() const { return frame_serial_; }
+  uint64_t completed_serial() const { return completed_serial_; }
+
+  BufferRingVulkan::Allocation AllocateUniforms(VkDeviceSize size);
+  BufferRingVulkan::Allocation AllocateStaging(VkDeviceSize size);
+  VkDescriptorSet AllocateDescriptorSet();
+
+  // Destroys the object once the GPU has finished every submitted frame.
+  void ReleaseWhenFrameComplete(VkBuffer buffer);
+  void ReleaseWhenFrameComplete(VkImage image);
+  void ReleaseWhenFrameComplete(VkImageView view);
+  void ReleaseWhenFrameComplete(VkFramebuffer framebuffer);
+  void ReleaseWhenFrameComplete(VkDeviceMemory memory);
+
+  // Returns VK_NULL_HANDLE if no memory type matches.
+  VkDeviceMemory AllocateMemory(const VkMemoryRequirements& requirements,
+    VkMemoryPropertyFlags properties);
+
+  VkDescriptorSetLayout descriptor_set_layout() const { return descriptor_set_layout_; }
+  VkPipelineLayout pipeline_layout() const { return pipeline_layout_; }
+  VkSampler sampler() const { return sampler_; }
+
+  // Offscreen render targets are multisampled and resolved at the end of
+  // every render pass.
+  VkSampleCountFlagBits render_target_samples() const { return render_target_samples_; }
+  static VkFormat render_target_format() { return VK_FORMAT_B8G8R8A8_UNORM; }
+
+  // Render passes for a color attachment format and sample count, 'clear'
+  // selects a load op of CLEAR over LOAD. Multisampled passes resolve to a
+  // second attachment.
+  VkRenderPass GetRenderPass(VkFormat format, VkSampleCountFlagBits samples, bool clear);
+
+  // Pipelines for offscreen targets are created up front for every shader
+  // with and without premultiplied-alpha blending, others on first use.
+  VkPipeline GetPipeline(const PipelineKeyVulkan& key);
+
+protected:
+  GPUContextVulkan(bool enable_vsync);
+
+  bool Initialize();
+  bool CreateInstance();
+  bool SelectPhysicalDevice();
+  bool CreateDevice();
+  bool CreateFrames();
+  bool CreatePipelineObjects();
+  bool CreateShaderModules();
+  void PrebuildPipelines();
+  VkPipeline CreatePipeline(const PipelineKeyVulkan& key);
+
+  struct Frame {
+    VkCommandPool command_pool = VK_NULL_HANDLE;
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    uint64_t serial = 0; // Serial of the last submission from this slot
+    std::vector<VkDescriptorPool> descriptor_pools;
+    size_t descriptor_pool_index = 0;
+    std::unique_ptr<BufferRingVulkan> uniforms;
+    std::unique_ptr<BufferRingVulkan> staging;
+  };
+
+  // An object passed to ReleaseWhenFrameComplete(), only one handle is set.
+  struct PendingRelease {
+    uint64_t serial = 0; // Destroyed once completed_serial_ reaches this
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkImage image = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+  };
+
+  Frame& frame() { return frames_[frame_index_]; }
+
+  // Waits for the slot's previous submission and recycles its resources.
+  void BeginFrame();
+
+  // Ends the command buffer and submits it, the next frame uses the next slot.
+  void SubmitFrame(VkSemaphore wait_semaphore, VkSemaphore signal_semaphore);
+
+  void QueueRelease(PendingRelease release);
+
+  // Destroys queued objects whose frames have completed, or all of them.
+  void ReleaseCompletedObjects(bool release_all);
+  VkDescriptorPool CreateDescriptorPool();
+
+  bool enable_vsync_;
+  GLFWwindow* window_ = nullptr;
+  GLFWwindow* active_window_ = nullptr;
+  std::map<GLFWwindow*, std::unique_ptr<SwapChainVulkan>> swap_chains_;
+
+  VkInstance instance_ = VK_NULL_HANDLE;
+  VkPhysicalDevice physical_device_ = VK_NULL_HANDLE;
+  VkPhysicalDeviceProperties device_properties_ = {};
+  VkPhysicalDeviceMemoryProperties memory_properties_ = {};
+  VkDevice device_ = VK_NULL_HANDLE;
+  VkQueue queue_ = VK_NULL_HANDLE;
+  uint32_t queue_family_ = 0;
+
+  Frame frames_[kFrameCount];
+  uint32_t frame_index_ = 0;
+  bool recording_ = false;
+  uint64_t frame_serial_ = 1;
+  uint64_t completed_serial_ = 0;
+  std::deque<PendingRelease> pending_releases_; // Ordered by serial
+
+  VkDescriptorSetLayout descriptor_set_layout_ = VK_NULL_HANDLE;
+  VkPipelineLayout pipeline_layout_ = VK_NULL_HANDLE;
+  VkPipelineCache pipeline_cache_ = VK_NULL_HANDLE;
+  VkSampler sampler_ = VK_NULL_HANDLE;
+  VkSampleCountFlagBits render_target_samples_ = VK_SAMPLE_COUNT_1_BIT;
+
+  struct ShaderModules {
+    VkShaderModule vertex = VK_NULL_HANDLE;
+    VkShaderModule fragment = VK_NULL_HANDLE;
+  };
+  std::map<ShaderType, ShaderModules> shaders_;
+  std::vector<VkShaderModule> shader_modules_; // Owning list, vertex shaders are shared
+
+  std::map<uint64_t, VkRenderPass> render_passes_;
+  std::map<uint64_t, VkPipeline> pipelines_;
+
+  std::unique_ptr<GPUDriverVulkan> driver_;
+};
+
+}  // namespace ultralight
+
+#endif
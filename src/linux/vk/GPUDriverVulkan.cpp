@@ -0,0 +1,786 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#include "GPUDriverVulkan.h"
+#include "SwapChainVulkan.h"
+#include "TraceRecorder.h"
+#include <Ultralight/platform/Platform.h>
+#include <Ultralight/platform/Logger.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace ultralight {
+
+static void LogError(const char* message) {
+  if (Logger* logger = Platform::instance().logger())
+    logger->LogMessage(LogLevel::Error, message);
+}
+
+static void ImageBarrier(VkCommandBuffer command_buffer, VkImage image,
+  VkImageLayout old_layout, VkImageLayout new_layout,
+  VkPipelineStageFlags src_stage, VkAccessFlags src_access,
+  VkPipelineStageFlags dst_stage, VkAccessFlags dst_access) {
+  VkImageMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.srcAccessMask = src_access;
+  barrier.dstAccessMask = dst_access;
+  barrier.oldLayout = old_layout;
+  barrier.newLayout = new_layout;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = image;
+  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.layerCount = 1;
+  vkCmdPipelineBarrier(command_buffer, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+// Creates a 2D image with dedicated device-local memory and a view of it.
+// A8 images are R8 in memory, the view swizzles .r into .a (the HLSL shaders
+// read A8_UNORM textures from .a).
+static bool CreateImageAndView(GPUContextVulkan& context, uint32_t width, uint32_t height,
+  VkFormat format, VkSampleCountFlagBits samples, VkImageUsageFlags usage,
+  VkImage& image, VkDeviceMemory& memory, VkImageView& view, uint64_t& bytes) {
+  VkDevice device = context.device();
+
+  VkImageCreateInfo image_info = {};
+  image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  image_info.imageType = VK_IMAGE_TYPE_2D;
+  image_info.format = format;
+  image_info.extent = { width, height, 1 };
+  image_info.mipLevels = 1;
+  image_info.arrayLayers = 1;
+  image_info.samples = samples;
+  image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+  image_info.usage = usage;
+  image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  if (vkCreateImage(device, &image_info, nullptr, &image) != VK_SUCCESS) {
+    image = VK_NULL_HANDLE;
+    return false;
+  }
+
+  VkMemoryRequirements requirements;
+  vkGetImageMemoryRequirements(device, image, &requirements);
+  memory = context.AllocateMemory(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  if (!memory || vkBindImageMemory(device, image, memory, 0) != VK_SUCCESS) {
+    if (memory)
+      vkFreeMemory(device, memory, nullptr);
+    vkDestroyImage(device, image, nullptr);
+    image = VK_NULL_HANDLE;
+    memory = VK_NULL_HANDLE;
+    return false;
+  }
+
+  VkImageViewCreateInfo view_info = {};
+  view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+  view_info.image = image;
+  view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+  view_info.format = format;
+  if (format == VK_FORMAT_R8_UNORM) {
+    view_info.components = { VK_COMPONENT_SWIZZLE_ZERO, VK_COMPONENT_SWIZZLE_ZERO,
+      VK_COMPONENT_SWIZZLE_ZERO, VK_COMPONENT_SWIZZLE_R };
+  }
+  view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  view_info.subresourceRange.levelCount = 1;
+  view_info.subresourceRange.layerCount = 1;
+  if (vkCreateImageView(device, &view_info, nullptr, &view) != VK_SUCCESS) {
+    vkDestroyImage(device, image, nullptr);
+    vkFreeMemory(device, memory, nullptr);
+    image = VK_NULL_HANDLE;
+    memory = VK_NULL_HANDLE;
+    view = VK_NULL_HANDLE;
+    return false;
+  }
+
+  bytes = requirements.size;
+  return true;
+}
+
+GPUDriverVulkan::GPUDriverVulkan(GPUContextVulkan* context)
+  : geometry_arena_(*context), context_(context) {
+  memset(&last_uniforms_, 0, sizeof(Uniforms));
+}
+
+GPUDriverVulkan::~GPUDriverVulkan() {
+  // The context destroys everything released here right after, once the
+  // device is idle.
+  for (auto& i : render_buffer_map)
+    context_->ReleaseWhenFrameComplete(i.second.framebuffer);
+  for (auto& i : texture_map)
+    ReleaseTexture(i.second);
+  ReleaseTexture(placeholder_);
+}
+
+void GPUDriverVulkan::CreateTexture(uint32_t texture_id,
+  RefPtr<Bitmap> bitmap) {
+  if (bitmap->IsEmpty()) {
+    CreateRenderTarget(texture_id, bitmap);
+    return;
+  }
+
+  TextureEntry& entry = texture_map[texture_id];
+  entry.width = bitmap->width();
+  entry.height = bitmap->height();
+  entry.format = bitmap->format();
+
+  uint64_t bytes = 0, msaa_bytes = 0;
+  if (CreateImages(entry, bytes, msaa_bytes)) {
+    UploadPixels(entry, bitmap->LockPixels(), bitmap->row_bytes());
+    bitmap->UnlockPixels();
+  } else {
+    LogError("Failed to create Vulkan texture, it will be drawn transparent.");
+  }
+
+  memory_stats_.texture_count++;
+  TrackTextureBytes(entry, bytes, msaa_bytes);
+}
+
+void GPUDriverVulkan::UpdateTexture(uint32_t texture_id,
+  RefPtr<Bitmap> bitmap) {
+  TextureEntry& entry = texture_map[texture_id];
+  if (entry.is_render_target)
+    return;
+
+  if (!entry.image || entry.width != bitmap->width() || entry.height != bitmap->height() ||
+      entry.format != bitmap->format()) {
+    // Frames in flight may still sample the old image.
+    ReleaseTexture(entry);
+    entry.width = bitmap->width();
+    entry.height = bitmap->height();
+    entry.format = bitmap->format();
+
+    uint64_t bytes = 0, msaa_bytes = 0;
+    CreateImages(entry, bytes, msaa_bytes);
+    TrackTextureBytes(entry, bytes, msaa_bytes);
+  }
+
+  if (entry.image) {
+    UploadPixels(entry, bitmap->LockPixels(), bitmap->row_bytes());
+    bitmap->UnlockPixels();
+  }
+}
+
+void GPUDriverVulkan::BindTexture(uint8_t texture_unit, uint32_t texture_id) {
+  // Only Texture0 and Texture1 are read by the shaders, textures are bound
+  // through the descriptor set of the next draw.
+  if (texture_unit < 2)
+    bound_textures_[texture_unit] = texture_id;
+}
+
+void GPUDriverVulkan::DestroyTexture(uint32_t texture_id) {
+  auto i = texture_map.find(texture_id);
+  if (i == texture_map.end())
+    return;
+
+  ReleaseTexture(i->second);
+  TrackTextureBytes(i->second, 0, 0);
+  memory_stats_.texture_count--;
+  texture_map.erase(i);
+}
+
+void GPUDriverVulkan::CreateRenderBuffer(uint32_t render_buffer_id,
+  const RenderBuffer& buffer) {
+  if (render_buffer_id == 0)
+    return;
+
+  RenderBufferEntry entry;
+  entry.texture_id = buffer.texture_id;
+
+  TextureEntry& texture = texture_map[buffer.texture_id];
+  texture.render_buffer_id = render_buffer_id;
+
+  if (texture.msaa_view && texture.view) {
+    // The load and clear variants of the render pass are compatible.
+    VkImageView attachments[2] = { texture.msaa_view, texture.view };
+    VkFramebufferCreateInfo framebuffer_info = {};
+    framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebuffer_info.renderPass = context_->GetRenderPass(GPUContextVulkan::render_target_format(),
+      context_->render_target_samples(), false);
+    framebuffer_info.attachmentCount = 2;
+    framebuffer_info.pAttachments = attachments;
+    framebuffer_info.width = texture.width;
+    framebuffer_info.height = texture.height;
+    framebuffer_info.layers = 1;
+    if (vkCreateFramebuffer(context_->device(), &framebuffer_info, nullptr, &entry.framebuffer) != VK_SUCCESS) {
+      entry.framebuffer = VK_NULL_HANDLE;
+      LogError("Failed to create Vulkan framebuffer, the render buffer will not be drawn.");
+    }
+  }
+
+  render_buffer_map[render_buffer_id] = entry;
+  memory_stats_.render_buffer_count++;
+}
+
+void GPUDriverVulkan::BindRenderBuffer(uint32_t render_buffer_id) {
+  if (pass_open_ && pass_render_buffer_id_ == render_buffer_id)
+    return;
+
+  BeginRenderPass(render_buffer_id, false);
+}
+
+void GPUDriverVulkan::ClearRenderBuffer(uint32_t render_buffer_id) {
+  if (pass_open_ && pass_render_buffer_id_ == render_buffer_id) {
+    VkClearAttachment attachment = {};
+    attachment.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    attachment.colorAttachment = 0;
+    VkClearRect rect = {};
+    rect.rect.extent = pass_extent_;
+    rect.layerCount = 1;
+    vkCmdClearAttachments(context_->command_buffer(), 1, &attachment, 1, &rect);
+    return;
+  }
+
+  BeginRenderPass(render_buffer_id, true);
+}
+
+void GPUDriverVulkan::DestroyRenderBuffer(uint32_t render_buffer_id) {
+  auto i = render_buffer_map.find(render_buffer_id);
+  if (i == render_buffer_map.end())
+    return;
+
+  if (pass_open_ && pass_render_buffer_id_ == render_buffer_id)
+    EndRenderPass();
+
+  context_->ReleaseWhenFrameComplete(i->second.framebuffer);
+  memory_stats_.render_buffer_count--;
+  render_buffer_map.erase(i);
+}
+
+void GPUDriverVulkan::CreateGeometry(uint32_t geometry_id,
+  const VertexBuffer& vertices,
+  const IndexBuffer& indices) {
+  if (!GeometryArenaVulkan::StrideForFormat(vertices.format)) {
+    LogError("Unhandled vertex format, the geometry will not be drawn.");
+    return;
+  }
+
+  GeometryEntry geometry;
+  geometry.vertex_format = vertices.format;
+  geometry.allocation = geometry_arena_.Allocate(vertices, indices);
+
+  geometry.bytes = (uint64_t)vertices.size + indices.size;
+  memory_stats_.geometry_bytes = geometry_arena_.reserved_bytes();
+  memory_stats_.geometry_count++;
+
+  geometry_map[geometry_id] = geometry;
+}
+
+void GPUDriverVulkan::UpdateGeometry(uint32_t geometry_id,
+  const VertexBuffer& vertices,
+  const IndexBuffer& indices) {
+  auto i = geometry_map.find(geometry_id);
+  if (i == geometry_map.end())
+    return;
+
+  GeometryEntry& geometry = i->second;
+  geometry_arena_.Update(geometry.allocation, vertices, indices);
+
+  geometry.vertex_format = vertices.format;
+  geometry.bytes = (uint64_t)vertices.size + indices.size;
+  memory_stats_.geometry_bytes = geometry_arena_.reserved_bytes();
+}
+
+void GPUDriverVulkan::DrawGeometry(uint32_t geometry_id,
+  uint32_t indices_count,
+  uint32_t indices_offset,
+  const GPUState& state) {
+  auto i = geometry_map.find(geometry_id);
+  if (i == geometry_map.end() || !i->second.allocation.page_id)
+    return;
+
+  BindRenderBuffer(state.render_buffer_id);
+  if (!pass_open_ || pass_render_buffer_id_ != state.render_buffer_id)
+    return;
+
+  VkCommandBuffer command_buffer = context_->command_buffer();
+
+  PipelineKeyVulkan key;
+  key.shader_type = (ShaderType)state.shader_type;
+  key.blend_enabled = state.enable_blend;
+  key.blend_src_factor = state.blend_src_factor;
+  key.blend_dst_factor = state.blend_dst_factor;
+  key.blend_equation = state.blend_equation;
+  key.format = pass_format_;
+  key.samples = pass_samples_;
+  VkPipeline pipeline = context_->GetPipeline(key);
+  if (!pipeline)
+    return;
+
+  if (pipeline != bound_pipeline_) {
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    bound_pipeline_ = pipeline;
+  }
+
+  VkViewport viewport = { 0.0f, 0.0f, (float)state.viewport_width, (float)state.viewport_height, 0.0f, 1.0f };
+  vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+
+  VkRect2D scissor = {};
+  if (state.enable_scissor) {
+    const IntRect& r = state.scissor_rect;
+    scissor.offset.x = std::max(r.left, 0);
+    scissor.offset.y = std::max(r.top, 0);
+    scissor.extent.width = (uint32_t)std::max(r.right - scissor.offset.x, 0);
+    scissor.extent.height = (uint32_t)std::max(r.bottom - scissor.offset.y, 0);
+  } else {
+    scissor.extent.width = state.viewport_width;
+    scissor.extent.height = state.viewport_height;
+  }
+  vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+  if (!UpdateUniforms(state))
+    return;
+
+  BindTexture(0, state.texture_1_id);
+  BindTexture(1, state.texture_2_id);
+
+  DescriptorSetKey set_key(uniform_allocation_.buffer, ViewForTexture(bound_textures_[0]),
+    ViewForTexture(bound_textures_[1]));
+  if (!std::get<1>(set_key) || !std::get<2>(set_key))
+    return;
+  VkDescriptorSet& set = descriptor_sets_[set_key];
+  if (!set) {
+    set = context_->AllocateDescriptorSet();
+    if (!set) {
+      descriptor_sets_.erase(set_key);
+      return;
+    }
+
+    VkDescriptorBufferInfo buffer_info = { uniform_allocation_.buffer, 0, sizeof(Uniforms) };
+    VkDescriptorImageInfo image_infos[2] = {};
+    image_infos[0].imageView = std::get<1>(set_key);
+    image_infos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    image_infos[1].imageView = std::get<2>(set_key);
+    image_infos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    VkDescriptorImageInfo sampler_info = {};
+    sampler_info.sampler = context_->sampler();
+
+    VkWriteDescriptorSet writes[3] = {};
+    for (auto& write : writes) {
+      write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      write.dstSet = set;
+      write.descriptorCount = 1;
+    }
+    writes[0].dstBinding = 0;
+    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    writes[0].pBufferInfo = &buffer_info;
+    writes[1].dstBinding = 1;
+    writes[1].descriptorCount = 2; // Texture0 and Texture1, bindings 1 and 2
+    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    writes[1].pImageInfo = image_infos;
+    writes[2].dstBinding = 3;
+    writes[2].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+    writes[2].pImageInfo = &sampler_info;
+    vkUpdateDescriptorSets(context_->device(), 3, writes, 0, nullptr);
+  }
+
+  uint32_t uniform_offset = (uint32_t)uniform_allocation_.offset;
+  if (set != bound_descriptor_set_ || uniform_offset != bound_uniform_offset_) {
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, context_->pipeline_layout(),
+      0, 1, &set, 1, &uniform_offset);
+    bound_descriptor_set_ = set;
+    bound_uniform_offset_ = uniform_offset;
+  }
+
+  // Geometry in the same arena page shares its buffers, only rebind when the
+  // page changes between consecutive draws.
+  GeometryEntry& geometry = i->second;
+  GeometryArenaVulkan::Buffers buffers = geometry_arena_.buffers(geometry.allocation);
+  if (buffers.vertex_buffer != bound_vertex_buffer_) {
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(command_buffer, 0, 1, &buffers.vertex_buffer, &offset);
+    vkCmdBindIndexBuffer(command_buffer, buffers.index_buffer, 0, VK_INDEX_TYPE_UINT32);
+    bound_vertex_buffer_ = buffers.vertex_buffer;
+  }
+
+  vkCmdDrawIndexed(command_buffer, indices_count, 1, geometry.allocation.index_offset + indices_offset,
+    (int32_t)geometry.allocation.vertex_offset, 0);
+  geometry.allocation.last_used_serial = context_->frame_serial();
+
+  batch_count_++;
+}
+
+void GPUDriverVulkan::DestroyGeometry(uint32_t geometry_id) {
+  auto i = geometry_map.find(geometry_id);
+  if (i == geometry_map.end())
+    return;
+
+  geometry_arena_.Free(i->second.allocation);
+
+  memory_stats_.geometry_bytes = geometry_arena_.reserved_bytes();
+  memory_stats_.geometry_count--;
+  geometry_map.erase(i);
+}
+
+void GPUDriverVulkan::DrawCommandList() {
+  if (!command_arena_.has_pending())
+    return;
+
+  TraceZone("GPUDriverVulkan::DrawCommandList");
+
+  batch_count_ = 0;
+
+  // Created up front, uploads can't be recorded inside a render pass.
+  if (!placeholder_.view)
+    CreatePlaceholder();
+
+  for (auto& cmd : command_arena_.Acquire()) {
+    switch (cmd.command_type) {
+    case CommandType::DrawGeometry:
+      DrawGeometry(cmd.geometry_id, cmd.indices_count, cmd.indices_offset, cmd.gpu_state);
+      break;
+    case CommandType::ClearRenderBuffer:
+      ClearRenderBuffer(cmd.gpu_state.render_buffer_id);
+      break;
+    };
+  }
+
+  EndRenderPass();
+
+  last_frame_uniform_stats_ = uniform_stats_;
+  uniform_stats_ = UniformUploadStats();
+}
+
+GPUMemoryStats GPUDriverVulkan::memory_stats() const {
+  GPUMemoryStats stats = memory_stats_;
+  GeometryArenaVulkan::Stats geometry = geometry_arena_.stats();
+  stats.geometry_used_bytes = geometry.used_bytes;
+  stats.geometry_largest_free_bytes = geometry.largest_free_bytes;
+  stats.geometry_fragmentation = geometry.fragmentation;
+  return stats;
+}
+
+GPUDriverStats GPUDriverVulkan::driver_stats() const {
+  GPUDriverStats stats;
+  stats.uniform_full_bytes = last_frame_uniform_stats_.full_bytes;
+  stats.uniform_uploaded_bytes = last_frame_uniform_stats_.uploaded_bytes;
+  stats.uniform_skipped_uploads = last_frame_uniform_stats_.skipped_uploads;
+  return stats;
+}
+
+std::vector<GPUDriverImpl::ResourceUsage> GPUDriverVulkan::TopMemoryConsumers(size_t max_count) const {
+  std::vector<ResourceUsage> result;
+  result.reserve(texture_map.size() + geometry_map.size());
+
+  for (auto& i : texture_map) {
+    const TextureEntry& entry = i.second;
+    if (entry.bytes)
+      result.push_back({ entry.is_render_target ? "render target" : "texture", i.first, entry.bytes });
+    if (entry.msaa_bytes)
+      result.push_back({ "msaa render target", i.first, entry.msaa_bytes });
+  }
+
+  for (auto& i : geometry_map) {
+    if (i.second.bytes)
+      result.push_back({ "geometry", i.first, i.second.bytes });
+  }
+
+  size_t count = std::min(max_count, result.size());
+  std::partial_sort(result.begin(), result.begin() + count, result.end(),
+    [](const ResourceUsage& a, const ResourceUsage& b) { return a.bytes > b.bytes; });
+  result.resize(count);
+  return result;
+}
+
+void GPUDriverVulkan::OnFrameBegin() {
+  geometry_arena_.Collect(context_->completed_serial());
+
+  // Descriptor sets and uniforms of the previous frame in this slot have
+  // been recycled along with their pools and ring.
+  descriptor_sets_.clear();
+  uniform_allocation_ = BufferRingVulkan::Allocation();
+  last_uniforms_size_ = 0;
+
+  pass_open_ = false;
+  bound_pipeline_ = VK_NULL_HANDLE;
+  bound_descriptor_set_ = VK_NULL_HANDLE;
+  bound_vertex_buffer_ = VK_NULL_HANDLE;
+}
+
+void GPUDriverVulkan::FinishRendering() {
+  SwapChainVulkan* swap_chain = context_->active_swap_chain();
+  if (swap_chain && swap_chain->image_acquired() && !swap_chain->image_drawn())
+    BeginRenderPass(0, true);
+
+  EndRenderPass();
+}
+
+Matrix GPUDriverVulkan::ApplyProjection(const Matrix4x4& transform, float screen_width, float screen_height, bool flip_y) {
+  Matrix transform_mat;
+  transform_mat.Set(transform);
+
+  Matrix result;
+  result.SetOrthographicProjection(screen_width, screen_height, flip_y);
+  result.Transform(transform_mat);
+
+  return result;
+}
+
+bool GPUDriverVulkan::CreateImages(TextureEntry& entry, uint64_t& bytes, uint64_t& msaa_bytes) {
+  bytes = 0;
+  msaa_bytes = 0;
+
+  VkFormat format = entry.format == BitmapFormat::A8_UNORM ? VK_FORMAT_R8_UNORM :
+    GPUContextVulkan::render_target_format();
+
+  VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  if (entry.is_render_target)
+    usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+  if (!CreateImageAndView(*context_, entry.width, entry.height, format, VK_SAMPLE_COUNT_1_BIT, usage,
+      entry.image, entry.memory, entry.view, bytes))
+    return false;
+
+  if (!entry.is_render_target)
+    return true;
+
+  // Kept across passes: each pass loads it, draws and resolves into 'image'.
+  if (!CreateImageAndView(*context_, entry.width, entry.height, format, context_->render_target_samples(),
+      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+      entry.msaa_image, entry.msaa_memory, entry.msaa_view, msaa_bytes)) {
+    vkDestroyImageView(context_->device(), entry.view, nullptr);
+    vkDestroyImage(context_->device(), entry.image, nullptr);
+    vkFreeMemory(context_->device(), entry.memory, nullptr);
+    entry.view = VK_NULL_HANDLE;
+    entry.image = VK_NULL_HANDLE;
+    entry.memory = VK_NULL_HANDLE;
+    bytes = 0;
+    return false;
+  }
+
+  return true;
+}
+
+void GPUDriverVulkan::CreateRenderTarget(uint32_t texture_id, RefPtr<Bitmap> bitmap) {
+  TextureEntry& entry = texture_map[texture_id];
+  entry.width = bitmap->width();
+  entry.height = bitmap->height();
+  entry.format = BitmapFormat::BGRA8_UNORM_SRGB;
+  entry.is_render_target = true;
+
+  uint64_t bytes = 0, msaa_bytes = 0;
+  if (CreateImages(entry, bytes, msaa_bytes)) {
+    // Start both images out transparent, in the layouts the render pass
+    // expects: the multisampled one as an attachment, the resolved one
+    // readable in case it's sampled before it's drawn to.
+    EndRenderPass();
+    VkCommandBuffer command_buffer = context_->command_buffer();
+    VkClearColorValue transparent = {};
+    VkImageSubresourceRange range = {};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.levelCount = 1;
+    range.layerCount = 1;
+
+    VkImage images[2] = { entry.msaa_image, entry.image };
+    for (VkImage image : images) {
+      ImageBarrier(command_buffer, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+      vkCmdClearColorImage(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &transparent, 1, &range);
+    }
+
+    ImageBarrier(command_buffer, entry.msaa_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+      VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+      VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+    ImageBarrier(command_buffer, entry.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+  } else {
+    LogError("Failed to create Vulkan render target, it will not be drawn.");
+  }
+
+  memory_stats_.texture_count++;
+  TrackTextureBytes(entry, bytes, msaa_bytes);
+}
+
+void GPUDriverVulkan::UploadPixels(TextureEntry& entry, const void* pixels, uint32_t row_bytes) {
+  // Transfers can't be recorded inside a render pass.
+  EndRenderPass();
+
+  uint32_t bpp = entry.format == BitmapFormat::A8_UNORM ? 1 : 4;
+  VkDeviceSize size = (VkDeviceSize)row_bytes * entry.height;
+  BufferRingVulkan::Allocation staging = context_->AllocateStaging(size);
+  if (!staging.buffer) {
+    LogError("Out of Vulkan staging memory, texture upload skipped.");
+    return;
+  }
+  memcpy(staging.data, pixels, (size_t)size);
+
+  // Earlier frames may still sample the image, the barrier orders the copy
+  // after them; the old contents are discarded.
+  VkCommandBuffer command_buffer = context_->command_buffer();
+  ImageBarrier(command_buffer, entry.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+
+  VkBufferImageCopy region = {};
+  region.bufferOffset = staging.offset;
+  region.bufferRowLength = row_bytes / bpp;
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.layerCount = 1;
+  region.imageExtent = { entry.width, entry.height, 1 };
+  vkCmdCopyBufferToImage(command_buffer, staging.buffer, entry.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    1, &region);
+
+  ImageBarrier(command_buffer, entry.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+}
+
+void GPUDriverVulkan::ReleaseTexture(TextureEntry& entry) {
+  context_->ReleaseWhenFrameComplete(entry.view);
+  context_->ReleaseWhenFrameComplete(entry.image);
+  context_->ReleaseWhenFrameComplete(entry.memory);
+  context_->ReleaseWhenFrameComplete(entry.msaa_view);
+  context_->ReleaseWhenFrameComplete(entry.msaa_image);
+  context_->ReleaseWhenFrameComplete(entry.msaa_memory);
+  entry.view = VK_NULL_HANDLE;
+  entry.image = VK_NULL_HANDLE;
+  entry.memory = VK_NULL_HANDLE;
+  entry.msaa_view = VK_NULL_HANDLE;
+  entry.msaa_image = VK_NULL_HANDLE;
+  entry.msaa_memory = VK_NULL_HANDLE;
+}
+
+bool GPUDriverVulkan::BeginRenderPass(uint32_t render_buffer_id, bool clear) {
+  EndRenderPass();
+
+  VkFramebuffer framebuffer = VK_NULL_HANDLE;
+  if (render_buffer_id == 0) {
+    SwapChainVulkan* swap_chain = context_->active_swap_chain();
+    if (!swap_chain || !swap_chain->image_acquired())
+      return false;
+
+    // The image's previous contents are undefined, the first pass clears it.
+    clear = clear || !swap_chain->image_drawn();
+    swap_chain->set_image_drawn();
+    framebuffer = swap_chain->framebuffer();
+    pass_format_ = swap_chain->format();
+    pass_samples_ = VK_SAMPLE_COUNT_1_BIT;
+    pass_extent_ = swap_chain->extent();
+  } else {
+    auto i = render_buffer_map.find(render_buffer_id);
+    if (i == render_buffer_map.end() || !i->second.framebuffer)
+      return false;
+
+    const TextureEntry& texture = texture_map[i->second.texture_id];
+    framebuffer = i->second.framebuffer;
+    pass_format_ = GPUContextVulkan::render_target_format();
+    pass_samples_ = context_->render_target_samples();
+    pass_extent_ = { texture.width, texture.height };
+  }
+
+  VkRenderPass render_pass = context_->GetRenderPass(pass_format_, pass_samples_, clear);
+  if (!render_pass)
+    return false;
+
+  // Only attachment 0 is ever cleared.
+  VkClearValue clear_values[2] = {};
+
+  VkRenderPassBeginInfo begin_info = {};
+  begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  begin_info.renderPass = render_pass;
+  begin_info.framebuffer = framebuffer;
+  begin_info.renderArea.extent = pass_extent_;
+  begin_info.clearValueCount = 2;
+  begin_info.pClearValues = clear_values;
+  vkCmdBeginRenderPass(context_->command_buffer(), &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+
+  pass_open_ = true;
+  pass_render_buffer_id_ = render_buffer_id;
+  bound_pipeline_ = VK_NULL_HANDLE;
+  bound_descriptor_set_ = VK_NULL_HANDLE;
+  bound_vertex_buffer_ = VK_NULL_HANDLE;
+  return true;
+}
+
+void GPUDriverVulkan::EndRenderPass() {
+  if (!pass_open_)
+    return;
+
+  vkCmdEndRenderPass(context_->command_buffer());
+  pass_open_ = false;
+}
+
+bool GPUDriverVulkan::UpdateUniforms(const GPUState& state) {
+  Uniforms uniforms;
+
+  // State: [time, screenWidth, screenHeight, screenScale]
+  uniforms.State[0] = 0.0f;
+  uniforms.State[1] = (float)state.viewport_width;
+  uniforms.State[2] = (float)state.viewport_height;
+  uniforms.State[3] = 1.0f;
+
+  // Vulkan's clip space has +Y pointing down for every target, unlike GL's
+  // default framebuffer.
+  Matrix model_view_projection = ApplyProjection(state.transform,
+    (float)state.viewport_width, (float)state.viewport_height, true);
+  Matrix4x4 mat = model_view_projection.GetMatrix4x4();
+  memcpy(uniforms.Transform, mat.data, sizeof(uniforms.Transform));
+
+  memcpy(uniforms.Integer4, state.uniform_integer, sizeof(uniforms.Integer4));
+  memcpy(uniforms.Scalar4, state.uniform_scalar, sizeof(uniforms.Scalar4));
+  memcpy(uniforms.Vector, &state.uniform_vector[0].x, sizeof(uniforms.Vector));
+
+  uniforms.ClipData[0] = (int32_t)state.clip_size;
+  uniforms.ClipData[1] = 0;
+  uniforms.ClipData[2] = 0;
+  uniforms.ClipData[3] = 0;
+
+  // Only the first clip_size clip matrices are read by the shaders.
+  size_t clip_bytes = std::min((size_t)state.clip_size, (size_t)8) * sizeof(float) * 16;
+  memcpy(uniforms.Clip, &state.clip[0].data[0], clip_bytes);
+  size_t used_end = offsetof(Uniforms, Clip) + clip_bytes;
+
+  uniform_stats_.draws++;
+  uniform_stats_.full_bytes += sizeof(Uniforms);
+
+  if (uniform_allocation_.buffer && used_end == last_uniforms_size_ &&
+      memcmp(&uniforms, &last_uniforms_, used_end) == 0) {
+    uniform_stats_.skipped_uploads++;
+    return true;
+  }
+
+  // The descriptor covers a whole block, bytes past used_end aren't read.
+  BufferRingVulkan::Allocation allocation = context_->AllocateUniforms(sizeof(Uniforms));
+  if (!allocation.buffer)
+    return false;
+
+  memcpy(allocation.data, &uniforms, used_end);
+  memcpy(&last_uniforms_, &uniforms, used_end);
+  last_uniforms_size_ = used_end;
+  uniform_allocation_ = allocation;
+  uniform_stats_.uploaded_bytes += used_end;
+  return true;
+}
+
+VkImageView GPUDriverVulkan::ViewForTexture(uint32_t texture_id) {
+  auto i = texture_map.find(texture_id);
+  if (i == texture_map.end() || !i->second.view)
+    return placeholder_.view;
+
+  return i->second.view;
+}
+
+void GPUDriverVulkan::CreatePlaceholder() {
+  placeholder_.width = 1;
+  placeholder_.height = 1;
+  placeholder_.format = BitmapFormat::BGRA8_UNORM_SRGB;
+
+  uint64_t bytes = 0, msaa_bytes = 0;
+  if (!CreateImages(placeholder_, bytes, msaa_bytes))
+    return;
+
+  const uint32_t transparent = 0;
+  UploadPixels(placeholder_, &transparent, sizeof(transparent));
+}
+
+void GPUDriverVulkan::TrackTextureBytes(TextureEntry& entry, uint64_t bytes, uint64_t msaa_bytes) {
+  uint64_t& bucket = entry.is_render_target ? memory_stats_.render_target_bytes : memory_stats_.texture_bytes;
+  bucket = bucket - entry.bytes + bytes;
+  memory_stats_.msaa_bytes = memory_stats_.msaa_bytes - entry.msaa_bytes + msaa_bytes;
+  entry.bytes = bytes;
+  entry.msaa_bytes = msaa_bytes;
+}
+
+}  // namespace ultralight
+
+#endif
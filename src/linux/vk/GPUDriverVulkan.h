@@ -0,0 +1,193 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#pragma once
+#include <Ultralight/platform/GPUDriver.h>
+#include "FunctionsVulkan.h"
+#include "GPUContextVulkan.h"
+#include "GPUDriverImpl.h"
+#include "GeometryArenaVulkan.h"
+#include "ShaderUniforms.h"
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace ultralight {
+
+//
+// GPUDriver on top of Vulkan, an alternative to GPUDriverGL with a much
+// lower CPU cost per draw: pipelines are created up front for every shader
+// and blend state, uniforms are sub-allocated from a per-frame ring and bound
+// with a dynamic offset, and there is no driver-side state validation.
+//
+// Offscreen render buffers are always multisampled (like the D3D12 driver)
+// and resolved at the end of every render pass. Render buffer 0 is the
+// current image of the active window's swap chain.
+//
+class GPUDriverVulkan : public GPUDriverImpl {
+public:
+  GPUDriverVulkan(GPUContextVulkan* context);
+
+  virtual ~GPUDriverVulkan();
+
+  virtual const char* name() override { return "Vulkan"; }
+
+  virtual void BeginDrawing() override {}
+
+  virtual void EndDrawing() override {}
+
+  virtual void CreateTexture(uint32_t texture_id,
+    RefPtr<Bitmap> bitmap) override;
+
+  virtual void UpdateTexture(uint32_t texture_id,
+    RefPtr<Bitmap> bitmap) override;
+
+  virtual void BindTexture(uint8_t texture_unit,
+    uint32_t texture_id) override;
+
+  virtual void DestroyTexture(uint32_t texture_id) override;
+
+  virtual void CreateRenderBuffer(uint32_t render_buffer_id,
+    const RenderBuffer& buffer) override;
+
+  virtual void BindRenderBuffer(uint32_t render_buffer_id) override;
+
+  virtual void ClearRenderBuffer(uint32_t render_buffer_id) override;
+
+  virtual void DestroyRenderBuffer(uint32_t render_buffer_id) override;
+
+  virtual void CreateGeometry(uint32_t geometry_id,
+    const VertexBuffer& vertices,
+    const IndexBuffer& indices) override;
+
+  virtual void UpdateGeometry(uint32_t geometry_id,
+    const VertexBuffer& vertices,
+    const IndexBuffer& indices) override;
+
+  virtual void DrawGeometry(uint32_t geometry_id,
+    uint32_t indices_count,
+    uint32_t indices_offset,
+    const GPUState& state) override;
+
+  virtual void DestroyGeometry(uint32_t geometry_id) override;
+
+  virtual void DrawCommandList() override;
+
+  virtual GPUMemoryStats memory_stats() const override;
+
+  virtual GPUDriverStats driver_stats() const override;
+
+  virtual std::vector<ResourceUsage> TopMemoryConsumers(size_t max_count) const override;
+
+  // Called by the context once a frame slot has been recycled.
+  void OnFrameBegin();
+
+  // Ends the open render pass. If the swap chain image was acquired but
+  // never drawn to, clears it so it reaches the layout Present() expects.
+  void FinishRendering();
+
+  // Uniform traffic during the most recent DrawCommandList().
+  const UniformUploadStats& uniform_upload_stats() const { return last_frame_uniform_stats_; }
+
+  GeometryArenaVulkan::Stats geometry_arena_stats() const { return geometry_arena_.stats(); }
+
+protected:
+  Matrix ApplyProjection(const Matrix4x4& transform, float screen_width, float screen_height, bool flip_y);
+
+  struct TextureEntry {
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkImage msaa_image = VK_NULL_HANDLE; // Only for render targets
+    VkDeviceMemory msaa_memory = VK_NULL_HANDLE;
+    VkImageView msaa_view = VK_NULL_HANDLE;
+    uint32_t width = 0, height = 0;
+    BitmapFormat format = BitmapFormat::BGRA8_UNORM_SRGB;
+    bool is_render_target = false; // Created from an empty bitmap
+    uint32_t render_buffer_id = 0;
+    uint64_t bytes = 0; // GPU memory used by image
+    uint64_t msaa_bytes = 0; // GPU memory used by msaa_image
+  };
+
+  // Maps Ultralight Texture IDs to images
+  std::map<uint32_t, TextureEntry> texture_map;
+
+  struct GeometryEntry {
+    VertexBufferFormat vertex_format;
+    GeometryAllocationVulkan allocation; // Range within a geometry_arena_ page
+    uint64_t bytes = 0; // Size of vertex + index buffer data
+  };
+  std::map<uint32_t, GeometryEntry> geometry_map;
+
+  // Vertex/index buffers backing all geometry in geometry_map.
+  GeometryArenaVulkan geometry_arena_;
+
+  struct RenderBufferEntry {
+    uint32_t texture_id = 0; // The Ultralight texture ID backing this RenderBuffer.
+    VkFramebuffer framebuffer = VK_NULL_HANDLE; // [msaa view, resolve view]
+  };
+  std::map<uint32_t, RenderBufferEntry> render_buffer_map;
+
+  // Creates the images, memory and views of 'entry' for its size and format.
+  // Returns false on failure, leaving every handle null.
+  bool CreateImages(TextureEntry& entry, uint64_t& bytes, uint64_t& msaa_bytes);
+
+  void CreateRenderTarget(uint32_t texture_id, RefPtr<Bitmap> bitmap);
+
+  // Records a copy of the pixels into the texture's image, through the
+  // frame's staging ring.
+  void UploadPixels(TextureEntry& entry, const void* pixels, uint32_t row_bytes);
+
+  // Releases the texture's Vulkan objects once the GPU is done with them.
+  void ReleaseTexture(TextureEntry& entry);
+
+  // Begins a render pass on the render buffer, 'clear' clears it first.
+  // Returns false if there is nothing to render to.
+  bool BeginRenderPass(uint32_t render_buffer_id, bool clear);
+  void EndRenderPass();
+
+  // Returns false if the uniform ring is out of memory.
+  bool UpdateUniforms(const GPUState& state);
+
+  VkImageView ViewForTexture(uint32_t texture_id);
+
+  void CreatePlaceholder();
+
+  void TrackTextureBytes(TextureEntry& entry, uint64_t bytes, uint64_t msaa_bytes);
+
+  // Render pass state, only valid while pass_open_ is set.
+  bool pass_open_ = false;
+  uint32_t pass_render_buffer_id_ = 0;
+  VkFormat pass_format_ = VK_FORMAT_UNDEFINED;
+  VkSampleCountFlagBits pass_samples_ = VK_SAMPLE_COUNT_1_BIT;
+  VkExtent2D pass_extent_ = {};
+  VkPipeline bound_pipeline_ = VK_NULL_HANDLE;
+  VkDescriptorSet bound_descriptor_set_ = VK_NULL_HANDLE;
+  uint32_t bound_uniform_offset_ = 0;
+  VkBuffer bound_vertex_buffer_ = VK_NULL_HANDLE;
+
+  uint32_t bound_textures_[2] = {}; // Texture0 and Texture1 of the next draw
+
+  // The uniforms of the previous draw in this frame, repeated uniforms are
+  // bound again at the same offset instead of being copied.
+  Uniforms last_uniforms_;
+  size_t last_uniforms_size_ = 0;
+  BufferRingVulkan::Allocation uniform_allocation_;
+  UniformUploadStats uniform_stats_;
+  UniformUploadStats last_frame_uniform_stats_;
+
+  // Descriptor sets of this frame by (uniform buffer, Texture0, Texture1).
+  typedef std::tuple<VkBuffer, VkImageView, VkImageView> DescriptorSetKey;
+  std::map<DescriptorSetKey, VkDescriptorSet> descriptor_sets_;
+
+  TextureEntry placeholder_; // 1x1 transparent image bound in place of missing textures
+
+  // Tracks estimated GPU memory for every resource type, updated as resources
+  // are created, updated and destroyed.
+  GPUMemoryStats memory_stats_;
+
+  GPUContextVulkan* context_;
+};
+
+}  // namespace ultralight
+
+#endif
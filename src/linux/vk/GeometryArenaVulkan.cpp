@@ -0,0 +1,280 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#include "GeometryArenaVulkan.h"
+#include "GPUContextVulkan.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ultralight {
+
+// Default page sizes, geometry larger than a page gets a dedicated page.
+static const uint32_t kVertexPageBytes = 4 * 1024 * 1024;
+static const uint32_t kIndexPageCount = 256 * 1024;
+
+// Reservations are rounded up to this many elements so that geometry which
+// grows slightly between updates can usually be updated in place.
+static const uint32_t kAllocationGranularity = 4;
+
+static uint32_t RoundUpCount(uint32_t count) {
+  count = std::max(count, 1u);
+  return (count + kAllocationGranularity - 1) / kAllocationGranularity * kAllocationGranularity;
+}
+
+GeometryArenaVulkan::Page::Page(VertexBufferFormat format, uint32_t vertex_capacity,
+  uint32_t index_capacity) : format(format), stride(StrideForFormat(format)),
+  vertices(vertex_capacity), indices(index_capacity) {}
+
+GeometryArenaVulkan::GeometryArenaVulkan(GPUContextVulkan& context) : context_(context) {}
+
+GeometryArenaVulkan::~GeometryArenaVulkan() {
+  // The context waits for the device to go idle before destroying the driver.
+  for (auto& i : pages_) {
+    vkDestroyBuffer(context_.device(), i.second->vertex_buffer, nullptr);
+    vkDestroyBuffer(context_.device(), i.second->index_buffer, nullptr);
+    vkFreeMemory(context_.device(), i.second->memory, nullptr);
+  }
+}
+
+uint32_t GeometryArenaVulkan::StrideForFormat(VertexBufferFormat format) {
+  switch (format) {
+  case VertexBufferFormat::_2f_4ub_2f_2f_28f: return 140;
+  case VertexBufferFormat::_2f_4ub_2f:        return 20;
+  default:                                    return 0;
+  }
+}
+
+GeometryAllocationVulkan GeometryArenaVulkan::Allocate(const VertexBuffer& vertices,
+  const IndexBuffer& indices) {
+  uint32_t stride = StrideForFormat(vertices.format);
+  uint32_t vertex_count = RoundUpCount(vertices.size / stride);
+  uint32_t index_count = RoundUpCount(indices.size / sizeof(uint32_t));
+
+  GeometryAllocationVulkan allocation;
+  allocation.vertex_count = vertex_count;
+  allocation.index_count = index_count;
+
+  Page* page = nullptr;
+  for (auto& i : pages_) {
+    Page& candidate = *i.second;
+    if (candidate.format != vertices.format)
+      continue;
+
+    uint32_t vertex_offset = candidate.vertices.Allocate(vertex_count);
+    if (vertex_offset == RangeAllocator::kInvalidOffset)
+      continue;
+
+    uint32_t index_offset = candidate.indices.Allocate(index_count);
+    if (index_offset == RangeAllocator::kInvalidOffset) {
+      candidate.vertices.Free(vertex_offset, vertex_count);
+      continue;
+    }
+
+    allocation.page_id = i.first;
+    allocation.vertex_offset = vertex_offset;
+    allocation.index_offset = index_offset;
+    page = &candidate;
+    break;
+  }
+
+  if (!page) {
+    uint32_t page_id = next_page_id_;
+    page = CreatePage(vertices.format, vertex_count, index_count);
+    if (!page)
+      return GeometryAllocationVulkan();
+
+    allocation.page_id = page_id;
+    allocation.vertex_offset = page->vertices.Allocate(vertex_count);
+    allocation.index_offset = page->indices.Allocate(index_count);
+  }
+
+  page->allocation_count++;
+  Upload(*page, allocation, vertices, indices);
+  return allocation;
+}
+
+void GeometryArenaVulkan::Update(GeometryAllocationVulkan& allocation, const VertexBuffer& vertices,
+  const IndexBuffer& indices) {
+  auto i = pages_.find(allocation.page_id);
+  if (i != pages_.end() && allocation.last_used_serial <= context_.completed_serial()) {
+    Page& page = *i->second;
+    uint32_t vertex_count = vertices.size / page.stride;
+    uint32_t index_count = indices.size / sizeof(uint32_t);
+    if (page.format == vertices.format && vertex_count <= allocation.vertex_count &&
+        index_count <= allocation.index_count) {
+      Upload(page, allocation, vertices, indices);
+      in_place_updates_++;
+      return;
+    }
+  }
+
+  // Doesn't fit or a frame in flight still reads the old contents. Allocate
+  // the new range before freeing the old one so that the page isn't
+  // destroyed and re-created in between.
+  GeometryAllocationVulkan new_allocation = Allocate(vertices, indices);
+  Free(allocation);
+  allocation = new_allocation;
+  reallocations_++;
+}
+
+void GeometryArenaVulkan::Free(const GeometryAllocationVulkan& allocation) {
+  if (!allocation.page_id)
+    return;
+
+  if (allocation.last_used_serial > context_.completed_serial()) {
+    retired_.push_back(allocation);
+    return;
+  }
+
+  ReleaseRange(allocation);
+}
+
+void GeometryArenaVulkan::Collect(uint64_t completed_serial) {
+  auto completed = std::partition(retired_.begin(), retired_.end(),
+    [completed_serial](const GeometryAllocationVulkan& allocation) {
+      return allocation.last_used_serial > completed_serial;
+    });
+
+  std::vector<GeometryAllocationVulkan> released(completed, retired_.end());
+  retired_.erase(completed, retired_.end());
+
+  for (auto& allocation : released)
+    ReleaseRange(allocation);
+}
+
+GeometryArenaVulkan::Buffers GeometryArenaVulkan::buffers(const GeometryAllocationVulkan& allocation) const {
+  Buffers result;
+  auto i = pages_.find(allocation.page_id);
+  if (i != pages_.end()) {
+    result.vertex_buffer = i->second->vertex_buffer;
+    result.index_buffer = i->second->index_buffer;
+  }
+  return result;
+}
+
+GeometryArenaVulkan::Stats GeometryArenaVulkan::stats() const {
+  Stats result;
+  uint64_t free_vertex_bytes = 0;
+  for (auto& i : pages_) {
+    const Page& page = *i.second;
+    result.page_count++;
+    result.allocation_count += page.allocation_count;
+    uint64_t used_vertices = page.vertices.capacity() - page.vertices.free_count();
+    uint64_t used_indices = page.indices.capacity() - page.indices.free_count();
+    result.used_bytes += used_vertices * page.stride + used_indices * sizeof(uint32_t);
+    free_vertex_bytes += (uint64_t)page.vertices.free_count() * page.stride;
+    result.largest_free_bytes = std::max(result.largest_free_bytes,
+      (uint64_t)page.vertices.largest_free_block() * page.stride);
+  }
+  result.reserved_bytes = reserved_bytes_;
+  if (free_vertex_bytes)
+    result.fragmentation = 1.0 - (double)result.largest_free_bytes / (double)free_vertex_bytes;
+  result.in_place_updates = in_place_updates_;
+  result.reallocations = reallocations_;
+  return result;
+}
+
+GeometryArenaVulkan::Page* GeometryArenaVulkan::CreatePage(VertexBufferFormat format,
+  uint32_t min_vertices, uint32_t min_indices) {
+  uint32_t vertex_capacity = std::max(min_vertices, kVertexPageBytes / StrideForFormat(format));
+  uint32_t index_capacity = std::max(min_indices, kIndexPageCount);
+
+  std::unique_ptr<Page> page(new Page(format, vertex_capacity, index_capacity));
+  VkDevice device = context_.device();
+
+  VkBufferCreateInfo buffer_info = {};
+  buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  buffer_info.size = (VkDeviceSize)vertex_capacity * page->stride;
+  buffer_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+  if (vkCreateBuffer(device, &buffer_info, nullptr, &page->vertex_buffer) != VK_SUCCESS)
+    return nullptr;
+
+  buffer_info.size = (VkDeviceSize)index_capacity * sizeof(uint32_t);
+  buffer_info.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+  if (vkCreateBuffer(device, &buffer_info, nullptr, &page->index_buffer) != VK_SUCCESS) {
+    vkDestroyBuffer(device, page->vertex_buffer, nullptr);
+    return nullptr;
+  }
+
+  // Both buffers share one allocation, the index buffer follows the vertices.
+  VkMemoryRequirements vertex_requirements, index_requirements;
+  vkGetBufferMemoryRequirements(device, page->vertex_buffer, &vertex_requirements);
+  vkGetBufferMemoryRequirements(device, page->index_buffer, &index_requirements);
+
+  VkDeviceSize alignment = index_requirements.alignment;
+  page->index_buffer_offset = (vertex_requirements.size + alignment - 1) / alignment * alignment;
+
+  VkMemoryRequirements requirements = vertex_requirements;
+  requirements.size = page->index_buffer_offset + index_requirements.size;
+  requirements.memoryTypeBits &= index_requirements.memoryTypeBits;
+  page->memory = context_.AllocateMemory(requirements,
+    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+  void* data = nullptr;
+  if (!page->memory ||
+      vkBindBufferMemory(device, page->vertex_buffer, page->memory, 0) != VK_SUCCESS ||
+      vkBindBufferMemory(device, page->index_buffer, page->memory, page->index_buffer_offset) != VK_SUCCESS ||
+      vkMapMemory(device, page->memory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS) {
+    vkDestroyBuffer(device, page->vertex_buffer, nullptr);
+    vkDestroyBuffer(device, page->index_buffer, nullptr);
+    if (page->memory)
+      vkFreeMemory(device, page->memory, nullptr);
+    return nullptr;
+  }
+
+  page->vertex_data = (uint8_t*)data;
+  page->index_data = (uint8_t*)data + page->index_buffer_offset;
+
+  reserved_bytes_ += (uint64_t)vertex_capacity * page->stride + (uint64_t)index_capacity * sizeof(uint32_t);
+  Page* result = page.get();
+  pages_[next_page_id_++] = std::move(page);
+  return result;
+}
+
+void GeometryArenaVulkan::DestroyPage(uint32_t page_id) {
+  auto i = pages_.find(page_id);
+  if (i == pages_.end())
+    return;
+
+  // Earlier frames may still be drawing from the page.
+  Page& page = *i->second;
+  context_.ReleaseWhenFrameComplete(page.vertex_buffer);
+  context_.ReleaseWhenFrameComplete(page.index_buffer);
+  context_.ReleaseWhenFrameComplete(page.memory);
+
+  reserved_bytes_ -= (uint64_t)page.vertices.capacity() * page.stride +
+    (uint64_t)page.indices.capacity() * sizeof(uint32_t);
+  pages_.erase(i);
+}
+
+void GeometryArenaVulkan::ReleaseRange(const GeometryAllocationVulkan& allocation) {
+  auto i = pages_.find(allocation.page_id);
+  if (i == pages_.end())
+    return;
+
+  Page& page = *i->second;
+  page.vertices.Free(allocation.vertex_offset, allocation.vertex_count);
+  page.indices.Free(allocation.index_offset, allocation.index_count);
+  page.allocation_count--;
+
+  if (page.allocation_count)
+    return;
+
+  // Keep one empty page per vertex format around to avoid churning pages
+  // when a single geometry is repeatedly created and destroyed.
+  for (auto& j : pages_) {
+    if (j.first != allocation.page_id && j.second->format == page.format) {
+      DestroyPage(allocation.page_id);
+      return;
+    }
+  }
+}
+
+void GeometryArenaVulkan::Upload(Page& page, const GeometryAllocationVulkan& allocation,
+  const VertexBuffer& vertices, const IndexBuffer& indices) {
+  memcpy(page.vertex_data + (size_t)allocation.vertex_offset * page.stride, vertices.data, vertices.size);
+  memcpy(page.index_data + (size_t)allocation.index_offset * sizeof(uint32_t), indices.data, indices.size);
+}
+
+}  // namespace ultralight
+
+#endif
@@ -0,0 +1,110 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#pragma once
+#include <Ultralight/platform/GPUDriver.h>
+#include "FunctionsVulkan.h"
+#include "RangeAllocator.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace ultralight {
+
+class GPUContextVulkan;
+
+// A geometry's reservation inside a GeometryArenaVulkan page. Offsets and
+// counts are in elements (vertices / 32-bit indices), not bytes.
+struct GeometryAllocationVulkan {
+  uint32_t page_id = 0;
+  uint32_t vertex_offset = 0;
+  uint32_t vertex_count = 0;
+  uint32_t index_offset = 0;
+  uint32_t index_count = 0;
+  uint64_t last_used_serial = 0; // Frame serial of the last draw that read this range
+};
+
+//
+// Sub-allocates geometry out of large host-visible vertex/index buffer pages,
+// the Vulkan counterpart of GeometryArenaGL.
+//
+// Pages are persistently mapped so uploads are a memcpy. A range that a frame
+// still in flight may read is never written: updates to it move the geometry
+// to a new range and the old one is freed once that frame completes.
+//
+class GeometryArenaVulkan {
+public:
+  struct Stats {
+    uint32_t page_count = 0;
+    uint32_t allocation_count = 0;
+    uint64_t reserved_bytes = 0;
+    uint64_t used_bytes = 0;
+    uint64_t largest_free_bytes = 0;
+    double fragmentation = 0.0;
+    uint64_t in_place_updates = 0;
+    uint64_t reallocations = 0;
+  };
+
+  struct Buffers {
+    VkBuffer vertex_buffer = VK_NULL_HANDLE;
+    VkBuffer index_buffer = VK_NULL_HANDLE;
+  };
+
+  explicit GeometryArenaVulkan(GPUContextVulkan& context);
+  ~GeometryArenaVulkan();
+
+  // Bytes per vertex for a vertex format, 0 if the format is unknown.
+  static uint32_t StrideForFormat(VertexBufferFormat format);
+
+  // Returns an allocation with a page_id of 0 if memory is exhausted.
+  GeometryAllocationVulkan Allocate(const VertexBuffer& vertices, const IndexBuffer& indices);
+
+  void Update(GeometryAllocationVulkan& allocation, const VertexBuffer& vertices,
+    const IndexBuffer& indices);
+
+  // The range is reused once the last frame that drew from it completes.
+  void Free(const GeometryAllocationVulkan& allocation);
+
+  // Returns ranges freed by frames that have completed to their pages.
+  void Collect(uint64_t completed_serial);
+
+  Buffers buffers(const GeometryAllocationVulkan& allocation) const;
+
+  uint64_t reserved_bytes() const { return reserved_bytes_; }
+
+  Stats stats() const;
+
+protected:
+  struct Page {
+    Page(VertexBufferFormat format, uint32_t vertex_capacity, uint32_t index_capacity);
+
+    VertexBufferFormat format;
+    uint32_t stride;
+    VkBuffer vertex_buffer = VK_NULL_HANDLE;
+    VkBuffer index_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE; // Backs both buffers
+    VkDeviceSize index_buffer_offset = 0;
+    uint8_t* vertex_data = nullptr;
+    uint8_t* index_data = nullptr;
+    RangeAllocator vertices;
+    RangeAllocator indices;
+    uint32_t allocation_count = 0;
+  };
+
+  Page* CreatePage(VertexBufferFormat format, uint32_t min_vertices, uint32_t min_indices);
+  void DestroyPage(uint32_t page_id);
+  void ReleaseRange(const GeometryAllocationVulkan& allocation);
+  void Upload(Page& page, const GeometryAllocationVulkan& allocation,
+    const VertexBuffer& vertices, const IndexBuffer& indices);
+
+  GPUContextVulkan& context_;
+  std::map<uint32_t, std::unique_ptr<Page>> pages_;
+  std::vector<GeometryAllocationVulkan> retired_; // Ranges waiting for their last frame
+  uint32_t next_page_id_ = 1;
+  uint64_t reserved_bytes_ = 0;
+  uint64_t in_place_updates_ = 0;
+  uint64_t reallocations_ = 0;
+};
+
+}  // namespace ultralight
+
+#endif
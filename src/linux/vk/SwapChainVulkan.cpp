@@ -0,0 +1,268 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#include "SwapChainVulkan.h"
+#include <GLFW/glfw3.h>
+#include <Ultralight/platform/Platform.h>
+#include <Ultralight/platform/Logger.h>
+#include <algorithm>
+#include <string>
+
+namespace ultralight {
+
+static void LogSwapChainError(const char* what, VkResult result) {
+  if (Logger* logger = Platform::instance().logger())
+    logger->LogMessage(LogLevel::Error, (std::string(what) + " failed: " + VkResultString(result)).c_str());
+}
+
+SwapChainVulkan::SwapChainVulkan(GPUContextVulkan& context, GLFWwindow* window)
+  : context_(context), window_(window) {}
+
+SwapChainVulkan::~SwapChainVulkan() {
+  // The context waits for the device to go idle before destroying us.
+  DestroyImages();
+
+  if (swap_chain_)
+    vkDestroySwapchainKHR(context_.device(), swap_chain_, nullptr);
+  if (surface_)
+    vkDestroySurfaceKHR(context_.instance(), surface_, nullptr);
+
+  for (auto semaphore : acquire_semaphores_) {
+    if (semaphore)
+      vkDestroySemaphore(context_.device(), semaphore, nullptr);
+  }
+}
+
+bool SwapChainVulkan::Initialize() {
+  VkResult result = glfwCreateWindowSurface(context_.instance(), window_, nullptr, &surface_);
+  if (result != VK_SUCCESS) {
+    LogSwapChainError("glfwCreateWindowSurface", result);
+    return false;
+  }
+
+  VkBool32 supported = VK_FALSE;
+  vkGetPhysicalDeviceSurfaceSupportKHR(context_.physical_device(), context_.queue_family(),
+    surface_, &supported);
+  if (!supported)
+    return false;
+
+  uint32_t format_count = 0;
+  vkGetPhysicalDeviceSurfaceFormatsKHR(context_.physical_device(), surface_, &format_count, nullptr);
+  std::vector<VkSurfaceFormatKHR> formats(format_count);
+  vkGetPhysicalDeviceSurfaceFormatsKHR(context_.physical_device(), surface_, &format_count, formats.data());
+  if (formats.empty())
+    return false;
+
+  // The GL backend writes to a non-sRGB default framebuffer, match it.
+  format_ = formats[0].format == VK_FORMAT_UNDEFINED ? VK_FORMAT_B8G8R8A8_UNORM : formats[0].format;
+  color_space_ = formats[0].colorSpace;
+  for (auto& format : formats) {
+    if (format.format == VK_FORMAT_B8G8R8A8_UNORM || format.format == VK_FORMAT_R8G8B8A8_UNORM) {
+      format_ = format.format;
+      color_space_ = format.colorSpace;
+      break;
+    }
+  }
+
+  VkSemaphoreCreateInfo semaphore_info = {};
+  semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  for (auto& semaphore : acquire_semaphores_) {
+    if (vkCreateSemaphore(context_.device(), &semaphore_info, nullptr, &semaphore) != VK_SUCCESS)
+      return false;
+  }
+
+  return CreateSwapChain();
+}
+
+bool SwapChainVulkan::AcquireNextImage() {
+  image_acquired_ = false;
+  image_drawn_ = false;
+
+  int width = 0, height = 0;
+  glfwGetFramebufferSize(window_, &width, &height);
+  if (!width || !height)
+    return false;
+
+  if (needs_recreate_ || !swap_chain_ || (uint32_t)width != extent_.width ||
+      (uint32_t)height != extent_.height) {
+    if (!CreateSwapChain())
+      return false;
+  }
+
+  // The semaphore of this frame slot was last waited on by the slot's
+  // previous submission, which the context has already waited for.
+  acquire_frame_index_ = context_.frame_index();
+  VkResult result = vkAcquireNextImageKHR(context_.device(), swap_chain_, UINT64_MAX,
+    acquire_semaphore(), VK_NULL_HANDLE, &image_index_);
+  if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+    needs_recreate_ = true;
+    return false;
+  }
+
+  if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+    LogSwapChainError("vkAcquireNextImageKHR", result);
+    return false;
+  }
+
+  needs_recreate_ = result == VK_SUBOPTIMAL_KHR;
+  image_acquired_ = true;
+  return true;
+}
+
+void SwapChainVulkan::Present() {
+  if (!image_acquired_)
+    return;
+
+  VkSemaphore wait_semaphore = render_finished_semaphore();
+  VkPresentInfoKHR present_info = {};
+  present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+  present_info.waitSemaphoreCount = 1;
+  present_info.pWaitSemaphores = &wait_semaphore;
+  present_info.swapchainCount = 1;
+  present_info.pSwapchains = &swap_chain_;
+  present_info.pImageIndices = &image_index_;
+
+  VkResult result = vkQueuePresentKHR(context_.queue(), &present_info);
+  if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+    needs_recreate_ = true;
+  else if (result != VK_SUCCESS)
+    LogSwapChainError("vkQueuePresentKHR", result);
+
+  image_acquired_ = false;
+}
+
+bool SwapChainVulkan::CreateSwapChain() {
+  VkSurfaceCapabilitiesKHR capabilities;
+  vkGetPhysicalDeviceSurfaceCapabilitiesKHR(context_.physical_device(), surface_, &capabilities);
+
+  VkExtent2D extent = capabilities.currentExtent;
+  if (extent.width == UINT32_MAX) {
+    int width = 0, height = 0;
+    glfwGetFramebufferSize(window_, &width, &height);
+    extent.width = std::min(std::max((uint32_t)width, capabilities.minImageExtent.width),
+      capabilities.maxImageExtent.width);
+    extent.height = std::min(std::max((uint32_t)height, capabilities.minImageExtent.height),
+      capabilities.maxImageExtent.height);
+  }
+
+  if (!extent.width || !extent.height)
+    return false;
+
+  uint32_t mode_count = 0;
+  vkGetPhysicalDeviceSurfacePresentModesKHR(context_.physical_device(), surface_, &mode_count, nullptr);
+  std::vector<VkPresentModeKHR> modes(mode_count);
+  vkGetPhysicalDeviceSurfacePresentModesKHR(context_.physical_device(), surface_, &mode_count, modes.data());
+
+  // FIFO is the only mode that is always supported.
+  VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
+  if (!context_.enable_vsync()) {
+    if (std::find(modes.begin(), modes.end(), VK_PRESENT_MODE_MAILBOX_KHR) != modes.end())
+      present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
+    else if (std::find(modes.begin(), modes.end(), VK_PRESENT_MODE_IMMEDIATE_KHR) != modes.end())
+      present_mode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+  }
+
+  uint32_t image_count = capabilities.minImageCount + 1;
+  if (capabilities.maxImageCount)
+    image_count = std::min(image_count, capabilities.maxImageCount);
+
+  VkCompositeAlphaFlagBitsKHR composite_alpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+  if (!(capabilities.supportedCompositeAlpha & composite_alpha))
+    composite_alpha = (VkCompositeAlphaFlagBitsKHR)(capabilities.supportedCompositeAlpha &
+      ~(capabilities.supportedCompositeAlpha - 1));
+
+  // Frames in flight may still render to the old images.
+  vkDeviceWaitIdle(context_.device());
+  DestroyImages();
+
+  VkSwapchainKHR old_swap_chain = swap_chain_;
+
+  VkSwapchainCreateInfoKHR create_info = {};
+  create_info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+  create_info.surface = surface_;
+  create_info.minImageCount = image_count;
+  create_info.imageFormat = format_;
+  create_info.imageColorSpace = color_space_;
+  create_info.imageExtent = extent;
+  create_info.imageArrayLayers = 1;
+  create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  create_info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  create_info.preTransform = capabilities.currentTransform;
+  create_info.compositeAlpha = composite_alpha;
+  create_info.presentMode = present_mode;
+  create_info.clipped = VK_TRUE;
+  create_info.oldSwapchain = old_swap_chain;
+
+  VkResult result = vkCreateSwapchainKHR(context_.device(), &create_info, nullptr, &swap_chain_);
+  if (old_swap_chain)
+    vkDestroySwapchainKHR(context_.device(), old_swap_chain, nullptr);
+  if (result != VK_SUCCESS) {
+    swap_chain_ = VK_NULL_HANDLE;
+    LogSwapChainError("vkCreateSwapchainKHR", result);
+    return false;
+  }
+
+  extent_ = extent;
+  needs_recreate_ = false;
+
+  uint32_t count = 0;
+  vkGetSwapchainImagesKHR(context_.device(), swap_chain_, &count, nullptr);
+  std::vector<VkImage> images(count);
+  vkGetSwapchainImagesKHR(context_.device(), swap_chain_, &count, images.data());
+
+  VkRenderPass render_pass = context_.GetRenderPass(format_, VK_SAMPLE_COUNT_1_BIT, false);
+  images_.resize(count);
+  for (uint32_t i = 0; i < count; i++) {
+    Image& image = images_[i];
+    image.image = images[i];
+
+    VkImageViewCreateInfo view_info = {};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = image.image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = format_;
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.layerCount = 1;
+    if (vkCreateImageView(context_.device(), &view_info, nullptr, &image.view) != VK_SUCCESS) {
+      needs_recreate_ = true;
+      return false;
+    }
+
+    VkFramebufferCreateInfo framebuffer_info = {};
+    framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebuffer_info.renderPass = render_pass;
+    framebuffer_info.attachmentCount = 1;
+    framebuffer_info.pAttachments = &image.view;
+    framebuffer_info.width = extent_.width;
+    framebuffer_info.height = extent_.height;
+    framebuffer_info.layers = 1;
+    if (vkCreateFramebuffer(context_.device(), &framebuffer_info, nullptr, &image.framebuffer) != VK_SUCCESS) {
+      needs_recreate_ = true;
+      return false;
+    }
+
+    VkSemaphoreCreateInfo semaphore_info = {};
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    if (vkCreateSemaphore(context_.device(), &semaphore_info, nullptr, &image.render_finished) != VK_SUCCESS) {
+      needs_recreate_ = true;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void SwapChainVulkan::DestroyImages() {
+  for (auto& image : images_) {
+    if (image.framebuffer)
+      vkDestroyFramebuffer(context_.device(), image.framebuffer, nullptr);
+    if (image.view)
+      vkDestroyImageView(context_.device(), image.view, nullptr);
+    if (image.render_finished)
+      vkDestroySemaphore(context_.device(), image.render_finished, nullptr);
+  }
+  images_.clear();
+}
+
+}  // namespace ultralight
+
+#endif
@@ -0,0 +1,83 @@
+#if defined(APPCORE_ENABLE_VULKAN)
+#pragma once
+#include "FunctionsVulkan.h"
+#include "GPUContextVulkan.h"
+#include <cstdint>
+#include <vector>
+
+typedef struct GLFWwindow GLFWwindow;
+
+namespace ultralight {
+
+//
+// The surface and swap chain of a window. The swap chain is re-created when
+// the window's framebuffer size changes or presentation reports it out of
+// date.
+//
+class SwapChainVulkan {
+public:
+  SwapChainVulkan(GPUContextVulkan& context, GLFWwindow* window);
+
+  ~SwapChainVulkan();
+
+  // Creates the surface and the initial swap chain.
+  bool Initialize();
+
+  // Acquires the image the next frame renders to. Returns false if there is
+  // nothing to present to (eg, the window is minimized), draws to render
+  // buffer 0 are skipped for the frame then.
+  bool AcquireNextImage();
+
+  // Queues the acquired image for presentation, the frame that rendered to
+  // it must have been submitted with render_finished_semaphore().
+  void Present();
+
+  bool image_acquired() const { return image_acquired_; }
+
+  // Whether a render pass has drawn to the acquired image yet. The first
+  // pass of a frame clears it.
+  bool image_drawn() const { return image_drawn_; }
+  void set_image_drawn() { image_drawn_ = true; }
+
+  // Signalled when the acquired image is ready to be rendered to.
+  VkSemaphore acquire_semaphore() const { return acquire_semaphores_[acquire_frame_index_]; }
+
+  // Signalled by the frame that renders the acquired image, waited on by Present().
+  VkSemaphore render_finished_semaphore() const { return images_[image_index_].render_finished; }
+
+  VkFramebuffer framebuffer() const { return images_[image_index_].framebuffer; }
+
+  VkFormat format() const { return format_; }
+
+  VkExtent2D extent() const { return extent_; }
+
+protected:
+  bool CreateSwapChain();
+  void DestroyImages();
+
+  struct Image {
+    VkImage image = VK_NULL_HANDLE; // Owned by the swap chain
+    VkImageView view = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    VkSemaphore render_finished = VK_NULL_HANDLE;
+  };
+
+  GPUContextVulkan& context_;
+  GLFWwindow* window_;
+  VkSurfaceKHR surface_ = VK_NULL_HANDLE;
+  VkSwapchainKHR swap_chain_ = VK_NULL_HANDLE;
+  VkFormat format_ = VK_FORMAT_UNDEFINED;
+  VkColorSpaceKHR color_space_ = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+  VkExtent2D extent_ = {};
+  std::vector<Image> images_;
+  VkSemaphore acquire_semaphores_[GPUContextVulkan::kFrameCount] = {};
+  uint32_t acquire_frame_index_ = 0;
+  uint32_t image_index_ = 0;
+  bool image_acquired_ = false;
+  bool image_drawn_ = false;
+  bool needs_recreate_ = false;
+};
+
+}  // namespace ultralight
+
+#endif
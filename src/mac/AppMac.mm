@@ -150,7 +150,11 @@ AppMac::AppMac(Settings settings, Config config) {
     std::string bundle_resource_path_str = bundle_resource_path.utf8().data();
     std::filesystem::path file_system_path = bundle_resource_path_str / std::filesystem::path(fs_str);
 
-    Platform::instance().set_file_system(GetPlatformFileSystem(file_system_path.string().c_str()));
+    std::string archive_str = settings.file_system_archive.utf8().data();
+    std::filesystem::path archive_path = bundle_resource_path_str / std::filesystem::path(archive_str);
+
+    FileSystem* file_system = GetPlatformFileSystem(file_system_path.string().c_str());
+    Platform::instance().set_file_system(LayerFileSystems(file_system, archive_path.string().c_str()));
     
     //std::ostringstream info;
     //info << "File system base directory resolved to: " <<
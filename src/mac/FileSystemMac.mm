@@ -109,9 +109,20 @@ bool FileSystemMac::FileExists(const String& path) {
 
 String FileSystemMac::GetFileMimeType(const String& file_path) {
     String8 utf8 = file_path.utf8();
-    std::string filepath(utf8.data(), utf8.length()); 
-    std::string ext = filepath.substr(filepath.find_last_of(".") + 1);
-    return String(FileUtils::FileExtensionToMimeType(ext.c_str()));
+    std::string_view filepath(utf8.data(), utf8.length());
+    if (const char* mime_type = FileUtils::LookupMimeType(FileUtils::FileExtension(filepath)))
+        return String(mime_type);
+
+    // Missing or unknown extension, look at the contents instead.
+    char head[FileUtils::kMimeSniffLength];
+    ssize_t length = 0;
+    std::string fsRep = fileSystemRepresentation(getRelative(file_path.utf16()));
+    int file_handle = fsRep.empty() ? -1 : open(fsRep.data(), O_RDONLY);
+    if (file_handle != -1) {
+        length = pread(file_handle, head, sizeof(head), 0);
+        close(file_handle);
+    }
+    return String(FileUtils::FileMimeType(filepath, head, length > 0 ? (size_t)length : 0));
 }
 
 String FileSystemMac::GetFileCharset(const String& file_path) {
@@ -94,7 +94,12 @@ AppWin::AppWin(Settings settings, Config config)
 
         std::filesystem::path file_system_path = module_path / std::filesystem::path(fs_str);
 
-        Platform::instance().set_file_system(GetPlatformFileSystem(file_system_path.string().c_str()));
+        std::wstring archive_str = settings.file_system_archive.utf16().data();
+        std::replace(archive_str.begin(), archive_str.end(), L'/', L'\\');
+        std::filesystem::path archive_path = module_path / std::filesystem::path(archive_str);
+
+        FileSystem* file_system = GetPlatformFileSystem(file_system_path.string().c_str());
+        Platform::instance().set_file_system(LayerFileSystems(file_system, archive_path.string().c_str()));
 
         info.clear();
         info << "File system base directory resolved to: " << file_system_path.string().c_str();
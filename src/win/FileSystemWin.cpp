@@ -68,9 +68,21 @@ bool FileSystemWin::FileExists(const String& path) {
 
 String FileSystemWin::GetFileMimeType(const String& file_path) {
   String8 utf8 = file_path.utf8();
-  std::string filepath(utf8.data(), utf8.length());
-  std::string ext = filepath.substr(filepath.find_last_of(".") + 1);
-  return String(FileUtils::FileExtensionToMimeType(ext.c_str()));
+  std::string_view filepath(utf8.data(), utf8.length());
+  if (const char* mime_type = FileUtils::LookupMimeType(FileUtils::FileExtension(filepath)))
+    return String(mime_type);
+
+  // Missing or unknown extension, look at the contents instead.
+  char head[FileUtils::kMimeSniffLength];
+  DWORD length = 0;
+  HANDLE hFile = CreateFile(GetRelative(file_path).get(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+  if (hFile != INVALID_HANDLE_VALUE) {
+    if (!ReadFile(hFile, head, sizeof(head), &length, NULL))
+      length = 0;
+    CloseHandle(hFile);
+  }
+  return String(FileUtils::FileMimeType(filepath, head, length));
 }
 
 String FileSystemWin::GetFileCharset(const String& file_path) { return "utf-8"; }
@@ -0,0 +1,177 @@
+// Throughput of AsyncFileReaderLinux's backends against blocking reads.
+//
+// Two workloads are written to a temporary directory: many small files (the
+// shape of a web app's assets) and a few large ones. Each is then read in
+// full through the io_uring backend, the thread pool backend and a plain
+// open()/pread() loop on one thread.
+//
+// The files are in the page cache after being written, so this measures the
+// submission overhead. Run as root with --drop-caches to evict them before
+// every pass and measure cold reads instead.
+//
+// Usage: AsyncFileReaderBenchmark [--drop-caches] [directory]
+#include "AsyncFileReaderLinux.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ultralight;
+
+namespace {
+
+struct Workload {
+  const char* name;
+  size_t file_count;
+  size_t file_size;
+};
+
+const Workload kWorkloads[] = {
+  { "many small files", 4000, 16 * 1024 },
+  { "few large files", 8, 32 * 1024 * 1024 },
+};
+
+const int kPasses = 5;
+
+bool WriteFiles(const std::string& directory, const Workload& workload, std::vector<std::string>& paths) {
+  std::vector<char> contents(workload.file_size, 'x');
+  for (size_t i = 0; i < workload.file_count; i++) {
+    std::string path = directory + "/" + std::to_string(workload.file_size) + "_" + std::to_string(i);
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+      return false;
+    bool written = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    if (fclose(file) != 0 || !written)
+      return false;
+    paths.push_back(path);
+  }
+  return true;
+}
+
+void DropCaches() {
+  sync();
+  FILE* file = fopen("/proc/sys/vm/drop_caches", "w");
+  if (!file) {
+    printf("can't drop caches (not root?), measuring warm reads\n");
+    return;
+  }
+  fputs("3\n", file);
+  fclose(file);
+}
+
+// Allocates a buffer per file like the readers do, so page faults weigh
+// the same on every row.
+size_t ReadBlocking(const std::vector<std::string>& paths) {
+  size_t total = 0;
+  for (const std::string& path : paths) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      continue;
+    struct stat file_info;
+    char* data;
+    if (fstat(fd, &file_info) == 0 && (data = (char*)malloc((size_t)file_info.st_size + 1))) {
+      size_t size = (size_t)file_info.st_size;
+      size_t offset = 0;
+      ssize_t result;
+      while (offset < size && (result = pread(fd, data + offset, size - offset, (off_t)offset)) > 0)
+        offset += (size_t)result;
+      total += offset;
+      free(data);
+    }
+    close(fd);
+  }
+  return total;
+}
+
+size_t ReadAsync(AsyncFileReaderLinux& reader, const std::vector<std::string>& paths) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t remaining = paths.size();
+  size_t total = 0;
+  for (const std::string& path : paths) {
+    reader.ReadFile(path, [&](RefPtr<Buffer> buffer) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (buffer)
+        total += buffer->size();
+      if (--remaining == 0)
+        cv.notify_one();
+    });
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&] { return remaining == 0; });
+  return total;
+}
+
+template <typename Read>
+void Measure(const char* method, const std::vector<std::string>& paths, bool drop_caches, Read read) {
+  double best = 0;
+  size_t bytes = 0;
+  for (int pass = 0; pass < kPasses; pass++) {
+    if (drop_caches)
+      DropCaches();
+    auto start = std::chrono::steady_clock::now();
+    bytes = read(paths);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (pass == 0 || seconds < best)
+      best = seconds;
+  }
+  printf("  %-12s %8.2f ms %10.1f MiB/s %10.0f files/s\n", method, best * 1000.0,
+         bytes / (1024.0 * 1024.0) / best, paths.size() / best);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool drop_caches = false;
+  std::string directory;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--drop-caches") == 0)
+      drop_caches = true;
+    else
+      directory = argv[i];
+  }
+
+  bool remove_directory = directory.empty();
+  if (remove_directory) {
+    char temp[] = "/tmp/AsyncFileReaderBenchmark.XXXXXX";
+    if (!mkdtemp(temp)) {
+      printf("can't create a temporary directory\n");
+      return 1;
+    }
+    directory = temp;
+  }
+
+  AsyncFileReaderLinux uring(AsyncFileReaderLinux::Backend::IoUring);
+  AsyncFileReaderLinux pool(AsyncFileReaderLinux::Backend::ThreadPool);
+  if (uring.backend() != AsyncFileReaderLinux::Backend::IoUring)
+    printf("io_uring is unavailable, its row uses the thread pool\n");
+
+  int result = 0;
+  for (const Workload& workload : kWorkloads) {
+    std::vector<std::string> paths;
+    if (!WriteFiles(directory, workload, paths)) {
+      printf("can't write files to %s\n", directory.c_str());
+      result = 1;
+    } else {
+      printf("%s (%zu x %zu KiB), best of %d:\n", workload.name, workload.file_count, workload.file_size / 1024,
+             kPasses);
+      Measure("io_uring", paths, drop_caches, [&](const std::vector<std::string>& p) { return ReadAsync(uring, p); });
+      Measure("thread pool", paths, drop_caches, [&](const std::vector<std::string>& p) { return ReadAsync(pool, p); });
+      Measure("blocking", paths, drop_caches, ReadBlocking);
+    }
+
+    for (const std::string& path : paths)
+      unlink(path.c_str());
+  }
+
+  if (remove_directory)
+    rmdir(directory.c_str());
+  return result;
+}
@@ -0,0 +1,100 @@
+// Fallback font ranking of FontCoverageIndex, over hand-built indexes so the
+// results don't depend on the fonts installed.
+#include "FontCoverageIndex.h"
+#include <fontconfig/fontconfig.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace ultralight;
+
+namespace {
+
+struct TestFace {
+  const char* family;
+  bool italic;
+  bool bold;
+  std::u32string coverage;
+};
+
+// Lays faces out the way Build() does, in the given preference order.
+class TestIndex : public FontCoverageIndex {
+public:
+  explicit TestIndex(const std::vector<TestFace>& faces) {
+    for (const TestFace& test_face : faces) {
+      auto family = std::find(families_.begin(), families_.end(), test_face.family);
+      if (family == families_.end())
+        family = families_.insert(families_.end(), test_face.family);
+
+      uint32_t face = (uint32_t)faces_.size();
+      faces_.push_back({ (uint32_t)(family - families_.begin()), test_face.italic, test_face.bold });
+
+      for (char32_t c : test_face.coverage) {
+        auto page = std::find_if(pages_.begin(), pages_.end(), [&](const Page& page) {
+          return page.page == (uint32_t)(c >> 8) && page.face == face;
+        });
+        if (page == pages_.end()) {
+          pages_.push_back({ (uint32_t)(c >> 8), face, {} });
+          page = pages_.end() - 1;
+        }
+        page->bits[(c >> 5) & 7] |= 1u << (c & 31);
+      }
+    }
+
+    std::sort(pages_.begin(), pages_.end(), [](const Page& a, const Page& b) {
+      return a.page != b.page ? a.page < b.page : a.face < b.face;
+    });
+  }
+};
+
+const char32_t kEmoji[] = U"\U0001F600";
+const char32_t kCJK[] = U"中文字体";
+
+int failures = 0;
+
+void Expect(const char* name, const FontCoverageIndex& index, const std::u32string& text, int weight,
+            bool italic, const char* expected) {
+  const std::string* family = index.FallbackFamily(text.data(), text.size(), weight, italic);
+  const char* actual = family ? family->c_str() : "(none)";
+  bool passed = strcmp(actual, expected) == 0;
+  printf("%s: %s", name, passed ? "passed\n" : "FAILED");
+  if (!passed) {
+    printf(" (expected %s, got %s)\n", expected, actual);
+    failures++;
+  }
+}
+
+}  // namespace
+
+int main() {
+  // The emoji font is preferred but covers one character, the CJK font
+  // covers the other four.
+  TestIndex mixed({
+    { "Emoji", false, false, kEmoji },
+    { "Latin", false, false, U"abc" },
+    { "CJK", false, false, kCJK },
+  });
+  Expect("emoji_then_cjk", mixed, std::u32string(kEmoji) + kCJK, FC_WEIGHT_REGULAR, false, "CJK");
+  Expect("cjk_then_emoji", mixed, std::u32string(kCJK) + kEmoji, FC_WEIGHT_REGULAR, false, "CJK");
+  Expect("emoji_only", mixed, kEmoji, FC_WEIGHT_REGULAR, false, "Emoji");
+  Expect("uncovered_ignored", mixed, U"؀" + std::u32string(kCJK), FC_WEIGHT_REGULAR, false, "CJK");
+  Expect("nothing_covered", mixed, U"؀؁", FC_WEIGHT_REGULAR, false, "(none)");
+
+  // Equal coverage goes to the matching style, then to the preferred face.
+  TestIndex styles({
+    { "Regular", false, false, kCJK },
+    { "Bold", false, true, kCJK },
+  });
+  Expect("style_breaks_ties", styles, kCJK, FC_WEIGHT_BOLD, false, "Bold");
+  Expect("preference_breaks_ties", styles, kCJK, FC_WEIGHT_REGULAR, true, "Regular");
+
+  TestIndex partial({
+    { "Regular", false, false, kCJK },
+    { "Partial Bold", false, true, U"中" },
+  });
+  Expect("coverage_beats_style", partial, kCJK, FC_WEIGHT_BOLD, false, "Regular");
+
+  return failures ? 1 : 0;
+}
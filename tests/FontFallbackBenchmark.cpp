@@ -0,0 +1,139 @@
+// Fallback font lookups through FontCoverageIndex against the FcFontMatch
+// call FontLoaderLinux used before, over the fonts installed on this machine.
+//
+// Requests are short runs of text from one script (Latin, Greek, Cyrillic,
+// Arabic, Hebrew, Devanagari, CJK, Hangul, emoji, symbols) or mixing emoji
+// with CJK. Also reports how long the index takes to build and its size.
+//
+// Usage: FontFallbackBenchmark [requests]
+#include "FontCoverageIndex.h"
+#include <fontconfig/fontconfig.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace ultralight;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double Microseconds(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+struct Range {
+  char32_t first, last;
+};
+
+const Range kScripts[] = {
+  { 0x0100, 0x017F },   // Latin Extended-A
+  { 0x0391, 0x03C9 },   // Greek
+  { 0x0410, 0x044F },   // Cyrillic
+  { 0x0627, 0x064A },   // Arabic
+  { 0x05D0, 0x05EA },   // Hebrew
+  { 0x0905, 0x0939 },   // Devanagari
+  { 0x4E00, 0x9FFF },   // CJK
+  { 0xAC00, 0xD7A3 },   // Hangul
+  { 0x1F600, 0x1F64F }, // Emoji
+  { 0x2190, 0x21FF },   // Arrows
+};
+
+const size_t kScriptCount = sizeof(kScripts) / sizeof(kScripts[0]);
+const Range kEmoji = kScripts[8];
+const Range kCJK = kScripts[6];
+
+std::vector<std::u32string> MakeRequests(size_t count) {
+  std::vector<std::u32string> requests;
+  uint32_t seed = 1;
+  auto random_char = [&](const Range& range) {
+    seed = seed * 1103515245 + 12345;
+    return (char32_t)(range.first + (seed >> 8) % (range.last - range.first + 1));
+  };
+
+  for (size_t i = 0; i < count; i++) {
+    std::u32string text;
+    if (i % (kScriptCount + 1) == kScriptCount) {
+      // An emoji followed by CJK, the fallback has to cover the CJK.
+      text += random_char(kEmoji);
+      for (int j = 0; j < 4; j++)
+        text += random_char(kCJK);
+    } else {
+      const Range& script = kScripts[i % (kScriptCount + 1)];
+      for (size_t j = 0; j <= i % 3; j++)
+        text += random_char(script);
+    }
+    requests.push_back(text);
+  }
+  return requests;
+}
+
+// What FontLoaderLinux did before the index.
+std::string MatchFamily(const std::u32string& text) {
+  FcCharSet* charset = FcCharSetCreate();
+  for (char32_t c : text)
+    FcCharSetAddChar(charset, c);
+  FcPattern* pattern = FcPatternCreate();
+  FcPatternAddCharSet(pattern, FC_CHARSET, charset);
+  FcPatternAddInteger(pattern, FC_SLANT, FC_SLANT_ROMAN);
+  FcPatternAddInteger(pattern, FC_WEIGHT, FC_WEIGHT_REGULAR);
+  FcPatternAddDouble(pattern, FC_PIXEL_SIZE, 12.0);
+
+  std::string family;
+  FcResult result;
+  if (FcPattern* match = FcFontMatch(nullptr, pattern, &result)) {
+    FcChar8* name;
+    if (FcPatternGetString(match, FC_FAMILY, 0, &name) == FcResultMatch)
+      family = (const char*)name;
+    FcPatternDestroy(match);
+  }
+  FcPatternDestroy(pattern);
+  FcCharSetDestroy(charset);
+  return family;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 3000;
+  if (!count)
+    count = 1;
+  std::vector<std::u32string> requests = MakeRequests(count);
+
+  FcInit();
+  Clock::time_point start = Clock::now();
+  std::shared_ptr<const FontCoverageIndex> index = FontCoverageIndex::Build();
+  double build_time = Microseconds(start);
+  if (!index) {
+    printf("fontconfig lists no usable fonts\n");
+    return 1;
+  }
+
+  printf("%zu faces, %zu families, %zu pages\n", index->face_count(), index->family_count(),
+         index->page_count());
+  printf("  build          %8.2f ms\n", build_time / 1000.0);
+  printf("  memory         %8.1f KiB\n", index->memory_usage() / 1024.0);
+
+  start = Clock::now();
+  size_t matched = 0;
+  for (const std::u32string& text : requests)
+    matched += MatchFamily(text).empty() ? 0 : 1;
+  double match_time = Microseconds(start) / requests.size();
+
+  // Repeated, a pass is too quick to time on its own.
+  const int kPasses = 20;
+  start = Clock::now();
+  size_t found = 0;
+  for (int pass = 0; pass < kPasses; pass++) {
+    for (const std::u32string& text : requests)
+      found += index->FallbackFamily(text.data(), text.size(), FC_WEIGHT_REGULAR, false) ? 1 : 0;
+  }
+  double index_time = Microseconds(start) / (kPasses * requests.size());
+
+  printf("%zu requests (%zu covered by some font):\n", requests.size(), found / kPasses);
+  printf("  FcFontMatch    %8.3f us/request\n", match_time);
+  printf("  index          %8.3f us/request\n", index_time);
+  return matched ? 0 : 1;
+}
@@ -0,0 +1,334 @@
+// Golden-image tests for the software GPU driver.
+//
+// Each scene is a hand-built command list drawn through the exported
+// SoftwareGPUDriver at several worker counts. Every run must match
+// golden/<scene>.pam (a netpbm RGB_ALPHA image) byte for byte.
+//
+// Run with --update to rewrite the golden images after an intended change,
+// then review them before committing.
+#include <AppCore/SoftwareGPUDriver.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace ultralight;
+
+namespace {
+
+const uint32_t kSize = 64;
+
+// FillType values read from data0.x by the fill shader.
+const float kFillSolid = 0.0f;
+const float kFillImage = 1.0f;
+
+struct Quad {
+  float left, top, right, bottom;
+  uint8_t color[4]; // RGBA, premultiplied
+  float fill_type;
+  float tex[4];     // Texture coordinates of the left, top, right and bottom edges
+};
+
+class SceneBuilder {
+public:
+  explicit SceneBuilder(GPUDriver* gpu) : gpu_(gpu) {}
+
+  GPUDriver* gpu() { return gpu_; }
+
+  uint32_t CreateTarget() {
+    uint32_t texture_id = gpu_->NextTextureId();
+    // No pixels, like the renderer's render target textures.
+    gpu_->CreateTexture(texture_id,
+                        Bitmap::Create(kSize, kSize, BitmapFormat::BGRA8_UNORM_SRGB, 0, nullptr, 0, false));
+    uint32_t render_buffer_id = gpu_->NextRenderBufferId();
+    RenderBuffer buffer = {};
+    buffer.texture_id = texture_id;
+    buffer.width = kSize;
+    buffer.height = kSize;
+    gpu_->CreateRenderBuffer(render_buffer_id, buffer);
+    target_texture_id_ = texture_id;
+    render_buffer_id_ = render_buffer_id;
+    return texture_id;
+  }
+
+  uint32_t CreateCheckerTexture(uint32_t size) {
+    RefPtr<Bitmap> bitmap = Bitmap::Create(size, size, BitmapFormat::BGRA8_UNORM_SRGB);
+    uint8_t* pixels = (uint8_t*)bitmap->LockPixels();
+    for (uint32_t y = 0; y < size; y++) {
+      for (uint32_t x = 0; x < size; x++) {
+        uint8_t* p = pixels + y * bitmap->row_bytes() + x * 4;
+        bool dark = ((x + y) & 1) != 0;
+        p[0] = dark ? 0x40 : 0xF0;
+        p[1] = dark ? 0x20 : 0xC0;
+        p[2] = dark ? 0x10 : 0x30;
+        p[3] = 0xFF;
+      }
+    }
+    bitmap->UnlockPixels();
+    uint32_t texture_id = gpu_->NextTextureId();
+    gpu_->CreateTexture(texture_id, bitmap);
+    return texture_id;
+  }
+
+  void Clear() {
+    Command cmd = {};
+    cmd.command_type = CommandType::ClearRenderBuffer;
+    cmd.gpu_state = State(ShaderType::Fill);
+    commands_.push_back(cmd);
+  }
+
+  void DrawQuad(const Quad& quad, uint32_t texture_1_id = 0) {
+    Vertex_2f_4ub_2f_2f_28f v[4] = {};
+    const float corners[4][2] = { { quad.left, quad.top }, { quad.right, quad.top },
+                                  { quad.right, quad.bottom }, { quad.left, quad.bottom } };
+    const float tex[4][2] = { { quad.tex[0], quad.tex[1] }, { quad.tex[2], quad.tex[1] },
+                              { quad.tex[2], quad.tex[3] }, { quad.tex[0], quad.tex[3] } };
+    for (int i = 0; i < 4; i++) {
+      memcpy(v[i].pos, corners[i], sizeof(v[i].pos));
+      memcpy(v[i].color, quad.color, sizeof(v[i].color));
+      memcpy(v[i].tex, tex[i], sizeof(v[i].tex));
+      memcpy(v[i].obj, corners[i], sizeof(v[i].obj));
+      v[i].data0[0] = quad.fill_type;
+    }
+
+    GPUState state = State(ShaderType::Fill);
+    state.texture_1_id = texture_1_id;
+    AddDraw(VertexBufferFormat::_2f_4ub_2f_2f_28f, v, sizeof(v), state);
+  }
+
+  void DrawTriangle(const float points[3][2], const uint8_t color[4]) {
+    Vertex_2f_4ub_2f v[4] = {};
+    for (int i = 0; i < 3; i++) {
+      memcpy(v[i].pos, points[i], sizeof(v[i].pos));
+      memcpy(v[i].color, color, sizeof(v[i].color));
+      memcpy(v[i].obj, points[i], sizeof(v[i].obj));
+    }
+    // Degenerate fourth vertex keeps the index layout the same as quads.
+    v[3] = v[2];
+    AddDraw(VertexBufferFormat::_2f_4ub_2f, v, sizeof(v), State(ShaderType::FillPath));
+  }
+
+  void Submit() {
+    CommandList list;
+    list.size = (uint32_t)commands_.size();
+    list.commands = commands_.data();
+    gpu_->UpdateCommandList(list);
+    commands_.clear();
+  }
+
+  uint32_t target_texture_id() const { return target_texture_id_; }
+
+protected:
+  GPUState State(ShaderType shader_type) const {
+    GPUState state = {};
+    state.viewport_width = kSize;
+    state.viewport_height = kSize;
+    for (int i = 0; i < 16; i++)
+      state.transform.data[i] = (i % 5) == 0 ? 1.0f : 0.0f;
+    state.enable_blend = true;
+    state.blend_src_factor = BlendFactor::One;
+    state.blend_dst_factor = BlendFactor::InvSrcAlpha;
+    state.blend_equation = BlendEquation::Add;
+    state.shader_type = (uint8_t)shader_type;
+    state.render_buffer_id = render_buffer_id_;
+    return state;
+  }
+
+  void AddDraw(VertexBufferFormat format, void* vertices, size_t size, const GPUState& state) {
+    IndexType indices[6] = { 0, 1, 2, 0, 2, 3 };
+    VertexBuffer vertex_buffer = {};
+    vertex_buffer.format = format;
+    vertex_buffer.size = (uint32_t)size;
+    vertex_buffer.data = (uint8_t*)vertices;
+    IndexBuffer index_buffer = {};
+    index_buffer.size = sizeof(indices);
+    index_buffer.data = (uint8_t*)indices;
+    uint32_t geometry_id = gpu_->NextGeometryId();
+    gpu_->CreateGeometry(geometry_id, vertex_buffer, index_buffer);
+
+    Command cmd = {};
+    cmd.command_type = CommandType::DrawGeometry;
+    cmd.gpu_state = state;
+    cmd.geometry_id = geometry_id;
+    cmd.indices_count = format == VertexBufferFormat::_2f_4ub_2f ? 3 : 6;
+    cmd.indices_offset = 0;
+    commands_.push_back(cmd);
+  }
+
+  GPUDriver* gpu_;
+  uint32_t target_texture_id_ = 0;
+  uint32_t render_buffer_id_ = 0;
+  std::vector<Command> commands_;
+};
+
+// Overlapping translucent solid quads, blended with premultiplied over.
+void SolidQuads(SceneBuilder& s) {
+  s.Clear();
+  s.DrawQuad({ 4, 4, 44, 44, { 200, 0, 0, 200 }, kFillSolid, {} });
+  s.DrawQuad({ 20, 20, 60, 60, { 0, 0, 128, 128 }, kFillSolid, {} });
+  s.DrawQuad({ 10.5f, 30.25f, 54.75f, 36.5f, { 0, 96, 0, 96 }, kFillSolid, {} });
+}
+
+// A checkerboard texture magnified with bilinear filtering.
+void ImageQuad(SceneBuilder& s) {
+  uint32_t checker = s.CreateCheckerTexture(8);
+  s.Clear();
+  s.DrawQuad({ 0, 0, 64, 64, { 255, 255, 255, 255 }, kFillImage, { 0, 0, 1, 1 } }, checker);
+  s.DrawQuad({ 16, 16, 48, 48, { 128, 128, 128, 128 }, kFillImage, { 0.25f, 0.25f, 0.75f, 0.75f } },
+             checker);
+}
+
+// Path geometry (no anti-aliasing, see SoftwareGPUDriver).
+void PathTriangles(SceneBuilder& s) {
+  s.Clear();
+  const float a[3][2] = { { 32, 2 }, { 62, 58 }, { 2, 50 } };
+  const uint8_t red[4] = { 255, 0, 0, 255 };
+  s.DrawTriangle(a, red);
+  const float b[3][2] = { { 8, 8 }, { 56, 16 }, { 24, 62 } };
+  const uint8_t green[4] = { 0, 128, 0, 128 };
+  s.DrawTriangle(b, green);
+}
+
+// Draws that sample the render target they draw to. Each one must see every
+// earlier draw and none of its own output, whatever the tile order.
+void SelfSample(SceneBuilder& s) {
+  uint32_t target = s.target_texture_id();
+  s.Clear();
+  s.DrawQuad({ 0, 0, 32, 32, { 255, 0, 0, 255 }, kFillSolid, {} });
+  s.DrawQuad({ 32, 0, 64, 32, { 0, 255, 0, 255 }, kFillSolid, {} });
+  // Shift the whole target down and right by 8 pixels, twice.
+  for (int i = 0; i < 2; i++)
+    s.DrawQuad({ 8, 8, 64, 64, { 255, 255, 255, 255 }, kFillImage, { 0, 0, 56.0f / 64, 56.0f / 64 } },
+               target);
+  s.DrawQuad({ 0, 48, 16, 64, { 0, 0, 255, 255 }, kFillSolid, {} });
+  // Copy the bottom half over the top half, reading the quad drawn above.
+  s.DrawQuad({ 0, 0, 64, 32, { 255, 255, 255, 255 }, kFillImage, { 0, 0.5f, 1, 1 } }, target);
+}
+
+struct Scene {
+  const char* name;
+  void (*record)(SceneBuilder&);
+};
+
+const Scene kScenes[] = {
+  { "solid_quads", SolidQuads },
+  { "image_quad", ImageQuad },
+  { "path_triangles", PathTriangles },
+  { "self_sample", SelfSample },
+};
+
+// The target's pixels as tightly packed, premultiplied RGBA.
+std::vector<uint8_t> Render(const Scene& scene, int32_t worker_count) {
+  RefPtr<SoftwareGPUDriver> driver = SoftwareGPUDriver::Create(worker_count);
+  SceneBuilder builder(driver->driver());
+  builder.gpu()->BeginSynchronize();
+  uint32_t target = builder.CreateTarget();
+  scene.record(builder);
+  builder.Submit();
+  builder.gpu()->EndSynchronize();
+  driver->DrawCommandList();
+
+  std::vector<uint8_t> rgba(kSize * kSize * 4);
+  RefPtr<Bitmap> bitmap = driver->texture_bitmap(target);
+  const uint8_t* pixels = (const uint8_t*)bitmap->LockPixels();
+  for (uint32_t y = 0; y < kSize; y++) {
+    for (uint32_t x = 0; x < kSize; x++) {
+      const uint8_t* p = pixels + y * bitmap->row_bytes() + x * 4;
+      uint8_t* out = rgba.data() + (y * kSize + x) * 4;
+      out[0] = p[2];
+      out[1] = p[1];
+      out[2] = p[0];
+      out[3] = p[3];
+    }
+  }
+  bitmap->UnlockPixels();
+  return rgba;
+}
+
+std::string GoldenPath(const Scene& scene) {
+  return std::string(APPCORE_GOLDEN_DIR "/") + scene.name + ".pam";
+}
+
+bool WriteImage(const std::string& path, const std::vector<uint8_t>& rgba) {
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  fprintf(file, "P7\nWIDTH %u\nHEIGHT %u\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", kSize, kSize);
+  bool ok = fwrite(rgba.data(), 1, rgba.size(), file) == rgba.size();
+  return fclose(file) == 0 && ok;
+}
+
+bool ReadImage(const std::string& path, std::vector<uint8_t>& rgba) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file)
+    return false;
+  unsigned width = 0, height = 0;
+  bool ok = fscanf(file, "P7\nWIDTH %u\nHEIGHT %u\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR", &width,
+                   &height) == 2 && fgetc(file) == '\n' && width == kSize && height == kSize;
+  if (ok) {
+    rgba.resize(kSize * kSize * 4);
+    ok = fread(rgba.data(), 1, rgba.size(), file) == rgba.size();
+  }
+  fclose(file);
+  return ok;
+}
+
+// Reports the first differing pixel, returns the number of differing pixels.
+size_t Compare(const std::vector<uint8_t>& expected, const std::vector<uint8_t>& actual, const char* name,
+               int32_t worker_count) {
+  size_t differing = 0;
+  for (size_t i = 0; i < expected.size(); i += 4) {
+    if (memcmp(&expected[i], &actual[i], 4) == 0)
+      continue;
+    if (!differing++) {
+      size_t pixel = i / 4;
+      printf("%s (%d workers): pixel (%zu, %zu) is %d,%d,%d,%d, expected %d,%d,%d,%d\n", name, worker_count,
+             pixel % kSize, pixel / kSize, actual[i], actual[i + 1], actual[i + 2], actual[i + 3], expected[i],
+             expected[i + 1], expected[i + 2], expected[i + 3]);
+    }
+  }
+  return differing;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool update = argc > 1 && strcmp(argv[1], "--update") == 0;
+  const int32_t kWorkerCounts[] = { 0, 1, 3, 7 };
+  int failures = 0;
+
+  for (const Scene& scene : kScenes) {
+    std::string path = GoldenPath(scene);
+    if (update) {
+      if (!WriteImage(path, Render(scene, 0))) {
+        printf("%s: can't write %s\n", scene.name, path.c_str());
+        failures++;
+      }
+      continue;
+    }
+
+    std::vector<uint8_t> expected;
+    if (!ReadImage(path, expected)) {
+      printf("%s: can't read %s\n", scene.name, path.c_str());
+      failures++;
+      continue;
+    }
+
+    bool passed = true;
+    for (int32_t worker_count : kWorkerCounts) {
+      std::vector<uint8_t> actual = Render(scene, worker_count);
+      if (size_t differing = Compare(expected, actual, scene.name, worker_count)) {
+        printf("%s (%d workers): %zu pixels differ\n", scene.name, worker_count, differing);
+        std::string actual_path = std::string(scene.name) + ".actual.pam";
+        if (WriteImage(actual_path, actual))
+          printf("%s: wrote %s\n", scene.name, actual_path.c_str());
+        passed = false;
+        break;
+      }
+    }
+    printf("%s: %s\n", scene.name, passed ? "passed" : "FAILED");
+    failures += passed ? 0 : 1;
+  }
+
+  return failures ? 1 : 0;
+}
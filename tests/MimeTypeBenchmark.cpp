@@ -0,0 +1,81 @@
+// Mime type lookups through FileUtils::LookupMimeType() (a compile-time
+// perfect hash) against the std::unordered_map it replaced.
+//
+// Both hold the same extensions. Queries mix common web asset extensions
+// with a few unknown ones, like a page load does.
+//
+// Usage: MimeTypeBenchmark [iterations]
+
+// Included rather than linked for kMimeTypes, so the baseline map is built
+// from the same table.
+#include "FileUtils.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+
+using namespace ultralight;
+
+namespace {
+
+const char* const kQueries[] = {
+  "html", "css", "js", "png", "jpg", "svg", "woff2", "json", "gif", "webp",
+  "mjs", "wasm", "ico", "ttf", "otf", "mp4", "webm", "xml", "txt", "map",
+  "jpeg", "avif", "htm", "mp3", "unknown", "tmp", "bak", "",
+};
+
+const size_t kQueryCount = std::size(kQueries);
+
+// The old implementation: a lazily built map keyed by std::string, which
+// allocated a key on every lookup.
+const char* MapLookup(const char* ext) {
+  static const std::unordered_map<std::string, const char*> mime_types = [] {
+    std::unordered_map<std::string, const char*> map;
+    for (const auto& entry : FileUtils::kMimeTypes)
+      map.emplace(std::string(entry.ext), entry.mime_type);
+    return map;
+  }();
+
+  auto it = mime_types.find(ext);
+  if (it != mime_types.end())
+    return it->second;
+  return "application/octet-stream";
+}
+
+template <typename Lookup>
+double Measure(size_t iterations, Lookup lookup) {
+  // Summed so the lookups can't be optimized away.
+  size_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++)
+    checksum += (uintptr_t)lookup(kQueries[i % kQueryCount]);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (checksum == 1)
+    printf("\n");
+  return seconds * 1e9 / iterations;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t iterations = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+  if (!iterations)
+    iterations = 1;
+
+  // Results must agree for every known extension.
+  for (const char* query : kQueries) {
+    if (strcmp(FileUtils::FileExtensionToMimeType(query), MapLookup(query)) != 0) {
+      printf("mismatch for '%s'\n", query);
+      return 1;
+    }
+  }
+
+  double perfect_hash = Measure(iterations, [](const char* ext) { return FileUtils::FileExtensionToMimeType(ext); });
+  double map = Measure(iterations, MapLookup);
+  printf("%zu lookups over %zu extensions:\n", iterations, kQueryCount);
+  printf("  perfect hash   %6.1f ns/lookup\n", perfect_hash);
+  printf("  unordered_map  %6.1f ns/lookup\n", map);
+  return 0;
+}
@@ -0,0 +1,257 @@
+// AppCorePak: packs a directory of assets into an AppCore asset archive
+// (see src/common/PakFormat.h) for FileSystemPak.
+//
+// Usage: AppCorePak [options] <input_dir> <output.pak>
+//
+//   --compression none|lz4|zstd  Codec for entries (default: zstd, else lz4, else none,
+//                                depending on what this build supports).
+//   --level N                    Compression level (default: 19 for zstd, 12 for lz4).
+//   --min-savings PERCENT        Store entries as-is unless compression saves at least
+//                                this much (default: 10). Stored entries are served
+//                                straight from the mapped archive.
+//
+#include "FileUtils.h"
+#include "PakFormat.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace ultralight;
+
+namespace {
+
+struct InputFile {
+  std::string path; // Relative, forward slashes
+  std::filesystem::path source;
+  PakEntry entry = {};
+};
+
+bool ReadFile(const std::filesystem::path& path, std::vector<char>& data) {
+  FILE* file = fopen(path.string().c_str(), "rb");
+  if (!file)
+    return false;
+
+  data.clear();
+  char chunk[1 << 16];
+  size_t length;
+  while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    data.insert(data.end(), chunk, chunk + length);
+
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+}
+
+// From the extension, or from the first bytes of the file if the extension is
+// missing or unknown.
+std::string MimeType(const InputFile& file) {
+  if (const char* mime = FileUtils::LookupMimeType(FileUtils::FileExtension(file.path)))
+    return mime;
+
+  char head[FileUtils::kMimeSniffLength];
+  size_t length = 0;
+  if (FILE* input = fopen(file.source.string().c_str(), "rb")) {
+    length = fread(head, 1, sizeof(head), input);
+    fclose(input);
+  }
+  const char* mime = FileUtils::SniffMimeType(head, length);
+  return mime ? mime : "application/octet-stream";
+}
+
+const char kZeros[kPakDataAlignment] = {};
+
+bool WritePadding(FILE* file, uint64_t& offset, uint64_t alignment) {
+  uint64_t padding = (alignment - offset % alignment) % alignment;
+  offset += padding;
+  return fwrite(kZeros, 1, (size_t)padding, file) == padding;
+}
+
+bool ParseCompression(const char* name, PakCompression& compression) {
+  if (!strcmp(name, "none"))
+    compression = PakCompression::None;
+  else if (!strcmp(name, "lz4"))
+    compression = PakCompression::LZ4;
+  else if (!strcmp(name, "zstd"))
+    compression = PakCompression::Zstd;
+  else
+    return false;
+  return true;
+}
+
+int Usage() {
+  fprintf(stderr, "Usage: AppCorePak [--compression none|lz4|zstd] [--level N] "
+                  "[--min-savings PERCENT] <input_dir> <output.pak>\n");
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  PakCompression compression = PakCompression::None;
+  if (PakIsCompressionSupported(PakCompression::Zstd))
+    compression = PakCompression::Zstd;
+  else if (PakIsCompressionSupported(PakCompression::LZ4))
+    compression = PakCompression::LZ4;
+
+  int level = -1;
+  double min_savings = 10.0;
+  std::vector<const char*> positional;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--compression") && i + 1 < argc) {
+      if (!ParseCompression(argv[++i], compression))
+        return Usage();
+    } else if (!strcmp(argv[i], "--level") && i + 1 < argc) {
+      level = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--min-savings") && i + 1 < argc) {
+      min_savings = atof(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      return Usage();
+    } else {
+      positional.push_back(argv[i]);
+    }
+  }
+
+  if (positional.size() != 2)
+    return Usage();
+
+  if (!PakIsCompressionSupported(compression)) {
+    fprintf(stderr, "AppCorePak: this build doesn't support the requested compression\n");
+    return 1;
+  }
+
+  if (level < 0)
+    level = compression == PakCompression::LZ4 ? 12 : 19;
+
+  std::filesystem::path input_dir = positional[0];
+  std::vector<InputFile> files;
+  std::error_code ec;
+  auto options = std::filesystem::directory_options::follow_directory_symlink;
+  for (std::filesystem::recursive_directory_iterator it(input_dir, options, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    if (!it->is_regular_file(ec))
+      continue;
+
+    InputFile file;
+    file.source = it->path();
+    file.path = std::filesystem::relative(it->path(), input_dir, ec).generic_string();
+    if (ec)
+      break;
+    file.entry.path_hash = PakHashPath(file.path.data(), file.path.size());
+    files.push_back(file);
+  }
+
+  if (ec) {
+    fprintf(stderr, "AppCorePak: failed to read '%s': %s\n", input_dir.string().c_str(),
+            ec.message().c_str());
+    return 1;
+  }
+
+  std::sort(files.begin(), files.end(), [](const InputFile& a, const InputFile& b) {
+    return a.entry.path_hash != b.entry.path_hash ? a.entry.path_hash < b.entry.path_hash
+                                                  : a.path < b.path;
+  });
+
+  // Paths first, then each distinct mime type once.
+  std::string strings;
+  std::map<std::string, uint32_t> mime_offsets;
+  for (auto& file : files) {
+    file.entry.path_offset = (uint32_t)strings.size();
+    file.entry.path_length = (uint32_t)file.path.size();
+    strings += file.path;
+  }
+  for (auto& file : files) {
+    std::string mime = MimeType(file);
+    auto inserted = mime_offsets.insert({ mime, (uint32_t)strings.size() });
+    if (inserted.second) {
+      strings += mime;
+      strings += '\0';
+    }
+    file.entry.mime_offset = inserted.first->second;
+  }
+
+  const char* output_path = positional[1];
+  FILE* output = fopen(output_path, "wb");
+  if (!output) {
+    fprintf(stderr, "AppCorePak: failed to create '%s'\n", output_path);
+    return 1;
+  }
+
+  PakHeader header = {};
+  bool ok = fwrite(&header, sizeof(header), 1, output) == 1;
+  uint64_t offset = sizeof(header);
+  uint64_t total_size = 0, total_stored = 0;
+  std::vector<char> data, compressed;
+
+  for (auto& file : files) {
+    if (!ok)
+      break;
+
+    if (!ReadFile(file.source, data)) {
+      fprintf(stderr, "AppCorePak: failed to read '%s'\n", file.source.string().c_str());
+      ok = false;
+      break;
+    }
+
+    const char* stored = data.data();
+    size_t stored_size = data.size();
+    file.entry.compression = (uint16_t)PakCompression::None;
+
+    if (compression != PakCompression::None && !data.empty()) {
+      size_t max_size = (size_t)(data.size() * (1.0 - min_savings / 100.0));
+      compressed.resize(max_size);
+      size_t compressed_size = max_size ? PakCompress(compression, level, data.data(), data.size(),
+                                                      compressed.data(), max_size) : 0;
+      if (compressed_size) {
+        stored = compressed.data();
+        stored_size = compressed_size;
+        file.entry.compression = (uint16_t)compression;
+      }
+    }
+
+    ok = WritePadding(output, offset, kPakDataAlignment) &&
+         fwrite(stored, 1, stored_size, output) == stored_size;
+    file.entry.data_offset = offset;
+    file.entry.stored_size = stored_size;
+    file.entry.size = data.size();
+    offset += stored_size;
+    total_size += data.size();
+    total_stored += stored_size;
+  }
+
+  if (ok) {
+    ok = WritePadding(output, offset, alignof(PakEntry));
+    header.index_offset = offset;
+    for (auto& file : files)
+      ok = ok && fwrite(&file.entry, sizeof(PakEntry), 1, output) == 1;
+    offset += files.size() * sizeof(PakEntry);
+
+    header.strings_offset = offset;
+    header.strings_size = strings.size();
+    ok = ok && fwrite(strings.data(), 1, strings.size(), output) == strings.size();
+  }
+
+  if (ok) {
+    memcpy(header.magic, kPakMagic, sizeof(kPakMagic));
+    header.version = kPakVersion;
+    header.entry_count = (uint32_t)files.size();
+    ok = fseek(output, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, output) == 1;
+  }
+
+  ok = fclose(output) == 0 && ok;
+  if (!ok) {
+    fprintf(stderr, "AppCorePak: failed to write '%s'\n", output_path);
+    remove(output_path);
+    return 1;
+  }
+
+  printf("Packed %zu files, %llu bytes stored as %llu\n", files.size(),
+         (unsigned long long)total_size, (unsigned long long)total_stored);
+  return 0;
+}